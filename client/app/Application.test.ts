@@ -1,5 +1,14 @@
-import { Wallet } from 'xrpl'
-import { Application, CreateCampaignParams } from './Application'
+import { Client, Wallet } from 'xrpl'
+import { Connection } from 'mongoose'
+import {
+  Application,
+  CreateCampaignParams,
+  FundCampaignsParams,
+} from './Application'
+import { HOOK_ACCOUNT_WALLET } from './constants'
+import { HookStateKey } from './models/HookStateKey'
+import connectDatabase from '../database'
+import { DestinationTagReservationDatabaseModel } from '../database/models/destinationTagReservation.model'
 
 describe('Application', () => {
   describe('createCampaign', () => {
@@ -246,5 +255,144 @@ describe('Application', () => {
         )
       })
     })
+
+    describe('destination tag reservation', () => {
+      let database: Connection
+
+      beforeAll(async () => {
+        database = connectDatabase()
+        await DestinationTagReservationDatabaseModel.init()
+      })
+
+      afterAll(async () => {
+        await database.close()
+      })
+
+      it('should release the destination tag when the Payment is not submitted', async () => {
+        // Every destination tag is free on ledger; remembers the ones that were probed
+        const probedDestinationTags: number[] = []
+        const client = {
+          isConnected: () => true,
+          request: async (request: any) => {
+            probedDestinationTags.push(
+              HookStateKey.destinationTagOf(request.hook_state.key)
+            )
+            throw Object.assign(new Error('entryNotFound'), {
+              data: { error: 'entryNotFound' },
+            })
+          },
+        } as unknown as Client
+        const now = Math.floor(Date.now() / 1000)
+        const params: CreateCampaignParams = {
+          ownerWallet: Wallet.generate(),
+          depositInDrops: Application.getCreateCampaignDepositInDrops(),
+          title: 'title',
+          description: 'description',
+          overviewUrl: 'overviewUrl',
+          imageUrl: 'imageUrl',
+          fundRaiseGoalInDrops: BigInt(25000000000),
+          fundRaiseEndDateInUnixSeconds: BigInt(now + 30 * 24 * 60 * 60),
+          milestones: [
+            {
+              endDateInUnixSeconds: BigInt(now + 60 * 24 * 60 * 60),
+              title: 'milestoneTitle',
+              payoutPercent: 100,
+            },
+          ],
+        }
+
+        // The shared xrpl Client used to prepare the Payment isn't connected, so it fails
+        await expect(
+          Application.createCampaign(client, database, params)
+        ).rejects.toThrow()
+
+        expect(probedDestinationTags).toHaveLength(1)
+        const [destinationTag] = probedDestinationTags
+        expect(
+          await DestinationTagReservationDatabaseModel.findOne({
+            destinationTag,
+          })
+        ).toBeNull()
+      })
+    })
+  })
+
+  describe('fundCampaigns', () => {
+    describe('_validateFundCampaignsParams', () => {
+      let params: FundCampaignsParams
+
+      beforeEach(() => {
+        const fundAmountInDrops =
+          Application.getFundCampaignDepositInDrops() + BigInt(1000000)
+        params = {
+          backerWallet: Wallet.generate(),
+          fundCampaigns: [
+            { campaignId: 1, fundAmountInDrops },
+            { campaignId: 2, fundAmountInDrops },
+          ],
+        }
+      })
+
+      it('should not throw', () => {
+        expect(() =>
+          // @ts-expect-error - we're testing the private method
+          Application._validateFundCampaignsParams(params)
+        ).not.toThrow()
+      })
+
+      it('should throw if fundCampaigns is empty', () => {
+        params.fundCampaigns = []
+        expect(() =>
+          // @ts-expect-error - we're testing the private method
+          Application._validateFundCampaignsParams(params)
+        ).toThrow('Invalid fundCampaigns length 0. Must be between 1 and 5')
+      })
+
+      it('should throw if fundCampaigns is greater than the max value allowed', () => {
+        params.fundCampaigns = Array(6).fill(params.fundCampaigns[0])
+        expect(() =>
+          // @ts-expect-error - we're testing the private method
+          Application._validateFundCampaignsParams(params)
+        ).toThrow('Invalid fundCampaigns length 6. Must be between 1 and 5')
+      })
+
+      it('should throw if a fundAmountInDrops does not cover the fund campaign deposit', () => {
+        params.fundCampaigns[1].fundAmountInDrops =
+          Application.getFundCampaignDepositInDrops()
+        expect(() =>
+          // @ts-expect-error - we're testing the private method
+          Application._validateFundCampaignsParams(params)
+        ).toThrow(
+          `Invalid fundAmountInDrops ${Application.getFundCampaignDepositInDrops()}. Must be more than the fund campaign deposit of ${Application.getFundCampaignDepositInDrops()} drops`
+        )
+      })
+    })
+  })
+
+  describe('migrateCampaignHookState', () => {
+    describe('_validateMigrateCampaignHookStateParams', () => {
+      it('should not throw for the Hook Account wallet', () => {
+        expect(() =>
+          // @ts-expect-error - we're testing the private method
+          Application._validateMigrateCampaignHookStateParams({
+            wallet: HOOK_ACCOUNT_WALLET,
+            campaignId: 1,
+          })
+        ).not.toThrow()
+      })
+
+      it('should throw if the wallet is not the Hook Account', () => {
+        const wallet = Wallet.generate()
+        expect(() =>
+          // @ts-expect-error - we're testing the private method
+          Application._validateMigrateCampaignHookStateParams({
+            wallet,
+            campaignId: 1,
+          })
+        ).toThrow(
+          `Invalid wallet ${wallet.address}. Must be the Hook Account wallet ${HOOK_ACCOUNT_WALLET.address}`
+        )
+      })
+    })
   })
 })
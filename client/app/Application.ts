@@ -4,11 +4,14 @@ Contains the operations that can are performed by the application.
 Here are the operations that are required by the application:
 1. Create Campaign
 2. View Campaigns
-3. Fund Campaign
+3. Fund Campaign (or several campaigns with one Payment)
 4. Vote Reject Milestone
 5. Vote Approve Milestone
 6. Request Refund Payment
 7. Request Milestone Payout Payment
+
+Maintenance operations:
+1. Migrate Campaign Hook State
 */
 
 import { spawnSync } from 'child_process'
@@ -22,27 +25,30 @@ import {
   Wallet,
 } from 'xrpl'
 import { StateUtility } from '../util/StateUtility'
-import {
-  generateRandomDestinationTag,
-  prepareTransactionV3,
-} from '../util/transaction'
+import { CampaignViewReader } from '../util/CampaignViewReader'
+import { prepareTransactionV3 } from '../util/transaction'
+import { submitAndWaitV3 } from '../util/SubmissionPipeline'
 import {
   CREATE_CAMPAIGN_DEPOSIT_IN_DROPS,
   DESCRIPTION_MAX_LENGTH,
   FUND_CAMPAIGN_DEPOSIT_IN_DROPS,
   HOOK_ACCOUNT_WALLET,
   MILESTONES_MAX_LENGTH,
+  MULTI_FUND_CAMPAIGNS_MAX_LENGTH,
   OVERVIEW_URL_MAX_LENGTH,
   TITLE_MAX_LENGTH,
 } from './constants'
 import { CreateCampaignPayload } from './models/CreateCampaignPayload'
 import { FundCampaignPayload } from './models/FundCampaignPayload'
+import { MultiFundCampaignPayload } from './models/MultiFundCampaignPayload'
+import { MultiFundCampaignEntryPayload } from './models/MultiFundCampaignEntryPayload'
 import { MilestonePayload } from './models/MilestonePayload'
 import { Campaign } from './models/Campaign'
 import { VoteRejectMilestonePayload } from './models/VoteRejectMilestonePayload'
 import { VoteApproveMilestonePayload } from './models/VoteApproveMilestonePayload'
 import { RequestRefundPaymentPayload } from './models/RequestRefundPaymentPayload'
 import { RequestMilestonePayoutPaymentPayload } from './models/RequestMilestonePayoutPaymentPayload'
+import { MigrateHookStatePayload } from './models/MigrateHookStatePayload'
 import {
   CampaignDatabaseModel,
   ICampaignDatabaseModel,
@@ -71,6 +77,15 @@ export interface FundCampaignParams {
   fundAmountInDrops: bigint
 }
 
+export interface FundCampaignsParams {
+  backerWallet: Wallet
+  // fundAmountInDrops of each campaign includes its fund campaign deposit, same as FundCampaignParams
+  fundCampaigns: Array<{
+    campaignId: number
+    fundAmountInDrops: bigint
+  }>
+}
+
 interface InvokeCampaignParams {
   backerWallet: Wallet
   campaignId: number
@@ -89,6 +104,16 @@ export interface RequestMilestonePayoutPaymentParams {
   milestoneIndex: number
 }
 
+export interface MigrateCampaignHookStateParams {
+  wallet: Wallet
+  campaignId: number
+}
+
+export interface MigrateCampaignHookStateResult {
+  layoutVersion: number
+  migrationCursor: number
+}
+
 export class Application {
   static init(): void {
     const command1 = 'npm'
@@ -149,58 +174,59 @@ export class Application {
     /* Step 1. Input validation */
     this._validateCreateCampaignParams(params)
 
-    /* Step 2. Generate a random unique campaign ID */
-    const campaigns = await Application.viewCampaigns(client, database)
-    let destinationTag: number
-    do {
-      destinationTag = generateRandomDestinationTag()
-    } while (campaigns.find((campaign) => campaign.id === destinationTag))
+    /* Step 2. Allocate a random unique campaign ID */
+    const campaignId = await StateUtility.allocateDestinationTag(client)
 
-    const campaignId = destinationTag
-
-    /* Step 3. Create transaction Memo payloads */
-    const milestonePayloads = milestones.map((milestone) => {
-      return new MilestonePayload(
-        milestone.endDateInUnixSeconds,
-        milestone.payoutPercent
+    try {
+      /* Step 3. Create transaction Memo payloads */
+      const milestonePayloads = milestones.map((milestone) => {
+        return new MilestonePayload(
+          milestone.endDateInUnixSeconds,
+          milestone.payoutPercent
+        )
+      })
+      const createCampaignPayload = new CreateCampaignPayload(
+        fundRaiseGoalInDrops,
+        fundRaiseEndDateInUnixSeconds,
+        milestonePayloads
       )
-    })
-    const createCampaignPayload = new CreateCampaignPayload(
-      fundRaiseGoalInDrops,
-      fundRaiseEndDateInUnixSeconds,
-      milestonePayloads
-    )
 
-    /* Step 4. Submit Payment transaction with CreateCampaignPayload */
-    const createCampaignTx: Payment = {
-      TransactionType: 'Payment',
-      Account: ownerWallet.address,
-      Amount: depositInDrops.toString(),
-      Destination: HOOK_ACCOUNT_WALLET.address, // TODO: replace with Hook Account address
-      DestinationTag: campaignId,
-      Memos: [
-        {
-          Memo: {
-            MemoData: createCampaignPayload.encode(),
-            MemoFormat: convertStringToHex(`signed/payload+1`),
-            MemoType: convertStringToHex(`liteacc/payment`),
+      /* Step 4. Submit Payment transaction with CreateCampaignPayload */
+      const createCampaignTx: Payment = {
+        TransactionType: 'Payment',
+        Account: ownerWallet.address,
+        Amount: depositInDrops.toString(),
+        Destination: HOOK_ACCOUNT_WALLET.address, // TODO: replace with Hook Account address
+        DestinationTag: campaignId,
+        Memos: [
+          {
+            Memo: {
+              MemoData: createCampaignPayload.encode(),
+              MemoFormat: convertStringToHex(`signed/payload+1`),
+              MemoType: convertStringToHex(`liteacc/payment`),
+            },
           },
-        },
-      ],
-    }
+        ],
+      }
 
-    await prepareTransactionV3(createCampaignTx)
+      await prepareTransactionV3(createCampaignTx)
 
-    /* Step 6. submit Payment transaction with CreateCampaignPayload */
-    // @ts-expect-error - this is functional
-    validate(createCampaignTx)
-    const paymentResponse = await client.submitAndWait(createCampaignTx, {
-      autofill: true,
-      wallet: ownerWallet,
-    })
+      /* Step 6. submit Payment transaction with CreateCampaignPayload */
+      // @ts-expect-error - this is functional
+      validate(createCampaignTx)
+      const paymentResponse = await submitAndWaitV3(
+        client,
+        createCampaignTx,
+        ownerWallet
+      )
 
-    /* Step 7. Check Payment transaction result */
-    this._validateTxResponse(paymentResponse, 'createCampaign')
+      /* Step 7. Check Payment transaction result */
+      this._validateTxResponse(paymentResponse, 'createCampaign')
+    } catch (error) {
+      // Free the tag so a failed submission doesn't keep it reserved
+      await StateUtility.releaseDestinationTag(campaignId)
+      throw error
+    }
 
     /* Step 8. Add title(campaign & milestones), description, overviewUrl, imageUrl fields to an off-ledger database (e.g. MongoDB) */
     const campaignData: ICampaignDatabaseModel = {
@@ -253,8 +279,11 @@ export class Application {
       throw new Error('MongoDB database is not connected')
     }
 
-    const campaigns = await Application.viewCampaigns(client, database)
-    const campaign = campaigns.find((campaign) => campaign.id === campaignId)
+    const campaign = await CampaignViewReader.getCampaign(
+      client,
+      database,
+      campaignId
+    )
     if (!campaign) {
       throw new Error(`Campaign with ID ${campaignId} not found`)
     }
@@ -300,10 +329,11 @@ export class Application {
     /* Step 4. Submit Payment transaction with CreateCampaignPayload */
     // @ts-expect-error - this is functional
     validate(fundCampaignTx)
-    const paymentResponse = await client.submitAndWait(fundCampaignTx, {
-      autofill: true,
-      wallet: backerWallet,
-    })
+    const paymentResponse = await submitAndWaitV3(
+      client,
+      fundCampaignTx,
+      backerWallet
+    )
 
     /* Step 5. Check Payment transaction result */
     const acceptMessageHex = this._validateTxResponse(
@@ -316,6 +346,78 @@ export class Application {
     return fundTransactionId
   }
 
+  static async fundCampaigns(
+    client: Client,
+    params: FundCampaignsParams
+  ): Promise<number[]> {
+    if (!client.isConnected()) {
+      throw new Error('xrpl Client is not connected')
+    }
+
+    /* Step 1. Input validation */
+    this._validateFundCampaignsParams(params)
+
+    const { backerWallet, fundCampaigns } = params
+
+    /* Step 2. Create transaction Memo payload; the hook receives each fund amount without its deposit */
+    const multiFundCampaignPayload = new MultiFundCampaignPayload(
+      fundCampaigns.map(
+        ({ campaignId, fundAmountInDrops }) =>
+          new MultiFundCampaignEntryPayload(
+            campaignId,
+            fundAmountInDrops - FUND_CAMPAIGN_DEPOSIT_IN_DROPS
+          )
+      )
+    )
+    const totalAmountInDrops = fundCampaigns.reduce(
+      (acc, cur) => acc + cur.fundAmountInDrops,
+      0n
+    )
+
+    // Step 3. Submit Payment transaction with MultiFundCampaignPayload
+    const fundCampaignsTx: Payment = {
+      TransactionType: 'Payment',
+      Account: backerWallet.address,
+      Amount: totalAmountInDrops.toString(),
+      Destination: HOOK_ACCOUNT_WALLET.address, // TODO: replace with Hook Account address
+      Memos: [
+        {
+          Memo: {
+            MemoData: multiFundCampaignPayload.encode(),
+            MemoFormat: convertStringToHex(`signed/payload+1`),
+            MemoType: convertStringToHex(`liteacc/payment`),
+          },
+        },
+      ],
+    }
+
+    await prepareTransactionV3(fundCampaignsTx)
+
+    /* Step 4. Submit Payment transaction with MultiFundCampaignPayload */
+    // @ts-expect-error - this is functional
+    validate(fundCampaignsTx)
+    const paymentResponse = await submitAndWaitV3(
+      client,
+      fundCampaignsTx,
+      backerWallet
+    )
+
+    /* Step 5. Check Payment transaction result */
+    const acceptMessageHex = this._validateTxResponse(
+      paymentResponse,
+      'fundCampaigns'
+    )
+
+    /* Step 6. Return fundTransactionIds (4 bytes each, in fundCampaigns order) from transaction response */
+    const fundTransactionIds: number[] = []
+    for (let i = 0; i < fundCampaigns.length; i++) {
+      fundTransactionIds.push(
+        parseInt(acceptMessageHex.slice(i * 8, (i + 1) * 8), 16)
+      )
+    }
+    return fundTransactionIds
+  }
+
   static async voteRejectMilestone(
     client: Client,
     params: VoteRejectMilestoneParams
@@ -346,12 +448,10 @@ export class Application {
 
     await prepareTransactionV3(voteRejectMilestoneTx)
 
-    const voteRejectMilestoneTxResponse = await client.submitAndWait(
+    const voteRejectMilestoneTxResponse = await submitAndWaitV3(
+      client,
       voteRejectMilestoneTx,
-      {
-        autofill: true,
-        wallet: backerWallet,
-      }
+      backerWallet
     )
 
     /* Step 4. Check Invoke transaction result */
@@ -391,12 +491,10 @@ export class Application {
 
     await prepareTransactionV3(voteApproveMilestoneTx)
 
-    const voteApproveMilestoneTxResponse = await client.submitAndWait(
+    const voteApproveMilestoneTxResponse = await submitAndWaitV3(
+      client,
       voteApproveMilestoneTx,
-      {
-        autofill: true,
-        wallet: backerWallet,
-      }
+      backerWallet
     )
 
     /* Step 4. Check Invoke transaction result */
@@ -436,12 +534,10 @@ export class Application {
 
     await prepareTransactionV3(requestRefundPaymentTx)
 
-    const requestRefundPaymentTxResponse = await client.submitAndWait(
+    const requestRefundPaymentTxResponse = await submitAndWaitV3(
+      client,
       requestRefundPaymentTx,
-      {
-        autofill: true,
-        wallet: backerWallet,
-      }
+      backerWallet
     )
 
     /* Step 4. Check Invoke transaction result */
@@ -484,12 +580,10 @@ export class Application {
 
     await prepareTransactionV3(requestMilestonePaymentTx)
 
-    const requestMilestonePayoutPaymentTxResponse = await client.submitAndWait(
+    const requestMilestonePayoutPaymentTxResponse = await submitAndWaitV3(
+      client,
       requestMilestonePaymentTx,
-      {
-        autofill: true,
-        wallet: ownerWallet,
-      }
+      ownerWallet
     )
 
     /* Step 4. Check Invoke transaction result */
@@ -503,6 +597,59 @@ export class Application {
     return payoutAmountInDrops
   }
 
+  /**
+   * Submits a single migration step for a campaign from the Hook Account, the
+   * only account the hook lets migrate. Each step covers at most
+   * HOOK_STATE_MIGRATION_BATCH_PAGES fund transaction pages, so callers should
+   * repeat it until layoutVersion reaches HOOK_STATE_LAYOUT_VERSION_CURRENT.
+   */
+  static async migrateCampaignHookState(
+    client: Client,
+    params: MigrateCampaignHookStateParams
+  ): Promise<MigrateCampaignHookStateResult> {
+    if (!client.isConnected()) {
+      throw new Error('xrpl Client is not connected')
+    }
+
+    /* Step 1. Input validation */
+    this._validateMigrateCampaignHookStateParams(params)
+
+    const { wallet, campaignId } = params
+
+    /* Step 2. Create transaction Blob payload */
+    const migrateHookStatePayload = new MigrateHookStatePayload()
+
+    /* Step 3. Submit Invoke transaction with MigrateHookStatePayload */
+    // No Destination: an Invoke sent by the Hook Account runs its own hooks
+    const migrateHookStateTx: Transaction = {
+      // @ts-expect-error - Invoke transaction type is supported in Hooks Testnet v3
+      TransactionType: 'Invoke',
+      Account: wallet.address,
+      DestinationTag: campaignId,
+      Blob: migrateHookStatePayload.encode(),
+    }
+
+    await prepareTransactionV3(migrateHookStateTx)
+
+    const migrateHookStateTxResponse = await submitAndWaitV3(
+      client,
+      migrateHookStateTx,
+      wallet
+    )
+
+    /* Step 4. Check Invoke transaction result */
+    const acceptMessageHex = this._validateTxResponse(
+      migrateHookStateTxResponse,
+      'migrateCampaignHookState'
+    )
+
+    /* Step 5. Return layoutVersion & migrationCursor from transaction response */
+    return {
+      layoutVersion: parseInt(acceptMessageHex.slice(0, 2), 16),
+      migrationCursor: parseInt(acceptMessageHex.slice(2, 10), 16),
+    }
+  }
+
   private static _validateTxResponse(
     txResponse: TxResponse,
     operationName: string
@@ -669,6 +816,36 @@ export class Application {
     }
   }
 
+  private static _validateFundCampaignsParams(params: FundCampaignsParams) {
+    const { backerWallet, fundCampaigns } = params
+
+    if (
+      !Array.isArray(fundCampaigns) ||
+      fundCampaigns.length < 1 ||
+      fundCampaigns.length > MULTI_FUND_CAMPAIGNS_MAX_LENGTH
+    ) {
+      throw new Error(
+        `Invalid fundCampaigns length ${fundCampaigns?.length}. Must be between 1 and ${MULTI_FUND_CAMPAIGNS_MAX_LENGTH}`
+      )
+    }
+    for (const { campaignId, fundAmountInDrops } of fundCampaigns) {
+      this._validateFundCampaignParams({
+        backerWallet,
+        campaignId,
+        fundAmountInDrops,
+      })
+    }
+    const totalAmountInDrops = fundCampaigns.reduce(
+      (acc, cur) => acc + cur.fundAmountInDrops,
+      0n
+    )
+    if (totalAmountInDrops > 2n ** 64n - 1n) {
+      throw new Error(
+        `Invalid total fundAmountInDrops ${totalAmountInDrops}. Must be less than 2^64 - 1 drops`
+      )
+    }
+  }
+
   private static _validateInvokeCampaignParams(params: InvokeCampaignParams) {
     const { backerWallet, campaignId, fundTransactionId } = params
 
@@ -689,6 +866,26 @@ export class Application {
     }
   }
 
+  private static _validateMigrateCampaignHookStateParams(
+    params: MigrateCampaignHookStateParams
+  ) {
+    const { wallet, campaignId } = params
+
+    if (wallet instanceof Wallet === false) {
+      throw new Error(`Invalid wallet ${wallet}. Must be an instance of Wallet`)
+    }
+    if (wallet.address !== HOOK_ACCOUNT_WALLET.address) {
+      throw new Error(
+        `Invalid wallet ${wallet.address}. Must be the Hook Account wallet ${HOOK_ACCOUNT_WALLET.address}`
+      )
+    }
+    if (campaignId < 0 || campaignId > 2 ** 32 - 1) {
+      throw new Error(
+        `Invalid campaignId ${campaignId}. Must be between 0 and 2^32 - 1`
+      )
+    }
+  }
+
   private static _validateRequestMilestonePayoutPaymentParams(
     params: RequestMilestonePayoutPaymentParams
   ) {
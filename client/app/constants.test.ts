@@ -1,4 +1,11 @@
-import { deriveMilestonesStates } from './constants'
+import {
+  CAMPAIGN_STATE_DERIVE_FLAG,
+  campaignStateFlagOf,
+  deriveMilestonesStates,
+  MILESTONE_STATE_DERIVE_FLAG,
+  MILESTONE_STATE_PAID_FLAG,
+  milestoneStateFlagOf,
+} from './constants'
 import { HSVMilestone } from './models/HSVMilestone'
 
 describe('constants', () => {
@@ -39,4 +46,25 @@ describe('constants', () => {
       expect(milestonesStates).toEqual(['unstarted', 'unstarted', 'unstarted'])
     })
   })
+  describe('campaignStateFlagOf', () => {
+    it('should keep failed milestone codes and share the derive flag otherwise', () => {
+      expect(campaignStateFlagOf('failedMilestone3')).toBe(3)
+      expect(campaignStateFlagOf('failedMilestone10')).toBe(10)
+      expect(campaignStateFlagOf('fundRaise')).toBe(CAMPAIGN_STATE_DERIVE_FLAG)
+      expect(campaignStateFlagOf('milestone2')).toBe(CAMPAIGN_STATE_DERIVE_FLAG)
+      expect(campaignStateFlagOf('completed')).toBe(CAMPAIGN_STATE_DERIVE_FLAG)
+    })
+  })
+
+  describe('milestoneStateFlagOf', () => {
+    it('should share the derive flag for time-derived states', () => {
+      expect(milestoneStateFlagOf('paid')).toBe(MILESTONE_STATE_PAID_FLAG)
+      expect(milestoneStateFlagOf('inProgress')).toBe(
+        MILESTONE_STATE_DERIVE_FLAG
+      )
+      expect(milestoneStateFlagOf('payoutAvailable')).toBe(
+        MILESTONE_STATE_DERIVE_FLAG
+      )
+    })
+  })
 })
@@ -99,6 +99,20 @@ export const MODE_DEV_FUND_CAMPAIGN_FLAG = 0x07
 export const MODE_DEV_VOTE_REJECT_MILESTONE_FLAG = 0x08
 export const MODE_DEV_VOTE_APPROVE_MILESTONE_FLAG = 0x09
 
+// Mode used to upgrade a campaign's Hook State entries to the current layout version
+export const MODE_MIGRATE_HOOK_STATE_FLAG = 0x0a
+
+// Mode used to fund several campaigns with a single Payment
+export const MODE_MULTI_FUND_CAMPAIGN_FLAG = 0x0b
+
+// Hook State layout versions
+export const HOOK_STATE_LAYOUT_VERSION_LEGACY = 0x00
+export const HOOK_STATE_LAYOUT_VERSION_CURRENT = 0x01
+
+// General Info layout trailer (layout version 1+) starts right after the max General Info bytes
+export const GENERAL_INFO_MAX_BYTES = 186
+export const GENERAL_INFO_LAYOUT_MAGIC = 0x43464c56 // "CFLV"
+
 export const DATA_LOOKUP_GENERAL_INFO_FLAG = 0x00n
 export const DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG = 0x01n
 export const DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG =
@@ -106,6 +120,7 @@ export const DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG =
 
 // Payload validation
 export const MILESTONES_MAX_LENGTH = 10
+export const MULTI_FUND_CAMPAIGNS_MAX_LENGTH = 5
 
 export const FUND_TRANSACTIONS_PAGE_MAX_SIZE = 5
 
@@ -219,3 +234,27 @@ export const deriveFundTransactionState = (
 
   throw new Error('Invalid fund transaction state code')
 }
+
+// convert campaign state back to its state code; time-derived states share the derive flag
+export const campaignStateFlagOf = (
+  campaignState: CampaignState
+): CampaignStateFlag => {
+  if (campaignState.startsWith('failedMilestone')) {
+    return Number(
+      campaignState.replace('failedMilestone', '')
+    ) as CampaignStateFlag
+  }
+  return CAMPAIGN_STATE_DERIVE_FLAG
+}
+
+// convert milestone state back to its state code; time-derived states share the derive flag
+export const milestoneStateFlagOf = (
+  milestoneState: MilestoneState
+): MilestoneStateFlag => {
+  if (milestoneState === 'failed') {
+    return MILESTONE_STATE_FAILED_FLAG
+  } else if (milestoneState === 'paid') {
+    return MILESTONE_STATE_PAID_FLAG
+  }
+  return MILESTONE_STATE_DERIVE_FLAG
+}
@@ -0,0 +1,74 @@
+import { client, connectClient, disconnectClient } from '../util/xrplClient'
+import { StateUtility } from '../util/StateUtility'
+import { SubmissionPipeline } from '../util/SubmissionPipeline'
+import { Application } from './Application'
+import {
+  HOOK_ACCOUNT_WALLET,
+  HOOK_STATE_LAYOUT_VERSION_CURRENT,
+} from './constants'
+
+// Campaigns migrated at the same time, each lane starting on its own Ticket
+const MIGRATION_LANES = 8
+
+/**
+ * Replays the invoke hook's migrate mode for every campaign whose General Info
+ * is below HOOK_STATE_LAYOUT_VERSION_CURRENT until all of them are upgraded.
+ * The hook only accepts migration steps sent by the Hook Account itself.
+ */
+async function run() {
+  await connectClient()
+
+  // 1. Find campaigns that still need to be migrated
+  const hookState = await StateUtility.getHookState(client)
+  // Only General Info values are decoded; Fund Transactions pages are skipped by key
+  const campaignsToMigrate = hookState.generalInfoEntries.filter(
+    ({ value }) => value.layoutVersion < HOOK_STATE_LAYOUT_VERSION_CURRENT
+  )
+  console.log(
+    `\n1. Found ${campaignsToMigrate.length} campaign(s) to migrate to layout version ${HOOK_STATE_LAYOUT_VERSION_CURRENT}`
+  )
+  if (campaignsToMigrate.length === 0) {
+    await disconnectClient()
+    return
+  }
+
+  // 2. Migration Invoke transactions are sent by the Hook Account
+  const wallet = HOOK_ACCOUNT_WALLET
+  console.log(`\n2. Submitting migration transactions from the Hook Account:`)
+  console.log(`\t- address: ${wallet.address}`)
+
+  // 3. Replay migration steps for each campaign until it reaches the current layout version.
+  // Campaigns are independent, so they're migrated in lanes; Tickets keep a failed step in one
+  // lane from holding up the Sequences of the others
+  const laneCount = Math.min(MIGRATION_LANES, campaignsToMigrate.length)
+  if (laneCount > 1) {
+    await SubmissionPipeline.for(client).createTickets(wallet, laneCount)
+  }
+  console.log(`\n3. Migrating campaigns in ${laneCount} lane(s)...`)
+  const queue = [...campaignsToMigrate]
+  const migrateLane = async () => {
+    for (let next = queue.shift(); next; next = queue.shift()) {
+      const campaignId = next.key.destinationTag
+      let layoutVersion = next.value.layoutVersion
+      let steps = 0
+      while (layoutVersion < HOOK_STATE_LAYOUT_VERSION_CURRENT) {
+        const result = await Application.migrateCampaignHookState(client, {
+          wallet,
+          campaignId,
+        })
+        layoutVersion = result.layoutVersion
+        steps++
+        console.log(
+          `\t- campaign ${campaignId}: step ${steps} -> layoutVersion ${result.layoutVersion}, migrationCursor ${result.migrationCursor}`
+        )
+      }
+    }
+  }
+  await Promise.all(Array.from({ length: laneCount }, migrateLane))
+
+  console.log(`\n4. Migration completed!`)
+
+  await disconnectClient()
+}
+
+run()
@@ -0,0 +1,98 @@
+import { ApplicationState } from './ApplicationState'
+import { FundTransaction } from './FundTransaction'
+import { createCampaign } from './testFixtures'
+
+const BACKER_1 = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+const BACKER_2 = 'rPT1Sjq2YGrBMTttX4GZHjKu9dyfzbpAYe'
+
+describe('ApplicationState', () => {
+  it('should index campaigns, backers and fund transactions', () => {
+    const applicationState = new ApplicationState()
+    applicationState.setCampaign(createCampaign(1))
+    applicationState.setFundTransaction(
+      1,
+      new FundTransaction(0, BACKER_1, 'approve', BigInt(100))
+    )
+    applicationState.setFundTransaction(
+      1,
+      new FundTransaction(1, BACKER_2, 'approve', BigInt(200))
+    )
+    applicationState.setFundTransaction(
+      1,
+      new FundTransaction(2, BACKER_1, 'reject', BigInt(300))
+    )
+
+    expect(applicationState.hasCampaign(1)).toBe(true)
+    expect(applicationState.hasCampaign(2)).toBe(false)
+    expect(applicationState.getFundTransaction(1, 1)?.account).toBe(BACKER_2)
+    expect(
+      applicationState
+        .getBacker(1, BACKER_1)
+        ?.fundTransactions.map((fundTransaction) => fundTransaction.id)
+    ).toEqual([0, 2])
+
+    const campaign = applicationState.getCampaignById(1)
+    expect(campaign?.fundTransactions.map(({ id }) => id)).toEqual([0, 1, 2])
+    expect(campaign?.backers.map(({ account }) => account)).toEqual([
+      BACKER_1,
+      BACKER_2,
+    ])
+  })
+
+  it('should place fund transactions by id when added before their campaign', () => {
+    const applicationState = new ApplicationState()
+    // e.g. second Fund Transactions page decoded before the first one and the General Info
+    applicationState.setFundTransaction(
+      1,
+      new FundTransaction(5, BACKER_2, 'approve', BigInt(100))
+    )
+    for (let id = 0; id < 5; id++) {
+      applicationState.setFundTransaction(
+        1,
+        new FundTransaction(id, BACKER_1, 'approve', BigInt(100))
+      )
+    }
+    expect(applicationState.campaigns).toEqual([])
+
+    applicationState.setCampaign(createCampaign(1))
+
+    expect(
+      applicationState.getCampaignById(1)?.fundTransactions.map(({ id }) => id)
+    ).toEqual([0, 1, 2, 3, 4, 5])
+    expect(applicationState.campaigns.map(({ id }) => id)).toEqual([1])
+  })
+
+  it('should update existing fund transactions in place', () => {
+    const applicationState = new ApplicationState([createCampaign(1)])
+    applicationState.setFundTransaction(
+      1,
+      new FundTransaction(0, BACKER_1, 'approve', BigInt(100))
+    )
+    applicationState.setFundTransaction(
+      1,
+      new FundTransaction(0, BACKER_1, 'refunded', BigInt(100))
+    )
+
+    expect(applicationState.getCampaignById(1)?.fundTransactions).toHaveLength(
+      1
+    )
+    expect(
+      applicationState.getBacker(1, BACKER_1)?.fundTransactions[0].state
+    ).toBe('refunded')
+  })
+
+  it('should keep fund transactions and backers when a campaign is replaced', () => {
+    const applicationState = new ApplicationState([createCampaign(1)])
+    applicationState.setFundTransaction(
+      1,
+      new FundTransaction(0, BACKER_1, 'approve', BigInt(100))
+    )
+
+    applicationState.setCampaign(createCampaign(1))
+
+    expect(applicationState.getCampaignById(1)?.fundTransactions).toHaveLength(
+      1
+    )
+    expect(applicationState.getCampaignById(1)?.backers).toHaveLength(1)
+  })
+})
@@ -1,9 +1,120 @@
+import { Backer } from './Backer'
 import { Campaign } from './Campaign'
+import { FundTransaction } from './FundTransaction'
 
+interface CampaignIndex {
+  campaign?: Campaign
+  fundTransactions: FundTransaction[] // positioned by fund transaction id
+  fundTransactionsById: Map<number, FundTransaction>
+  backers: Backer[] // in order of first fund transaction seen
+  backersByAccount: Map<string, Backer>
+}
+
+/*
+Indexed container of the application state.
+
+Campaigns are keyed by id (destinationTag); fund transactions and backers are keyed per campaign by
+fund transaction id and backer account. Campaigns and fund transactions can be added in any order
+(e.g. a Fund Transactions page decoded before its campaign's General Info), and each one is placed
+in constant time so decoding is linear in the number of Hook State entries.
+*/
 export class ApplicationState {
-  campaigns: Campaign[]
+  private readonly campaignIndexes: Map<number, CampaignIndex> = new Map()
+  // Validated ledger the state was read at, if known
+  ledgerIndex?: number
+
+  constructor(campaigns: Campaign[] = []) {
+    for (const campaign of campaigns) {
+      const { fundTransactions } = campaign
+      this.setCampaign(campaign)
+      for (const fundTransaction of fundTransactions) {
+        this.setFundTransaction(campaign.id, fundTransaction)
+      }
+    }
+  }
+
+  get campaigns(): Campaign[] {
+    const campaigns: Campaign[] = []
+    for (const { campaign } of this.campaignIndexes.values()) {
+      if (campaign) {
+        campaigns.push(campaign)
+      }
+    }
+    return campaigns
+  }
+
+  hasCampaign(campaignId: number): boolean {
+    return this.campaignIndexes.get(campaignId)?.campaign !== undefined
+  }
+
+  getCampaignById(campaignId: number): Campaign | undefined {
+    return this.campaignIndexes.get(campaignId)?.campaign
+  }
+
+  getBacker(campaignId: number, account: string): Backer | undefined {
+    return this.campaignIndexes.get(campaignId)?.backersByAccount.get(account)
+  }
+
+  getFundTransaction(
+    campaignId: number,
+    fundTransactionId: number
+  ): FundTransaction | undefined {
+    return this.campaignIndexes
+      .get(campaignId)
+      ?.fundTransactionsById.get(fundTransactionId)
+  }
+
+  /**
+   * Adds or replaces a campaign. The campaign's fundTransactions and backers are
+   * replaced by the ones indexed for its id, so they're kept when its General Info changes.
+   */
+  setCampaign(campaign: Campaign): void {
+    const campaignIndex = this._getOrCreateCampaignIndex(campaign.id)
+    campaign.fundTransactions = campaignIndex.fundTransactions
+    campaign.backers = campaignIndex.backers
+    campaignIndex.campaign = campaign
+  }
+
+  /**
+   * Adds a fund transaction, or updates the existing one with the same id in place
+   * so every reference to it (campaign, backer) sees the update.
+   */
+  setFundTransaction(
+    campaignId: number,
+    fundTransaction: FundTransaction
+  ): void {
+    const campaignIndex = this._getOrCreateCampaignIndex(campaignId)
+
+    const existing = campaignIndex.fundTransactionsById.get(fundTransaction.id)
+    if (existing) {
+      existing.state = fundTransaction.state
+      existing.amountInDrops = fundTransaction.amountInDrops
+      return
+    }
+
+    campaignIndex.fundTransactions[fundTransaction.id] = fundTransaction
+    campaignIndex.fundTransactionsById.set(fundTransaction.id, fundTransaction)
+
+    let backer = campaignIndex.backersByAccount.get(fundTransaction.account)
+    if (!backer) {
+      backer = new Backer(fundTransaction.account, [])
+      campaignIndex.backersByAccount.set(fundTransaction.account, backer)
+      campaignIndex.backers.push(backer)
+    }
+    backer.fundTransactions.push(fundTransaction)
+  }
 
-  constructor(campaigns: Campaign[]) {
-    this.campaigns = campaigns
+  private _getOrCreateCampaignIndex(campaignId: number): CampaignIndex {
+    let campaignIndex = this.campaignIndexes.get(campaignId)
+    if (!campaignIndex) {
+      campaignIndex = {
+        fundTransactions: [],
+        fundTransactionsById: new Map(),
+        backers: [],
+        backersByAccount: new Map(),
+      }
+      this.campaignIndexes.set(campaignId, campaignIndex)
+    }
+    return campaignIndex
   }
 }
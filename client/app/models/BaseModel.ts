@@ -1,5 +1,4 @@
-import { encodeModel } from '../../util/encode'
-import { decodeModel } from '../../util/decode'
+import { decodeModelFromHex, encodeModelToHex } from '../../util/codec'
 
 export type ModelClass<T extends BaseModel> = new (...args: any[]) => T
 
@@ -25,14 +24,14 @@ export abstract class BaseModel {
   abstract getMetadata(): Metadata
 
   encode(): string {
-    return encodeModel(this)
+    return encodeModelToHex(this)
   }
 
   static decode<T extends BaseModel>(
     hex: string,
     modelClass: ModelClass<T>
   ): T {
-    return decodeModel(hex, modelClass)
+    return decodeModelFromHex(hex, modelClass)
   }
 
   /**
@@ -0,0 +1,23 @@
+import { UInt32, UInt8 } from '../../util/types'
+import { BaseModel, Metadata } from './BaseModel'
+
+export class HSVGeneralInfoLayoutTrailer extends BaseModel {
+  magic: UInt32
+  layoutVersion: UInt8
+  migrationCursor: UInt32
+
+  constructor(magic: UInt32, layoutVersion: UInt8, migrationCursor: UInt32) {
+    super()
+    this.magic = magic
+    this.layoutVersion = layoutVersion
+    this.migrationCursor = migrationCursor
+  }
+
+  getMetadata(): Metadata {
+    return [
+      { field: 'magic', type: 'uint32' },
+      { field: 'layoutVersion', type: 'uint8' },
+      { field: 'migrationCursor', type: 'uint32' },
+    ]
+  }
+}
@@ -0,0 +1,97 @@
+import {
+  DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+  DATA_LOOKUP_GENERAL_INFO_FLAG,
+} from '../constants'
+import { isNativeDecoderAvailable } from '../../util/nativeDecoder'
+import { HookState } from './HookState'
+import { HookStateKey } from './HookStateKey'
+import {
+  createCampaignNamespaceEntries,
+  createFundTransactionsPage,
+  createGeneralInfo,
+  createNamespaceEntry,
+} from './testFixtures'
+
+// Only run when the addon is built (npm run build:native)
+const itWithNativeAddon = isNativeDecoderAvailable() ? it : it.skip
+
+const generalInfo = createGeneralInfo()
+
+const fundTransactionsPage = createFundTransactionsPage()
+
+describe('HookState', () => {
+  it('classifies entries by key without decoding values', () => {
+    const hookState = new HookState([
+      // Not a valid Fund Transactions page; it would throw if it were decoded
+      createNamespaceEntry(
+        new HookStateKey(
+          DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+          8
+        ),
+        'FF'
+      ),
+      createNamespaceEntry(
+        new HookStateKey(
+          DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG + 1n,
+          7
+        ),
+        fundTransactionsPage.encode()
+      ),
+      createNamespaceEntry(
+        new HookStateKey(DATA_LOOKUP_GENERAL_INFO_FLAG, 7),
+        generalInfo.encode()
+      ),
+      createNamespaceEntry(
+        new HookStateKey(
+          DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+          7
+        ),
+        fundTransactionsPage.encode()
+      ),
+    ])
+
+    const { generalInfoEntries } = hookState
+    expect(generalInfoEntries).toHaveLength(1)
+    expect(generalInfoEntries[0].destinationTag).toBe(7)
+    expect(generalInfoEntries[0].value.decoded).toEqual(generalInfo)
+
+    const pages = hookState.getFundTransactionsPageEntries(7)
+    expect(pages.map((entry) => entry.dataLookupFlag)).toEqual([
+      DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+      DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG + 1n,
+    ])
+    expect(pages.map((entry) => entry.value.decoded)).toEqual([
+      fundTransactionsPage,
+      fundTransactionsPage,
+    ])
+    expect(hookState.entries[0].isValueDecoded).toBe(false)
+    expect(() =>
+      hookState.getFundTransactionsPageEntries(8).map(({ value }) => value)
+    ).toThrow()
+    expect(hookState.getFundTransactionsPageEntries(9)).toEqual([])
+  })
+
+  itWithNativeAddon('decodes the entries it returns in one native call', () => {
+    const hookState = new HookState(createCampaignNamespaceEntries(7))
+
+    const [generalInfoEntry] = hookState.generalInfoEntries
+    expect(generalInfoEntry.isValueDecoded).toBe(true)
+    expect(generalInfoEntry.value.decoded).toEqual(generalInfo)
+    expect(hookState.entries[1].isValueDecoded).toBe(false)
+  })
+
+  it('reads the same key fields as a decoded key', () => {
+    const key = new HookStateKey(
+      DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG + 41n,
+      4294967295
+    )
+    const [entry] = new HookState([
+      createNamespaceEntry(key, fundTransactionsPage.encode()),
+    ]).entries
+
+    expect(entry.dataLookupFlag).toBe(key.dataLookupFlag)
+    expect(entry.destinationTag).toBe(key.destinationTag)
+    expect(entry.kind).toBe('fundTransactionsPage')
+    expect(entry.key).toEqual(key)
+  })
+})
@@ -1,3 +1,7 @@
+import {
+  decodeHookStateEntries,
+  isNativeDecoderAvailable,
+} from '../../util/nativeDecoder'
 import { BaseModel } from './BaseModel'
 import { HookStateEntry } from './HookStateEntry'
 
@@ -10,10 +14,69 @@ export type AccountNamespaceHookStateEntry = {
   index: string
 }
 
+/*
+Hook State entries of the crowdfund namespace. Entries are classified by their encoded key and only
+decoded when read, so reading only General Info entries never decodes a Fund Transactions page.
+generalInfoEntries and getFundTransactionsPageEntries decode the entries they return in one
+native call when the addon is built (see util/nativeDecoder); otherwise each entry decodes itself
+with the TS codec on first access (see HookStateEntry).
+*/
 export class HookState<T extends BaseModel> {
   entries: HookStateEntry<T>[]
+  // Validated ledger the entries were read at, if known
+  ledgerIndex?: number
+  private readonly namespaceEntries: AccountNamespaceHookStateEntry[]
 
-  constructor(entries: AccountNamespaceHookStateEntry[]) {
-    this.entries = entries.map((entry) => new HookStateEntry(entry))
+  constructor(entries: AccountNamespaceHookStateEntry[], ledgerIndex?: number) {
+    this.namespaceEntries = entries
+    this.entries = entries.map((entry) => new HookStateEntry<T>(entry))
+    this.ledgerIndex = ledgerIndex
+  }
+
+  get generalInfoEntries(): HookStateEntry<T>[] {
+    return this._decode(
+      this._indexesOf((entry) => entry.kind === 'generalInfo')
+    )
+  }
+
+  /**
+   * @returns the campaign's Fund Transactions page entries in page order
+   */
+  getFundTransactionsPageEntries(campaignId: number): HookStateEntry<T>[] {
+    return this._decode(
+      this._indexesOf(
+        (entry) =>
+          entry.kind === 'fundTransactionsPage' &&
+          entry.destinationTag === campaignId
+      )
+    ).sort((a, b) => (a.dataLookupFlag < b.dataLookupFlag ? -1 : 1))
+  }
+
+  private _indexesOf(
+    predicate: (entry: HookStateEntry<T>) => boolean
+  ): number[] {
+    const indexes: number[] = []
+    this.entries.forEach((entry, index) => {
+      if (predicate(entry)) {
+        indexes.push(index)
+      }
+    })
+    return indexes
+  }
+
+  // Entries at indexes, the ones not decoded yet decoded natively in one batch if possible
+  private _decode(indexes: number[]): HookStateEntry<T>[] {
+    const undecodedIndexes = indexes.filter(
+      (index) => !this.entries[index].isValueDecoded
+    )
+    if (undecodedIndexes.length > 0 && isNativeDecoderAvailable()) {
+      const decoded = decodeHookStateEntries<T>(
+        undecodedIndexes.map((index) => this.namespaceEntries[index])
+      )
+      undecodedIndexes.forEach((index, i) => {
+        this.entries[index] = decoded[i]
+      })
+    }
+    return indexes.map((index) => this.entries[index])
   }
 }
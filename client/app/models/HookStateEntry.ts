@@ -1,17 +1,76 @@
+import { UInt224, UInt32 } from '../../util/types'
 import { BaseModel } from './BaseModel'
 import { AccountNamespaceHookStateEntry } from './HookState'
-import { HookStateKey } from './HookStateKey'
+import { HookStateKey, HookStateKeyKind } from './HookStateKey'
 import { HookStateValue } from './HookStateValue'
 
+/*
+A Hook State entry that keeps its encoded key and value and decodes each on first access.
+dataLookupFlag, destinationTag and kind are read straight from the encoded key, so entries can be
+classified (e.g. General Info vs Fund Transactions page) without decoding their values.
+*/
 export class HookStateEntry<T extends BaseModel> {
-  key: HookStateKey
-  value: HookStateValue<T>
+  private keyEncoded?: string
+  private valueEncoded?: string
+  private decodedKey?: HookStateKey
+  private decodedValue?: HookStateValue<T>
 
   constructor({
     HookStateKey: hookStateKey,
     HookStateData: hookStateValue,
   }: AccountNamespaceHookStateEntry) {
-    this.key = HookStateKey.from(hookStateKey)
-    this.value = HookStateValue.from(hookStateValue, this.key.dataLookupFlag)
+    this.keyEncoded = hookStateKey
+    this.valueEncoded = hookStateValue
+  }
+
+  // For entries decoded elsewhere (see util/nativeDecoder)
+  static fromDecoded<T extends BaseModel>(
+    key: HookStateKey,
+    value: HookStateValue<T>
+  ): HookStateEntry<T> {
+    const entry: HookStateEntry<T> = Object.create(HookStateEntry.prototype)
+    entry.decodedKey = key
+    entry.decodedValue = value
+    return entry
+  }
+
+  get key(): HookStateKey {
+    if (!this.decodedKey) {
+      this.decodedKey = HookStateKey.from(this.keyEncoded as string)
+      this.keyEncoded = undefined
+    }
+    return this.decodedKey
+  }
+
+  get value(): HookStateValue<T> {
+    if (!this.decodedValue) {
+      this.decodedValue = HookStateValue.from<T>(
+        this.valueEncoded as string,
+        this.dataLookupFlag
+      )
+      this.valueEncoded = undefined
+    }
+    return this.decodedValue
+  }
+
+  get dataLookupFlag(): UInt224 {
+    return this.decodedKey
+      ? this.decodedKey.dataLookupFlag
+      : HookStateKey.dataLookupFlagOf(this.keyEncoded as string)
+  }
+
+  get destinationTag(): UInt32 {
+    return this.decodedKey
+      ? this.decodedKey.destinationTag
+      : HookStateKey.destinationTagOf(this.keyEncoded as string)
+  }
+
+  get kind(): HookStateKeyKind {
+    return HookStateKey.kindOf(this.dataLookupFlag)
+  }
+
+  // Whether the value has been decoded yet
+  get isValueDecoded(): boolean {
+    return this.decodedValue !== undefined
   }
 }
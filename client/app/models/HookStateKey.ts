@@ -1,6 +1,17 @@
 import { UInt224, UInt32 } from '../../util/types'
+import {
+  DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG,
+  DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+  DATA_LOOKUP_GENERAL_INFO_FLAG,
+} from '../constants'
 import { BaseModel, Metadata } from './BaseModel'
 
+export type HookStateKeyKind = 'generalInfo' | 'fundTransactionsPage'
+
+// dataLookupFlag (uint224) is the first 28 bytes of a key, destinationTag (uint32) the last 4
+const DATA_LOOKUP_FLAG_HEX_LENGTH = 56
+const DESTINATION_TAG_HEX_LENGTH = 8
+
 export class HookStateKey extends BaseModel {
   dataLookupFlag: UInt224
   destinationTag: UInt32
@@ -27,4 +38,33 @@ export class HookStateKey extends BaseModel {
   static from(keyEncoded: string): HookStateKey {
     return BaseModel.decode(keyEncoded, HookStateKey)
   }
+
+  // Reads the dataLookupFlag of an encoded key without decoding the whole key
+  static dataLookupFlagOf(keyEncoded: string): UInt224 {
+    return BigInt(`0x${keyEncoded.slice(0, DATA_LOOKUP_FLAG_HEX_LENGTH)}`)
+  }
+
+  // Reads the destinationTag of an encoded key without decoding the whole key
+  static destinationTagOf(keyEncoded: string): UInt32 {
+    return parseInt(
+      keyEncoded.slice(
+        DATA_LOOKUP_FLAG_HEX_LENGTH,
+        DATA_LOOKUP_FLAG_HEX_LENGTH + DESTINATION_TAG_HEX_LENGTH
+      ),
+      16
+    )
+  }
+
+  static kindOf(dataLookupFlag: UInt224): HookStateKeyKind {
+    if (dataLookupFlag === DATA_LOOKUP_GENERAL_INFO_FLAG) {
+      return 'generalInfo'
+    } else if (
+      dataLookupFlag >= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG &&
+      dataLookupFlag <= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG
+    ) {
+      return 'fundTransactionsPage'
+    } else {
+      throw new Error(`Invalid dataLookupFlag: ${dataLookupFlag}`)
+    }
+  }
 }
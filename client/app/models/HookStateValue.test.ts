@@ -0,0 +1,78 @@
+import {
+  DATA_LOOKUP_GENERAL_INFO_FLAG,
+  GENERAL_INFO_LAYOUT_MAGIC,
+  GENERAL_INFO_MAX_BYTES,
+  HOOK_STATE_LAYOUT_VERSION_CURRENT,
+  HOOK_STATE_LAYOUT_VERSION_LEGACY,
+} from '../constants'
+import { HookStateValue } from './HookStateValue'
+import { HSVCampaignGeneralInfo } from './HSVCampaignGeneralInfo'
+import { HSVGeneralInfoLayoutTrailer } from './HSVGeneralInfoLayoutTrailer'
+import { HSVMilestone } from './HSVMilestone'
+
+describe('HookStateValue', () => {
+  let generalInfoHex: string
+
+  beforeAll(() => {
+    const generalInfo = new HSVCampaignGeneralInfo(
+      0,
+      'rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh',
+      BigInt(25000000000),
+      BigInt(1700000000),
+      BigInt(0),
+      BigInt(0),
+      BigInt(100000100),
+      0,
+      0,
+      [new HSVMilestone(0, BigInt(1710000000), 100)]
+    )
+    // General Info entries are always written padded to GENERAL_INFO_MAX_BYTES
+    generalInfoHex = generalInfo
+      .encode()
+      .padEnd(GENERAL_INFO_MAX_BYTES * 2, '0')
+  })
+
+  it('decodes a legacy General Info entry as layout version 0', () => {
+    const value = HookStateValue.from<HSVCampaignGeneralInfo>(
+      generalInfoHex,
+      DATA_LOOKUP_GENERAL_INFO_FLAG
+    )
+    expect(value.layoutVersion).toBe(HOOK_STATE_LAYOUT_VERSION_LEGACY)
+    expect(value.migrationCursor).toBe(0)
+    expect(value.decoded.totalReserveAmountInDrops).toBe(BigInt(100000100))
+  })
+
+  it('ignores trailing bytes without the layout magic', () => {
+    const value = HookStateValue.from<HSVCampaignGeneralInfo>(
+      generalInfoHex + 'AB'.repeat(256 - GENERAL_INFO_MAX_BYTES),
+      DATA_LOOKUP_GENERAL_INFO_FLAG
+    )
+    expect(value.layoutVersion).toBe(HOOK_STATE_LAYOUT_VERSION_LEGACY)
+  })
+
+  it('decodes the layout trailer of a migrating and a migrated entry', () => {
+    const migrating = new HSVGeneralInfoLayoutTrailer(
+      GENERAL_INFO_LAYOUT_MAGIC,
+      HOOK_STATE_LAYOUT_VERSION_LEGACY,
+      8
+    )
+    const migratingValue = HookStateValue.from<HSVCampaignGeneralInfo>(
+      generalInfoHex + migrating.encode(),
+      DATA_LOOKUP_GENERAL_INFO_FLAG
+    )
+    expect(migratingValue.layoutVersion).toBe(HOOK_STATE_LAYOUT_VERSION_LEGACY)
+    expect(migratingValue.migrationCursor).toBe(8)
+
+    const migrated = new HSVGeneralInfoLayoutTrailer(
+      GENERAL_INFO_LAYOUT_MAGIC,
+      HOOK_STATE_LAYOUT_VERSION_CURRENT,
+      0
+    )
+    const migratedValue = HookStateValue.from<HSVCampaignGeneralInfo>(
+      generalInfoHex + migrated.encode(),
+      DATA_LOOKUP_GENERAL_INFO_FLAG
+    )
+    expect(migratedValue.layoutVersion).toBe(HOOK_STATE_LAYOUT_VERSION_CURRENT)
+    expect(migratedValue.decoded.milestones[0].payoutPercent).toBe(100)
+  })
+})
@@ -1,20 +1,33 @@
-import { UInt224 } from '../../util/types'
+import { UInt224, UInt32, UInt8 } from '../../util/types'
 import {
   DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG,
   DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
   DATA_LOOKUP_GENERAL_INFO_FLAG,
+  GENERAL_INFO_LAYOUT_MAGIC,
+  GENERAL_INFO_MAX_BYTES,
+  HOOK_STATE_LAYOUT_VERSION_LEGACY,
 } from '../constants'
 import { BaseModel } from './BaseModel'
 import { HSVCampaignGeneralInfo } from './HSVCampaignGeneralInfo'
 import { HSVFundTransactionsPage } from './HSVFundTransactionsPage'
+import { HSVGeneralInfoLayoutTrailer } from './HSVGeneralInfoLayoutTrailer'
 
 export class HookStateValue<T extends BaseModel> {
   dataLookupFlag: UInt224
   decoded: T
+  layoutVersion: UInt8
+  migrationCursor: UInt32
 
-  constructor(dataLookupFlag: UInt224, decoded: T) {
+  constructor(
+    dataLookupFlag: UInt224,
+    decoded: T,
+    layoutVersion: UInt8 = HOOK_STATE_LAYOUT_VERSION_LEGACY,
+    migrationCursor: UInt32 = 0
+  ) {
     this.dataLookupFlag = dataLookupFlag
     this.decoded = decoded
+    this.layoutVersion = layoutVersion
+    this.migrationCursor = migrationCursor
   }
 
   static from<T extends BaseModel>(
@@ -22,15 +35,19 @@ export class HookStateValue<T extends BaseModel> {
     dataLookupFlag: UInt224
   ): HookStateValue<T> {
     if (dataLookupFlag === DATA_LOOKUP_GENERAL_INFO_FLAG) {
+      const trailer = HookStateValue.decodeGeneralInfoLayoutTrailer(valueEncoded)
       // @ts-expect-error - TS doesn't know that HSVCampaignGeneralInfo extends BaseModel
       return new HookStateValue(
         dataLookupFlag,
-        BaseModel.decode(valueEncoded, HSVCampaignGeneralInfo)
+        BaseModel.decode(valueEncoded, HSVCampaignGeneralInfo),
+        trailer?.layoutVersion,
+        trailer?.migrationCursor
       )
     } else if (
       dataLookupFlag >= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG &&
       dataLookupFlag <= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG
     ) {
+      // Both layout versions share the same page encoding; version 1 only drops the unused trailing slots
       // @ts-expect-error - TS doesn't know that HSVFundTransactionsPage extends BaseModel
       return new HookStateValue(
         dataLookupFlag,
@@ -40,4 +57,31 @@ export class HookStateValue<T extends BaseModel> {
       throw new Error(`Invalid dataLookupFlag: ${dataLookupFlag}`)
     }
   }
+
+  /**
+   * Legacy (version 0) General Info entries have no layout trailer, and may
+   * contain arbitrary bytes past GENERAL_INFO_MAX_BYTES, so the trailer is
+   * only trusted when its magic matches.
+   *
+   * @param valueEncoded - General Info Hook State value in hex
+   * @returns the decoded trailer, or undefined for legacy entries
+   */
+  private static decodeGeneralInfoLayoutTrailer(
+    valueEncoded: string
+  ): HSVGeneralInfoLayoutTrailer | undefined {
+    const trailerHexIndex = GENERAL_INFO_MAX_BYTES * 2
+    const trailerHexLength = BaseModel.getHexLength(HSVGeneralInfoLayoutTrailer)
+    if (valueEncoded.length < trailerHexIndex + trailerHexLength) {
+      return undefined
+    }
+
+    const trailer = BaseModel.decode(
+      valueEncoded.slice(trailerHexIndex, trailerHexIndex + trailerHexLength),
+      HSVGeneralInfoLayoutTrailer
+    )
+    if (trailer.magic !== GENERAL_INFO_LAYOUT_MAGIC) {
+      return undefined
+    }
+    return trailer
+  }
 }
@@ -0,0 +1,16 @@
+import { UInt8 } from '../../util/types'
+import { MODE_MIGRATE_HOOK_STATE_FLAG } from '../constants'
+import { BaseModel, Metadata } from './BaseModel'
+
+export class MigrateHookStatePayload extends BaseModel {
+  modeFlag: UInt8
+
+  constructor() {
+    super()
+    this.modeFlag = MODE_MIGRATE_HOOK_STATE_FLAG
+  }
+
+  getMetadata(): Metadata {
+    return [{ field: 'modeFlag', type: 'uint8' }]
+  }
+}
@@ -0,0 +1,20 @@
+import { UInt32, UInt64 } from '../../util/types'
+import { BaseModel, Metadata } from './BaseModel'
+
+export class MultiFundCampaignEntryPayload extends BaseModel {
+  destinationTag: UInt32
+  fundAmountInDrops: UInt64
+
+  constructor(destinationTag: UInt32, fundAmountInDrops: UInt64) {
+    super()
+    this.destinationTag = destinationTag
+    this.fundAmountInDrops = fundAmountInDrops
+  }
+
+  getMetadata(): Metadata {
+    return [
+      { field: 'destinationTag', type: 'uint32' },
+      { field: 'fundAmountInDrops', type: 'uint64' },
+    ]
+  }
+}
@@ -0,0 +1,31 @@
+import { BaseModel } from './BaseModel'
+import { MultiFundCampaignEntryPayload } from './MultiFundCampaignEntryPayload'
+import { MultiFundCampaignPayload } from './MultiFundCampaignPayload'
+
+describe('MultiFundCampaignPayload', () => {
+  it('encodes and decodes a model', () => {
+    const payload = new MultiFundCampaignPayload([
+      new MultiFundCampaignEntryPayload(1, BigInt(25000000)),
+      new MultiFundCampaignEntryPayload(2 ** 32 - 1, BigInt(1000000)),
+    ])
+
+    const payloadEncoded = payload.encode()
+
+    const payloadDecoded = BaseModel.decode(
+      payloadEncoded,
+      MultiFundCampaignPayload
+    )
+
+    expect(payloadDecoded).toEqual(payload)
+  })
+
+  it('encodes entries as 4 byte destinationTag + 8 byte fundAmountInDrops', () => {
+    const payload = new MultiFundCampaignPayload([
+      new MultiFundCampaignEntryPayload(0x0a0b0c0d, BigInt(0x10)),
+    ])
+
+    expect(payload.encode().toUpperCase()).toEqual(
+      '0B' + '01' + '0A0B0C0D' + '0000000000000010'
+    )
+  })
+})
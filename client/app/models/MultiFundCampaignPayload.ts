@@ -0,0 +1,30 @@
+import { UInt8 } from '../../util/types'
+import {
+  MODE_MULTI_FUND_CAMPAIGN_FLAG,
+  MULTI_FUND_CAMPAIGNS_MAX_LENGTH,
+} from '../constants'
+import { BaseModel, Metadata } from './BaseModel'
+import { MultiFundCampaignEntryPayload } from './MultiFundCampaignEntryPayload'
+
+export class MultiFundCampaignPayload extends BaseModel {
+  modeFlag: UInt8
+  fundCampaigns: MultiFundCampaignEntryPayload[]
+
+  constructor(fundCampaigns: MultiFundCampaignEntryPayload[]) {
+    super()
+    this.modeFlag = MODE_MULTI_FUND_CAMPAIGN_FLAG
+    this.fundCampaigns = fundCampaigns
+  }
+
+  getMetadata(): Metadata {
+    return [
+      { field: 'modeFlag', type: 'uint8' },
+      {
+        field: 'fundCampaigns',
+        type: 'varModelArray',
+        modelClass: MultiFundCampaignEntryPayload,
+        maxArrayLength: MULTI_FUND_CAMPAIGNS_MAX_LENGTH,
+      },
+    ]
+  }
+}
@@ -0,0 +1,109 @@
+import {
+  DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+  DATA_LOOKUP_GENERAL_INFO_FLAG,
+} from '../constants'
+import { Campaign } from './Campaign'
+import { AccountNamespaceHookStateEntry } from './HookState'
+import { HookStateKey } from './HookStateKey'
+import { HSVCampaignGeneralInfo } from './HSVCampaignGeneralInfo'
+import { HSVFundTransaction } from './HSVFundTransaction'
+import { HSVFundTransactionsPage } from './HSVFundTransactionsPage'
+import { HSVMilestone } from './HSVMilestone'
+
+// Shared by the unit tests; not used by the application
+export const OWNER = 'rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh'
+export const BACKER = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+
+export type CampaignFields = Partial<Omit<Campaign, 'id' | 'serialize'>>
+
+/**
+ * A 'fundRaise' Campaign owned by OWNER with no milestones, fund transactions or backers.
+ * fields replaces any of the defaults.
+ */
+export function createCampaign(
+  id: number,
+  fields: CampaignFields = {}
+): Campaign {
+  const campaign = new Campaign(
+    id,
+    'fundRaise',
+    OWNER,
+    `title ${id}`,
+    'description',
+    'overviewUrl',
+    'imageUrl',
+    BigInt(25000000000),
+    BigInt(1700000000),
+    BigInt(0),
+    BigInt(0),
+    BigInt(0),
+    0,
+    [],
+    [],
+    []
+  )
+  return Object.assign(campaign, fields)
+}
+
+// An account_namespace entry as the ledger returns it
+export function createNamespaceEntry(
+  key: HookStateKey,
+  data: string
+): AccountNamespaceHookStateEntry {
+  return {
+    Flags: 0,
+    HookStateData: data,
+    HookStateKey: key.encode(),
+    LedgerEntryType: 'HookState',
+    OwnerNode: '0',
+    index: '',
+  }
+}
+
+// General Info of a campaign with two milestones and the two fund transactions below
+export function createGeneralInfo(): HSVCampaignGeneralInfo {
+  return new HSVCampaignGeneralInfo(
+    0,
+    OWNER,
+    BigInt(1000000000),
+    BigInt(1700000000),
+    BigInt(20000000),
+    BigInt(0),
+    BigInt(100000100),
+    2,
+    0,
+    [
+      new HSVMilestone(0, BigInt(1710000000), 40),
+      new HSVMilestone(0, BigInt(1720000000), 60),
+    ]
+  )
+}
+
+export function createFundTransactionsPage(): HSVFundTransactionsPage {
+  return new HSVFundTransactionsPage([
+    new HSVFundTransaction(0, BACKER, 0, BigInt(10000000)),
+    new HSVFundTransaction(1, OWNER, 1, BigInt(10000000)),
+  ])
+}
+
+/**
+ * The campaign's General Info entry followed by its first Fund Transactions page entry,
+ * see createGeneralInfo and createFundTransactionsPage.
+ */
+export function createCampaignNamespaceEntries(
+  campaignId: number
+): AccountNamespaceHookStateEntry[] {
+  return [
+    createNamespaceEntry(
+      new HookStateKey(DATA_LOOKUP_GENERAL_INFO_FLAG, campaignId),
+      createGeneralInfo().encode()
+    ),
+    createNamespaceEntry(
+      new HookStateKey(
+        DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+        campaignId
+      ),
+      createFundTransactionsPage().encode()
+    ),
+  ]
+}
@@ -3,11 +3,8 @@ import path from 'path'
 import { dropsToXrp, Payment, Wallet } from 'xrpl'
 
 import { client, connectClient, disconnectClient } from '../util/xrplClient'
-import {
-  accountReserveFee,
-  ownerReserveFee,
-  prepareTransactionV3,
-} from '../util/transaction'
+import { getReserves, prepareTransactionV3 } from '../util/transaction'
+import { submitAndWaitV3 } from '../util/SubmissionPipeline'
 
 import config from '../../config.json'
 import { fundWallet } from '../util/fundWallet'
@@ -30,8 +27,10 @@ async function run() {
   await sleep(2000)
 
   // 3. Get account reserve fee
-  const accReserveFee = await accountReserveFee()
-  const ownReserveFee = await ownerReserveFee()
+  const {
+    accountReserveFee: accReserveFee,
+    ownerReserveFee: ownReserveFee,
+  } = await getReserves()
   const starterSetHookFee = 1300000000 // 124520 // TODO: dynamically get this fee
   const totalAmount = (
     accReserveFee +
@@ -59,10 +58,7 @@ async function run() {
 
   console.log(`\n5. Submitting transaction...`)
 
-  const result = await client.submitAndWait(tx, {
-    autofill: true,
-    wallet: angelWallet,
-  })
+  const result = await submitAndWaitV3(client, tx, angelWallet)
 
   console.log(`\n6. Transaction result:`)
   console.log(result)
@@ -0,0 +1,88 @@
+import { HSVFundTransaction } from '../app/models/HSVFundTransaction'
+import { HSVFundTransactionsPage } from '../app/models/HSVFundTransactionsPage'
+import { decodeModelFromHex, encodeModelToHex } from '../util/codec'
+import { decodeModel } from '../util/decode'
+import { encodeModel } from '../util/encode'
+
+/*
+Compares the reflective codec (decodeModel/encodeModel) with the compiled codec (util/codec) on a
+namespace of 10k full Fund Transactions pages, the largest entries getApplicationState decodes.
+
+Usage: npm run benchmark:codec
+*/
+
+const PAGE_COUNT = 10000
+const ROUNDS = 5
+const ACCOUNTS = [
+  'rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh',
+  'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH',
+]
+
+function createPages(): HSVFundTransactionsPage[] {
+  const pages: HSVFundTransactionsPage[] = []
+  for (let i = 0; i < PAGE_COUNT; i++) {
+    const fundTransactions: HSVFundTransaction[] = []
+    for (let j = 0; j < 5; j++) {
+      fundTransactions.push(
+        new HSVFundTransaction(
+          i * 5 + j,
+          ACCOUNTS[j % ACCOUNTS.length],
+          j % 2,
+          BigInt(1000000 + i * j)
+        )
+      )
+    }
+    pages.push(new HSVFundTransactionsPage(fundTransactions))
+  }
+  return pages
+}
+
+// Best of ROUNDS, in milliseconds
+function measure(run: () => void): number {
+  let best = Infinity
+  for (let round = 0; round < ROUNDS; round++) {
+    const start = process.hrtime.bigint()
+    run()
+    const elapsed = Number(process.hrtime.bigint() - start) / 1e6
+    best = Math.min(best, elapsed)
+  }
+  return best
+}
+
+function report(name: string, reflective: number, compiled: number): void {
+  const speedup = (reflective / compiled).toFixed(1)
+  console.log(
+    `${name}: reflective ${reflective.toFixed(1)} ms, compiled ${compiled.toFixed(1)} ms (${speedup}x)`
+  )
+}
+
+function main(): void {
+  const pages = createPages()
+  const hexPages = pages.map((page) => encodeModel(page))
+
+  const decodeReflective = measure(() => {
+    for (const hex of hexPages) {
+      decodeModel(hex, HSVFundTransactionsPage)
+    }
+  })
+  const decodeCompiled = measure(() => {
+    for (const hex of hexPages) {
+      decodeModelFromHex(hex, HSVFundTransactionsPage)
+    }
+  })
+  report(`decode ${PAGE_COUNT} pages`, decodeReflective, decodeCompiled)
+
+  const encodeReflective = measure(() => {
+    for (const page of pages) {
+      encodeModel(page)
+    }
+  })
+  const encodeCompiled = measure(() => {
+    for (const page of pages) {
+      encodeModelToHex(page)
+    }
+  })
+  report(`encode ${PAGE_COUNT} pages`, encodeReflective, encodeCompiled)
+}
+
+main()
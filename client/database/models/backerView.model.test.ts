@@ -0,0 +1,38 @@
+import { BackerViewDatabaseModel } from './backerView.model'
+import connectDatabase from '..'
+import { Connection } from 'mongoose'
+
+describe('BackerView model', () => {
+  let database: Connection
+
+  // Establish a database connection before running the tests
+  beforeAll(async () => {
+    database = await connectDatabase()
+    await BackerViewDatabaseModel.init()
+  })
+
+  // Close the database connection after running the tests
+  afterAll(async () => {
+    await database.close()
+  })
+
+  it('should keep one record per campaign backer', async () => {
+    // generate a random campaign id to avoid colliding with indexed campaigns
+    const campaignId = Math.floor(Math.random() * 4294967295)
+    const backerViewData = {
+      campaignId,
+      account: 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH',
+      ledgerIndex: 10,
+      fundTransactionIds: [0, 2],
+    }
+
+    const backerView = await BackerViewDatabaseModel.create(backerViewData)
+    expect([...backerView.fundTransactionIds]).toEqual([0, 2])
+
+    await expect(
+      BackerViewDatabaseModel.create(backerViewData)
+    ).rejects.toMatchObject({ code: 11000 })
+
+    await BackerViewDatabaseModel.deleteOne({ _id: backerView._id })
+  })
+})
@@ -0,0 +1,36 @@
+import mongoose from 'mongoose'
+
+// An account that funded a campaign, derived from its fund transactions by CampaignViewIndexer
+export interface IBackerViewDatabaseModel {
+  campaignId: number
+  account: string
+  // Validated ledger the record was derived from
+  ledgerIndex: number
+  fundTransactionIds: number[]
+}
+
+const backerViewSchema = new mongoose.Schema<IBackerViewDatabaseModel>({
+  campaignId: {
+    type: Number,
+    required: true,
+  },
+  account: {
+    type: String,
+    required: true,
+  },
+  ledgerIndex: {
+    type: Number,
+    required: true,
+  },
+  fundTransactionIds: {
+    type: [Number],
+    required: true,
+  },
+})
+backerViewSchema.index({ campaignId: 1, account: 1 }, { unique: true })
+backerViewSchema.index({ account: 1, campaignId: 1 })
+
+export const BackerViewDatabaseModel = mongoose.model(
+  'BackerView',
+  backerViewSchema
+)
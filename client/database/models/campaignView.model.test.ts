@@ -0,0 +1,54 @@
+import { CampaignViewDatabaseModel } from './campaignView.model'
+import connectDatabase from '..'
+import { Connection } from 'mongoose'
+
+describe('CampaignView model', () => {
+  let database: Connection
+
+  // Establish a database connection before running the tests
+  beforeAll(async () => {
+    database = await connectDatabase()
+    await CampaignViewDatabaseModel.init()
+  })
+
+  // Close the database connection after running the tests
+  afterAll(async () => {
+    await database.close()
+  })
+
+  it('should keep one record per campaign', async () => {
+    // generate a random campaign id to avoid colliding with indexed campaigns
+    const campaignId = Math.floor(Math.random() * 4294967295)
+    const campaignViewData = {
+      campaignId,
+      ledgerIndex: 10,
+      stateFlag: 0,
+      owner: 'rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh',
+      fundRaiseGoalInDrops: '25000000000',
+      fundRaiseEndDateInUnixSeconds: 1700000000,
+      totalAmountRaisedInDrops: '0',
+      totalAmountNonRefundableInDrops: '0',
+      totalReserveAmountInDrops: '0',
+      totalRejectVotesForCurrentMilestone: 0,
+      totalFundTransactions: 0,
+      milestones: [
+        {
+          stateFlag: 0,
+          endDateInUnixSeconds: '1710000000',
+          payoutPercent: 100,
+        },
+      ],
+    }
+
+    const campaignView = await CampaignViewDatabaseModel.create(
+      campaignViewData
+    )
+    expect(campaignView.milestones.length).toBe(1)
+
+    await expect(
+      CampaignViewDatabaseModel.create(campaignViewData)
+    ).rejects.toMatchObject({ code: 11000 })
+
+    await CampaignViewDatabaseModel.deleteOne({ _id: campaignView._id })
+  })
+})
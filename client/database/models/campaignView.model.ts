@@ -0,0 +1,104 @@
+import mongoose from 'mongoose'
+
+// On-ledger campaign General Info as decoded by CampaignViewIndexer. Metadata (title, etc.)
+// stays in CampaignDatabaseModel. States are kept as their on-ledger state codes: the ones derived
+// from the current time change without a write, so CampaignViewReader derives them on read.
+export interface IMilestoneViewDatabaseModel {
+  stateFlag: number
+  endDateInUnixSeconds: string
+  payoutPercent: number
+}
+
+export interface ICampaignViewDatabaseModel {
+  campaignId: number
+  // Validated ledger the record was derived from
+  ledgerIndex: number
+  stateFlag: number
+  owner: string
+  fundRaiseGoalInDrops: string
+  // A number (not a string like other amounts) so it can be range-queried and sorted
+  fundRaiseEndDateInUnixSeconds: number
+  totalAmountRaisedInDrops: string
+  totalAmountNonRefundableInDrops: string
+  totalReserveAmountInDrops: string
+  totalRejectVotesForCurrentMilestone: number
+  // Fund transactions on ledger; fewer FundTransactionView records means the view has a gap
+  totalFundTransactions: number
+  milestones: IMilestoneViewDatabaseModel[]
+}
+
+const milestoneViewSchema = new mongoose.Schema<IMilestoneViewDatabaseModel>(
+  {
+    stateFlag: {
+      type: Number,
+      required: true,
+    },
+    endDateInUnixSeconds: {
+      type: String,
+      required: true,
+    },
+    payoutPercent: {
+      type: Number,
+      required: true,
+    },
+  },
+  { _id: false }
+)
+
+const campaignViewSchema = new mongoose.Schema<ICampaignViewDatabaseModel>({
+  campaignId: {
+    type: Number,
+    required: true,
+    unique: true,
+    index: true,
+  },
+  ledgerIndex: {
+    type: Number,
+    required: true,
+  },
+  stateFlag: {
+    type: Number,
+    required: true,
+  },
+  owner: {
+    type: String,
+    required: true,
+  },
+  fundRaiseGoalInDrops: {
+    type: String,
+    required: true,
+  },
+  fundRaiseEndDateInUnixSeconds: {
+    type: Number,
+    required: true,
+    index: true,
+  },
+  totalAmountRaisedInDrops: {
+    type: String,
+    required: true,
+  },
+  totalAmountNonRefundableInDrops: {
+    type: String,
+    required: true,
+  },
+  totalReserveAmountInDrops: {
+    type: String,
+    required: true,
+  },
+  totalRejectVotesForCurrentMilestone: {
+    type: Number,
+    required: true,
+  },
+  totalFundTransactions: {
+    type: Number,
+    required: true,
+  },
+  milestones: [milestoneViewSchema],
+})
+// Derived states are a stateFlag and an end date range (fundRaise: derive flag, end date to come)
+campaignViewSchema.index({ stateFlag: 1, fundRaiseEndDateInUnixSeconds: 1 })
+
+export const CampaignViewDatabaseModel = mongoose.model(
+  'CampaignView',
+  campaignViewSchema
+)
@@ -0,0 +1,36 @@
+import { DestinationTagReservationDatabaseModel } from './destinationTagReservation.model'
+import connectDatabase from '..'
+import { Connection } from 'mongoose'
+
+describe('DestinationTagReservation model', () => {
+  let database: Connection
+
+  // Establish a database connection before running the tests
+  beforeAll(async () => {
+    database = await connectDatabase()
+    await DestinationTagReservationDatabaseModel.init()
+  })
+
+  // Close the database connection after running the tests
+  afterAll(async () => {
+    await database.close()
+  })
+
+  it('should not reserve the same destination tag twice', async () => {
+    // generate a random destination tag to avoid colliding with existing reservations
+    const destinationTag = Math.floor(Math.random() * 4294967295)
+
+    const reservation = await DestinationTagReservationDatabaseModel.create({
+      destinationTag,
+    })
+    expect(reservation.reservedAt).toBeDefined()
+
+    await expect(
+      DestinationTagReservationDatabaseModel.create({ destinationTag })
+    ).rejects.toMatchObject({ code: 11000 })
+
+    await DestinationTagReservationDatabaseModel.deleteOne({
+      _id: reservation._id,
+    })
+  })
+})
@@ -0,0 +1,28 @@
+import mongoose from 'mongoose'
+
+// Destination tags handed out to campaigns. The unique index makes a reservation atomic,
+// so two concurrent createCampaign calls can never be given the same tag.
+export interface IDestinationTagReservationDatabaseModel {
+  destinationTag: number
+  reservedAt: Date
+}
+
+const destinationTagReservationSchema =
+  new mongoose.Schema<IDestinationTagReservationDatabaseModel>({
+    destinationTag: {
+      type: Number,
+      required: true,
+      unique: true,
+      index: true,
+    },
+    reservedAt: {
+      type: Date,
+      required: true,
+      default: Date.now,
+    },
+  })
+
+export const DestinationTagReservationDatabaseModel = mongoose.model(
+  'DestinationTagReservation',
+  destinationTagReservationSchema
+)
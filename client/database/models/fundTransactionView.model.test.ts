@@ -0,0 +1,46 @@
+import { FundTransactionViewDatabaseModel } from './fundTransactionView.model'
+import connectDatabase from '..'
+import { Connection } from 'mongoose'
+
+describe('FundTransactionView model', () => {
+  let database: Connection
+
+  // Establish a database connection before running the tests
+  beforeAll(async () => {
+    database = await connectDatabase()
+    await FundTransactionViewDatabaseModel.init()
+  })
+
+  // Close the database connection after running the tests
+  afterAll(async () => {
+    await database.close()
+  })
+
+  it('should keep one record per campaign fund transaction', async () => {
+    // generate a random campaign id to avoid colliding with indexed campaigns
+    const campaignId = Math.floor(Math.random() * 4294967295)
+    const fundTransactionViewData = {
+      campaignId,
+      fundTransactionId: 0,
+      ledgerIndex: 10,
+      account: 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH',
+      state: 'approve',
+      amountInDrops: '100',
+    }
+
+    const first = await FundTransactionViewDatabaseModel.create(
+      fundTransactionViewData
+    )
+    const second = await FundTransactionViewDatabaseModel.create({
+      ...fundTransactionViewData,
+      fundTransactionId: 1,
+    })
+    await expect(
+      FundTransactionViewDatabaseModel.create(fundTransactionViewData)
+    ).rejects.toMatchObject({ code: 11000 })
+
+    await FundTransactionViewDatabaseModel.deleteMany({
+      _id: { $in: [first._id, second._id] },
+    })
+  })
+})
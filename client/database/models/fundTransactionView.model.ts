@@ -0,0 +1,51 @@
+import mongoose from 'mongoose'
+
+// A fund transaction decoded from a campaign's Fund Transactions pages by CampaignViewIndexer
+export interface IFundTransactionViewDatabaseModel {
+  campaignId: number
+  fundTransactionId: number
+  // Validated ledger the record was derived from
+  ledgerIndex: number
+  account: string
+  state: string
+  amountInDrops: string
+}
+
+const fundTransactionViewSchema =
+  new mongoose.Schema<IFundTransactionViewDatabaseModel>({
+    campaignId: {
+      type: Number,
+      required: true,
+    },
+    fundTransactionId: {
+      type: Number,
+      required: true,
+    },
+    ledgerIndex: {
+      type: Number,
+      required: true,
+    },
+    account: {
+      type: String,
+      required: true,
+      index: true,
+    },
+    state: {
+      type: String,
+      required: true,
+    },
+    amountInDrops: {
+      type: String,
+      required: true,
+    },
+  })
+fundTransactionViewSchema.index(
+  { campaignId: 1, fundTransactionId: 1 },
+  { unique: true }
+)
+fundTransactionViewSchema.index({ campaignId: 1, state: 1 })
+
+export const FundTransactionViewDatabaseModel = mongoose.model(
+  'FundTransactionView',
+  fundTransactionViewSchema
+)
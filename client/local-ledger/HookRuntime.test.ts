@@ -0,0 +1,250 @@
+import fs from 'fs'
+import path from 'path'
+import { decodeAccountID } from 'ripple-address-codec'
+import { encode } from 'ripple-binary-codec'
+import {
+  assembleTestHook,
+  DROP,
+  i32Const,
+  i64Const,
+  localGet,
+  localSet,
+} from './assembleTestHook'
+import { HookExecutionContext, HookRuntime } from './HookRuntime'
+
+// Built by npm run build:hooks; its tests are skipped without it
+const CROWDFUND_WASM_PATH = path.resolve(
+  __dirname,
+  '../../build/crowdfund.wasm'
+)
+const describeWithBuiltHook = fs.existsSync(CROWDFUND_WASM_PATH)
+  ? describe
+  : describe.skip
+
+const HOOK_ACCOUNT = 'rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh'
+const BACKER = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+
+// Field ids (hook-src/sfcodes.h)
+const SF_AMOUNT = 0x60001
+const SF_MEMOS = 0xf0009
+const SF_MEMO = 0xe000a
+const SF_MEMO_DATA = 0x7000d
+
+const otxnBlob = Buffer.from(
+  encode({
+    TransactionType: 'Payment',
+    Account: BACKER,
+    Destination: HOOK_ACCOUNT,
+    Amount: '100',
+    Fee: '10',
+    Sequence: 1,
+    SigningPubKey: '',
+    Memos: [{ Memo: { MemoData: '0102' } }],
+  }),
+  'hex'
+)
+
+function createContext(
+  overrides: Partial<HookExecutionContext> = {}
+): HookExecutionContext {
+  return {
+    otxnBlob,
+    otxnId: Buffer.alloc(32, 1),
+    hookAccountId: Buffer.from(decodeAccountID(HOOK_ACCOUNT)),
+    ledgerSeq: 5,
+    ledgerLastTime: 1000,
+    ledgerLastHash: Buffer.alloc(32, 2),
+    baseFeeDrops: 10n,
+    readState: () => undefined,
+    ...overrides,
+  }
+}
+
+// Writes the Amount field under key 'k', then exits with [exit]('ok', code)
+function createStateHook(exit: 'accept' | 'rollback', code: number): Buffer {
+  return assembleTestHook(
+    ['otxn_field', 'state_set', exit],
+    (call) => [
+      ...[...i32Const(0), ...i32Const(8), ...i32Const(SF_AMOUNT)],
+      ...[...call('otxn_field'), ...DROP],
+      ...[...i32Const(0), ...i32Const(8), ...i32Const(100), ...i32Const(1)],
+      ...[...call('state_set'), ...DROP],
+      ...[...i32Const(200), ...i32Const(2), ...i64Const(code)],
+      ...[...call(exit), ...DROP, ...i64Const(0)],
+    ],
+    { data: [[100, Buffer.from('k')], [200, Buffer.from('ok')]] }
+  )
+}
+
+describe('HookRuntime', () => {
+  it('should buffer Hook State writes and accept with the return string', () => {
+    const runtime = new HookRuntime(createStateHook('accept', 0))
+    const result = runtime.execute(createContext())
+
+    expect(result.exitType).toBe('accept')
+    expect(result.returnString.toString()).toBe('ok')
+    // Keys are padded to 32 bytes; XRP amounts keep their positive bit
+    expect([...result.stateChanges]).toEqual([
+      ['6B'.padStart(64, '0'), Buffer.from('4000000000000064', 'hex')],
+    ])
+  })
+
+  it('should drop Hook State writes on rollback', () => {
+    const runtime = new HookRuntime(createStateHook('rollback', 7))
+    const result = runtime.execute(createContext())
+
+    expect(result.exitType).toBe('rollback')
+    expect(result.returnCode).toBe(7n)
+    expect(result.stateChanges.size).toBe(0)
+  })
+
+  it('should roll back when a guard is hit more often than its maxiter', () => {
+    const guard = [...i32Const(1), ...i32Const(1)]
+    const runtime = new HookRuntime(
+      assembleTestHook(['_g'], (call) => [
+        ...[...guard, ...call('_g'), ...DROP],
+        ...[...guard, ...call('_g'), ...DROP],
+        ...i64Const(0),
+      ])
+    )
+    const result = runtime.execute(createContext())
+
+    expect(result.exitType).toBe('rollback')
+    // GUARD_VIOLATION
+    expect(result.returnCode).toBe(-16n)
+  })
+
+  it('should read nested fields with sto_subarray and sto_subfield', () => {
+    // Locals 1-4 hold the packed offset and length of each step
+    const offset = (local: number) => [
+      ...localGet(local),
+      ...i64Const(32),
+      0x88, // i64.shr_u
+      0xa7, // i32.wrap_i64
+    ]
+    const length = (local: number) => [...localGet(local), 0xa7]
+    const runtime = new HookRuntime(
+      assembleTestHook(
+        ['otxn_field', 'sto_subarray', 'sto_subfield', 'state_set', 'accept'],
+        (call) => [
+          ...[...i32Const(512), ...i32Const(512), ...i32Const(SF_MEMOS)],
+          ...[...call('otxn_field'), ...localSet(1)],
+          ...[...i32Const(512), ...length(1), ...i32Const(0)],
+          ...[...call('sto_subarray'), ...localSet(2)],
+          ...[...i32Const(512), ...offset(2), 0x6a, ...length(2)],
+          ...[...i32Const(SF_MEMO), ...call('sto_subfield'), ...localSet(3)],
+          ...[...i32Const(512), ...offset(2), 0x6a, ...offset(3), 0x6a],
+          ...[...length(3), ...i32Const(SF_MEMO_DATA)],
+          ...[...call('sto_subfield'), ...localSet(4)],
+          ...[...i32Const(512), ...offset(2), 0x6a, ...offset(3), 0x6a],
+          ...[...offset(4), 0x6a, ...length(4), ...i32Const(100)],
+          ...[...i32Const(1), ...call('state_set'), ...DROP],
+          ...[...i32Const(0), ...i32Const(0), ...i64Const(0)],
+          ...[...call('accept'), ...DROP, ...i64Const(0)],
+        ],
+        { data: [[100, Buffer.from('k')]], locals: 4 }
+      )
+    )
+    const result = runtime.execute(createContext())
+
+    expect(result.exitType).toBe('accept')
+    expect(result.stateChanges.get('6B'.padStart(64, '0'))).toEqual(
+      Buffer.from('0102', 'hex')
+    )
+  })
+
+  it('should only emit transactions sent from the hook account', () => {
+    const createEmittedBlob = (account: string) =>
+      Buffer.from(
+        encode({
+          TransactionType: 'Payment',
+          Account: account,
+          Destination: BACKER,
+          Amount: '50',
+          Fee: '10',
+          Sequence: 0,
+          FirstLedgerSequence: 6,
+          LastLedgerSequence: 10,
+          SigningPubKey: '',
+          EmitDetails: {
+            EmitGeneration: 1,
+            EmitBurden: '1',
+            EmitParentTxnID: '01'.repeat(32),
+            EmitNonce: '02'.repeat(32),
+            EmitHookHash: '03'.repeat(32),
+          },
+        }),
+        'hex'
+      )
+    const emit = (blob: Buffer) =>
+      new HookRuntime(
+        assembleTestHook(
+          ['etxn_reserve', 'emit', 'accept'],
+          (call) => [
+            ...[...i32Const(1), ...call('etxn_reserve'), ...DROP],
+            ...[...i32Const(0), ...i32Const(0)],
+            ...[...i32Const(0), ...i32Const(32)],
+            ...[...i32Const(1024), ...i32Const(blob.length), ...call('emit')],
+            ...[...call('accept'), ...DROP, ...i64Const(0)],
+          ],
+          { data: [[1024, blob]] }
+        )
+      ).execute(createContext())
+
+    const emitted = emit(createEmittedBlob(HOOK_ACCOUNT))
+    expect(emitted.returnCode).toBe(32n)
+    expect(emitted.emitted).toHaveLength(1)
+
+    const rejected = emit(createEmittedBlob(BACKER))
+    // EMISSION_FAILURE
+    expect(rejected.returnCode).toBe(-11n)
+    expect(rejected.emitted).toHaveLength(0)
+  })
+
+  it('should reject modules without a hook export', () => {
+    const emptyModule = Buffer.from([0, 0x61, 0x73, 0x6d, 1, 0, 0, 0])
+    expect(() => new HookRuntime(emptyModule)).toThrow(
+      'Hook must export a hook function'
+    )
+  })
+})
+
+describeWithBuiltHook('HookRuntime with build/crowdfund.wasm', () => {
+  let runtime: HookRuntime
+
+  beforeAll(() => {
+    runtime = new HookRuntime(fs.readFileSync(CROWDFUND_WASM_PATH))
+  })
+
+  it('should roll back Payments whose memo has no MemoFormat', () => {
+    const result = runtime.execute(createContext())
+
+    expect(result.exitType).toBe('rollback')
+    expect(result.returnCode).toBe(54n)
+    expect(result.returnString.toString()).toBe(
+      'Memo transaction did not contain correct memo format.'
+    )
+    expect(result.stateChanges.size).toBe(0)
+  })
+
+  it('should roll back transactions other than Payment and Invoke', () => {
+    const ticketCreateBlob = Buffer.from(
+      encode({
+        TransactionType: 'TicketCreate',
+        Account: BACKER,
+        TicketCount: 1,
+        Fee: '10',
+        Sequence: 1,
+        SigningPubKey: '',
+      }),
+      'hex'
+    )
+
+    const result = runtime.execute(
+      createContext({ otxnBlob: ticketCreateBlob })
+    )
+
+    expect(result.exitType).toBe('rollback')
+    expect(result.returnCode).toBe(50n)
+  })
+})
@@ -0,0 +1,702 @@
+import { createHash } from 'crypto'
+import { decodeAccountID, encodeAccountID } from 'ripple-address-codec'
+import {
+  fieldId,
+  getFieldValue,
+  readFields,
+  SerializedField,
+  STI_ARRAY,
+} from './serializedFields'
+import {
+  floatCompare,
+  floatDivide,
+  floatInt,
+  floatMultiply,
+  floatNegate,
+  floatSet,
+  floatSum,
+  makeXfl,
+  xflToString,
+} from './xfl'
+
+// Hook API return codes (hook-src/error.h)
+const OUT_OF_BOUNDS = -1n
+const TOO_BIG = -3n
+const TOO_SMALL = -4n
+const DOESNT_EXIST = -5n
+const INVALID_ARGUMENT = -7n
+const ALREADY_SET = -8n
+const PREREQUISITE_NOT_MET = -9n
+const EMISSION_FAILURE = -11n
+const TOO_MANY_EMITTED_TXN = -13n
+const NOT_IMPLEMENTED = -14n
+const GUARD_VIOLATION = -16n
+const PARSE_ERROR = -18n
+
+const HOOK_STATE_KEY_BYTES = 32
+const HOOK_STATE_VALUE_MAX_BYTES = 256
+const HOOK_RETURN_STRING_MAX_BYTES = 256
+const EMITTED_TRANSACTIONS_MAX = 255
+const ACCOUNT_ID_BYTES = 20
+const HASH_BYTES = 32
+const ETXN_DETAILS_BYTES = 116
+
+const SF_TRANSACTION_TYPE = fieldId(1, 2)
+const SF_ACCOUNT = fieldId(8, 1)
+const SF_EMIT_DETAILS = fieldId(14, 13)
+const SF_EMIT_GENERATION = fieldId(2, 46)
+
+// 'TXN\0', prefixed to a transaction blob to get its hash
+const TRANSACTION_ID_PREFIX = Buffer.from('54584E00', 'hex')
+
+export function sha512Half(...parts: Uint8Array[]): Buffer {
+  const hash = createHash('sha512')
+  for (const part of parts) {
+    hash.update(part)
+  }
+  return hash.digest().subarray(0, 32)
+}
+
+// Same as rippled's transaction id; also works for unsigned (emitted) transactions
+export function hashTransactionBlob(txBlob: Uint8Array): string {
+  return sha512Half(TRANSACTION_ID_PREFIX, txBlob)
+    .toString('hex')
+    .toUpperCase()
+}
+
+export interface HookExecutionContext {
+  otxnBlob: Buffer
+  otxnId: Buffer
+  hookAccountId: Buffer
+  // The open ledger the transaction is applied to
+  ledgerSeq: number
+  // Close time of the last closed ledger, in seconds since the Ripple epoch (2000-01-01)
+  ledgerLastTime: number
+  ledgerLastHash: Buffer
+  baseFeeDrops: bigint
+  // Hook State of the hook's account and namespace, as left by earlier hooks in the chain
+  readState: (key: Buffer) => Buffer | undefined
+  trace?: (line: string) => void
+}
+
+export type HookExitType = 'accept' | 'rollback' | 'wasmError'
+
+export interface HookExecutionResult {
+  exitType: HookExitType
+  returnCode: bigint
+  returnString: Buffer
+  // By uppercase hex key; undefined deletes the entry. Only applied if the hook accepted
+  stateChanges: Map<string, Buffer | undefined>
+  emitted: Buffer[]
+  // Guard calls, a stand-in for rippled's instruction count
+  guardCalls: number
+}
+
+class HookExit {
+  constructor(
+    readonly exitType: HookExitType,
+    readonly returnCode: bigint,
+    readonly returnString: Buffer
+  ) {}
+}
+
+type HookApiFunction = (...args: any[]) => number | bigint
+
+function readVarUint32(bytes: Buffer, offset: number): [number, number] {
+  let value = 0
+  let length = 0
+  let byte: number
+  do {
+    byte = bytes[offset + length]
+    value |= (byte & 0x7f) << (7 * length)
+    length++
+  } while (byte & 0x80)
+  return [value >>> 0, length]
+}
+
+function writeVarUint32(value: number): Buffer {
+  const bytes: number[] = []
+  do {
+    let byte = value & 0x7f
+    value >>>= 7
+    if (value !== 0) {
+      byte |= 0x80
+    }
+    bytes.push(byte)
+  } while (value !== 0)
+  return Buffer.from(bytes)
+}
+
+/**
+ * Adds an export named 'memory' for memory 0. hook-cleaner strips every export but hook and cbak,
+ * and rippled reads the memory without one, but JS needs the export to reach it.
+ */
+function withMemoryExport(wasm: Buffer): Buffer {
+  const exportEntry = Buffer.concat([
+    writeVarUint32(6),
+    Buffer.from('memory'),
+    Buffer.from([0x02, 0x00]),
+  ])
+  const sections: Buffer[] = [wasm.subarray(0, 8)]
+  let added = false
+  for (let offset = 8; offset < wasm.length; ) {
+    const id = wasm[offset]
+    const [size, sizeLength] = readVarUint32(wasm, offset + 1)
+    const contentStart = offset + 1 + sizeLength
+    const contentEnd = contentStart + size
+
+    if (id === 7) {
+      // Export section: bump the count and append the entry
+      const [count, countLength] = readVarUint32(wasm, contentStart)
+      const content = Buffer.concat([
+        writeVarUint32(count + 1),
+        wasm.subarray(contentStart + countLength, contentEnd),
+        exportEntry,
+      ])
+      sections.push(Buffer.from([7]), writeVarUint32(content.length), content)
+      added = true
+    } else {
+      // No export section: add one before the first section that must follow it
+      if (!added && id !== 0 && id > 7) {
+        const content = Buffer.concat([writeVarUint32(1), exportEntry])
+        sections.push(Buffer.from([7]), writeVarUint32(content.length), content)
+        added = true
+      }
+      sections.push(wasm.subarray(offset, contentEnd))
+    }
+    offset = contentEnd
+  }
+  return Buffer.concat(sections)
+}
+
+// Offset and length packed the way sto_subfield and sto_subarray return them
+function packLocation(offset: number, length: number): bigint {
+  return (BigInt(offset) << 32n) | BigInt(length)
+}
+
+/*
+A compiled hook (the build/*.wasm a SetHook transaction installs), run against one transaction at
+a time with the Hook API implemented in JS.
+
+The API covers what hook-src uses: guards, accept/rollback, traces, otxn_*, state/state_set on the
+hook's own namespace, sto_subfield/sto_subarray, the XFL float_* arithmetic, ledger_* and
+emission (etxn_* and emit). Other imports return NOT_IMPLEMENTED. Hook State writes and emitted
+transactions are buffered in the result; the caller applies them only if the hook accepted.
+*/
+export class HookRuntime {
+  // sha512Half of the wasm, like rippled's HookHash
+  readonly hookHash: Buffer
+  private readonly module: WebAssembly.Module
+
+  constructor(wasm: Buffer) {
+    this.hookHash = sha512Half(wasm)
+
+    let module = new WebAssembly.Module(wasm)
+    const imports = WebAssembly.Module.imports(module)
+    for (const { module: importModule, name, kind } of imports) {
+      if (importModule !== 'env' || kind !== 'function') {
+        throw new Error(
+          `Hook imports ${importModule}.${name} (${kind}): only env functions are supported`
+        )
+      }
+    }
+    const exports = WebAssembly.Module.exports(module)
+    const exportsHook = exports.some(
+      ({ name, kind }) => name === 'hook' && kind === 'function'
+    )
+    if (!exportsHook) {
+      throw new Error('Hook must export a hook function')
+    }
+    if (!exports.some(({ kind }) => kind === 'memory')) {
+      module = new WebAssembly.Module(withMemoryExport(wasm))
+    }
+    this.module = module
+  }
+
+  execute(context: HookExecutionContext): HookExecutionResult {
+    return new HookExecution(this.module, this.hookHash, context).run()
+  }
+}
+
+// A single run of a hook: its memory, buffered state writes, emissions and guard counts
+class HookExecution {
+  private readonly module: WebAssembly.Module
+  private readonly hookHash: Buffer
+  private readonly context: HookExecutionContext
+  private readonly otxnFields: SerializedField[]
+  private readonly stateChanges: Map<string, Buffer | undefined> = new Map()
+  private readonly emitted: Buffer[] = []
+  private readonly guardCounts: Map<number, number> = new Map()
+  private memory: WebAssembly.Memory | undefined
+  private guardCalls = 0
+  private emitReserve: number | undefined
+  private nonceCount = 0
+
+  constructor(
+    module: WebAssembly.Module,
+    hookHash: Buffer,
+    context: HookExecutionContext
+  ) {
+    this.module = module
+    this.hookHash = hookHash
+    this.context = context
+    const otxnFields = readFields(context.otxnBlob)
+    if (!otxnFields) {
+      throw new Error('Originating transaction blob does not parse')
+    }
+    this.otxnFields = otxnFields
+  }
+
+  run(): HookExecutionResult {
+    const api = this._api()
+    const env: Record<string, HookApiFunction> = {}
+    for (const { name } of WebAssembly.Module.imports(this.module)) {
+      env[name] = api[name] ?? (() => NOT_IMPLEMENTED)
+    }
+    const instance = new WebAssembly.Instance(this.module, { env })
+    this.memory = Object.values(instance.exports).find(
+      (value) => value instanceof WebAssembly.Memory
+    ) as WebAssembly.Memory
+
+    let exit: HookExit
+    try {
+      ;(instance.exports.hook as (reserved: number) => bigint)(0)
+      // Returning without accept or rollback rolls back
+      exit = new HookExit('rollback', 0n, Buffer.alloc(0))
+    } catch (error) {
+      if (error instanceof HookExit) {
+        exit = error
+      } else {
+        this._trace(`Hook failed: ${error}`)
+        exit = new HookExit('wasmError', -1n, Buffer.alloc(0))
+      }
+    }
+
+    return {
+      exitType: exit.exitType,
+      returnCode: exit.returnCode,
+      returnString: exit.returnString,
+      stateChanges: exit.exitType === 'accept' ? this.stateChanges : new Map(),
+      emitted: exit.exitType === 'accept' ? this.emitted : [],
+      guardCalls: this.guardCalls,
+    }
+  }
+
+  private _api(): Record<string, HookApiFunction> {
+    return {
+      _g: (guardId: number, maxIterations: number) => {
+        this.guardCalls++
+        const count = (this.guardCounts.get(guardId) ?? 0) + 1
+        this.guardCounts.set(guardId, count)
+        if (count > maxIterations) {
+          throw new HookExit(
+            'rollback',
+            GUARD_VIOLATION,
+            Buffer.from('Guard violation')
+          )
+        }
+        return 1
+      },
+      accept: (readPtr: number, readLen: number, errorCode: bigint) =>
+        this._exit('accept', readPtr, readLen, errorCode),
+      rollback: (readPtr: number, readLen: number, errorCode: bigint) =>
+        this._exit('rollback', readPtr, readLen, errorCode),
+
+      trace: (
+        messagePtr: number,
+        messageLen: number,
+        dataPtr: number,
+        dataLen: number,
+        asHex: number
+      ) => {
+        const message = this._read(messagePtr, messageLen)
+        const data = this._read(dataPtr, dataLen)
+        if (!message || !data) {
+          return OUT_OF_BOUNDS
+        }
+        const text = asHex
+          ? data.toString('hex').toUpperCase()
+          : data.toString('utf8')
+        this._trace(`${message.toString('utf8')} ${text}`.trim())
+        return 0n
+      },
+      trace_num: (readPtr: number, readLen: number, number: bigint) =>
+        this._traceValue(readPtr, readLen, number.toString()),
+      trace_float: (readPtr: number, readLen: number, float1: bigint) =>
+        this._traceValue(readPtr, readLen, xflToString(float1)),
+
+      otxn_type: () => {
+        const field = this._findOtxnField(SF_TRANSACTION_TYPE)
+        return field
+          ? BigInt(this.context.otxnBlob.readUInt16BE(field.payloadStart))
+          : DOESNT_EXIST
+      },
+      otxn_field: (writePtr: number, writeLen: number, id: number) => {
+        const field = this._findOtxnField(id)
+        if (!field) {
+          return DOESNT_EXIST
+        }
+        return this._write(
+          writePtr,
+          writeLen,
+          getFieldValue(this.context.otxnBlob, field)
+        )
+      },
+      otxn_id: (writePtr: number, writeLen: number) =>
+        this._write(writePtr, writeLen, this.context.otxnId),
+      otxn_generation: () => BigInt(this._otxnGeneration()),
+      hook_account: (writePtr: number, writeLen: number) =>
+        this._write(writePtr, writeLen, this.context.hookAccountId),
+      hook_hash: (writePtr: number, writeLen: number) =>
+        this._write(writePtr, writeLen, this.hookHash),
+      hook_param: () => DOESNT_EXIST,
+
+      ledger_seq: () => BigInt(this.context.ledgerSeq),
+      ledger_last_time: () => BigInt(this.context.ledgerLastTime),
+      ledger_last_hash: (writePtr: number, writeLen: number) =>
+        this._write(writePtr, writeLen, this.context.ledgerLastHash),
+      ledger_nonce: (writePtr: number, writeLen: number) =>
+        this._write(writePtr, writeLen, this._nextNonce()),
+
+      state: (
+        writePtr: number,
+        writeLen: number,
+        keyPtr: number,
+        keyLen: number
+      ) => {
+        const key = this._readStateKey(keyPtr, keyLen)
+        if (typeof key === 'bigint') {
+          return key
+        }
+        const keyHex = key.toString('hex').toUpperCase()
+        const value = this.stateChanges.has(keyHex)
+          ? this.stateChanges.get(keyHex)
+          : this.context.readState(key)
+        if (!value) {
+          return DOESNT_EXIST
+        }
+        return this._write(writePtr, writeLen, value)
+      },
+      state_set: (
+        readPtr: number,
+        readLen: number,
+        keyPtr: number,
+        keyLen: number
+      ) => {
+        const key = this._readStateKey(keyPtr, keyLen)
+        if (typeof key === 'bigint') {
+          return key
+        }
+        if (readLen > HOOK_STATE_VALUE_MAX_BYTES) {
+          return TOO_BIG
+        }
+        const value = this._read(readPtr, readLen)
+        if (!value) {
+          return OUT_OF_BOUNDS
+        }
+        this.stateChanges.set(
+          key.toString('hex').toUpperCase(),
+          readLen === 0 ? undefined : Buffer.from(value)
+        )
+        return BigInt(readLen)
+      },
+
+      sto_subfield: (readPtr: number, readLen: number, id: number) => {
+        const bytes = this._read(readPtr, readLen)
+        if (!bytes) {
+          return OUT_OF_BOUNDS
+        }
+        const fields = readFields(bytes)
+        if (!fields) {
+          return PARSE_ERROR
+        }
+        const field = fields.find(
+          ({ type, field }) => fieldId(type, field) === id
+        )
+        if (!field) {
+          return DOESNT_EXIST
+        }
+        // Arrays are returned whole, everything else as its payload
+        return field.type === STI_ARRAY
+          ? packLocation(field.start, field.end - field.start)
+          : packLocation(field.payloadStart, field.payloadLength)
+      },
+      sto_subarray: (readPtr: number, readLen: number, index: number) => {
+        const bytes = this._read(readPtr, readLen)
+        if (!bytes) {
+          return OUT_OF_BOUNDS
+        }
+        // An array with its header and end marker is unwrapped first
+        const wrapped = bytes.length > 0 && (bytes[0] & 0xf0) === 0xf0
+        const fields = wrapped
+          ? readFields(bytes, 1, bytes.length - 1)
+          : readFields(bytes)
+        if (!fields) {
+          return PARSE_ERROR
+        }
+        const field = fields[index]
+        return field
+          ? packLocation(field.start, field.end - field.start)
+          : DOESNT_EXIST
+      },
+
+      util_raddr: (
+        writePtr: number,
+        writeLen: number,
+        readPtr: number,
+        readLen: number
+      ) => {
+        const accountId = this._read(readPtr, readLen)
+        if (!accountId) {
+          return OUT_OF_BOUNDS
+        }
+        if (readLen !== ACCOUNT_ID_BYTES) {
+          return INVALID_ARGUMENT
+        }
+        return this._write(
+          writePtr,
+          writeLen,
+          Buffer.from(encodeAccountID(accountId), 'ascii')
+        )
+      },
+      util_accid: (
+        writePtr: number,
+        writeLen: number,
+        readPtr: number,
+        readLen: number
+      ) => {
+        const address = this._read(readPtr, readLen)
+        if (!address) {
+          return OUT_OF_BOUNDS
+        }
+        let accountId: Buffer
+        try {
+          accountId = Buffer.from(
+            decodeAccountID(address.toString('ascii').replace(/\0+$/, ''))
+          )
+        } catch {
+          return INVALID_ARGUMENT
+        }
+        return this._write(writePtr, writeLen, accountId)
+      },
+      util_sha512h: (
+        writePtr: number,
+        writeLen: number,
+        readPtr: number,
+        readLen: number
+      ) => {
+        const data = this._read(readPtr, readLen)
+        if (!data) {
+          return OUT_OF_BOUNDS
+        }
+        return this._write(writePtr, writeLen, sha512Half(data))
+      },
+
+      float_set: (exponent: number, mantissa: bigint) =>
+        floatSet(exponent, mantissa),
+      float_multiply: floatMultiply,
+      float_divide: floatDivide,
+      float_sum: floatSum,
+      float_negate: floatNegate,
+      float_compare: floatCompare,
+      float_int: (float1: bigint, decimalPlaces: number, absolute: number) =>
+        floatInt(float1, decimalPlaces, absolute !== 0),
+      float_one: () => makeXfl(1n, 0),
+
+      etxn_reserve: (count: number) => {
+        if (this.emitReserve !== undefined) {
+          return ALREADY_SET
+        }
+        if (count < 1) {
+          return TOO_SMALL
+        }
+        if (count > EMITTED_TRANSACTIONS_MAX) {
+          return TOO_BIG
+        }
+        this.emitReserve = count
+        return BigInt(count)
+      },
+      etxn_burden: () =>
+        this.emitReserve === undefined
+          ? PREREQUISITE_NOT_MET
+          : BigInt(this.emitReserve),
+      etxn_generation: () => BigInt(this._otxnGeneration() + 1),
+      etxn_fee_base: () =>
+        this.emitReserve === undefined
+          ? PREREQUISITE_NOT_MET
+          : this.context.baseFeeDrops,
+      etxn_nonce: (writePtr: number, writeLen: number) =>
+        this._write(writePtr, writeLen, this._nextNonce()),
+      etxn_details: (writePtr: number, writeLen: number) => {
+        if (this.emitReserve === undefined) {
+          return PREREQUISITE_NOT_MET
+        }
+        if (writeLen < ETXN_DETAILS_BYTES) {
+          return TOO_SMALL
+        }
+        return this._write(writePtr, writeLen, this._emitDetails())
+      },
+      emit: (
+        writePtr: number,
+        writeLen: number,
+        readPtr: number,
+        readLen: number
+      ) => {
+        if (this.emitReserve === undefined) {
+          return PREREQUISITE_NOT_MET
+        }
+        if (this.emitted.length >= this.emitReserve) {
+          return TOO_MANY_EMITTED_TXN
+        }
+        if (writeLen < HASH_BYTES) {
+          return TOO_SMALL
+        }
+        const txBlob = this._read(readPtr, readLen)
+        if (!txBlob) {
+          return OUT_OF_BOUNDS
+        }
+        if (!this._isEmittable(txBlob)) {
+          return EMISSION_FAILURE
+        }
+        this.emitted.push(Buffer.from(txBlob))
+        return this._write(
+          writePtr,
+          writeLen,
+          Buffer.from(hashTransactionBlob(txBlob), 'hex')
+        )
+      },
+    }
+  }
+
+  private _exit(
+    exitType: HookExitType,
+    readPtr: number,
+    readLen: number,
+    errorCode: bigint
+  ): never {
+    const returnString =
+      this._read(readPtr, Math.min(readLen, HOOK_RETURN_STRING_MAX_BYTES)) ??
+      Buffer.alloc(0)
+    throw new HookExit(exitType, errorCode, Buffer.from(returnString))
+  }
+
+  private _trace(line: string): void {
+    this.context.trace?.(line)
+  }
+
+  private _traceValue(readPtr: number, readLen: number, value: string): bigint {
+    const message = this._read(readPtr, readLen)
+    if (!message) {
+      return OUT_OF_BOUNDS
+    }
+    this._trace(`${message.toString('utf8')} ${value}`)
+    return 0n
+  }
+
+  // A view of linear memory, or undefined if out of bounds
+  private _read(ptr: number, len: number): Buffer | undefined {
+    const memory = this.memory as WebAssembly.Memory
+    const start = ptr >>> 0
+    const length = len >>> 0
+    if (start + length > memory.buffer.byteLength) {
+      return undefined
+    }
+    return Buffer.from(memory.buffer, start, length)
+  }
+
+  private _write(ptr: number, len: number, data: Uint8Array): bigint {
+    if (data.length > len >>> 0) {
+      return TOO_SMALL
+    }
+    const target = this._read(ptr, data.length)
+    if (!target) {
+      return OUT_OF_BOUNDS
+    }
+    target.set(data)
+    return BigInt(data.length)
+  }
+
+  // Keys shorter than 32 bytes are padded with leading zeros, like rippled does
+  private _readStateKey(keyPtr: number, keyLen: number): Buffer | bigint {
+    if (keyLen > HOOK_STATE_KEY_BYTES) {
+      return TOO_BIG
+    }
+    if (keyLen < 1) {
+      return TOO_SMALL
+    }
+    const key = this._read(keyPtr, keyLen)
+    if (!key) {
+      return OUT_OF_BOUNDS
+    }
+    const paddedKey = Buffer.alloc(HOOK_STATE_KEY_BYTES)
+    key.copy(paddedKey, HOOK_STATE_KEY_BYTES - keyLen)
+    return paddedKey
+  }
+
+  private _findOtxnField(id: number): SerializedField | undefined {
+    return this.otxnFields.find(
+      ({ type, field }) => fieldId(type, field) === id
+    )
+  }
+
+  private _otxnGeneration(): number {
+    const emitDetails = this._findOtxnField(SF_EMIT_DETAILS)
+    if (!emitDetails) {
+      return 0
+    }
+    const { otxnBlob } = this.context
+    const fields = readFields(
+      otxnBlob,
+      emitDetails.payloadStart,
+      emitDetails.payloadStart + emitDetails.payloadLength
+    )
+    const generation = fields?.find(
+      ({ type, field }) => fieldId(type, field) === SF_EMIT_GENERATION
+    )
+    return generation ? otxnBlob.readUInt32BE(generation.payloadStart) : 0
+  }
+
+  private _nextNonce(): Buffer {
+    const count = Buffer.alloc(4)
+    count.writeUInt32BE(this.nonceCount++)
+    return sha512Half(
+      this.context.otxnId,
+      this.context.hookAccountId,
+      this.hookHash,
+      count
+    )
+  }
+
+  // sfEmitDetails as etxn_details writes it: generation, burden, parent, nonce and hook hash
+  private _emitDetails(): Buffer {
+    const details = Buffer.alloc(ETXN_DETAILS_BYTES)
+    let offset = 0
+    details[offset++] = 0xed
+    details[offset++] = 0x20
+    details[offset++] = 0x2e
+    offset = details.writeUInt32BE(this._otxnGeneration() + 1, offset)
+    details[offset++] = 0x3d
+    offset = details.writeBigUInt64BE(BigInt(this.emitReserve ?? 1), offset)
+    details[offset++] = 0x5b
+    offset += this.context.otxnId.copy(details, offset)
+    details[offset++] = 0x5c
+    offset += this._nextNonce().copy(details, offset)
+    details[offset++] = 0x5d
+    offset += this.hookHash.copy(details, offset)
+    details[offset++] = 0xe1
+    return details
+  }
+
+  // An emitted transaction must parse, come from the hook's account and carry sfEmitDetails
+  private _isEmittable(txBlob: Buffer): boolean {
+    const fields = readFields(txBlob)
+    const findField = (id: number) =>
+      fields?.find(({ type, field }) => fieldId(type, field) === id)
+    const account = findField(SF_ACCOUNT)
+    return (
+      findField(SF_EMIT_DETAILS) !== undefined &&
+      account !== undefined &&
+      this.context.hookAccountId.equals(getFieldValue(txBlob, account))
+    )
+  }
+}
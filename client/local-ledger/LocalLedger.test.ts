@@ -0,0 +1,295 @@
+import { encode } from 'ripple-binary-codec'
+import {
+  assembleTestHook,
+  DROP,
+  i32Const,
+  i64Const,
+} from './assembleTestHook'
+import {
+  LocalLedger,
+  RIPPLE_EPOCH_OFFSET,
+  SubmitResult,
+  TransactionJson,
+} from './LocalLedger'
+
+const HOOK_ACCOUNT = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+const BACKER = 'rPT1Sjq2YGrBMTttX4GZHjKu9dyfzbpAYe'
+const NAMESPACE = 'AB'.repeat(32)
+// Fires on Payment only (bit 0 cleared; SetHook's bit 22 is inverted)
+const HOOK_ON_PAYMENT = 'F'.repeat(58) + 'BFFFFE'
+const SF_AMOUNT = 0x60001
+const STATE_KEY = '6B'.padStart(64, '0')
+
+// Writes the Payment's Amount under key 'k' and exits with [exit]('ok')
+function createStateHook(exit: 'accept' | 'rollback'): Buffer {
+  return assembleTestHook(
+    ['otxn_field', 'state_set', exit],
+    (call) => [
+      ...[...i32Const(0), ...i32Const(8), ...i32Const(SF_AMOUNT)],
+      ...[...call('otxn_field'), ...DROP],
+      ...[...i32Const(0), ...i32Const(8), ...i32Const(100), ...i32Const(1)],
+      ...[...call('state_set'), ...DROP],
+      ...[...i32Const(200), ...i32Const(2), ...i64Const(0)],
+      ...[...call(exit), ...DROP, ...i64Const(0)],
+    ],
+    { data: [[100, Buffer.from('k')], [200, Buffer.from('ok')]] }
+  )
+}
+
+// Pays 50 drops from the Hook Account back to the backer
+function createEmittingHook(): Buffer {
+  const blob = Buffer.from(
+    encode({
+      TransactionType: 'Payment',
+      Account: HOOK_ACCOUNT,
+      Destination: BACKER,
+      Amount: '50',
+      Fee: '10',
+      Sequence: 0,
+      FirstLedgerSequence: 1,
+      LastLedgerSequence: 100,
+      SigningPubKey: '',
+      EmitDetails: {
+        EmitGeneration: 1,
+        EmitBurden: '1',
+        EmitParentTxnID: '0'.repeat(64),
+        EmitNonce: '0'.repeat(64),
+        EmitHookHash: '0'.repeat(64),
+      },
+    }),
+    'hex'
+  )
+  return assembleTestHook(
+    ['etxn_reserve', 'emit', 'accept'],
+    (call) => [
+      ...[...i32Const(1), ...call('etxn_reserve'), ...DROP],
+      ...[...i32Const(0), ...i32Const(0), ...i32Const(0), ...i32Const(32)],
+      ...[...i32Const(1024), ...i32Const(blob.length), ...call('emit')],
+      ...[...call('accept'), ...DROP, ...i64Const(0)],
+    ],
+    { data: [[1024, blob]] }
+  )
+}
+
+describe('LocalLedger', () => {
+  let ledger: LocalLedger
+
+  // Fills in Sequence (unless a TicketSequence is given), Fee and NetworkID
+  function submit(tx: TransactionJson): SubmitResult {
+    const { sequence } = ledger.getAccountRoot(
+      tx.Account,
+      ledger.getLedger('current')
+    )
+    return ledger.submit(
+      encode({
+        Sequence: tx.TicketSequence === undefined ? sequence : 0,
+        Fee: '20',
+        NetworkID: 21338,
+        SigningPubKey: '',
+        ...tx,
+      })
+    )
+  }
+
+  function setHook(wasm: Buffer): void {
+    const { engineResult } = submit({
+      TransactionType: 'SetHook',
+      Account: HOOK_ACCOUNT,
+      Hooks: [
+        {
+          Hook: {
+            CreateCode: wasm.toString('hex'),
+            HookOn: HOOK_ON_PAYMENT,
+            HookNamespace: NAMESPACE,
+            Flags: 1,
+            HookApiVersion: 0,
+          },
+        },
+      ],
+    })
+    expect(engineResult).toBe('tesSUCCESS')
+  }
+
+  function pay(amount: string, extra: TransactionJson = {}): SubmitResult {
+    return submit({
+      TransactionType: 'Payment',
+      Account: BACKER,
+      Destination: HOOK_ACCOUNT,
+      Amount: amount,
+      ...extra,
+    })
+  }
+
+  const balanceOf = (address: string) =>
+    ledger.getAccountRoot(address, ledger.getLedger('current')).balance
+
+  beforeEach(() => {
+    ledger = new LocalLedger()
+    ledger.fund(HOOK_ACCOUNT, 1000000000n)
+    ledger.fund(BACKER, 1000000000n)
+  })
+
+  it('should run the receiving account hooks and record their Hook State', () => {
+    setHook(createStateHook('accept'))
+
+    const { engineResult, hash } = pay('100')
+
+    expect(engineResult).toBe('tesSUCCESS')
+    const { meta } = ledger.getTransaction(hash) ?? {}
+    expect(meta?.HookExecutions).toEqual([
+      {
+        HookExecution: expect.objectContaining({
+          HookAccount: HOOK_ACCOUNT,
+          HookResult: 3,
+          HookReturnString: '6F6B',
+          HookStateChangeCount: 1,
+        }),
+      },
+    ])
+    expect(meta?.AffectedNodes).toContainEqual({
+      CreatedNode: expect.objectContaining({
+        LedgerEntryType: 'HookState',
+        NewFields: {
+          HookStateData: '4000000000000064',
+          HookStateKey: STATE_KEY,
+          OwnerNode: '0',
+        },
+      }),
+    })
+    const current = ledger.getLedger('current')
+    expect(
+      ledger.getHookStateEntries(HOOK_ACCOUNT, NAMESPACE, current)
+    ).toEqual([[STATE_KEY, '4000000000000064']])
+    // The hook and the Hook State entry
+    expect(ledger.getAccountRoot(HOOK_ACCOUNT, current)).toMatchObject({
+      ownerCount: 2,
+      hookNamespaces: [NAMESPACE],
+    })
+  })
+
+  it('should keep only the fee of transactions a hook rolls back', () => {
+    setHook(createStateHook('rollback'))
+    const backerBalance = balanceOf(BACKER)
+
+    const { engineResult, hash } = pay('100')
+
+    expect(engineResult).toBe('tecHOOK_REJECTED')
+    expect(balanceOf(BACKER)).toBe(backerBalance - 20n)
+    expect(
+      ledger.getTransaction(hash)?.meta.HookExecutions[0].HookExecution
+    ).toMatchObject({ HookResult: 2, HookReturnString: '6F6B' })
+    expect(
+      ledger.getHookStateEntries(
+        HOOK_ACCOUNT,
+        NAMESPACE,
+        ledger.getLedger('current')
+      )
+    ).toEqual([])
+  })
+
+  it('should charge the base fee again for each hook a transaction runs', () => {
+    setHook(createStateHook('accept'))
+    const txBlob = encode({
+      TransactionType: 'Payment',
+      Account: BACKER,
+      Destination: HOOK_ACCOUNT,
+      Amount: '100',
+      Fee: '0',
+      Sequence: 0,
+      SigningPubKey: '',
+    })
+
+    expect(ledger.getRequiredFee(txBlob)).toBe(20n)
+    expect(pay('100', { Fee: '10' }).engineResult).toBe('telINSUF_FEE_P')
+  })
+
+  it('should leave closed ledgers as they were closed', () => {
+    setHook(createStateHook('accept'))
+    pay('100')
+    const closed = ledger.closeLedger()
+
+    pay('7')
+
+    const entries = (ledgerIndex: number | 'current') =>
+      ledger.getHookStateEntries(
+        HOOK_ACCOUNT,
+        NAMESPACE,
+        ledger.getLedger(ledgerIndex)
+      )
+    expect(entries(closed.index)).toEqual([[STATE_KEY, '4000000000000064']])
+    expect(entries('current')).toEqual([[STATE_KEY, '4000000000000007']])
+  })
+
+  it('should hold transactions until their sequence gap fills', () => {
+    const { sequence } = ledger.getAccountRoot(
+      BACKER,
+      ledger.getLedger('current')
+    )
+
+    const held = pay('100', { Sequence: sequence + 1 })
+    expect(held).toMatchObject({ engineResult: 'terPRE_SEQ', queued: true })
+    expect(pay('100', { Sequence: sequence }).engineResult).toBe('tesSUCCESS')
+
+    expect(ledger.getTransaction(held.hash)?.engineResult).toBe('tesSUCCESS')
+    expect(pay('200', { Sequence: sequence }).engineResult).toBe(
+      'tefPAST_SEQ'
+    )
+  })
+
+  it('should create tickets and consume them', () => {
+    const created = submit({
+      TransactionType: 'TicketCreate',
+      Account: BACKER,
+      TicketCount: 2,
+    })
+    expect(created.engineResult).toBe('tesSUCCESS')
+    const { tickets, sequence } = ledger.getAccountRoot(
+      BACKER,
+      ledger.getLedger('current')
+    )
+    expect(tickets).toEqual([sequence - 2, sequence - 1])
+
+    const TicketSequence = tickets[0]
+    expect(pay('100', { TicketSequence }).engineResult).toBe('tesSUCCESS')
+    expect(pay('200', { TicketSequence }).engineResult).toBe('tefNO_TICKET')
+  })
+
+  it('should apply emitted transactions first in the next ledger', () => {
+    setHook(createEmittingHook())
+    const { hash } = pay('100')
+    const backerBalance = balanceOf(BACKER)
+
+    expect(ledger.getTransaction(hash)?.meta.HookEmissions).toHaveLength(1)
+    ledger.closeLedger()
+
+    const [emittedHash] = ledger.getLedger('current').transactions
+    expect(ledger.getTransaction(emittedHash)).toMatchObject({
+      engineResult: 'tesSUCCESS',
+      tx: { Account: HOOK_ACCOUNT, Destination: BACKER, Amount: '50' },
+    })
+    expect(balanceOf(BACKER)).toBe(backerBalance + 50n)
+  })
+
+  it('should close ledgers at the ledger clock time and notify listeners', () => {
+    const closedLedgers: [number, string[]][] = []
+    ledger.onLedgerClosed((closed, transactions) =>
+      closedLedgers.push([
+        closed.index,
+        transactions.map(({ engineResult }) => engineResult),
+      ])
+    )
+    ledger.setTime(2000000000)
+
+    const first = ledger.closeLedger()
+    ledger.advanceTime(60)
+    const second = ledger.closeLedger()
+
+    expect(first.closeTime).toBe(2000000000 - RIPPLE_EPOCH_OFFSET)
+    expect(second.closeTime).toBe(2000000060 - RIPPLE_EPOCH_OFFSET)
+    // The funding payments were in the first ledger
+    expect(closedLedgers).toEqual([
+      [first.index, ['tesSUCCESS', 'tesSUCCESS']],
+      [second.index, []],
+    ])
+  })
+})
@@ -0,0 +1,1261 @@
+import { decodeAccountID } from 'ripple-address-codec'
+import { decode, encode } from 'ripple-binary-codec'
+import { hashTransactionBlob, HookRuntime, sha512Half } from './HookRuntime'
+import { fieldId, readFields } from './serializedFields'
+
+// Seconds from the Unix epoch to the Ripple epoch (2000-01-01)
+export const RIPPLE_EPOCH_OFFSET = 946684800
+
+// rippled's standalone genesis account ("masterpassphrase"), which funds every other account
+export const GENESIS_ADDRESS = 'rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh'
+const GENESIS_BALANCE_DROPS = 100000000000000000n
+
+const ZERO_HASH = '0'.repeat(64)
+const HOOKS_MAX = 10
+const TICKETS_PER_TRANSACTION_MAX = 250
+
+const SF_TRANSACTION_TYPE = fieldId(1, 2)
+const TT_SET_HOOK = 22
+
+// Ledger entry index prefixes (rippled's LedgerNameSpace)
+const ACCOUNT_SPACE = Buffer.from('0061', 'hex')
+const TICKET_SPACE = Buffer.from('0054', 'hex')
+const HOOK_STATE_SPACE = Buffer.from('0076', 'hex')
+
+// Codes and messages as rippled reports them
+const ENGINE_RESULTS: Record<string, [number, string]> = {
+  tesSUCCESS: [
+    0,
+    'The transaction was applied. Only final in a validated ledger.',
+  ],
+  tecUNFUNDED_PAYMENT: [104, 'Insufficient XRP balance to send.'],
+  tecNO_DST_INSUFF_XRP: [
+    125,
+    'Destination does not exist. Too little XRP sent to create it.',
+  ],
+  tecINSUFFICIENT_RESERVE: [
+    141,
+    'Insufficient reserve to complete requested operation.',
+  ],
+  tecHOOK_REJECTED: [
+    153,
+    'Rejected by hook on sending or receiving account.',
+  ],
+  tefALREADY: [-198, 'The exact transaction was already in this ledger.'],
+  tefPAST_SEQ: [-190, 'This sequence number has already passed.'],
+  tefMAX_LEDGER: [-186, 'Ledger sequence too high.'],
+  tefNO_TICKET: [-180, 'Ticket is not in ledger.'],
+  telINSUF_FEE_P: [-394, 'Fee insufficient.'],
+  telWRONG_NETWORK: [
+    -386,
+    'Transaction specifies a Network ID that differs from that of the local node.',
+  ],
+  telREQUIRES_NETWORK_ID: [
+    -385,
+    'Transactions submitted to this node/network must include a correct NetworkID field.',
+  ],
+  temMALFORMED: [-299, 'Malformed transaction.'],
+  temBAD_AMOUNT: [-298, 'Can only send positive amounts.'],
+  temBAD_FEE: [-295, 'Invalid fee, negative or not XRP.'],
+  temREDUNDANT: [-275, 'Sends same currency to self.'],
+  temDISABLED: [
+    -273,
+    'The transaction requires logic that is currently disabled.',
+  ],
+  terINSUF_FEE_B: [-97, "Account balance can't pay fee."],
+  terNO_ACCOUNT: [-96, 'The source account does not exist.'],
+  terPRE_SEQ: [-92, 'Missing/inapplicable prior transaction.'],
+  terPRE_TICKET: [-88, 'Ticket is not yet in ledger.'],
+}
+
+// rippled's HookResult values in HookExecution metadata
+const HOOK_RESULTS = { wasmError: 1, rollback: 2, accept: 3 }
+
+export type TransactionJson = Record<string, any>
+
+export type LedgerSpecifier = number | 'current' | 'closed' | 'validated'
+
+export class LocalLedgerError extends Error {
+  // error is the rippled error code the RPC responds with, e.g. actNotFound
+  constructor(readonly error: string, message: string) {
+    super(message)
+  }
+}
+
+export interface InstalledHook {
+  // Uppercase hex throughout
+  hookHash: string
+  hookOn: bigint
+  namespace: string
+  runtime: HookRuntime
+}
+
+// Replaced, never mutated, so closed ledgers can share them
+export interface AccountRoot {
+  address: string
+  accountId: Buffer
+  balance: bigint
+  sequence: number
+  ownerCount: number
+  tickets: readonly number[]
+  // By SetHook position; undefined for empty positions
+  hooks: readonly (InstalledHook | undefined)[]
+  // Namespaces holding Hook State entries
+  hookNamespaces: readonly string[]
+  previousTxnId: string
+  previousTxnLgrSeq: number
+}
+
+interface LedgerState {
+  accounts: Map<string, AccountRoot>
+  // Hook State data by `${address}:${namespace}`, then by key; uppercase hex
+  hookState: Map<string, Map<string, string>>
+}
+
+export interface Ledger {
+  index: number
+  parentHash: string
+  // Set once closed
+  hash: string | undefined
+  // Seconds since the Ripple epoch; set once closed
+  closeTime: number | undefined
+  state: LedgerState
+  // Hashes of the applied transactions, in order
+  transactions: string[]
+}
+
+export interface TransactionRecord {
+  hash: string
+  tx: TransactionJson
+  engineResult: string
+  meta: TransactionJson
+  // The ledger the transaction was applied to; validated once that ledger closed
+  ledgerIndex: number
+}
+
+export interface SubmitResult {
+  engineResult: string
+  engineResultCode: number
+  engineResultMessage: string
+  hash: string
+  tx: TransactionJson
+  // tes and tec results are in the open ledger
+  applied: boolean
+  // terPRE_SEQ transactions are held until the sequence gap fills
+  queued: boolean
+}
+
+export type LedgerClosedListener = (
+  ledger: Ledger,
+  transactions: TransactionRecord[]
+) => void
+
+export interface LocalLedgerOptions {
+  networkId?: number
+  baseFeeDrops?: number
+  reserveBaseDrops?: number
+  reserveIncrementDrops?: number
+  // Ledgers are closed every closeIntervalMs once started; 0 closes them only on closeLedger()
+  closeIntervalMs?: number
+  // Closed ledgers (and their transactions) kept for reads
+  ledgerHistory?: number
+  // Hook traces (trace, trace_num, trace_float)
+  onTrace?: (line: string) => void
+}
+
+interface PendingTransaction {
+  hash: string
+  blob: Buffer
+  tx: TransactionJson
+  // Emitted by a hook: no signature, sequence or NetworkID, and the emitter's hooks don't run
+  emitted: boolean
+}
+
+type HookChange = 'keep' | 'delete' | InstalledHook
+
+type AffectedNode = Record<string, TransactionJson>
+
+export function accountRootIndex(accountId: Buffer): string {
+  return sha512Half(ACCOUNT_SPACE, accountId).toString('hex').toUpperCase()
+}
+
+export function hookStateIndex(
+  accountId: Buffer,
+  key: Buffer,
+  namespace: Buffer
+): string {
+  return sha512Half(HOOK_STATE_SPACE, accountId, key, namespace)
+    .toString('hex')
+    .toUpperCase()
+}
+
+function ticketIndex(accountId: Buffer, ticketSequence: number): string {
+  const sequence = Buffer.alloc(4)
+  sequence.writeUInt32BE(ticketSequence)
+  return sha512Half(TICKET_SPACE, accountId, sequence)
+    .toString('hex')
+    .toUpperCase()
+}
+
+function hookStateSpace(address: string, namespace: string): string {
+  return `${address}:${namespace}`
+}
+
+function transactionTypeCode(blob: Buffer): number | undefined {
+  const field = readFields(blob)?.find(
+    ({ type, field }) => fieldId(type, field) === SF_TRANSACTION_TYPE
+  )
+  return field && blob.readUInt16BE(field.headerEnd)
+}
+
+// HookOn bits are cleared for the transaction types a hook runs on; SetHook's bit is inverted
+function hookFires(hook: InstalledHook, transactionType: number): boolean {
+  const bit = (hook.hookOn >> BigInt(transactionType)) & 1n
+  return transactionType === TT_SET_HOOK ? bit === 1n : bit === 0n
+}
+
+// UInt64 metadata fields are hex; negative return codes are sign and magnitude, like rippled's
+function hookReturnCodeHex(returnCode: bigint): string {
+  const magnitude = returnCode < 0n ? -returnCode | (1n << 63n) : returnCode
+  return magnitude.toString(16).toUpperCase()
+}
+
+// [engine_result_code, engine_result_message]
+export function describeEngineResult(engineResult: string): [number, string] {
+  return ENGINE_RESULTS[engineResult] ?? [0, '']
+}
+
+function isDrops(value: unknown): value is string {
+  return typeof value === 'string' && /^[0-9]+$/.test(value)
+}
+
+export function accountRootJson(account: AccountRoot): TransactionJson {
+  const json: TransactionJson = {
+    Account: account.address,
+    Balance: account.balance.toString(),
+    Flags: 0,
+    LedgerEntryType: 'AccountRoot',
+    OwnerCount: account.ownerCount,
+    PreviousTxnID: account.previousTxnId,
+    PreviousTxnLgrSeq: account.previousTxnLgrSeq,
+    Sequence: account.sequence,
+    index: accountRootIndex(account.accountId),
+  }
+  // Left out until the account has Hook State, like rippled does
+  if (account.hookNamespaces.length > 0) {
+    json.HookNamespaces = [...account.hookNamespaces]
+  }
+  if (account.tickets.length > 0) {
+    json.TicketCount = account.tickets.length
+  }
+  return json
+}
+
+export function hookStateJson(
+  account: AccountRoot,
+  namespace: string,
+  key: string,
+  data: string
+): TransactionJson {
+  return {
+    Flags: 0,
+    HookStateData: data,
+    HookStateKey: key,
+    LedgerEntryType: 'HookState',
+    OwnerNode: '0',
+    index: hookStateIndex(
+      account.accountId,
+      Buffer.from(key, 'hex'),
+      Buffer.from(namespace, 'hex')
+    ),
+  }
+}
+
+/*
+An in-memory XRPL ledger that applies the transactions the crowdfund client submits and runs the
+installed hooks (build/*.wasm, see HookRuntime) against in-memory Hook State, standing in for
+Hooks Testnet v3 in offline integration and load tests.
+
+It keeps an open ledger that transactions are applied to as they're submitted, and the last
+ledgerHistory closed ledgers. Closed ledgers are validated straight away, like rippled in
+standalone mode. Ledgers close every closeIntervalMs once started, or on closeLedger(); close
+times come from a clock that tests can stop (setTime) and move forward (advanceTime).
+
+Supported: XRP Payments (creating accounts), Invoke, SetHook, TicketCreate and AccountSet (a no-op)
+with Sequence or TicketSequence, LastLedgerSequence, fee and reserve checks, and hooks on the
+sending and receiving accounts, including the transactions they emit (applied first in the next
+ledger). Signatures aren't verified, cbak callbacks aren't run and Hook State entries count
+towards OwnerCount without being checked against the reserve.
+*/
+export class LocalLedger {
+  private readonly options: Required<Omit<LocalLedgerOptions, 'onTrace'>>
+  private readonly onTrace: ((line: string) => void) | undefined
+  private readonly closedLedgers: Ledger[] = []
+  private readonly transactions: Map<string, TransactionRecord> = new Map()
+  // terPRE_SEQ transactions by account, then by Sequence
+  private readonly held: Map<string, Map<number, PendingTransaction>> =
+    new Map()
+  private readonly runtimes: Map<string, HookRuntime> = new Map()
+  private readonly ledgerClosedListeners: Set<LedgerClosedListener> = new Set()
+  private emittedQueue: PendingTransaction[] = []
+  private openLedger: Ledger
+  // Copied on first write in the open ledger; the others are shared with closed ledgers
+  private ownedHookState: Set<Map<string, string>> = new Set()
+  private frozenTime: number | undefined
+  private clockOffsetSeconds = 0
+  private closeTimer: NodeJS.Timeout | undefined
+
+  constructor(options: LocalLedgerOptions = {}) {
+    this.options = {
+      networkId: options.networkId ?? 21338,
+      baseFeeDrops: options.baseFeeDrops ?? 10,
+      reserveBaseDrops: options.reserveBaseDrops ?? 10000000,
+      reserveIncrementDrops: options.reserveIncrementDrops ?? 2000000,
+      closeIntervalMs: options.closeIntervalMs ?? 0,
+      ledgerHistory: options.ledgerHistory ?? 256,
+    }
+    this.onTrace = options.onTrace
+
+    const genesisId = decodeAccountID(GENESIS_ADDRESS)
+    const genesis: AccountRoot = {
+      address: GENESIS_ADDRESS,
+      accountId: Buffer.from(genesisId),
+      balance: GENESIS_BALANCE_DROPS,
+      sequence: 1,
+      ownerCount: 0,
+      tickets: [],
+      hooks: [],
+      hookNamespaces: [],
+      previousTxnId: ZERO_HASH,
+      previousTxnLgrSeq: 0,
+    }
+    const ledger: Ledger = {
+      index: 1,
+      parentHash: ZERO_HASH,
+      hash: undefined,
+      closeTime: undefined,
+      state: {
+        accounts: new Map([[GENESIS_ADDRESS, genesis]]),
+        hookState: new Map(),
+      },
+      transactions: [],
+    }
+    this.openLedger = ledger
+    this.closeLedger()
+  }
+
+  get networkId(): number {
+    return this.options.networkId
+  }
+
+  get baseFeeDrops(): number {
+    return this.options.baseFeeDrops
+  }
+
+  get reserveBaseDrops(): number {
+    return this.options.reserveBaseDrops
+  }
+
+  get reserveIncrementDrops(): number {
+    return this.options.reserveIncrementDrops
+  }
+
+  get closeIntervalMs(): number {
+    return this.options.closeIntervalMs
+  }
+
+  get currentLedgerIndex(): number {
+    return this.openLedger.index
+  }
+
+  get validatedLedger(): Ledger {
+    return this.closedLedgers[this.closedLedgers.length - 1]
+  }
+
+  // The closed ledgers kept, as rippled's complete_ledgers range
+  get completeLedgers(): string {
+    return `${this.closedLedgers[0].index}-${this.validatedLedger.index}`
+  }
+
+  /**
+   * Starts closing ledgers every closeIntervalMs (if it isn't 0).
+   */
+  start(): void {
+    this.stop()
+    if (this.options.closeIntervalMs > 0) {
+      this.closeTimer = setInterval(
+        () => this.closeLedger(),
+        this.options.closeIntervalMs
+      )
+    }
+  }
+
+  stop(): void {
+    clearInterval(this.closeTimer)
+    this.closeTimer = undefined
+  }
+
+  setCloseInterval(closeIntervalMs: number): void {
+    this.options.closeIntervalMs = closeIntervalMs
+    if (this.closeTimer) {
+      this.start()
+    }
+  }
+
+  // Unix seconds of the ledger clock
+  now(): number {
+    return (
+      this.frozenTime ??
+      Math.floor(Date.now() / 1000) + this.clockOffsetSeconds
+    )
+  }
+
+  /**
+   * Stops the ledger clock at unixSeconds. Close times only move forward, so a time before the
+   * last close time applies to ledgers once the clock passed it.
+   */
+  setTime(unixSeconds: number): void {
+    this.frozenTime = unixSeconds
+  }
+
+  advanceTime(seconds: number): void {
+    if (this.frozenTime !== undefined) {
+      this.frozenTime += seconds
+    } else {
+      this.clockOffsetSeconds += seconds
+    }
+  }
+
+  onLedgerClosed(listener: LedgerClosedListener): () => void {
+    this.ledgerClosedListeners.add(listener)
+    return () => {
+      this.ledgerClosedListeners.delete(listener)
+    }
+  }
+
+  /**
+   * Closes (and validates) the open ledger, opens the next one with the transactions hooks
+   * emitted and notifies the ledger closed listeners.
+   */
+  closeLedger(): Ledger {
+    // Step 1. Close the open ledger
+    const closed = this.openLedger
+    const parent = this.closedLedgers[this.closedLedgers.length - 1]
+    closed.closeTime = Math.max(
+      this.now() - RIPPLE_EPOCH_OFFSET,
+      (parent?.closeTime ?? 0) + 1
+    )
+    const header = Buffer.alloc(8)
+    header.writeUInt32BE(closed.index)
+    header.writeUInt32BE(closed.closeTime, 4)
+    // Not rippled's ledger hash, but unique per ledger and chained the same way
+    closed.hash = sha512Half(
+      header,
+      Buffer.from(closed.parentHash, 'hex'),
+      ...closed.transactions.map((hash) => Buffer.from(hash, 'hex'))
+    )
+      .toString('hex')
+      .toUpperCase()
+    this.closedLedgers.push(closed)
+    while (this.closedLedgers.length > this.options.ledgerHistory) {
+      const dropped = this.closedLedgers.shift() as Ledger
+      for (const hash of dropped.transactions) {
+        this.transactions.delete(hash)
+      }
+    }
+
+    // Step 2. Open the next ledger on a copy of the closed state
+    this.openLedger = {
+      index: closed.index + 1,
+      parentHash: closed.hash,
+      hash: undefined,
+      closeTime: undefined,
+      state: {
+        accounts: new Map(closed.state.accounts),
+        hookState: new Map(closed.state.hookState),
+      },
+      transactions: [],
+    }
+    this.ownedHookState = new Set()
+    this._pruneHeld()
+
+    // Step 3. Apply what hooks emitted in the closed ledger
+    const emitted = this.emittedQueue
+    this.emittedQueue = []
+    for (const pending of emitted) {
+      this._apply(pending)
+    }
+
+    // Step 4. Notify
+    const transactions = closed.transactions.map(
+      (hash) => this.transactions.get(hash) as TransactionRecord
+    )
+    for (const listener of this.ledgerClosedListeners) {
+      try {
+        listener(closed, transactions)
+      } catch (error) {
+        console.error(`LedgerClosedListener failed: ${error}`)
+      }
+    }
+    return closed
+  }
+
+  /**
+   * Applies a (signed) transaction blob to the open ledger, like rippled's submit.
+   */
+  submit(txBlob: string): SubmitResult {
+    let tx: TransactionJson
+    try {
+      tx = decode(txBlob)
+    } catch (error) {
+      throw new LocalLedgerError(
+        'invalidTransaction',
+        `Transaction blob does not decode: ${error}`
+      )
+    }
+    const blob = Buffer.from(txBlob, 'hex')
+    const hash = hashTransactionBlob(blob)
+
+    const engineResult = this.transactions.has(hash)
+      ? 'tefALREADY'
+      : this._apply({ hash, blob, tx, emitted: false })
+    if (engineResult === 'terPRE_SEQ') {
+      let held = this.held.get(tx.Account)
+      if (!held) {
+        held = new Map()
+        this.held.set(tx.Account, held)
+      }
+      held.set(tx.Sequence, { hash, blob, tx, emitted: false })
+    }
+    const applied =
+      engineResult === 'tesSUCCESS' || engineResult.startsWith('tec')
+    if (applied) {
+      this._applyHeld(tx.Account)
+    }
+
+    const [engineResultCode, engineResultMessage] =
+      describeEngineResult(engineResult)
+    return {
+      engineResult,
+      engineResultCode,
+      engineResultMessage,
+      hash,
+      tx: { ...tx, hash },
+      applied,
+      queued: engineResult === 'terPRE_SEQ',
+    }
+  }
+
+  /**
+   * Pays drops from the genesis account to address, creating the account if needed.
+   */
+  fund(address: string, drops: bigint): SubmitResult {
+    const genesis = this.openLedger.state.accounts.get(
+      GENESIS_ADDRESS
+    ) as AccountRoot
+    const result = this.submit(
+      encode({
+        TransactionType: 'Payment',
+        Account: GENESIS_ADDRESS,
+        Destination: address,
+        Amount: drops.toString(),
+        Fee: String(this.options.baseFeeDrops),
+        Sequence: genesis.sequence,
+        NetworkID: this.options.networkId,
+        SigningPubKey: '',
+      })
+    )
+    if (result.engineResult !== 'tesSUCCESS') {
+      throw new Error(`Funding ${address} failed: ${result.engineResult}`)
+    }
+    return result
+  }
+
+  getLedger(ledgerIndex: LedgerSpecifier = 'current'): Ledger {
+    if (ledgerIndex === 'current') {
+      return this.openLedger
+    }
+    if (ledgerIndex === 'closed' || ledgerIndex === 'validated') {
+      return this.validatedLedger
+    }
+    if (ledgerIndex === this.openLedger.index) {
+      return this.openLedger
+    }
+    const oldest = this.closedLedgers[0].index
+    const ledger = this.closedLedgers[ledgerIndex - oldest]
+    if (!ledger) {
+      throw new LocalLedgerError('lgrNotFound', 'ledgerNotFound')
+    }
+    return ledger
+  }
+
+  getAccountRoot(address: string, ledger: Ledger): AccountRoot {
+    const account = ledger.state.accounts.get(address)
+    if (!account) {
+      throw new LocalLedgerError('actNotFound', 'Account not found.')
+    }
+    return account
+  }
+
+  // [key, data] pairs of a namespace, ordered by key
+  getHookStateEntries(
+    address: string,
+    namespace: string,
+    ledger: Ledger
+  ): [string, string][] {
+    const entries = ledger.state.hookState.get(
+      hookStateSpace(address, namespace.toUpperCase())
+    )
+    return entries ? [...entries].sort(([a], [b]) => a.localeCompare(b)) : []
+  }
+
+  getHookState(
+    address: string,
+    namespace: string,
+    key: string,
+    ledger: Ledger
+  ): string | undefined {
+    return ledger.state.hookState
+      .get(hookStateSpace(address, namespace.toUpperCase()))
+      ?.get(key.toUpperCase())
+  }
+
+  getTransaction(hash: string): TransactionRecord | undefined {
+    return this.transactions.get(hash.toUpperCase())
+  }
+
+  isValidated(record: TransactionRecord): boolean {
+    return record.ledgerIndex < this.openLedger.index
+  }
+
+  /**
+   * The fee a transaction needs: the base fee, plus the base fee again for each hook it runs.
+   */
+  getRequiredFee(txBlob: string): bigint {
+    const blob = Buffer.from(txBlob, 'hex')
+    const tx: TransactionJson = decode(txBlob)
+    const hooks = this._getHooksToRun(tx, blob, false, this.openLedger.state)
+    return BigInt(this.options.baseFeeDrops) * BigInt(1 + hooks.length)
+  }
+
+  private _reserve(ownerCount: number): bigint {
+    return (
+      BigInt(this.options.reserveBaseDrops) +
+      BigInt(this.options.reserveIncrementDrops) * BigInt(ownerCount)
+    )
+  }
+
+  // Hooks of the sending account (not for emitted transactions) and then the receiving account
+  private _getHooksToRun(
+    tx: TransactionJson,
+    blob: Buffer,
+    emitted: boolean,
+    state: LedgerState
+  ): { account: AccountRoot; hook: InstalledHook }[] {
+    const transactionType = transactionTypeCode(blob)
+    if (transactionType === undefined) {
+      return []
+    }
+    const addresses: string[] = emitted ? [] : [tx.Account]
+    if (typeof tx.Destination === 'string' && tx.Destination !== tx.Account) {
+      addresses.push(tx.Destination)
+    }
+    const hooks: { account: AccountRoot; hook: InstalledHook }[] = []
+    for (const address of addresses) {
+      const account = state.accounts.get(address)
+      for (const hook of account?.hooks ?? []) {
+        if (account && hook && hookFires(hook, transactionType)) {
+          hooks.push({ account, hook })
+        }
+      }
+    }
+    return hooks
+  }
+
+  /**
+   * Checks that can fail without claiming a fee (tem, tef, tel and ter results).
+   */
+  private _preflight(
+    pending: PendingTransaction,
+    account: AccountRoot | undefined,
+    hookChanges: HookChange[]
+  ): string | undefined {
+    const { tx, blob, emitted } = pending
+    if (!emitted) {
+      if (tx.NetworkID === undefined) {
+        return 'telREQUIRES_NETWORK_ID'
+      }
+      if (tx.NetworkID !== this.options.networkId) {
+        return 'telWRONG_NETWORK'
+      }
+    }
+    if (!isDrops(tx.Fee)) {
+      return 'temBAD_FEE'
+    }
+
+    switch (tx.TransactionType) {
+      case 'Payment':
+        if (!isDrops(tx.Amount) || BigInt(tx.Amount) === 0n) {
+          return 'temBAD_AMOUNT'
+        }
+        if (typeof tx.Destination !== 'string') {
+          return 'temMALFORMED'
+        }
+        if (tx.Destination === tx.Account) {
+          return 'temREDUNDANT'
+        }
+        break
+      case 'TicketCreate':
+        if (
+          !(tx.TicketCount >= 1) ||
+          tx.TicketCount > TICKETS_PER_TRANSACTION_MAX
+        ) {
+          return 'temMALFORMED'
+        }
+        break
+      case 'SetHook': {
+        const hooks: TransactionJson[] = tx.Hooks ?? []
+        if (hooks.length === 0 || hooks.length > HOOKS_MAX) {
+          return 'temMALFORMED'
+        }
+        for (const { Hook } of hooks) {
+          try {
+            hookChanges.push(this._parseHook(Hook ?? {}))
+          } catch (error) {
+            return 'temMALFORMED'
+          }
+        }
+        break
+      }
+      case 'Invoke':
+      case 'AccountSet':
+        break
+      default:
+        return 'temDISABLED'
+    }
+
+    if (!account) {
+      return 'terNO_ACCOUNT'
+    }
+    if (
+      tx.LastLedgerSequence !== undefined &&
+      tx.LastLedgerSequence < this.openLedger.index
+    ) {
+      return 'tefMAX_LEDGER'
+    }
+    const fee = BigInt(tx.Fee)
+    if (!emitted) {
+      const required =
+        BigInt(this.options.baseFeeDrops) *
+        BigInt(
+          1 +
+            this._getHooksToRun(tx, blob, false, this.openLedger.state).length
+        )
+      if (fee < required) {
+        return 'telINSUF_FEE_P'
+      }
+      if (tx.TicketSequence !== undefined) {
+        if (!account.tickets.includes(tx.TicketSequence)) {
+          return tx.TicketSequence >= account.sequence
+            ? 'terPRE_TICKET'
+            : 'tefNO_TICKET'
+        }
+      } else if (tx.Sequence < account.sequence) {
+        return 'tefPAST_SEQ'
+      } else if (tx.Sequence > account.sequence) {
+        return 'terPRE_SEQ'
+      }
+    }
+    if (fee > account.balance) {
+      return 'terINSUF_FEE_B'
+    }
+    return undefined
+  }
+
+  private _parseHook(hook: TransactionJson): HookChange {
+    if (hook.CreateCode === undefined) {
+      return 'keep'
+    }
+    if (hook.CreateCode === '') {
+      return 'delete'
+    }
+    const wasm = Buffer.from(hook.CreateCode, 'hex')
+    const hookHash = sha512Half(wasm).toString('hex').toUpperCase()
+    let runtime = this.runtimes.get(hookHash)
+    if (!runtime) {
+      runtime = new HookRuntime(wasm)
+      this.runtimes.set(hookHash, runtime)
+    }
+    return {
+      hookHash,
+      hookOn: BigInt(`0x${hook.HookOn ?? ZERO_HASH}`),
+      namespace: (hook.HookNamespace ?? ZERO_HASH).toUpperCase(),
+      runtime,
+    }
+  }
+
+  /**
+   * Applies a transaction to the open ledger. tes and tec results are recorded (a tec only claims
+   * the fee and the sequence or ticket); other results leave the ledger untouched.
+   */
+  private _apply(pending: PendingTransaction): string {
+    const { hash, blob, tx, emitted } = pending
+    const state = this.openLedger.state
+    const ledgerIndex = this.openLedger.index
+    const { closeTime, hash: lastHash } = this.validatedLedger
+
+    // Step 1. Checks that don't claim a fee
+    const hookChanges: HookChange[] = []
+    const account = state.accounts.get(tx.Account)
+    const preflightResult = this._preflight(pending, account, hookChanges)
+    if (preflightResult || !account) {
+      return preflightResult ?? 'terNO_ACCOUNT'
+    }
+
+    // Step 2. Claim the fee and the sequence or ticket
+    const before: Map<string, AccountRoot | undefined> = new Map()
+    const draft: Map<string, AccountRoot> = new Map()
+    const getAccount = (address: string) =>
+      draft.get(address) ?? state.accounts.get(address)
+    const setAccount = (updated: AccountRoot) => {
+      if (!before.has(updated.address)) {
+        before.set(updated.address, state.accounts.get(updated.address))
+      }
+      draft.set(updated.address, updated)
+    }
+    const usesTicket = tx.TicketSequence !== undefined
+    const claimed: AccountRoot = {
+      ...account,
+      balance: account.balance - BigInt(tx.Fee),
+      sequence:
+        usesTicket || emitted ? account.sequence : account.sequence + 1,
+      tickets: usesTicket
+        ? account.tickets.filter((ticket) => ticket !== tx.TicketSequence)
+        : account.tickets,
+      ownerCount: usesTicket ? account.ownerCount - 1 : account.ownerCount,
+    }
+    setAccount(claimed)
+    const createdTickets: number[] = []
+
+    // Step 3. The transaction's own effects
+    let engineResult = this._applyEffects(
+      tx,
+      claimed,
+      hookChanges,
+      createdTickets,
+      getAccount,
+      setAccount
+    )
+
+    // Step 4. Hooks, which can reject the transaction
+    const hookExecutions: TransactionJson[] = []
+    const hookEmissions: TransactionJson[] = []
+    const stateChanges: Map<string, Map<string, Buffer | undefined>> =
+      new Map()
+    const emittedBlobs: Buffer[] = []
+    if (engineResult === 'tesSUCCESS') {
+      const hooks = this._getHooksToRun(tx, blob, emitted, state)
+      for (const { account: hookAccount, hook } of hooks) {
+        const space = hookStateSpace(hookAccount.address, hook.namespace)
+        const changes = stateChanges.get(space) ?? new Map()
+        const result = hook.runtime.execute({
+          otxnBlob: blob,
+          otxnId: Buffer.from(hash, 'hex'),
+          hookAccountId: hookAccount.accountId,
+          ledgerSeq: ledgerIndex,
+          ledgerLastTime: closeTime as number,
+          ledgerLastHash: Buffer.from(lastHash as string, 'hex'),
+          baseFeeDrops: BigInt(this.options.baseFeeDrops),
+          readState: (key) => {
+            const hexKey = key.toString('hex').toUpperCase()
+            if (changes.has(hexKey)) {
+              return changes.get(hexKey)
+            }
+            const data = state.hookState.get(space)?.get(hexKey)
+            return data === undefined ? undefined : Buffer.from(data, 'hex')
+          },
+          trace:
+            this.onTrace &&
+            ((line) =>
+              this.onTrace?.(`HookTrace[${hookAccount.address}]: ${line}`)),
+        })
+
+        hookExecutions.push({
+          HookExecution: {
+            HookAccount: hookAccount.address,
+            HookEmitCount: result.emitted.length,
+            HookExecutionIndex: hookExecutions.length,
+            HookHash: hook.hookHash,
+            HookInstructionCount: result.guardCalls.toString(16),
+            HookResult: HOOK_RESULTS[result.exitType],
+            HookReturnCode: hookReturnCodeHex(result.returnCode),
+            HookReturnString: result.returnString
+              .toString('hex')
+              .toUpperCase(),
+            HookStateChangeCount: result.stateChanges.size,
+          },
+        })
+        if (result.exitType !== 'accept') {
+          engineResult = 'tecHOOK_REJECTED'
+          break
+        }
+        for (const [key, data] of result.stateChanges) {
+          changes.set(key, data)
+        }
+        stateChanges.set(space, changes)
+        for (const emittedBlob of result.emitted) {
+          emittedBlobs.push(emittedBlob)
+          hookEmissions.push({
+            HookEmission: {
+              EmittedTxnID: hashTransactionBlob(emittedBlob),
+              HookAccount: hookAccount.address,
+              HookHash: hook.hookHash,
+            },
+          })
+        }
+      }
+    }
+
+    // Step 5. A tec keeps only the fee and the sequence or ticket
+    if (engineResult !== 'tesSUCCESS') {
+      draft.clear()
+      before.clear()
+      setAccount(claimed)
+      createdTickets.length = 0
+      stateChanges.clear()
+      emittedBlobs.length = 0
+      hookEmissions.length = 0
+    }
+
+    // Step 6. Commit Hook State, accounts and the transaction
+    const affectedNodes: AffectedNode[] = []
+    for (const [space, changes] of stateChanges) {
+      this._commitHookState(
+        space,
+        changes,
+        getAccount,
+        setAccount,
+        affectedNodes
+      )
+    }
+    for (const [address, updated] of draft) {
+      const touched = {
+        ...updated,
+        previousTxnId: hash,
+        previousTxnLgrSeq: ledgerIndex,
+      }
+      state.accounts.set(address, touched)
+      affectedNodes.push(this._accountNode(before.get(address), touched))
+    }
+    for (const ticketSequence of createdTickets) {
+      affectedNodes.push({
+        CreatedNode: {
+          LedgerEntryType: 'Ticket',
+          LedgerIndex: ticketIndex(account.accountId, ticketSequence),
+          NewFields: {
+            Account: account.address,
+            TicketSequence: ticketSequence,
+          },
+        },
+      })
+    }
+    if (usesTicket) {
+      affectedNodes.push({
+        DeletedNode: {
+          LedgerEntryType: 'Ticket',
+          LedgerIndex: ticketIndex(account.accountId, tx.TicketSequence),
+          FinalFields: {
+            Account: account.address,
+            Flags: 0,
+            TicketSequence: tx.TicketSequence,
+          },
+        },
+      })
+    }
+    affectedNodes.sort((a, b) =>
+      (Object.values(a)[0].LedgerIndex as string).localeCompare(
+        Object.values(b)[0].LedgerIndex
+      )
+    )
+
+    const meta: TransactionJson = {
+      AffectedNodes: affectedNodes,
+      TransactionIndex: this.openLedger.transactions.length,
+      TransactionResult: engineResult,
+    }
+    if (hookExecutions.length > 0) {
+      meta.HookExecutions = hookExecutions
+    }
+    if (hookEmissions.length > 0) {
+      meta.HookEmissions = hookEmissions
+    }
+    if (tx.TransactionType === 'Payment' && engineResult === 'tesSUCCESS') {
+      meta.delivered_amount = tx.Amount
+    }
+    this.openLedger.transactions.push(hash)
+    this.transactions.set(hash, {
+      hash,
+      tx: { ...tx, hash },
+      engineResult,
+      meta,
+      ledgerIndex,
+    })
+    for (const emittedBlob of emittedBlobs) {
+      this.emittedQueue.push({
+        hash: hashTransactionBlob(emittedBlob),
+        blob: emittedBlob,
+        tx: decode(emittedBlob.toString('hex')),
+        emitted: true,
+      })
+    }
+    return engineResult
+  }
+
+  private _applyEffects(
+    tx: TransactionJson,
+    claimed: AccountRoot,
+    hookChanges: HookChange[],
+    createdTickets: number[],
+    getAccount: (address: string) => AccountRoot | undefined,
+    setAccount: (account: AccountRoot) => void
+  ): string {
+    switch (tx.TransactionType) {
+      case 'Payment': {
+        const amount = BigInt(tx.Amount)
+        if (claimed.balance - amount < this._reserve(claimed.ownerCount)) {
+          return 'tecUNFUNDED_PAYMENT'
+        }
+        const destination = getAccount(tx.Destination)
+        if (!destination && amount < BigInt(this.options.reserveBaseDrops)) {
+          return 'tecNO_DST_INSUFF_XRP'
+        }
+        setAccount({ ...claimed, balance: claimed.balance - amount })
+        setAccount(
+          destination
+            ? { ...destination, balance: destination.balance + amount }
+            : {
+                address: tx.Destination,
+                accountId: Buffer.from(decodeAccountID(tx.Destination)),
+                balance: amount,
+                // New accounts start at the ledger index, like rippled's since DeletableAccounts
+                sequence: this.openLedger.index,
+                ownerCount: 0,
+                tickets: [],
+                hooks: [],
+                hookNamespaces: [],
+                previousTxnId: ZERO_HASH,
+                previousTxnLgrSeq: 0,
+              }
+        )
+        return 'tesSUCCESS'
+      }
+      case 'TicketCreate': {
+        const ownerCount = claimed.ownerCount + tx.TicketCount
+        if (claimed.balance < this._reserve(ownerCount)) {
+          return 'tecINSUFFICIENT_RESERVE'
+        }
+        for (let i = 0; i < tx.TicketCount; i++) {
+          createdTickets.push(claimed.sequence + i)
+        }
+        setAccount({
+          ...claimed,
+          sequence: claimed.sequence + tx.TicketCount,
+          tickets: [...claimed.tickets, ...createdTickets],
+          ownerCount,
+        })
+        return 'tesSUCCESS'
+      }
+      case 'SetHook': {
+        const hooks = [...claimed.hooks]
+        let ownerCount = claimed.ownerCount
+        hookChanges.forEach((change, position) => {
+          if (change === 'keep') {
+            return
+          }
+          ownerCount +=
+            (change === 'delete' ? 0 : 1) - (hooks[position] ? 1 : 0)
+          hooks[position] = change === 'delete' ? undefined : change
+        })
+        if (claimed.balance < this._reserve(ownerCount)) {
+          return 'tecINSUFFICIENT_RESERVE'
+        }
+        setAccount({ ...claimed, hooks, ownerCount })
+        return 'tesSUCCESS'
+      }
+      default:
+        return 'tesSUCCESS'
+    }
+  }
+
+  private _commitHookState(
+    space: string,
+    changes: Map<string, Buffer | undefined>,
+    getAccount: (address: string) => AccountRoot | undefined,
+    setAccount: (account: AccountRoot) => void,
+    affectedNodes: AffectedNode[]
+  ): void {
+    const [address, namespace] = space.split(':')
+    const hookState = this.openLedger.state.hookState
+    let entries = hookState.get(space)
+    if (!entries || !this.ownedHookState.has(entries)) {
+      entries = new Map(entries)
+      hookState.set(space, entries)
+      this.ownedHookState.add(entries)
+    }
+
+    let account = getAccount(address) as AccountRoot
+    let ownerCount = account.ownerCount
+    for (const [key, value] of changes) {
+      const previous = entries.get(key)
+      const data = value?.toString('hex').toUpperCase()
+      const LedgerIndex = hookStateIndex(
+        account.accountId,
+        Buffer.from(key, 'hex'),
+        Buffer.from(namespace, 'hex')
+      )
+      if (data === undefined) {
+        if (previous === undefined) {
+          continue
+        }
+        entries.delete(key)
+        ownerCount--
+        affectedNodes.push({
+          DeletedNode: {
+            LedgerEntryType: 'HookState',
+            LedgerIndex,
+            FinalFields: {
+              Flags: 0,
+              HookStateData: previous,
+              HookStateKey: key,
+              OwnerNode: '0',
+            },
+          },
+        })
+      } else if (previous === undefined) {
+        entries.set(key, data)
+        ownerCount++
+        affectedNodes.push({
+          CreatedNode: {
+            LedgerEntryType: 'HookState',
+            LedgerIndex,
+            NewFields: {
+              HookStateData: data,
+              HookStateKey: key,
+              OwnerNode: '0',
+            },
+          },
+        })
+      } else if (previous !== data) {
+        entries.set(key, data)
+        affectedNodes.push({
+          ModifiedNode: {
+            LedgerEntryType: 'HookState',
+            LedgerIndex,
+            FinalFields: {
+              Flags: 0,
+              HookStateData: data,
+              HookStateKey: key,
+              OwnerNode: '0',
+            },
+            PreviousFields: { HookStateData: previous },
+          },
+        })
+      }
+    }
+
+    if (entries.size === 0) {
+      hookState.delete(space)
+    }
+    const hookNamespaces = account.hookNamespaces.filter(
+      (hookNamespace) => hookNamespace !== namespace
+    )
+    if (entries.size > 0) {
+      hookNamespaces.push(namespace)
+    }
+    account = { ...account, ownerCount, hookNamespaces }
+    setAccount(account)
+  }
+
+  private _accountNode(
+    previous: AccountRoot | undefined,
+    account: AccountRoot
+  ): AffectedNode {
+    const LedgerIndex = accountRootIndex(account.accountId)
+    if (!previous) {
+      return {
+        CreatedNode: {
+          LedgerEntryType: 'AccountRoot',
+          LedgerIndex,
+          NewFields: {
+            Account: account.address,
+            Balance: account.balance.toString(),
+            Sequence: account.sequence,
+          },
+        },
+      }
+    }
+    const previousFields: TransactionJson = {}
+    if (previous.balance !== account.balance) {
+      previousFields.Balance = previous.balance.toString()
+    }
+    if (previous.sequence !== account.sequence) {
+      previousFields.Sequence = previous.sequence
+    }
+    if (previous.ownerCount !== account.ownerCount) {
+      previousFields.OwnerCount = previous.ownerCount
+    }
+    const finalFields = accountRootJson(account)
+    delete finalFields.LedgerEntryType
+    delete finalFields.PreviousTxnID
+    delete finalFields.PreviousTxnLgrSeq
+    delete finalFields.index
+    return {
+      ModifiedNode: {
+        LedgerEntryType: 'AccountRoot',
+        LedgerIndex,
+        FinalFields: finalFields,
+        PreviousFields: previousFields,
+        PreviousTxnID: previous.previousTxnId,
+        PreviousTxnLgrSeq: previous.previousTxnLgrSeq,
+      },
+    }
+  }
+
+  // Applies held transactions that the account's new Sequence made applicable
+  private _applyHeld(address: string): void {
+    const held = this.held.get(address)
+    let account = this.openLedger.state.accounts.get(address)
+    while (held && account) {
+      const next = held.get(account.sequence)
+      if (!next) {
+        break
+      }
+      held.delete(account.sequence)
+      this._apply(next)
+      const applied = this.openLedger.state.accounts.get(address)
+      if (applied?.sequence === account.sequence) {
+        break
+      }
+      account = applied
+    }
+    if (held?.size === 0) {
+      this.held.delete(address)
+    }
+  }
+
+  private _pruneHeld(): void {
+    for (const [address, held] of this.held) {
+      for (const [sequence, { tx }] of held) {
+        if (
+          tx.LastLedgerSequence !== undefined &&
+          tx.LastLedgerSequence < this.openLedger.index
+        ) {
+          held.delete(sequence)
+        }
+      }
+      if (held.size === 0) {
+        this.held.delete(address)
+      }
+    }
+  }
+}
@@ -0,0 +1,244 @@
+import axios from 'axios'
+import { encode } from 'ripple-binary-codec'
+import { WebSocket } from 'ws'
+import {
+  assembleTestHook,
+  DROP,
+  i32Const,
+  i64Const,
+} from './assembleTestHook'
+import { LocalLedger, RIPPLE_EPOCH_OFFSET } from './LocalLedger'
+import { LocalLedgerServer } from './LocalLedgerServer'
+
+const HOOK_ACCOUNT = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+const BACKER = 'rPT1Sjq2YGrBMTttX4GZHjKu9dyfzbpAYe'
+const NAMESPACE = 'AB'.repeat(32)
+const STATE_KEY = '6B'.padStart(64, '0')
+
+// Writes 'v' under key 'k' on every Payment
+const stateHook = assembleTestHook(
+  ['state_set', 'accept'],
+  (call) => [
+    ...[...i32Const(200), ...i32Const(1), ...i32Const(100), ...i32Const(1)],
+    ...[...call('state_set'), ...DROP],
+    ...[...i32Const(0), ...i32Const(0), ...i64Const(0)],
+    ...[...call('accept'), ...DROP, ...i64Const(0)],
+  ],
+  { data: [[100, Buffer.from('k')], [200, Buffer.from('v')]] }
+)
+
+// A WebSocket client that keeps the stream messages it receives
+class TestClient {
+  readonly streamMessages: Record<string, any>[] = []
+  private readonly socket: WebSocket
+  private readonly pending: Map<number, (message: any) => void> = new Map()
+  private nextId = 1
+
+  constructor(url: string) {
+    this.socket = new WebSocket(url)
+    this.socket.on('message', (data) => {
+      const message = JSON.parse(data.toString())
+      if (message.type === 'response') {
+        this.pending.get(message.id)?.(message)
+        this.pending.delete(message.id)
+      } else {
+        this.streamMessages.push(message)
+      }
+    })
+  }
+
+  open(): Promise<void> {
+    return new Promise((resolve) => this.socket.once('open', () => resolve()))
+  }
+
+  close(): void {
+    this.socket.close()
+  }
+
+  request(command: string, params: Record<string, unknown> = {}) {
+    const id = this.nextId++
+    return new Promise<Record<string, any>>((resolve) => {
+      this.pending.set(id, resolve)
+      this.socket.send(JSON.stringify({ id, command, ...params }))
+    })
+  }
+}
+
+describe('LocalLedgerServer', () => {
+  let ledger: LocalLedger
+  let server: LocalLedgerServer
+  let client: TestClient
+
+  // Signatures aren't checked, so unsigned blobs are accepted
+  async function submit(tx: Record<string, unknown>) {
+    const { result } = await client.request('account_info', {
+      account: tx.Account,
+      ledger_index: 'current',
+    })
+    const txBlob = encode({
+      Sequence: result.account_data.Sequence,
+      Fee: '20',
+      NetworkID: ledger.networkId,
+      SigningPubKey: '',
+      ...tx,
+    })
+    return client.request('submit', { tx_blob: txBlob })
+  }
+
+  beforeEach(async () => {
+    ledger = new LocalLedger()
+    server = new LocalLedgerServer(ledger, { port: 0 })
+    await server.listen()
+    client = new TestClient(server.url)
+    await client.open()
+  })
+
+  afterEach(async () => {
+    client.close()
+    await server.close()
+  })
+
+  it('should fund accounts from the faucet', async () => {
+    const { data } = await axios.post(server.faucetUrl)
+
+    expect(data.balance).toBe(10000)
+    await client.request('ledger_accept')
+    const { result } = await client.request('account_info', {
+      account: data.account.classicAddress,
+      ledger_index: 'validated',
+    })
+    expect(result.account_data.Balance).toBe('10000000000')
+    expect(result.validated).toBe(true)
+  })
+
+  it('should answer with rippled errors', async () => {
+    const response = await client.request('account_info', {
+      account: BACKER,
+      ledger_index: 'validated',
+    })
+    expect(response).toMatchObject({ status: 'error', error: 'actNotFound' })
+
+    const unknown = await client.request('path_find')
+    expect(unknown.error).toBe('unknownCmd')
+  })
+
+  it('should run hooks on submitted transactions and serve their Hook State', async () => {
+    ledger.fund(HOOK_ACCOUNT, 1000000000n)
+    ledger.fund(BACKER, 1000000000n)
+    ledger.closeLedger()
+    const setHook = await submit({
+      TransactionType: 'SetHook',
+      Account: HOOK_ACCOUNT,
+      Hooks: [
+        {
+          Hook: {
+            CreateCode: stateHook.toString('hex'),
+            HookOn: 'F'.repeat(58) + 'BFFFFE',
+            HookNamespace: NAMESPACE,
+            Flags: 1,
+            HookApiVersion: 0,
+          },
+        },
+      ],
+    })
+    expect(setHook.result.engine_result).toBe('tesSUCCESS')
+
+    const { result: fee } = await client.request('fee', {
+      tx_blob: encode({
+        TransactionType: 'Payment',
+        Account: BACKER,
+        Destination: HOOK_ACCOUNT,
+        Amount: '100',
+        Fee: '0',
+        Sequence: 0,
+        SigningPubKey: '',
+      }),
+    })
+    expect(fee.drops.base_fee).toBe('20')
+
+    const payment = await submit({
+      TransactionType: 'Payment',
+      Account: BACKER,
+      Destination: HOOK_ACCOUNT,
+      Amount: '100',
+    })
+    expect(payment.result).toMatchObject({
+      engine_result: 'tesSUCCESS',
+      applied: true,
+    })
+
+    const namespaceRequest = {
+      account: HOOK_ACCOUNT,
+      namespace_id: NAMESPACE,
+      ledger_index: 'validated',
+    }
+    const { result: namespace } = await client.request(
+      'account_namespace',
+      namespaceRequest
+    )
+    // Not validated until the ledger closes
+    expect(namespace.namespace_entries).toEqual([])
+
+    await client.request('ledger_accept')
+
+    const { result: closed } = await client.request(
+      'account_namespace',
+      namespaceRequest
+    )
+    expect(closed.namespace_entries).toMatchObject([
+      { HookStateKey: STATE_KEY, HookStateData: '76' },
+    ])
+    const { result: entry } = await client.request('ledger_entry', {
+      hook_state: {
+        account: HOOK_ACCOUNT,
+        key: '6B',
+        namespace_id: NAMESPACE,
+      },
+      ledger_index: 'validated',
+    })
+    expect(entry.node.HookStateData).toBe('76')
+    const { result: tx } = await client.request('tx', {
+      transaction: payment.result.tx_json.hash,
+    })
+    expect(tx.validated).toBe(true)
+    expect(tx.meta.HookExecutions).toHaveLength(1)
+  })
+
+  it('should stream the closed ledger before its transactions', async () => {
+    const subscribed = await client.request('subscribe', {
+      streams: ['ledger'],
+      accounts: [BACKER],
+    })
+    expect(subscribed.result.ledger_index).toBe(ledger.validatedLedger.index)
+    ledger.fund(BACKER, 1000000000n)
+
+    await client.request('ledger_accept')
+    await client.request('ping')
+
+    expect(client.streamMessages).toMatchObject([
+      {
+        type: 'ledgerClosed',
+        ledger_index: subscribed.result.ledger_index + 1,
+      },
+      { type: 'transaction', engine_result: 'tesSUCCESS', validated: true },
+    ])
+  })
+
+  it('should let tests control the ledger clock', async () => {
+    const { result } = await client.request('local_clock', {
+      set_time: 2000000000,
+      close_interval_ms: 0,
+    })
+    expect(result).toEqual({ time: 2000000000, close_interval_ms: 0 })
+
+    await client.request('local_clock', { advance_seconds: 30 })
+    await client.request('ledger_accept')
+
+    const { result: closed } = await client.request('ledger', {
+      ledger_index: 'validated',
+    })
+    expect(closed.ledger.close_time).toBe(
+      2000000030 - RIPPLE_EPOCH_OFFSET
+    )
+  })
+})
@@ -0,0 +1,674 @@
+import http from 'http'
+import { AddressInfo } from 'net'
+import { isValidClassicAddress } from 'ripple-address-codec'
+import { RawData, WebSocket, WebSocketServer } from 'ws'
+import { Wallet } from 'xrpl'
+import {
+  accountRootJson,
+  describeEngineResult,
+  hookStateJson,
+  Ledger,
+  LedgerSpecifier,
+  LocalLedger,
+  LocalLedgerError,
+  RIPPLE_EPOCH_OFFSET,
+  TransactionJson,
+  TransactionRecord,
+} from './LocalLedger'
+
+const ACCOUNT_NAMESPACE_LIMIT_DEFAULT = 200
+const ACCOUNT_NAMESPACE_LIMIT_MAX = 400
+const DROPS_PER_XRP = 1000000n
+
+type RpcRequest = Record<string, any>
+
+type RpcHandler = (
+  request: RpcRequest,
+  socket: WebSocket | undefined
+) => Record<string, unknown>
+
+interface Subscription {
+  ledger: boolean
+  transactions: boolean
+  accounts: Set<string>
+}
+
+export interface LocalLedgerServerOptions {
+  port?: number
+  host?: string
+  // Paid to each account the faucet creates or funds
+  faucetDrops?: bigint
+}
+
+function requireParam(request: RpcRequest, name: string): any {
+  if (request[name] === undefined) {
+    throw new LocalLedgerError('invalidParams', `Missing field '${name}'.`)
+  }
+  return request[name]
+}
+
+function requireAccount(request: RpcRequest, name = 'account'): string {
+  const account = requireParam(request, name)
+  if (typeof account !== 'string' || !isValidClassicAddress(account)) {
+    throw new LocalLedgerError('actMalformed', 'Account malformed.')
+  }
+  return account
+}
+
+function requireHash(request: RpcRequest, name: string): string {
+  const hash = requireParam(request, name)
+  if (typeof hash !== 'string' || !/^[0-9a-fA-F]{1,64}$/.test(hash)) {
+    throw new LocalLedgerError('invalidParams', `Invalid field '${name}'.`)
+  }
+  return hash.toUpperCase().padStart(64, '0')
+}
+
+function parseLedgerSpecifier(
+  value: unknown,
+  fallback: LedgerSpecifier
+): LedgerSpecifier {
+  if (value === undefined) {
+    return fallback
+  }
+  if (value === 'current' || value === 'closed' || value === 'validated') {
+    return value
+  }
+  const ledgerIndex = Number(value)
+  if (!Number.isInteger(ledgerIndex) || ledgerIndex <= 0) {
+    throw new LocalLedgerError('invalidParams', 'ledgerIndexMalformed')
+  }
+  return ledgerIndex
+}
+
+// ledger_index or ledger_current_index, the way rippled reports which ledger it read
+function ledgerFields(ledger: Ledger): Record<string, unknown> {
+  return ledger.hash === undefined
+    ? { ledger_current_index: ledger.index, validated: false }
+    : { ledger_hash: ledger.hash, ledger_index: ledger.index, validated: true }
+}
+
+/*
+Serves a LocalLedger over WebSocket and HTTP like a rippled node, for running the client, the
+integration tests and load tests against it (XRPL_ENDPOINTS=ws://127.0.0.1:<port>).
+
+Commands are the subset the client uses: submit, tx, account_info, account_namespace,
+ledger_entry (hook_state), fee, server_info, server_state, ledger, ping, and subscribe/unsubscribe
+to the ledger, transactions and accounts streams. Besides those:
+- ledger_accept closes the open ledger, like rippled in standalone mode
+- local_clock sets (set_time, Unix seconds) or advances (advance_seconds) the ledger clock and
+  changes the close interval (close_interval_ms, 0 to close only on ledger_accept)
+
+HTTP serves the same commands as JSON-RPC (POST / with method and params), and a faucet like the
+Hooks Testnet's: POST /accounts funds a new account, POST /accounts?account=<address> an existing
+address.
+*/
+export class LocalLedgerServer {
+  readonly ledger: LocalLedger
+  private readonly options: Required<LocalLedgerServerOptions>
+  private readonly httpServer: http.Server
+  private readonly webSocketServer: WebSocketServer
+  private readonly subscriptions: Map<WebSocket, Subscription> = new Map()
+  private readonly handlers: Record<string, RpcHandler>
+  private removeLedgerClosedListener: (() => void) | undefined
+
+  constructor(ledger: LocalLedger, options: LocalLedgerServerOptions = {}) {
+    this.ledger = ledger
+    this.options = {
+      port: options.port ?? 6006,
+      host: options.host ?? '127.0.0.1',
+      faucetDrops: options.faucetDrops ?? 10000n * DROPS_PER_XRP,
+    }
+    this.handlers = {
+      account_info: this._accountInfo,
+      account_namespace: this._accountNamespace,
+      fee: this._fee,
+      ledger: this._ledger,
+      ledger_accept: this._ledgerAccept,
+      ledger_entry: this._ledgerEntry,
+      local_clock: this._localClock,
+      ping: () => ({}),
+      server_info: this._serverInfo,
+      server_state: this._serverState,
+      submit: this._submit,
+      subscribe: this._subscribe,
+      tx: this._tx,
+      unsubscribe: this._unsubscribe,
+    }
+
+    this.httpServer = http.createServer((request, response) =>
+      this._onHttpRequest(request, response)
+    )
+    this.webSocketServer = new WebSocketServer({ server: this.httpServer })
+    this.webSocketServer.on('connection', (socket) => {
+      socket.on('message', (data) => this._onMessage(socket, data))
+      socket.on('close', () => this.subscriptions.delete(socket))
+    })
+  }
+
+  get url(): string {
+    const { port } = this.httpServer.address() as AddressInfo
+    return `ws://${this.options.host}:${port}`
+  }
+
+  get faucetUrl(): string {
+    const { port } = this.httpServer.address() as AddressInfo
+    return `http://${this.options.host}:${port}/accounts`
+  }
+
+  async listen(): Promise<void> {
+    this.removeLedgerClosedListener = this.ledger.onLedgerClosed(
+      (ledger, transactions) => this._publish(ledger, transactions)
+    )
+    await new Promise<void>((resolve, reject) => {
+      this.httpServer.once('error', reject)
+      this.httpServer.listen(this.options.port, this.options.host, () => {
+        this.httpServer.off('error', reject)
+        resolve()
+      })
+    })
+  }
+
+  async close(): Promise<void> {
+    this.removeLedgerClosedListener?.()
+    for (const socket of this.webSocketServer.clients) {
+      socket.terminate()
+    }
+    await new Promise<void>((resolve) =>
+      this.webSocketServer.close(() => resolve())
+    )
+    await new Promise<void>((resolve) => this.httpServer.close(() => resolve()))
+  }
+
+  /**
+   * Runs a command the way both transports answer it: the result, or an error response body.
+   */
+  handle(
+    request: RpcRequest,
+    socket?: WebSocket
+  ): { result: Record<string, unknown> } | Record<string, unknown> {
+    const handler = this.handlers[request.command]
+    if (!handler) {
+      return {
+        error: 'unknownCmd',
+        error_message: 'Unknown method.',
+        request,
+      }
+    }
+    try {
+      return { result: handler(request, socket) }
+    } catch (error) {
+      if (error instanceof LocalLedgerError) {
+        return { error: error.error, error_message: error.message, request }
+      }
+      console.error(`LocalLedgerServer ${request.command} failed: ${error}`)
+      return {
+        error: 'internal',
+        error_message: `${error}`,
+        request,
+      }
+    }
+  }
+
+  private _onMessage(socket: WebSocket, data: RawData): void {
+    let request: RpcRequest
+    try {
+      request = JSON.parse(data.toString())
+    } catch {
+      this._send(socket, {
+        type: 'response',
+        status: 'error',
+        error: 'invalidParams',
+        error_message: 'Unable to parse request.',
+      })
+      return
+    }
+    const response = this.handle(request, socket)
+    this._send(socket, {
+      id: request.id,
+      type: 'response',
+      status: 'result' in response ? 'success' : 'error',
+      ...response,
+    })
+  }
+
+  private _send(socket: WebSocket, message: Record<string, unknown>): void {
+    if (socket.readyState === WebSocket.OPEN) {
+      socket.send(JSON.stringify(message))
+    }
+  }
+
+  private _onHttpRequest(
+    request: http.IncomingMessage,
+    response: http.ServerResponse
+  ): void {
+    const chunks: Buffer[] = []
+    request.on('data', (chunk: Buffer) => chunks.push(chunk))
+    request.on('end', () => {
+      const url = new URL(request.url ?? '/', 'http://localhost')
+      let status = 200
+      let body: Record<string, unknown>
+      if (request.method !== 'POST') {
+        status = 405
+        body = { error: 'Only POST is supported' }
+      } else if (url.pathname === '/accounts') {
+        try {
+          body = this._faucet(url.searchParams.get('account') ?? undefined)
+        } catch (error) {
+          body = { error: `${error instanceof Error ? error.message : error}` }
+        }
+      } else if (url.pathname === '/') {
+        body = this._jsonRpc(Buffer.concat(chunks).toString())
+      } else {
+        status = 404
+        body = { error: `Not found: ${url.pathname}` }
+      }
+      response.writeHead(status, { 'Content-Type': 'application/json' })
+      response.end(JSON.stringify(body))
+    })
+  }
+
+  private _jsonRpc(body: string): Record<string, unknown> {
+    let method: string | undefined
+    let params: RpcRequest = {}
+    try {
+      const parsed = JSON.parse(body)
+      method = parsed.method
+      params = parsed.params?.[0] ?? {}
+    } catch {
+      method = undefined
+    }
+    const response = this.handle({ ...params, command: method })
+    return 'result' in response
+      ? { result: { ...response.result, status: 'success' } }
+      : { result: { ...response, status: 'error' } }
+  }
+
+  private _faucet(address: string | undefined): Record<string, unknown> {
+    if (address !== undefined && !isValidClassicAddress(address)) {
+      throw new Error(`Invalid account: ${address}`)
+    }
+    const wallet = address === undefined ? Wallet.generate() : undefined
+    const classicAddress = address ?? (wallet as Wallet).classicAddress
+    const { hash } = this.ledger.fund(classicAddress, this.options.faucetDrops)
+    const balance = this.ledger.getAccountRoot(
+      classicAddress,
+      this.ledger.getLedger('current')
+    ).balance
+    return {
+      account: {
+        address: classicAddress,
+        classicAddress,
+        secret: wallet?.seed,
+      },
+      amount: Number(this.options.faucetDrops / DROPS_PER_XRP),
+      balance: Number(balance / DROPS_PER_XRP),
+      hash,
+    }
+  }
+
+  private _accountInfo: RpcHandler = (request) => {
+    const address = requireAccount(request)
+    const ledger = this.ledger.getLedger(
+      parseLedgerSpecifier(request.ledger_index, 'current')
+    )
+    const account = this.ledger.getAccountRoot(address, ledger)
+    return { account_data: accountRootJson(account), ...ledgerFields(ledger) }
+  }
+
+  private _accountNamespace: RpcHandler = (request) => {
+    const address = requireAccount(request)
+    const namespace = requireHash(request, 'namespace_id')
+    const ledger = this.ledger.getLedger(
+      parseLedgerSpecifier(request.ledger_index, 'current')
+    )
+    const account = this.ledger.getAccountRoot(address, ledger)
+    const limit = Math.min(
+      Math.max(Number(request.limit ?? ACCOUNT_NAMESPACE_LIMIT_DEFAULT), 1),
+      ACCOUNT_NAMESPACE_LIMIT_MAX
+    )
+
+    // The marker is the key of the last entry on the previous page
+    let entries = this.ledger.getHookStateEntries(address, namespace, ledger)
+    if (request.marker !== undefined) {
+      const marker = String(request.marker).toUpperCase()
+      entries = entries.filter(([key]) => key > marker)
+    }
+    const page = entries.slice(0, limit)
+    const result: Record<string, unknown> = {
+      account: address,
+      namespace_id: namespace,
+      namespace_entries: page.map(([key, data]) =>
+        hookStateJson(account, namespace, key, data)
+      ),
+      ...ledgerFields(ledger),
+    }
+    if (entries.length > limit) {
+      result.limit = limit
+      result.marker = page[page.length - 1][0]
+    }
+    return result
+  }
+
+  private _ledgerEntry: RpcHandler = (request) => {
+    const hookState = request.hook_state
+    if (typeof hookState !== 'object' || hookState === null) {
+      throw new LocalLedgerError(
+        'invalidParams',
+        'Only hook_state ledger entries are supported.'
+      )
+    }
+    const address = requireAccount(hookState)
+    const key = requireHash(hookState, 'key')
+    const namespace = requireHash(hookState, 'namespace_id')
+    const ledger = this.ledger.getLedger(
+      parseLedgerSpecifier(request.ledger_index, 'current')
+    )
+    const data = this.ledger.getHookState(address, namespace, key, ledger)
+    if (data === undefined) {
+      throw new LocalLedgerError('entryNotFound', 'Entry not found.')
+    }
+    const node = hookStateJson(
+      this.ledger.getAccountRoot(address, ledger),
+      namespace,
+      key,
+      data
+    )
+    return { index: node.index, node, ...ledgerFields(ledger) }
+  }
+
+  private _fee: RpcHandler = (request) => {
+    let baseFee = BigInt(this.ledger.baseFeeDrops)
+    if (typeof request.tx_blob === 'string') {
+      try {
+        baseFee = this.ledger.getRequiredFee(request.tx_blob)
+      } catch (error) {
+        throw new LocalLedgerError('invalidParams', `Invalid tx_blob: ${error}`)
+      }
+    }
+    const fee = baseFee.toString()
+    return {
+      current_ledger_size: String(
+        this.ledger.getLedger('current').transactions.length
+      ),
+      current_queue_size: '0',
+      drops: {
+        base_fee: fee,
+        median_fee: fee,
+        minimum_fee: fee,
+        open_ledger_fee: fee,
+      },
+      expected_ledger_size: '1000',
+      ledger_current_index: this.ledger.currentLedgerIndex,
+      levels: {
+        median_level: '256',
+        minimum_level: '256',
+        open_ledger_level: '256',
+        reference_level: '256',
+      },
+      max_queue_size: '2000',
+    }
+  }
+
+  private _ledger: RpcHandler = (request) => {
+    const ledger = this.ledger.getLedger(
+      parseLedgerSpecifier(request.ledger_index, 'current')
+    )
+    const header: Record<string, unknown> = {
+      closed: ledger.hash !== undefined,
+      ledger_index: String(ledger.index),
+      parent_hash: ledger.parentHash,
+    }
+    if (ledger.hash !== undefined) {
+      header.ledger_hash = ledger.hash
+      header.close_time = ledger.closeTime
+    }
+    if (request.transactions) {
+      header.transactions = request.expand
+        ? ledger.transactions.map((hash) =>
+            this._transactionJson(
+              this.ledger.getTransaction(hash) as TransactionRecord
+            )
+          )
+        : [...ledger.transactions]
+    }
+    return { ledger: header, ...ledgerFields(ledger) }
+  }
+
+  private _ledgerAccept: RpcHandler = () => {
+    this.ledger.closeLedger()
+    return { ledger_current_index: this.ledger.currentLedgerIndex }
+  }
+
+  private _localClock: RpcHandler = (request) => {
+    if (request.set_time !== undefined) {
+      this.ledger.setTime(Number(request.set_time))
+    }
+    if (request.advance_seconds !== undefined) {
+      this.ledger.advanceTime(Number(request.advance_seconds))
+    }
+    if (request.close_interval_ms !== undefined) {
+      this.ledger.setCloseInterval(Number(request.close_interval_ms))
+    }
+    return {
+      time: this.ledger.now(),
+      close_interval_ms: this.ledger.closeIntervalMs,
+    }
+  }
+
+  private _validatedLedgerJson(): Record<string, unknown> {
+    const ledger = this.ledger.validatedLedger
+    return {
+      base_fee: this.ledger.baseFeeDrops,
+      close_time: ledger.closeTime,
+      hash: ledger.hash,
+      reserve_base: this.ledger.reserveBaseDrops,
+      reserve_inc: this.ledger.reserveIncrementDrops,
+      seq: ledger.index,
+    }
+  }
+
+  private _serverState: RpcHandler = () => ({
+    state: {
+      build_version: 'local-ledger',
+      complete_ledgers: this.ledger.completeLedgers,
+      network_id: this.ledger.networkId,
+      server_state: 'full',
+      validated_ledger: this._validatedLedgerJson(),
+    },
+  })
+
+  private _serverInfo: RpcHandler = () => {
+    const ledger = this.ledger.validatedLedger
+    const xrp = (drops: number) => drops / Number(DROPS_PER_XRP)
+    return {
+      info: {
+        build_version: 'local-ledger',
+        complete_ledgers: this.ledger.completeLedgers,
+        network_id: this.ledger.networkId,
+        server_state: 'full',
+        validated_ledger: {
+          age: Math.max(
+            0,
+            this.ledger.now() -
+              RIPPLE_EPOCH_OFFSET -
+              (ledger.closeTime as number)
+          ),
+          base_fee_xrp: xrp(this.ledger.baseFeeDrops),
+          hash: ledger.hash,
+          reserve_base_xrp: xrp(this.ledger.reserveBaseDrops),
+          reserve_inc_xrp: xrp(this.ledger.reserveIncrementDrops),
+          seq: ledger.index,
+        },
+      },
+    }
+  }
+
+  private _submit: RpcHandler = (request) => {
+    const txBlob = requireParam(request, 'tx_blob')
+    if (typeof txBlob !== 'string' || !/^([0-9a-fA-F]{2})+$/.test(txBlob)) {
+      throw new LocalLedgerError('invalidParams', "Invalid field 'tx_blob'.")
+    }
+    const result = this.ledger.submit(txBlob)
+    return {
+      accepted: result.applied || result.queued,
+      applied: result.applied,
+      broadcast: false,
+      engine_result: result.engineResult,
+      engine_result_code: result.engineResultCode,
+      engine_result_message: result.engineResultMessage,
+      kept: result.applied || result.queued,
+      queued: result.queued,
+      tx_blob: txBlob.toUpperCase(),
+      tx_json: result.tx,
+    }
+  }
+
+  private _tx: RpcHandler = (request) => {
+    const hash = requireHash(request, 'transaction')
+    const record = this.ledger.getTransaction(hash)
+    if (!record) {
+      throw new LocalLedgerError('txnNotFound', 'Transaction not found.')
+    }
+    return this._transactionJson(record)
+  }
+
+  // Transactions in the open ledger have no meta yet, as with rippled
+  private _transactionJson(record: TransactionRecord): TransactionJson {
+    const validated = this.ledger.isValidated(record)
+    const json: TransactionJson = {
+      ...record.tx,
+      ledger_index: record.ledgerIndex,
+      validated,
+    }
+    if (validated) {
+      const ledger = this.ledger.getLedger(record.ledgerIndex)
+      json.meta = record.meta
+      json.date = ledger.closeTime
+      json.inLedger = record.ledgerIndex
+    }
+    return json
+  }
+
+  private _subscribe: RpcHandler = (request, socket) => {
+    if (!socket) {
+      throw new LocalLedgerError(
+        'notSupported',
+        'Subscriptions need a WebSocket connection.'
+      )
+    }
+    const streams: string[] = request.streams ?? []
+    const accounts: string[] = request.accounts ?? []
+    for (const stream of streams) {
+      if (stream !== 'ledger' && stream !== 'transactions') {
+        throw new LocalLedgerError('malformedStream', 'Stream malformed.')
+      }
+    }
+    for (const account of accounts) {
+      if (!isValidClassicAddress(account)) {
+        throw new LocalLedgerError('actMalformed', 'Account malformed.')
+      }
+    }
+
+    let subscription = this.subscriptions.get(socket)
+    if (!subscription) {
+      subscription = { ledger: false, transactions: false, accounts: new Set() }
+      this.subscriptions.set(socket, subscription)
+    }
+    subscription.ledger ||= streams.includes('ledger')
+    subscription.transactions ||= streams.includes('transactions')
+    for (const account of accounts) {
+      subscription.accounts.add(account)
+    }
+    return streams.includes('ledger')
+      ? this._ledgerClosedJson(this.ledger.validatedLedger)
+      : {}
+  }
+
+  private _unsubscribe: RpcHandler = (request, socket) => {
+    const subscription = socket && this.subscriptions.get(socket)
+    if (subscription) {
+      const streams: string[] = request.streams ?? []
+      const accounts: string[] = request.accounts ?? []
+      subscription.ledger &&= !streams.includes('ledger')
+      subscription.transactions &&= !streams.includes('transactions')
+      for (const account of accounts) {
+        subscription.accounts.delete(account)
+      }
+    }
+    return {}
+  }
+
+  private _ledgerClosedJson(ledger: Ledger): Record<string, unknown> {
+    return {
+      fee_base: this.ledger.baseFeeDrops,
+      fee_ref: this.ledger.baseFeeDrops,
+      ledger_hash: ledger.hash,
+      ledger_index: ledger.index,
+      ledger_time: ledger.closeTime,
+      reserve_base: this.ledger.reserveBaseDrops,
+      reserve_inc: this.ledger.reserveIncrementDrops,
+      txn_count: ledger.transactions.length,
+      validated_ledgers: this.ledger.completeLedgers,
+    }
+  }
+
+  /**
+   * Streams the ledgerClosed message of a closed ledger to the subscribed sockets, then its
+   * validated transactions, in the order rippled sends them.
+   */
+  private _publish(ledger: Ledger, transactions: TransactionRecord[]): void {
+    if (this.subscriptions.size === 0) {
+      return
+    }
+    const messages = transactions.map((record) => {
+      const [engineResultCode, engineResultMessage] = describeEngineResult(
+        record.engineResult
+      )
+      return {
+        // Accounts whose AccountRoot the transaction touched
+        accounts: new Set<string>(
+          record.meta.AffectedNodes.flatMap((node: TransactionJson) => {
+            const fields = Object.values(node)[0]
+            const account = (fields.FinalFields ?? fields.NewFields)?.Account
+            return fields.LedgerEntryType === 'AccountRoot' && account
+              ? [account]
+              : []
+          })
+        ),
+        message: JSON.stringify({
+          type: 'transaction',
+          engine_result: record.engineResult,
+          engine_result_code: engineResultCode,
+          engine_result_message: engineResultMessage,
+          ledger_hash: ledger.hash,
+          ledger_index: ledger.index,
+          meta: record.meta,
+          status: 'closed',
+          transaction: { ...record.tx, date: ledger.closeTime },
+          validated: true,
+        }),
+      }
+    })
+    const ledgerClosed = JSON.stringify({
+      type: 'ledgerClosed',
+      ...this._ledgerClosedJson(ledger),
+    })
+
+    for (const [socket, subscription] of this.subscriptions) {
+      if (socket.readyState !== WebSocket.OPEN) {
+        continue
+      }
+      if (subscription.ledger) {
+        socket.send(ledgerClosed)
+      }
+      for (const { accounts, message } of messages) {
+        const subscribed =
+          subscription.transactions ||
+          [...accounts].some((account) => subscription.accounts.has(account))
+        if (subscribed) {
+          socket.send(message)
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,147 @@
+/*
+Assembles minimal hooks for the local ledger tests: one wasm module importing Hook API functions
+from env and exporting hook(i32) -> i64 with the given body, one page of memory and data segments.
+Bodies are raw wasm instructions built with the helpers below; local 0 is hook's parameter and
+the extra locals are i64s.
+*/
+
+const I32 = 0x7f
+const I64 = 0x7e
+
+// Signatures of the Hook API functions the tests import (hook-src/extern.h)
+const SIGNATURES: Record<string, [number[], number]> = {
+  _g: [[I32, I32], I32],
+  accept: [[I32, I32, I64], I64],
+  rollback: [[I32, I32, I64], I64],
+  otxn_field: [[I32, I32, I32], I64],
+  state: [[I32, I32, I32, I32], I64],
+  state_set: [[I32, I32, I32, I32], I64],
+  etxn_reserve: [[I32], I64],
+  emit: [[I32, I32, I32, I32], I64],
+  sto_subarray: [[I32, I32, I32], I64],
+  sto_subfield: [[I32, I32, I32], I64],
+  ledger_seq: [[], I64],
+}
+
+function unsignedLeb128(value: number): number[] {
+  const bytes: number[] = []
+  do {
+    let byte = value & 0x7f
+    value >>>= 7
+    if (value !== 0) {
+      byte |= 0x80
+    }
+    bytes.push(byte)
+  } while (value !== 0)
+  return bytes
+}
+
+function signedLeb128(value: number | bigint): number[] {
+  let remaining = BigInt(value)
+  const bytes: number[] = []
+  for (;;) {
+    const byte = Number(remaining & 0x7fn)
+    remaining >>= 7n
+    const signBitSet = (byte & 0x40) !== 0
+    if (
+      (remaining === 0n && !signBitSet) ||
+      (remaining === -1n && signBitSet)
+    ) {
+      bytes.push(byte)
+      return bytes
+    }
+    bytes.push(byte | 0x80)
+  }
+}
+
+function vector(items: number[][]): number[] {
+  return [...unsignedLeb128(items.length), ...items.flat()]
+}
+
+function name(value: string): number[] {
+  const bytes = [...Buffer.from(value)]
+  return [...unsignedLeb128(bytes.length), ...bytes]
+}
+
+function section(id: number, content: number[]): number[] {
+  return [id, ...unsignedLeb128(content.length), ...content]
+}
+
+export const i32Const = (value: number): number[] => [
+  0x41,
+  ...signedLeb128(value),
+]
+export const i64Const = (value: number | bigint): number[] => [
+  0x42,
+  ...signedLeb128(value),
+]
+export const localGet = (index: number): number[] => [0x20, index]
+export const localSet = (index: number): number[] => [0x21, index]
+export const DROP = [0x1a]
+
+export interface TestHookOptions {
+  // [offset, bytes]
+  data?: [number, Uint8Array][]
+  // i64 locals after hook's parameter
+  locals?: number
+}
+
+/**
+ * body gets call(name), the instruction calling an imported function; the body must leave the
+ * i64 hook returns on the stack.
+ */
+export function assembleTestHook(
+  imports: string[],
+  body: (call: (name: string) => number[]) => number[],
+  options: TestHookOptions = {}
+): Buffer {
+  const types = imports.map((importName) => {
+    const [params, result] = SIGNATURES[importName]
+    return [
+      0x60,
+      ...vector(params.map((param) => [param])),
+      ...vector([[result]]),
+    ]
+  })
+  types.push([0x60, ...vector([[I32]]), ...vector([[I64]])])
+
+  const call = (importName: string) => [
+    0x10,
+    ...unsignedLeb128(imports.indexOf(importName)),
+  ]
+  const locals = options.locals ?? 0
+  const functionBody = [
+    ...(locals > 0 ? vector([[...unsignedLeb128(locals), I64]]) : [0]),
+    ...body(call),
+    0x0b,
+  ]
+  const code = [...unsignedLeb128(functionBody.length), ...functionBody]
+  // hook's type and function index, after the imports'
+  const hookIndex = unsignedLeb128(imports.length)
+  const importEntries = imports.map((importName, index) => [
+    ...name('env'),
+    ...name(importName),
+    0,
+    ...unsignedLeb128(index),
+  ])
+  const dataSegments = (options.data ?? []).map(([offset, bytes]) => [
+    0,
+    ...i32Const(offset),
+    0x0b,
+    ...unsignedLeb128(bytes.length),
+    ...bytes,
+  ])
+
+  return Buffer.from([
+    // Magic and version
+    ...[0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00],
+    ...section(1, vector(types)),
+    ...section(2, vector(importEntries)),
+    ...section(3, vector([hookIndex])),
+    ...section(5, vector([[0, 1]])),
+    // Only hook is exported, like hook-cleaner leaves it
+    ...section(7, vector([[...name('hook'), 0, ...hookIndex]])),
+    ...section(10, vector([code])),
+    ...section(11, vector(dataSegments)),
+  ])
+}
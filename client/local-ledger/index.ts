@@ -0,0 +1,103 @@
+import { encode } from 'ripple-binary-codec'
+import { Wallet } from 'xrpl'
+
+import config from '../../config.json'
+import { HookOnTransactionType } from '../util/calculateHookOn'
+import { createHooksPayload, readBuiltHookWasm } from '../util/hooksPayload'
+import { LocalLedger } from './LocalLedger'
+import { LocalLedgerServer } from './LocalLedgerServer'
+
+/*
+Runs a LocalLedger behind a LocalLedgerServer with the Hook Account of config.json funded and the
+config.json HOOKS (build/<HOOK_C_FILENAME>.wasm, see npm run build:hooks) installed on it.
+
+Usage: npm run ledger:local, then point the client at it:
+  XRPL_ENDPOINTS=ws://127.0.0.1:6006 XRPL_FAUCET_URL=http://127.0.0.1:6006/accounts npm run test:integration
+
+- LOCAL_LEDGER_PORT: port of the WebSocket, JSON-RPC and faucet server (default 6006)
+- LOCAL_LEDGER_CLOSE_INTERVAL_MS: ledger close interval (default 1000); 0 closes ledgers only on
+  ledger_accept
+- LOCAL_LEDGER_TRACE_HOOKS=true: prints hook traces
+*/
+
+type Config = {
+  HOOKS: {
+    HOOK_C_FILENAME: string
+    HookOn: HookOnTransactionType[]
+  }[]
+  HOOK_ACCOUNT: {
+    seed: string
+  }
+  HOOK_NAMESPACE_SEED: string
+}
+
+const HOOK_ACCOUNT_DROPS = 100000n * 1000000n
+
+function installHooks(ledger: LocalLedger, config: Config): void {
+  const hookAccount = Wallet.fromSeed(config.HOOK_ACCOUNT.seed)
+
+  // Step 1. Fund the Hook Account
+  ledger.fund(hookAccount.address, HOOK_ACCOUNT_DROPS)
+  console.log(`Funded Hook Account ${hookAccount.address}`)
+
+  // Step 2. Install the built hooks, like setHooks.ts
+  const Hooks = createHooksPayload(config, 0, (HOOK_C_FILENAME) => {
+    try {
+      return readBuiltHookWasm(HOOK_C_FILENAME)
+    } catch (error) {
+      throw new Error(
+        `build/${HOOK_C_FILENAME}.wasm could not be read, run npm run build:hooks first: ${error}`
+      )
+    }
+  })
+  const { sequence } = ledger.getAccountRoot(
+    hookAccount.address,
+    ledger.getLedger('current')
+  )
+  const { engineResult } = ledger.submit(
+    encode({
+      TransactionType: 'SetHook',
+      Account: hookAccount.address,
+      Hooks,
+      Fee: String(ledger.baseFeeDrops),
+      Sequence: sequence,
+      NetworkID: ledger.networkId,
+      SigningPubKey: hookAccount.publicKey,
+    })
+  )
+  if (engineResult !== 'tesSUCCESS') {
+    throw new Error(`SetHook failed with ${engineResult}`)
+  }
+  console.log(
+    `Installed ${config.HOOKS.map(({ HOOK_C_FILENAME }) => HOOK_C_FILENAME)}`
+  )
+}
+
+async function run() {
+  const traceHooks = process.env.LOCAL_LEDGER_TRACE_HOOKS === 'true'
+  const ledger = new LocalLedger({
+    closeIntervalMs: Number(process.env.LOCAL_LEDGER_CLOSE_INTERVAL_MS ?? 1000),
+    onTrace: traceHooks ? (line) => console.log(line) : undefined,
+  })
+  installHooks(ledger, config as Config)
+  ledger.closeLedger()
+
+  const server = new LocalLedgerServer(ledger, {
+    port: Number(process.env.LOCAL_LEDGER_PORT ?? 6006),
+  })
+  await server.listen()
+  ledger.start()
+  console.log(`Local ledger listening on ${server.url}`)
+  console.log(`Faucet: POST ${server.faucetUrl}`)
+
+  process.on('SIGINT', async () => {
+    ledger.stop()
+    await server.close()
+    process.exit(0)
+  })
+}
+
+run().catch((error) => {
+  console.error('Error starting the local ledger:', error)
+  process.exit(1)
+})
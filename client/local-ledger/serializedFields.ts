@@ -0,0 +1,220 @@
+/*
+Walks XRPL binary serialized objects (transactions, STObjects and STArrays) field by field, the way
+the Hook API's otxn_field, sto_subfield and sto_subarray see them. Field ids are the Hook API's:
+(type << 16) + field, as in hook-src/sfcodes.h.
+*/
+
+export const STI_AMOUNT = 6
+export const STI_VL = 7
+export const STI_ACCOUNT = 8
+export const STI_OBJECT = 14
+export const STI_ARRAY = 15
+export const STI_VECTOR256 = 19
+
+const OBJECT_END_MARKER = 0xe1
+const ARRAY_END_MARKER = 0xf1
+
+// Payload sizes of the fixed size types
+const FIXED_SIZES: Record<number, number> = {
+  1: 2, // UInt16
+  2: 4, // UInt32
+  3: 8, // UInt64
+  4: 16, // Hash128
+  5: 32, // Hash256
+  16: 1, // UInt8
+  17: 20, // Hash160
+  20: 12, // UInt96
+  21: 24, // UInt192
+  22: 48, // UInt384
+  23: 64, // UInt512
+}
+
+// Nesting deeper than this is rejected as a parse error
+const MAX_DEPTH = 16
+
+// Offsets are relative to the start of the parsed bytes
+export interface SerializedField {
+  type: number
+  field: number
+  start: number
+  // After the field header
+  headerEnd: number
+  // After the header and the length prefix of variable length fields
+  payloadStart: number
+  // Without the end marker of objects and arrays
+  payloadLength: number
+  // After the field, including its end marker
+  end: number
+}
+
+export function fieldId(type: number, field: number): number {
+  return (type << 16) + field
+}
+
+// Returns [length, prefix length], or undefined if the prefix runs past end
+function readVariableLength(
+  bytes: Uint8Array,
+  offset: number,
+  end: number
+): [number, number] | undefined {
+  if (offset >= end) {
+    return undefined
+  }
+  const b0 = bytes[offset]
+  if (b0 <= 192) {
+    return [b0, 1]
+  }
+  if (b0 <= 240 && offset + 1 < end) {
+    return [193 + (b0 - 193) * 256 + bytes[offset + 1], 2]
+  }
+  if (b0 <= 254 && offset + 2 < end) {
+    return [
+      12481 +
+        (b0 - 241) * 65536 +
+        bytes[offset + 1] * 256 +
+        bytes[offset + 2],
+      3,
+    ]
+  }
+  return undefined
+}
+
+/**
+ * Reads the field starting at offset. Returns undefined if it isn't a well formed field ending
+ * at or before end.
+ */
+export function readField(
+  bytes: Uint8Array,
+  offset: number,
+  end: number,
+  depth = 0
+): SerializedField | undefined {
+  if (offset >= end || depth > MAX_DEPTH) {
+    return undefined
+  }
+
+  // Step 1. Header: 1 to 3 bytes, type and field in the low nibbles or in their own byte
+  let cursor = offset
+  let type = bytes[cursor] >> 4
+  let field = bytes[cursor] & 0x0f
+  cursor++
+  if (type === 0) {
+    type = bytes[cursor++]
+  }
+  if (field === 0) {
+    field = bytes[cursor++]
+  }
+  if (cursor > end) {
+    return undefined
+  }
+  const headerEnd = cursor
+
+  // Step 2. Objects and arrays run to their end marker; the markers themselves are empty
+  if (type === STI_OBJECT || type === STI_ARRAY) {
+    if (field === 1) {
+      return {
+        type,
+        field,
+        start: offset,
+        headerEnd,
+        payloadStart: headerEnd,
+        payloadLength: 0,
+        end: headerEnd,
+      }
+    }
+    const endMarker =
+      type === STI_OBJECT ? OBJECT_END_MARKER : ARRAY_END_MARKER
+    while (cursor < end && bytes[cursor] !== endMarker) {
+      const inner = readField(bytes, cursor, end, depth + 1)
+      if (!inner) {
+        return undefined
+      }
+      cursor = inner.end
+    }
+    if (cursor >= end) {
+      return undefined
+    }
+    return {
+      type,
+      field,
+      start: offset,
+      headerEnd,
+      payloadStart: headerEnd,
+      payloadLength: cursor - headerEnd,
+      end: cursor + 1,
+    }
+  }
+
+  // Step 3. Variable length and fixed size payloads
+  let payloadStart = headerEnd
+  let payloadLength: number
+  if (type === STI_VL || type === STI_ACCOUNT || type === STI_VECTOR256) {
+    const variableLength = readVariableLength(bytes, headerEnd, end)
+    if (!variableLength) {
+      return undefined
+    }
+    payloadStart += variableLength[1]
+    payloadLength = variableLength[0]
+  } else if (type === STI_AMOUNT) {
+    // XRP amounts are 8 bytes, issued currency amounts 48
+    payloadLength = (bytes[headerEnd] & 0x80) === 0 ? 8 : 48
+  } else if (type in FIXED_SIZES) {
+    payloadLength = FIXED_SIZES[type]
+  } else {
+    // PathSet and unknown types
+    return undefined
+  }
+  if (payloadStart + payloadLength > end) {
+    return undefined
+  }
+  return {
+    type,
+    field,
+    start: offset,
+    headerEnd,
+    payloadStart,
+    payloadLength,
+    end: payloadStart + payloadLength,
+  }
+}
+
+/**
+ * Reads the fields of bytes[start..end) one after another. Returns undefined if any of them
+ * doesn't parse.
+ */
+export function readFields(
+  bytes: Uint8Array,
+  start = 0,
+  end = bytes.length
+): SerializedField[] | undefined {
+  const fields: SerializedField[] = []
+  for (let cursor = start; cursor < end; ) {
+    const field = readField(bytes, cursor, end)
+    if (!field) {
+      return undefined
+    }
+    fields.push(field)
+    cursor = field.end
+  }
+  return fields
+}
+
+/**
+ * The bytes the Hook API's otxn_field returns for a field: everything after the header except
+ * the end marker of objects and arrays, and without the length prefix for accounts.
+ */
+export function getFieldValue(
+  bytes: Uint8Array,
+  field: SerializedField
+): Uint8Array {
+  if (field.type === STI_ACCOUNT) {
+    return bytes.subarray(
+      field.payloadStart,
+      field.payloadStart + field.payloadLength
+    )
+  }
+  if (field.type === STI_OBJECT || field.type === STI_ARRAY) {
+    return bytes.subarray(field.headerEnd, field.end - 1)
+  }
+  return bytes.subarray(field.headerEnd, field.end)
+}
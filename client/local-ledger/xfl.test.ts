@@ -0,0 +1,55 @@
+import {
+  DIVISION_BY_ZERO,
+  floatCompare,
+  floatDivide,
+  floatInt,
+  floatMultiply,
+  floatNegate,
+  floatSet,
+  floatSum,
+  INVALID_FLOAT,
+  parseXfl,
+} from './xfl'
+
+// float_one() in the Hook API
+const ONE = 6089866696204910592n
+
+describe('xfl', () => {
+  it('should normalize mantissas to 16 digits', () => {
+    expect(floatSet(0, 1n)).toBe(ONE)
+    expect(parseXfl(floatSet(-2, 25n))).toEqual({
+      mantissa: 2500000000000000n,
+      exponent: -16,
+    })
+    expect(parseXfl(floatNegate(ONE))).toEqual({
+      mantissa: -1000000000000000n,
+      exponent: -15,
+    })
+  })
+
+  it('should truncate like the Hook API', () => {
+    const third = floatDivide(ONE, floatSet(0, 3n))
+    expect(floatInt(third, 6, false)).toBe(333333n)
+
+    // 25% of 1,000 XRP in drops
+    const quarter = floatDivide(floatSet(0, 25n), floatSet(0, 100n))
+    expect(floatInt(floatMultiply(quarter, floatSet(9, 1n)), 0, false)).toBe(
+      250000000n
+    )
+  })
+
+  it('should add, subtract and compare', () => {
+    const sum = floatSum(floatSet(0, 15n), floatNegate(floatSet(0, 5n)))
+    expect(floatInt(sum, 0, false)).toBe(10n)
+    // COMPARE_LESS | COMPARE_EQUAL
+    expect(floatCompare(floatSet(0, 5n), floatSet(0, 10n), 3)).toBe(1n)
+    // COMPARE_GREATER
+    expect(floatCompare(floatSet(0, 5n), floatSet(0, 10n), 4)).toBe(0n)
+    expect(floatSum(ONE, 0n)).toBe(ONE)
+  })
+
+  it('should return Hook API error codes', () => {
+    expect(floatDivide(ONE, 0n)).toBe(DIVISION_BY_ZERO)
+    expect(floatMultiply(-1n, ONE)).toBe(INVALID_FLOAT)
+  })
+})
@@ -0,0 +1,198 @@
+/*
+XFL, the Hook API's decimal floating point number packed into an int64 (see hook-src/extern.h
+float_*): bit 62 is set for positive numbers, bits 54-61 hold the exponent + 97 and bits 0-53 the
+mantissa, normalized to 16 digits. 0 is the only XFL without the normalized mantissa, and negative
+int64s are Hook API error codes.
+
+Results are truncated to 16 digits, like the Hook API's.
+*/
+
+// Hook API error codes (hook-src/error.h)
+export const INVALID_ARGUMENT = -7n
+export const INVALID_FLOAT = -10024n
+export const DIVISION_BY_ZERO = -25n
+export const EXPONENT_OVERSIZED = -28n
+export const CANT_RETURN_NEGATIVE = -33n
+export const TOO_BIG = -3n
+
+const MIN_MANTISSA = 1000000000000000n
+const MAX_MANTISSA = 9999999999999999n
+const MIN_EXPONENT = -96
+const MAX_EXPONENT = 80
+const EXPONENT_BIAS = 97
+const INT64_MAX = 0x7fffffffffffffffn
+
+export interface XflParts {
+  // Signed; 0 only for the XFL 0
+  mantissa: bigint
+  exponent: number
+}
+
+/**
+ * @returns the XFL for mantissa * 10^exponent, 0 when it is too small to represent, or
+ * EXPONENT_OVERSIZED
+ */
+export function makeXfl(mantissa: bigint, exponent: number): bigint {
+  if (mantissa === 0n) {
+    return 0n
+  }
+  const negative = mantissa < 0n
+  let normalized = negative ? -mantissa : mantissa
+  while (normalized > MAX_MANTISSA) {
+    normalized /= 10n
+    exponent++
+  }
+  while (normalized < MIN_MANTISSA) {
+    normalized *= 10n
+    exponent--
+  }
+  if (exponent < MIN_EXPONENT) {
+    return 0n
+  }
+  if (exponent > MAX_EXPONENT) {
+    return EXPONENT_OVERSIZED
+  }
+  return (
+    normalized |
+    (BigInt(exponent + EXPONENT_BIAS) << 54n) |
+    (negative ? 0n : 1n << 62n)
+  )
+}
+
+// Returns undefined for an int64 that isn't a valid XFL
+export function parseXfl(xfl: bigint): XflParts | undefined {
+  if (xfl === 0n) {
+    return { mantissa: 0n, exponent: 0 }
+  }
+  if (xfl < 0n) {
+    return undefined
+  }
+  const mantissa = xfl & ((1n << 54n) - 1n)
+  if (mantissa < MIN_MANTISSA || mantissa > MAX_MANTISSA) {
+    return undefined
+  }
+  const exponent = Number((xfl >> 54n) & 0xffn) - EXPONENT_BIAS
+  const positive = ((xfl >> 62n) & 1n) === 1n
+  return { mantissa: positive ? mantissa : -mantissa, exponent }
+}
+
+export function floatSet(exponent: number, mantissa: bigint): bigint {
+  return makeXfl(mantissa, exponent)
+}
+
+export function floatMultiply(float1: bigint, float2: bigint): bigint {
+  const a = parseXfl(float1)
+  const b = parseXfl(float2)
+  if (!a || !b) {
+    return INVALID_FLOAT
+  }
+  return makeXfl(a.mantissa * b.mantissa, a.exponent + b.exponent)
+}
+
+export function floatDivide(float1: bigint, float2: bigint): bigint {
+  const a = parseXfl(float1)
+  const b = parseXfl(float2)
+  if (!a || !b) {
+    return INVALID_FLOAT
+  }
+  if (b.mantissa === 0n) {
+    return DIVISION_BY_ZERO
+  }
+  // Scale the dividend so the quotient keeps 16 digits
+  return makeXfl(
+    (a.mantissa * 10n ** 17n) / b.mantissa,
+    a.exponent - b.exponent - 17
+  )
+}
+
+export function floatSum(float1: bigint, float2: bigint): bigint {
+  const a = parseXfl(float1)
+  const b = parseXfl(float2)
+  if (!a || !b) {
+    return INVALID_FLOAT
+  }
+  if (a.mantissa === 0n) {
+    return float2
+  }
+  if (b.mantissa === 0n) {
+    return float1
+  }
+  // Align on the smaller exponent; an operand more than 32 digits below the other is below its
+  // precision
+  const exponent = Math.min(a.exponent, b.exponent)
+  const aShift = a.exponent - exponent
+  const bShift = b.exponent - exponent
+  if (aShift > 32 || bShift > 32) {
+    return aShift > bShift ? float1 : float2
+  }
+  const shift = (parts: XflParts, by: number) =>
+    parts.mantissa * 10n ** BigInt(by)
+  return makeXfl(shift(a, aShift) + shift(b, bShift), exponent)
+}
+
+export function floatNegate(float1: bigint): bigint {
+  const parts = parseXfl(float1)
+  if (!parts) {
+    return INVALID_FLOAT
+  }
+  return makeXfl(-parts.mantissa, parts.exponent)
+}
+
+// mode is a combination of COMPARE_EQUAL (1), COMPARE_LESS (2) and COMPARE_GREATER (4)
+export function floatCompare(
+  float1: bigint,
+  float2: bigint,
+  mode: number
+): bigint {
+  if (mode < 1 || mode > 6) {
+    return INVALID_ARGUMENT
+  }
+  const difference = parseXfl(floatSum(float1, floatNegate(float2)))
+  if (!difference) {
+    return INVALID_FLOAT
+  }
+  const matches =
+    (difference.mantissa === 0n && (mode & 1) !== 0) ||
+    (difference.mantissa < 0n && (mode & 2) !== 0) ||
+    (difference.mantissa > 0n && (mode & 4) !== 0)
+  return matches ? 1n : 0n
+}
+
+// float * 10^decimalPlaces as an integer, truncated
+export function floatInt(
+  float1: bigint,
+  decimalPlaces: number,
+  absolute: boolean
+): bigint {
+  const parts = parseXfl(float1)
+  if (!parts) {
+    return INVALID_FLOAT
+  }
+  if (decimalPlaces > 15) {
+    return INVALID_ARGUMENT
+  }
+  if (parts.mantissa < 0n && !absolute) {
+    return CANT_RETURN_NEGATIVE
+  }
+  const mantissa = parts.mantissa < 0n ? -parts.mantissa : parts.mantissa
+  const shift = parts.exponent + decimalPlaces
+  if (shift > 19) {
+    return TOO_BIG
+  }
+  const value =
+    shift >= 0
+      ? mantissa * 10n ** BigInt(shift)
+      : mantissa / 10n ** BigInt(-shift)
+  return value > INT64_MAX ? TOO_BIG : value
+}
+
+// For traces
+export function xflToString(xfl: bigint): string {
+  const parts = parseXfl(xfl)
+  if (!parts) {
+    return `<invalid XFL ${xfl}>`
+  }
+  return parts.mantissa === 0n
+    ? '0'
+    : `${parts.mantissa}*10^(${parts.exponent})`
+}
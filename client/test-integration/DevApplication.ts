@@ -14,10 +14,8 @@ import {
   validate,
   Wallet,
 } from 'xrpl'
-import {
-  generateRandomDestinationTag,
-  prepareTransactionV3,
-} from '../util/transaction'
+import { prepareTransactionV3 } from '../util/transaction'
+import { submitAndWaitV3 } from '../util/SubmissionPipeline'
 import {
   CREATE_CAMPAIGN_DEPOSIT_IN_DROPS,
   DESCRIPTION_MAX_LENGTH,
@@ -30,7 +28,7 @@ import {
 import { DevCreateCampaignPayload } from './DevCreateCampaignPayload'
 import { DevFundCampaignPayload } from './DevFundCampaignPayload'
 import { MilestonePayload } from '../app/models/MilestonePayload'
-import { Application } from '../app/Application'
+import { StateUtility } from '../util/StateUtility'
 import { DevVoteRejectMilestonePayload } from './DevVoteRejectMilestonePayload'
 import { DevVoteApproveMilestonePayload } from './DevVoteApproveMilestonePayload'
 import connectDatabase from '../database'
@@ -104,14 +102,8 @@ export class DevApplication {
     /* Step 1. Input validation */
     this._validateDevCreateCampaignParams(params)
 
-    /* Step 2. Generate a random unique campaign ID */
-    const campaigns = await Application.viewCampaigns(client, database)
-    let destinationTag: number
-    do {
-      destinationTag = generateRandomDestinationTag()
-    } while (campaigns.find((campaign) => campaign.id === destinationTag))
-
-    const campaignId = destinationTag
+    /* Step 2. Allocate a random unique campaign ID */
+    const campaignId = await StateUtility.allocateDestinationTag(client)
 
     /* Step 3. Create transaction Memo payloads */
     const milestonePayloads = milestones.map((milestone) => {
@@ -150,10 +142,11 @@ export class DevApplication {
     /* Step 6. submit Payment transaction with CreateCampaignPayload */
     // @ts-expect-error - this is functional
     validate(createCampaignTx)
-    const paymentResponse = await client.submitAndWait(createCampaignTx, {
-      autofill: true,
-      wallet: ownerWallet,
-    })
+    const paymentResponse = await submitAndWaitV3(
+      client,
+      createCampaignTx,
+      ownerWallet
+    )
 
     /* Step 7. Check Payment transaction result */
     this._validateTxResponse(paymentResponse, 'createCampaign')
@@ -228,10 +221,11 @@ export class DevApplication {
     /* Step 4. Submit Payment transaction with CreateCampaignPayload */
     // @ts-expect-error - this is functional
     validate(fundCampaignTx)
-    const paymentResponse = await client.submitAndWait(fundCampaignTx, {
-      autofill: true,
-      wallet: backerWallet,
-    })
+    const paymentResponse = await submitAndWaitV3(
+      client,
+      fundCampaignTx,
+      backerWallet
+    )
 
     /* Step 5. Check Payment transaction result */
     const acceptMessageHex = this._validateTxResponse(
@@ -280,12 +274,10 @@ export class DevApplication {
 
     await prepareTransactionV3(voteRejectMilestoneTx)
 
-    const voteRejectMilestoneTxResponse = await client.submitAndWait(
+    const voteRejectMilestoneTxResponse = await submitAndWaitV3(
+      client,
       voteRejectMilestoneTx,
-      {
-        autofill: true,
-        wallet: backerWallet,
-      }
+      backerWallet
     )
 
     /* Step 4. Check Invoke transaction result */
@@ -331,12 +323,10 @@ export class DevApplication {
 
     await prepareTransactionV3(voteApproveMilestoneTx)
 
-    const voteApproveMilestoneTxResponse = await client.submitAndWait(
+    const voteApproveMilestoneTxResponse = await submitAndWaitV3(
+      client,
       voteApproveMilestoneTx,
-      {
-        autofill: true,
-        wallet: backerWallet,
-      }
+      backerWallet
     )
 
     /* Step 4. Check Invoke transaction result */
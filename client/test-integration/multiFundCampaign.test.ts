@@ -0,0 +1,263 @@
+import accounts from './accounts.json'
+import { client, connectClient, disconnectClient } from '../util/xrplClient'
+import { Wallet } from 'xrpl'
+import { Application, CreateCampaignParams } from '../app/Application'
+import { StateUtility } from '../util/StateUtility'
+import {
+  dateOffsetToUnixTimestampInSeconds,
+  getHookStateEntriesOfCampaign,
+  cloneHSVCampaignGeneralInfo,
+  verifyHookStateKey,
+  cloneHSVFundTransactionsPage,
+} from './testUtil'
+import { HSVCampaignGeneralInfo } from '../app/models/HSVCampaignGeneralInfo'
+import { HSVFundTransactionsPage } from '../app/models/HSVFundTransactionsPage'
+import {
+  FUND_CAMPAIGN_DEPOSIT_IN_DROPS,
+  FUND_TRANSACTION_STATE_APPROVE_FLAG,
+} from '../app/constants'
+import { HSVFundTransaction } from '../app/models/HSVFundTransaction'
+import { Connection } from 'mongoose'
+import connectDatabase from '../database'
+
+describe('multiFundCampaign', () => {
+  let database: Connection
+  let owner: Wallet
+  let backer1: Wallet
+  let backer2: Wallet
+  let campaignIdA: number
+  let campaignIdB: number
+
+  beforeAll(async () => {
+    await connectClient()
+    database = await connectDatabase()
+
+    const multiFundCampaignAccounts = accounts['multiFundCampaign']
+    owner = Wallet.fromSeed(multiFundCampaignAccounts[0].seed)
+    backer1 = Wallet.fromSeed(multiFundCampaignAccounts[1].seed)
+    backer2 = Wallet.fromSeed(multiFundCampaignAccounts[2].seed)
+
+    const params: CreateCampaignParams = {
+      ownerWallet: owner,
+      depositInDrops: 100000100n,
+      title: 'Community Solar Panels for the Riverside Library',
+      description:
+        'We are raising funds to install solar panels on the roof of the Riverside Library, cutting its energy bill in half and powering free evening classes for the neighbourhood.',
+      overviewUrl: 'https://www.riversidelibrary.org/solar-campaign',
+      imageUrl:
+        'https://images.unsplash.com/photo-1509391366360-2e959784a276?ixlib=rb-4.0.3&auto=format&fit=crop&w=2070&q=80',
+      fundRaiseGoalInDrops: 100000000n,
+      fundRaiseEndDateInUnixSeconds:
+        dateOffsetToUnixTimestampInSeconds('1_MONTH_AFTER'),
+      milestones: [
+        {
+          endDateInUnixSeconds:
+            dateOffsetToUnixTimestampInSeconds('2_MONTH_AFTER'),
+          title: 'Buy solar panels and inverters',
+          payoutPercent: 50,
+        },
+        {
+          endDateInUnixSeconds:
+            dateOffsetToUnixTimestampInSeconds('3_MONTH_AFTER'),
+          title: 'Install solar panels on the library roof',
+          payoutPercent: 50,
+        },
+      ],
+    }
+
+    // Synchronous createCampaign calls so campaignIdB is created after campaignIdA
+    campaignIdA = await Application.createCampaign(client, database, params)
+    campaignIdB = await Application.createCampaign(client, database, params)
+  })
+
+  afterAll(async () => {
+    await disconnectClient()
+    await database.close()
+  })
+
+  it('should fund several campaigns with no backers in one Payment', async () => {
+    // Get the current HookState
+    const hookStateBefore = await StateUtility.getHookState(client)
+    const hsvGeneralInfoABefore = getHookStateEntriesOfCampaign(
+      hookStateBefore,
+      campaignIdA
+    ).generalInfo.value.decoded as HSVCampaignGeneralInfo
+    const hsvGeneralInfoBBefore = getHookStateEntriesOfCampaign(
+      hookStateBefore,
+      campaignIdB
+    ).generalInfo.value.decoded as HSVCampaignGeneralInfo
+
+    const fundTransactionIds = await Application.fundCampaigns(client, {
+      backerWallet: backer1,
+      fundCampaigns: [
+        {
+          campaignId: campaignIdA,
+          fundAmountInDrops: 400000000n + FUND_CAMPAIGN_DEPOSIT_IN_DROPS,
+        },
+        {
+          campaignId: campaignIdB,
+          fundAmountInDrops: 200000000n + FUND_CAMPAIGN_DEPOSIT_IN_DROPS,
+        },
+      ],
+    })
+
+    // Verify that both fund transactions were saved to Hook State
+    const hookStateAfter = await StateUtility.getHookState(client)
+
+    // Each campaign gets its first FundTransactionsPage
+    expect(fundTransactionIds).toEqual([0, 0])
+    expect(hookStateAfter.entries.length).toBe(
+      hookStateBefore.entries.length + 2
+    )
+
+    const expected = [
+      {
+        campaignId: campaignIdA,
+        hsvGeneralInfoBefore: hsvGeneralInfoABefore,
+        amountInDrops: 400000000n,
+      },
+      {
+        campaignId: campaignIdB,
+        hsvGeneralInfoBefore: hsvGeneralInfoBBefore,
+        amountInDrops: 200000000n,
+      },
+    ]
+    for (const {
+      campaignId,
+      hsvGeneralInfoBefore,
+      amountInDrops,
+    } of expected) {
+      const newHookStateEntries = getHookStateEntriesOfCampaign(
+        hookStateAfter,
+        campaignId
+      )
+      expect(newHookStateEntries.fundTransactionsPages.length).toBe(1)
+
+      verifyHookStateKey(newHookStateEntries.generalInfo.key, {
+        destinationTag: campaignId,
+        dataLookupFlag: 0n,
+      })
+      expect(newHookStateEntries.generalInfo.value.decoded).toEqual(
+        cloneHSVCampaignGeneralInfo(hsvGeneralInfoBefore, {
+          totalAmountRaisedInDrops: amountInDrops,
+          totalReserveAmountInDrops:
+            hsvGeneralInfoBefore.totalReserveAmountInDrops +
+            FUND_CAMPAIGN_DEPOSIT_IN_DROPS,
+          totalFundTransactions: 1,
+        })
+      )
+
+      verifyHookStateKey(newHookStateEntries.fundTransactionsPages[0].key, {
+        destinationTag: campaignId,
+        dataLookupFlag: 1n,
+      })
+      expect(
+        newHookStateEntries.fundTransactionsPages[0].value.decoded
+      ).toEqual(
+        cloneHSVFundTransactionsPage(null, [
+          {
+            pageSlotIndex: 0,
+            hsvFundTransaction: new HSVFundTransaction(
+              0,
+              backer1.classicAddress,
+              FUND_TRANSACTION_STATE_APPROVE_FLAG,
+              amountInDrops
+            ),
+          },
+        ])
+      )
+    }
+  })
+
+  it('should fund the same campaign several times in one Payment that adds a new FundTransactionsPage', async () => {
+    // Get the current HookState
+    const hookStateBefore = await StateUtility.getHookState(client)
+    const hookStateEntriesBefore = getHookStateEntriesOfCampaign(
+      hookStateBefore,
+      campaignIdA
+    )
+    const hsvGeneralInfoBefore = hookStateEntriesBefore.generalInfo.value
+      .decoded as HSVCampaignGeneralInfo
+    const hsvFundTransactionsPage0Before = hookStateEntriesBefore
+      .fundTransactionsPages[0].value.decoded as HSVFundTransactionsPage
+
+    const amountsInDrops = [
+      100000000n,
+      110000000n,
+      120000000n,
+      130000000n,
+      140000000n,
+    ]
+    const fundTransactionIds = await Application.fundCampaigns(client, {
+      backerWallet: backer2,
+      fundCampaigns: amountsInDrops.map((amountInDrops) => ({
+        campaignId: campaignIdA,
+        fundAmountInDrops: amountInDrops + FUND_CAMPAIGN_DEPOSIT_IN_DROPS,
+      })),
+    })
+
+    // Verify that the fund transactions were saved to Hook State
+    const hookStateAfter = await StateUtility.getHookState(client)
+    const newHookStateEntries = getHookStateEntriesOfCampaign(
+      hookStateAfter,
+      campaignIdA
+    )
+    const hsvFundTransactionsPage0After = newHookStateEntries
+      .fundTransactionsPages[0].value.decoded as HSVFundTransactionsPage
+    const hsvFundTransactionsPage1After = newHookStateEntries
+      .fundTransactionsPages[1].value.decoded as HSVFundTransactionsPage
+
+    // The entries are applied in payload order
+    expect(fundTransactionIds).toEqual([1, 2, 3, 4, 5])
+    expect(hookStateAfter.entries.length).toBe(
+      hookStateBefore.entries.length + 1
+    )
+    expect(newHookStateEntries.fundTransactionsPages.length).toBe(2)
+
+    expect(newHookStateEntries.generalInfo.value.decoded).toEqual(
+      cloneHSVCampaignGeneralInfo(hsvGeneralInfoBefore, {
+        totalAmountRaisedInDrops: 400000000n + 600000000n,
+        totalReserveAmountInDrops:
+          hsvGeneralInfoBefore.totalReserveAmountInDrops +
+          FUND_CAMPAIGN_DEPOSIT_IN_DROPS * 5n,
+        totalFundTransactions: 6,
+      })
+    )
+
+    const newHsvFundTransactions = amountsInDrops.map(
+      (amountInDrops, i) =>
+        new HSVFundTransaction(
+          fundTransactionIds[i],
+          backer2.classicAddress,
+          FUND_TRANSACTION_STATE_APPROVE_FLAG,
+          amountInDrops
+        )
+    )
+
+    // Slots 1-4 of fundTransactionsPage0 fill up first
+    verifyHookStateKey(newHookStateEntries.fundTransactionsPages[0].key, {
+      destinationTag: campaignIdA,
+      dataLookupFlag: 1n,
+    })
+    expect(hsvFundTransactionsPage0After).toEqual(
+      cloneHSVFundTransactionsPage(
+        hsvFundTransactionsPage0Before,
+        newHsvFundTransactions.slice(0, 4).map((hsvFundTransaction, i) => ({
+          pageSlotIndex: i + 1,
+          hsvFundTransaction,
+        }))
+      )
+    )
+
+    // The last entry starts fundTransactionsPage1
+    verifyHookStateKey(newHookStateEntries.fundTransactionsPages[1].key, {
+      destinationTag: campaignIdA,
+      dataLookupFlag: 2n,
+    })
+    expect(hsvFundTransactionsPage1After).toEqual(
+      cloneHSVFundTransactionsPage(null, [
+        { pageSlotIndex: 0, hsvFundTransaction: newHsvFundTransactions[4] },
+      ])
+    )
+  })
+})
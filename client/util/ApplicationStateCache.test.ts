@@ -0,0 +1,265 @@
+import { EventEmitter } from 'events'
+import { Connection } from 'mongoose'
+import { Client, TransactionMetadata } from 'xrpl'
+import config from '../../config.json'
+import { HOOK_ACCOUNT_WALLET } from '../app/constants'
+import connectDatabase from '../database'
+import { CampaignDatabaseModel } from '../database/models/campaign.model'
+import { AccountNamespaceHookStateEntry } from '../app/models/HookState'
+import {
+  BACKER,
+  createCampaignNamespaceEntries,
+} from '../app/models/testFixtures'
+import {
+  ApplicationStateCache,
+  extractHookStateChanges,
+} from './ApplicationStateCache'
+import { HookStateWorkerPool } from './HookStateWorkerPool'
+import { TransactionWaiter } from './TransactionWaiter'
+import { deriveHookNamespace } from './transaction'
+
+const GENERAL_INFO_KEY =
+  '0000000000000000000000000000000000000000000000000000000000000001'
+const FUND_TRANSACTIONS_PAGE_KEY =
+  '0000000000000000000000000000000000000000000000000000000100000001'
+
+describe('extractHookStateChanges', () => {
+  it('should extract created, modified and deleted HookState entries', () => {
+    const meta = {
+      TransactionIndex: 0,
+      TransactionResult: 'tesSUCCESS',
+      AffectedNodes: [
+        {
+          ModifiedNode: {
+            LedgerEntryType: 'AccountRoot',
+            LedgerIndex: 'A',
+            FinalFields: { Balance: '100' },
+          },
+        },
+        {
+          ModifiedNode: {
+            LedgerEntryType: 'HookState',
+            LedgerIndex: 'B',
+            FinalFields: {
+              HookStateKey: GENERAL_INFO_KEY,
+              HookStateData: 'AA',
+            },
+            PreviousFields: { HookStateData: 'BB' },
+          },
+        },
+        {
+          CreatedNode: {
+            LedgerEntryType: 'HookState',
+            LedgerIndex: 'C',
+            NewFields: {
+              HookStateKey: FUND_TRANSACTIONS_PAGE_KEY,
+              HookStateData: 'CC',
+            },
+          },
+        },
+        {
+          DeletedNode: {
+            LedgerEntryType: 'HookState',
+            LedgerIndex: 'D',
+            FinalFields: {
+              HookStateKey: GENERAL_INFO_KEY,
+              HookStateData: 'DD',
+            },
+          },
+        },
+      ],
+    } as unknown as TransactionMetadata
+
+    expect(extractHookStateChanges(meta)).toEqual([
+      { type: 'set', hookStateKey: GENERAL_INFO_KEY, hookStateData: 'AA' },
+      {
+        type: 'set',
+        hookStateKey: FUND_TRANSACTIONS_PAGE_KEY,
+        hookStateData: 'CC',
+      },
+      { type: 'delete', hookStateKey: GENERAL_INFO_KEY },
+    ])
+  })
+
+  it('should return no changes when no HookState entry is affected', () => {
+    const meta = {
+      TransactionIndex: 0,
+      TransactionResult: 'tecHOOK_REJECTED',
+      AffectedNodes: [
+        {
+          ModifiedNode: {
+            LedgerEntryType: 'AccountRoot',
+            LedgerIndex: 'A',
+            FinalFields: { Balance: '100' },
+          },
+        },
+      ],
+    } as unknown as TransactionMetadata
+
+    expect(extractHookStateChanges(meta)).toEqual([])
+  })
+})
+
+// Serves namespaceEntries as the Hook State of a single validated ledger
+class FakeClient extends EventEmitter {
+  namespaceEntries: AccountNamespaceHookStateEntry[] = []
+  unsubscribeRequests: any[] = []
+
+  isConnected(): boolean {
+    return true
+  }
+
+  async request(request: any): Promise<any> {
+    switch (request.command) {
+      case 'subscribe':
+        return { result: { ledger_index: 10 } }
+      case 'account_info':
+        return {
+          result: {
+            ledger_index: 10,
+            account_data: {
+              HookNamespaces: [deriveHookNamespace(config.HOOK_NAMESPACE_SEED)],
+            },
+          },
+        }
+      case 'account_namespace':
+        return { result: { namespace_entries: this.namespaceEntries } }
+      case 'unsubscribe':
+        this.unsubscribeRequests.push(request)
+        return { result: {} }
+      default:
+        return { result: {} }
+    }
+  }
+}
+
+// Assembles inline and keeps the entries it was given
+class RecordingWorkerPool extends HookStateWorkerPool {
+  assembledEntries: AccountNamespaceHookStateEntry[] = []
+
+  constructor() {
+    super(0)
+  }
+
+  async assemble(namespaceEntries: AccountNamespaceHookStateEntry[]) {
+    this.assembledEntries.push(...namespaceEntries)
+    return super.assemble(namespaceEntries)
+  }
+}
+
+describe('ApplicationStateCache', () => {
+  const CAMPAIGN_ID = 4000000007
+  let database: Connection
+  let client: FakeClient
+  let pool: RecordingWorkerPool
+  let cache: ApplicationStateCache
+
+  beforeAll(async () => {
+    database = connectDatabase()
+    await CampaignDatabaseModel.create({
+      id: CAMPAIGN_ID,
+      title: 'title',
+      description: 'description',
+      overviewUrl: 'overviewUrl',
+      imageUrl: 'imageUrl',
+      milestones: [
+        { endDateInUnixSeconds: '1710000000', title: 'Milestone 1' },
+        { endDateInUnixSeconds: '1720000000', title: 'Milestone 2' },
+      ],
+    })
+  })
+
+  afterAll(async () => {
+    await CampaignDatabaseModel.deleteOne({ id: CAMPAIGN_ID })
+    await database.close()
+  })
+
+  beforeEach(() => {
+    client = new FakeClient()
+    client.namespaceEntries = createCampaignNamespaceEntries(CAMPAIGN_ID)
+    pool = new RecordingWorkerPool()
+    cache = new ApplicationStateCache(
+      client as unknown as Client,
+      database,
+      client as unknown as Client,
+      pool
+    )
+  })
+
+  afterEach(async () => {
+    await cache.stop()
+  })
+
+  it('should load the Hook State through the worker pool', async () => {
+    await cache.start()
+
+    const campaign = await cache.readApplicationState((applicationState) =>
+      applicationState.getCampaignById(CAMPAIGN_ID)
+    )
+    expect(campaign?.title).toBe('title')
+    expect(campaign?.milestones.map(({ title }) => title)).toEqual([
+      'Milestone 1',
+      'Milestone 2',
+    ])
+    expect(campaign?.backers.map(({ account }) => account)).toEqual([
+      BACKER,
+      campaign?.owner,
+    ])
+    expect(pool.assembledEntries).toHaveLength(2)
+  })
+
+  it('should decode Fund Transactions pages only when they are read', async () => {
+    const [generalInfoEntry, fundTransactionsPageEntry] =
+      client.namespaceEntries
+    await cache.start()
+    expect(pool.assembledEntries).toEqual([generalInfoEntry])
+
+    const fundTransactions = await cache.readApplicationState(
+      (applicationState) =>
+        applicationState.getCampaignById(CAMPAIGN_ID)?.fundTransactions
+    )
+    expect(fundTransactions).toHaveLength(2)
+    expect(pool.assembledEntries).toEqual([
+      generalInfoEntry,
+      fundTransactionsPageEntry,
+    ])
+  })
+
+  it('should decode the pages of changed campaigns for listeners', async () => {
+    // Whether each notification saw the campaign's backer
+    const notified: Array<[number[], boolean]> = []
+    cache.onCampaignsChanged((campaignIds, applicationState) => {
+      const backer = applicationState.getBacker(CAMPAIGN_ID, BACKER)
+      notified.push([campaignIds, backer !== undefined])
+    })
+
+    await cache.start()
+
+    expect(notified).toEqual([[[CAMPAIGN_ID], true]])
+    expect(pool.assembledEntries).toHaveLength(2)
+  })
+
+  it('should unsubscribe the Hook Account and ledger stream when stopped', async () => {
+    await cache.start()
+    await cache.stop()
+
+    expect(client.unsubscribeRequests).toEqual([
+      {
+        command: 'unsubscribe',
+        accounts: [HOOK_ACCOUNT_WALLET.address],
+        streams: ['ledger'],
+      },
+    ])
+  })
+
+  it('should keep the subscriptions the TransactionWaiter still uses when stopped', async () => {
+    const transactionWaiter = TransactionWaiter.for(client as unknown as Client)
+    await transactionWaiter.subscribe(HOOK_ACCOUNT_WALLET.address)
+    await cache.start()
+
+    await cache.stop()
+
+    expect(client.unsubscribeRequests).toEqual([])
+    transactionWaiter.unsubscribe(HOOK_ACCOUNT_WALLET.address)
+  })
+})
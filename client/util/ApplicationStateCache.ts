@@ -0,0 +1,544 @@
+import {
+  Client,
+  LedgerStream,
+  SubscribeRequest,
+  TransactionMetadata,
+  TransactionStream,
+  UnsubscribeRequest,
+} from 'xrpl'
+import { Connection } from 'mongoose'
+import { HOOK_ACCOUNT_WALLET } from '../app/constants'
+import { ApplicationState } from '../app/models/ApplicationState'
+import { AccountNamespaceHookStateEntry } from '../app/models/HookState'
+import { HookStateKey } from '../app/models/HookStateKey'
+import {
+  AssembledHookState,
+  applyAssembledHookState,
+} from './assembleHookState'
+import { HookStateWorkerPool } from './HookStateWorkerPool'
+import { StateUtility } from './StateUtility'
+import { TransactionWaiter } from './TransactionWaiter'
+import { XrplRequester } from './XrplConnectionPool'
+
+export type HookStateChange =
+  | { type: 'set'; hookStateKey: string; hookStateData: string }
+  | { type: 'delete'; hookStateKey: string }
+
+/**
+ * Called on the ApplicationStateCache queue after campaigns changed, with the ids of the changed
+ * campaigns; applicationState must only be read synchronously.
+ */
+export type CampaignsChangedListener = (
+  campaignIds: number[],
+  applicationState: ApplicationState
+) => void
+
+type HookStateFields = {
+  HookStateKey?: string
+  HookStateData?: string
+}
+
+/**
+ * Returns the HookState ledger entries a transaction created, modified or deleted,
+ * in the order they appear in its metadata.
+ */
+export function extractHookStateChanges(
+  meta: TransactionMetadata
+): HookStateChange[] {
+  const changes: HookStateChange[] = []
+  for (const node of meta.AffectedNodes) {
+    if ('CreatedNode' in node) {
+      const { LedgerEntryType, NewFields } = node.CreatedNode
+      const fields = NewFields as HookStateFields
+      if (
+        LedgerEntryType === 'HookState' &&
+        fields.HookStateKey &&
+        fields.HookStateData
+      ) {
+        changes.push({
+          type: 'set',
+          hookStateKey: fields.HookStateKey,
+          hookStateData: fields.HookStateData,
+        })
+      }
+    } else if ('ModifiedNode' in node) {
+      const { LedgerEntryType, FinalFields } = node.ModifiedNode
+      const fields = (FinalFields ?? {}) as HookStateFields
+      if (
+        LedgerEntryType === 'HookState' &&
+        fields.HookStateKey &&
+        fields.HookStateData
+      ) {
+        changes.push({
+          type: 'set',
+          hookStateKey: fields.HookStateKey,
+          hookStateData: fields.HookStateData,
+        })
+      }
+    } else if ('DeletedNode' in node) {
+      const { LedgerEntryType, FinalFields } = node.DeletedNode
+      const fields = FinalFields as HookStateFields
+      if (LedgerEntryType === 'HookState' && fields.HookStateKey) {
+        changes.push({ type: 'delete', hookStateKey: fields.HookStateKey })
+      }
+    }
+  }
+  return changes
+}
+
+/*
+In-memory ApplicationState kept at the latest validated ledger.
+
+The state is loaded once with StateUtility.iterateAccountNamespacePages, then the cache subscribes to
+the Hook Account's validated transactions and patches it from each transaction's HookState
+AffectedNodes: only the changed entries are decoded and applied to the indexed ApplicationState.
+Loaded pages and changed entries are decoded and assembled on the HookStateWorkerPool (with the
+native decoder when it's built) and applied with applyAssembledHookState, like
+StateUtility.getApplicationState. General Info entries are applied right away; Fund Transactions
+pages are kept encoded until something reads fund transactions or backers: a reader
+(getApplicationState, readApplicationState) or a CampaignsChangedListener of their campaign. A page
+changed several times in between is only decoded once.
+
+All loads and patches run one at a time on a queue, so transactions streamed while the initial load
+is in progress are applied after it (and skipped if the load already includes their ledger).
+
+General Info entries are kept encoded, with their end dates, so campaign and milestone states, which
+are derived from the current time, are re-assembled once a fund raise or milestone end date passes.
+A campaign created by Application.createCampaign is hidden until its metadata is saved to the
+database.
+*/
+export class ApplicationStateCache {
+  private readonly client: Client
+  // Reads the Hook State; the client unless a connection pool is given
+  private readonly requester: XrplRequester
+  private readonly database: Connection
+  // The shared pool unless one is given
+  private readonly pool: HookStateWorkerPool | undefined
+  private applicationState: ApplicationState = new ApplicationState()
+  private generalInfoEntries: Map<number, AccountNamespaceHookStateEntry> =
+    new Map()
+  // Fund raise and milestone end dates of each applied General Info
+  private endDates: Map<number, bigint[]> = new Map()
+  private pendingCampaignIds: Set<number> = new Set()
+  // Fund Transactions pages not applied yet, by HookStateKey
+  private pendingFundTransactionsPages: Map<
+    string,
+    AccountNamespaceHookStateEntry
+  > = new Map()
+  private nextStateChangeInUnixSeconds: bigint | undefined
+  // Ledger the last full load was read at; streamed transactions up to it are already included
+  private loadedLedgerIndex: number | undefined
+  // Bumped whenever the state's campaigns, fund transactions or derived states change
+  private stateVersion = 0
+  private changedCampaignIds: Set<number> = new Set()
+  private campaignsChangedListeners: Set<CampaignsChangedListener> = new Set()
+  private queue: Promise<void> = Promise.resolve()
+  private started = false
+
+  constructor(
+    client: Client,
+    database: Connection,
+    requester: XrplRequester = client,
+    pool?: HookStateWorkerPool
+  ) {
+    this.client = client
+    this.requester = requester
+    this.database = database
+    this.pool = pool
+  }
+
+  // Validated ledger the cached state is at; undefined until loaded
+  get ledgerIndex(): number | undefined {
+    return this.applicationState.ledgerIndex
+  }
+
+  async start(): Promise<void> {
+    if (this.started) {
+      return
+    }
+    if (!this.client.isConnected()) {
+      throw new Error('xrpl Client is not connected')
+    }
+    this.started = true
+
+    this.client.on('transaction', this._onTransaction)
+    this.client.on('ledgerClosed', this._onLedgerClosed)
+    this.client.on('connected', this._onConnected)
+    await this._enqueue(() => this._load())
+  }
+
+  async stop(): Promise<void> {
+    if (!this.started) {
+      return
+    }
+    this.started = false
+
+    this.client.off('transaction', this._onTransaction)
+    this.client.off('ledgerClosed', this._onLedgerClosed)
+    this.client.off('connected', this._onConnected)
+    await this.queue
+    // The connection's TransactionWaiter shares the Hook Account and ledger stream subscriptions,
+    // so leave whatever it still uses in place
+    const transactionWaiter = TransactionWaiter.for(this.client)
+    const hookAccount = HOOK_ACCOUNT_WALLET.address
+    const unsubscribeRequest: UnsubscribeRequest = { command: 'unsubscribe' }
+    if (!transactionWaiter.isSubscribed(hookAccount)) {
+      unsubscribeRequest.accounts = [hookAccount]
+    }
+    if (!transactionWaiter.hasSubscriptions) {
+      unsubscribeRequest.streams = ['ledger']
+    }
+    if (
+      this.client.isConnected() &&
+      (unsubscribeRequest.accounts || unsubscribeRequest.streams)
+    ) {
+      await this.client.request(unsubscribeRequest)
+    }
+  }
+
+  async getApplicationState(): Promise<ApplicationState> {
+    if (!this.started) {
+      throw new Error('ApplicationStateCache is not started')
+    }
+
+    await this._enqueue(async () => {
+      await this._refreshTimeDerivedStates()
+      await this._applyPendingFundTransactionsPages()
+    })
+    return this.applicationState
+  }
+
+  /**
+   * Runs reader on the queue so the state can't change while it's read. stateVersion only changes
+   * when the state does, so readers can reuse anything they built for the same version.
+   */
+  async readApplicationState<T>(
+    reader: (applicationState: ApplicationState, stateVersion: number) => T
+  ): Promise<T> {
+    if (!this.started) {
+      throw new Error('ApplicationStateCache is not started')
+    }
+
+    let result: T | undefined
+    await this._enqueue(async () => {
+      await this._refreshTimeDerivedStates()
+      await this._applyPendingFundTransactionsPages()
+      result = reader(this.applicationState, this.stateVersion)
+    })
+    return result as T
+  }
+
+  /**
+   * Calls listener whenever campaigns change: transactions touching their Hook State, reloads
+   * and time-derived state changes (checked on every ledger close while someone listens).
+   * @returns a function that removes the listener
+   */
+  onCampaignsChanged(listener: CampaignsChangedListener): () => void {
+    this.campaignsChangedListeners.add(listener)
+    return () => {
+      this.campaignsChangedListeners.delete(listener)
+    }
+  }
+
+  private _onTransaction = (transactionStream: TransactionStream): void => {
+    if (!transactionStream.validated || !transactionStream.meta) {
+      return
+    }
+    this._enqueue(() => this._applyTransaction(transactionStream)).catch(
+      (error) => {
+        console.error(
+          `ApplicationStateCache failed to apply transaction, reloading: ${error}`
+        )
+        this._reload()
+      }
+    )
+  }
+
+  private _onLedgerClosed = (ledgerStream: LedgerStream): void => {
+    // The ledger stream message can arrive before the ledger's transactions, so this only
+    // advances ledgerIndex; transactions are filtered against loadedLedgerIndex instead
+    this._enqueue(async () => {
+      this._advanceLedgerIndex(ledgerStream.ledger_index)
+      // Otherwise time-derived states only change on reads
+      if (this.campaignsChangedListeners.size > 0) {
+        await this._refreshTimeDerivedStates()
+      }
+    }).catch((error) => {
+      console.error(
+        `ApplicationStateCache failed to refresh time-derived states: ${error}`
+      )
+    })
+  }
+
+  private _advanceLedgerIndex(ledgerIndex: number): void {
+    if (
+      this.applicationState.ledgerIndex !== undefined &&
+      ledgerIndex > this.applicationState.ledgerIndex
+    ) {
+      this.applicationState.ledgerIndex = ledgerIndex
+    }
+  }
+
+  // Subscriptions don't survive a reconnect and transactions may have been missed while disconnected
+  private _onConnected = (): void => {
+    this._reload()
+  }
+
+  private _reload(): void {
+    this._enqueue(() => this._load()).catch((error) => {
+      console.error(`ApplicationStateCache failed to reload: ${error}`)
+    })
+  }
+
+  private _enqueue(task: () => Promise<void>): Promise<void> {
+    const result = this.queue
+      .then(task)
+      .finally(() => this._notifyCampaignsChanged())
+    // keep the queue going if a task fails; callers get the failure from result
+    this.queue = result.catch(() => undefined)
+    return result
+  }
+
+  private async _load(): Promise<void> {
+    if (!this.started) {
+      return
+    }
+    if (this.database.readyState !== 1) {
+      throw new Error('MongoDB database is not connected')
+    }
+
+    // Step 1. Subscribe first so no transaction after the loaded ledger is missed
+    const subscribeRequest: SubscribeRequest = {
+      command: 'subscribe',
+      accounts: [HOOK_ACCOUNT_WALLET.address],
+      streams: ['ledger'],
+    }
+    const subscribeResponse = await this.client.request(subscribeRequest)
+
+    // Step 2. Load the Hook State at the ledger the subscription starts after, which also keeps
+    // every page on the same ledger when the requester spreads them across nodes
+    const { ledger_index: subscribedLedgerIndex } =
+      subscribeResponse.result as { ledger_index?: number }
+    this.applicationState = new ApplicationState()
+    this.stateVersion++
+    this.generalInfoEntries = new Map()
+    this.endDates = new Map()
+    this.pendingCampaignIds = new Set()
+    this.pendingFundTransactionsPages = new Map()
+    this.loadedLedgerIndex = undefined
+    try {
+      const pages = StateUtility.iterateAccountNamespacePages(this.requester, {
+        ledgerIndex: subscribedLedgerIndex,
+      })
+      for await (const { ledgerIndex, namespaceEntries } of pages) {
+        this.applicationState.ledgerIndex = ledgerIndex
+        this.loadedLedgerIndex = ledgerIndex
+        await this._applyEntries(namespaceEntries)
+      }
+    } catch (error: Error | any) {
+      if (!StateUtility.isHookStateEmptyError(error)) {
+        throw error
+      }
+    }
+  }
+
+  private async _applyTransaction(
+    transactionStream: TransactionStream
+  ): Promise<void> {
+    const { ledger_index: ledgerIndex, meta } = transactionStream
+    if (
+      this.loadedLedgerIndex !== undefined &&
+      ledgerIndex <= this.loadedLedgerIndex
+    ) {
+      // already included in the loaded state
+      return
+    }
+
+    const changes = extractHookStateChanges(meta as TransactionMetadata)
+    if (changes.some(({ type }) => type === 'delete')) {
+      // Deleted entries (e.g. a finished campaign's state or processed refunds) aren't patched out
+      // of the indexed state, so reload at the new ledger instead. Layout migrations don't delete:
+      // migrate_hook_state only trims Fund Transactions pages and rewrites the trailer, both sets.
+      await this._load()
+      return
+    }
+
+    const namespaceEntries: AccountNamespaceHookStateEntry[] = []
+    for (const change of changes) {
+      if (change.type === 'set') {
+        namespaceEntries.push({
+          HookStateKey: change.hookStateKey,
+          HookStateData: change.hookStateData,
+        } as AccountNamespaceHookStateEntry)
+      }
+    }
+    await this._applyEntries(namespaceEntries)
+    this._advanceLedgerIndex(ledgerIndex)
+  }
+
+  private async _applyEntries(
+    namespaceEntries: AccountNamespaceHookStateEntry[]
+  ): Promise<void> {
+    if (namespaceEntries.length > 0) {
+      this.stateVersion++
+    }
+    // Fund Transactions pages are applied when read; General Info entries are applied below
+    for (const namespaceEntry of namespaceEntries) {
+      const { HookStateKey: hookStateKey } = namespaceEntry
+      const destinationTag = HookStateKey.destinationTagOf(hookStateKey)
+      this.changedCampaignIds.add(destinationTag)
+      const dataLookupFlag = HookStateKey.dataLookupFlagOf(hookStateKey)
+      if (HookStateKey.kindOf(dataLookupFlag) === 'generalInfo') {
+        this.generalInfoEntries.set(destinationTag, namespaceEntry)
+        this.pendingCampaignIds.add(destinationTag)
+      } else {
+        // A later version of the page replaces the pending one
+        this.pendingFundTransactionsPages.set(hookStateKey, namespaceEntry)
+      }
+    }
+
+    await this._applyPendingGeneralInfo()
+  }
+
+  // Applies the pending Fund Transactions pages of campaignIds, or all of them
+  private async _applyPendingFundTransactionsPages(
+    campaignIds?: Set<number>
+  ): Promise<void> {
+    const namespaceEntries: AccountNamespaceHookStateEntry[] = []
+    for (const [hookStateKey, namespaceEntry] of this
+      .pendingFundTransactionsPages) {
+      if (
+        !campaignIds ||
+        campaignIds.has(HookStateKey.destinationTagOf(hookStateKey))
+      ) {
+        namespaceEntries.push(namespaceEntry)
+      }
+    }
+    if (namespaceEntries.length === 0) {
+      return
+    }
+
+    // They don't need campaign metadata; the pages stay pending if they fail to decode
+    const pool = this.pool ?? HookStateWorkerPool.shared()
+    for (const assembled of await pool.assemble(namespaceEntries)) {
+      applyAssembledHookState(this.applicationState, assembled, new Map())
+    }
+    for (const { HookStateKey: hookStateKey } of namespaceEntries) {
+      this.pendingFundTransactionsPages.delete(hookStateKey)
+    }
+  }
+
+  private async _applyPendingGeneralInfo(): Promise<void> {
+    if (this.pendingCampaignIds.size > 0) {
+      const campaignsMetadata = await StateUtility.getCampaignsMetadata([
+        ...this.pendingCampaignIds,
+      ])
+      // metadata is saved after the createCampaign transaction validates; the rest is retried on
+      // the next read
+      const namespaceEntries: AccountNamespaceHookStateEntry[] = []
+      for (const campaignId of this.pendingCampaignIds) {
+        const namespaceEntry = this.generalInfoEntries.get(campaignId)
+        if (namespaceEntry && campaignsMetadata.has(campaignId)) {
+          namespaceEntries.push(namespaceEntry)
+        }
+      }
+
+      if (namespaceEntries.length > 0) {
+        const pool = this.pool ?? HookStateWorkerPool.shared()
+        for (const assembled of await pool.assemble(namespaceEntries)) {
+          applyAssembledHookState(
+            this.applicationState,
+            assembled,
+            campaignsMetadata
+          )
+          this._setEndDates(assembled)
+        }
+        for (const namespaceEntry of namespaceEntries) {
+          const campaignId = HookStateKey.destinationTagOf(
+            namespaceEntry.HookStateKey
+          )
+          this.pendingCampaignIds.delete(campaignId)
+          this.changedCampaignIds.add(campaignId)
+        }
+        this.stateVersion++
+      }
+    }
+
+    this._updateNextStateChange()
+  }
+
+  private _setEndDates({ campaigns, milestones }: AssembledHookState): void {
+    let milestoneIndex = 0
+    for (let i = 0; i < campaigns.id.length; i++) {
+      const endDates = [campaigns.fundRaiseEndDateInUnixSeconds[i]]
+      for (; milestoneIndex < campaigns.milestonesEnd[i]; milestoneIndex++) {
+        endDates.push(milestones.endDateInUnixSeconds[milestoneIndex])
+      }
+      this.endDates.set(campaigns.id[i], endDates)
+    }
+  }
+
+  private async _notifyCampaignsChanged(): Promise<void> {
+    if (this.changedCampaignIds.size === 0) {
+      return
+    }
+    const changedCampaignIds = this.changedCampaignIds
+    this.changedCampaignIds = new Set()
+    if (this.campaignsChangedListeners.size === 0) {
+      return
+    }
+
+    // Listeners read the changed campaigns' fund transactions
+    try {
+      await this._applyPendingFundTransactionsPages(changedCampaignIds)
+    } catch (error) {
+      console.error(
+        `ApplicationStateCache failed to apply Fund Transactions pages: ${error}`
+      )
+      // Listeners are notified of these campaigns with the next change
+      for (const campaignId of changedCampaignIds) {
+        this.changedCampaignIds.add(campaignId)
+      }
+      return
+    }
+    const campaignIds = [...changedCampaignIds]
+    for (const listener of this.campaignsChangedListeners) {
+      try {
+        listener(campaignIds, this.applicationState)
+      } catch (error) {
+        console.error(`CampaignsChangedListener failed: ${error}`)
+      }
+    }
+  }
+
+  private async _refreshTimeDerivedStates(): Promise<void> {
+    const currentTimeUnixInSeconds = BigInt(Math.floor(Date.now() / 1000))
+    if (
+      this.nextStateChangeInUnixSeconds !== undefined &&
+      currentTimeUnixInSeconds >= this.nextStateChangeInUnixSeconds
+    ) {
+      for (const campaignId of this.generalInfoEntries.keys()) {
+        this.pendingCampaignIds.add(campaignId)
+      }
+    }
+
+    await this._applyPendingGeneralInfo()
+  }
+
+  // Earliest fund raise or milestone end date still in the future, across all campaigns
+  private _updateNextStateChange(): void {
+    const currentTimeUnixInSeconds = BigInt(Math.floor(Date.now() / 1000))
+    let next: bigint | undefined
+    for (const endDates of this.endDates.values()) {
+      for (const endDate of endDates) {
+        if (
+          endDate > currentTimeUnixInSeconds &&
+          (next === undefined || endDate < next)
+        ) {
+          next = endDate
+        }
+      }
+    }
+    this.nextStateChangeInUnixSeconds = next
+  }
+}
@@ -0,0 +1,173 @@
+import { ApplicationState } from '../app/models/ApplicationState'
+import { Campaign } from '../app/models/Campaign'
+import { FundTransaction } from '../app/models/FundTransaction'
+import { Milestone } from '../app/models/Milestone'
+import { createCampaign, OWNER } from '../app/models/testFixtures'
+import { CampaignsChangedListener } from './ApplicationStateCache'
+import {
+  CampaignViewIndexer,
+  CampaignViewRecords,
+  createCampaignViewRecords,
+} from './CampaignViewIndexer'
+
+const BACKER_1 = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+const BACKER_2 = 'rPT1Sjq2YGrBMTttX4GZHjKu9dyfzbpAYe'
+
+function createApplicationState(): ApplicationState {
+  const applicationState = new ApplicationState()
+  applicationState.setCampaign(
+    createCampaign(1, {
+      totalAmountRaisedInDrops: BigInt(300),
+      milestones: [
+        new Milestone('unstarted', BigInt(1710000000), 100, 'Milestone 1'),
+      ],
+    })
+  )
+  applicationState.setFundTransaction(
+    1,
+    new FundTransaction(0, BACKER_1, 'approve', BigInt(100))
+  )
+  applicationState.setFundTransaction(
+    1,
+    new FundTransaction(1, BACKER_2, 'approve', BigInt(200))
+  )
+  return applicationState
+}
+
+describe('createCampaignViewRecords', () => {
+  it('should convert a campaign with its fund transactions and backers', () => {
+    const campaign = createApplicationState().getCampaignById(1) as Campaign
+    const records = createCampaignViewRecords(campaign, 10)
+
+    expect(records.campaign).toEqual({
+      campaignId: 1,
+      ledgerIndex: 10,
+      stateFlag: 0,
+      owner: OWNER,
+      fundRaiseGoalInDrops: '25000000000',
+      fundRaiseEndDateInUnixSeconds: 1700000000,
+      totalAmountRaisedInDrops: '300',
+      totalAmountNonRefundableInDrops: '0',
+      totalReserveAmountInDrops: '0',
+      totalRejectVotesForCurrentMilestone: 0,
+      totalFundTransactions: 2,
+      milestones: [
+        {
+          stateFlag: 0,
+          endDateInUnixSeconds: '1710000000',
+          payoutPercent: 100,
+        },
+      ],
+    })
+    expect(records.fundTransactions).toEqual([
+      {
+        campaignId: 1,
+        fundTransactionId: 0,
+        ledgerIndex: 10,
+        account: BACKER_1,
+        state: 'approve',
+        amountInDrops: '100',
+      },
+      {
+        campaignId: 1,
+        fundTransactionId: 1,
+        ledgerIndex: 10,
+        account: BACKER_2,
+        state: 'approve',
+        amountInDrops: '200',
+      },
+    ])
+    expect(records.backers).toEqual([
+      {
+        campaignId: 1,
+        account: BACKER_1,
+        ledgerIndex: 10,
+        fundTransactionIds: [0],
+      },
+      {
+        campaignId: 1,
+        account: BACKER_2,
+        ledgerIndex: 10,
+        fundTransactionIds: [1],
+      },
+    ])
+  })
+
+  it('should only include fund transactions that changed', () => {
+    const applicationState = createApplicationState()
+    applicationState.setFundTransaction(
+      1,
+      new FundTransaction(1, BACKER_2, 'reject', BigInt(200))
+    )
+    const campaign = applicationState.getCampaignById(1) as Campaign
+    const records = createCampaignViewRecords(campaign, 11, [
+      'approve',
+      'approve',
+    ])
+
+    expect(records.campaign.totalFundTransactions).toBe(2)
+    expect(
+      records.fundTransactions.map(
+        ({ fundTransactionId }) => fundTransactionId
+      )
+    ).toEqual([1])
+    expect(records.backers.map(({ account }) => account)).toEqual([BACKER_2])
+  })
+})
+
+describe('CampaignViewIndexer', () => {
+  let listener: CampaignsChangedListener
+  const source = {
+    onCampaignsChanged: (campaignsChanged: CampaignsChangedListener) => {
+      listener = campaignsChanged
+      return () => undefined
+    },
+  }
+
+  // Fails the first `failures` writes, then keeps the campaign ids of each write
+  function createWriter(failures: number) {
+    const writes: number[][] = []
+    const writeRecords = async (records: CampaignViewRecords[]) => {
+      if (failures-- > 0) {
+        throw new Error('MongoDB is unavailable')
+      }
+      writes.push(records.map(({ campaign }) => campaign.campaignId))
+    }
+    return { writes, writeRecords }
+  }
+
+  function createLedgerState(): ApplicationState {
+    const applicationState = createApplicationState()
+    applicationState.setCampaign(createCampaign(2))
+    applicationState.ledgerIndex = 10
+    return applicationState
+  }
+
+  it('should retry a failed write', async () => {
+    const { writes, writeRecords } = createWriter(2)
+    const indexer = new CampaignViewIndexer(source, writeRecords, 0)
+    indexer.start()
+
+    listener([1], createLedgerState())
+    await indexer.stop()
+
+    expect(writes).toEqual([[1]])
+  })
+
+  it('should rewrite campaigns whose write failed with the next change', async () => {
+    // The first write and its 3 retries fail
+    const { writes, writeRecords } = createWriter(4)
+    const indexer = new CampaignViewIndexer(source, writeRecords, 0)
+    indexer.start()
+    const applicationState = createLedgerState()
+
+    listener([1], applicationState)
+    await indexer.stop()
+    expect(writes).toEqual([])
+
+    indexer.start()
+    listener([2], applicationState)
+    await indexer.stop()
+    expect(writes).toEqual([[2, 1]])
+  })
+})
@@ -0,0 +1,273 @@
+import { campaignStateFlagOf, milestoneStateFlagOf } from '../app/constants'
+import { ApplicationState } from '../app/models/ApplicationState'
+import { Campaign } from '../app/models/Campaign'
+import {
+  BackerViewDatabaseModel,
+  IBackerViewDatabaseModel,
+} from '../database/models/backerView.model'
+import {
+  CampaignViewDatabaseModel,
+  ICampaignViewDatabaseModel,
+} from '../database/models/campaignView.model'
+import {
+  FundTransactionViewDatabaseModel,
+  IFundTransactionViewDatabaseModel,
+} from '../database/models/fundTransactionView.model'
+import { CampaignsChangedListener } from './ApplicationStateCache'
+
+export interface CampaignViewRecords {
+  campaign: ICampaignViewDatabaseModel
+  // Only fund transactions whose state differs from writtenFundTransactionStates
+  fundTransactions: IFundTransactionViewDatabaseModel[]
+  // Only backers of those fund transactions
+  backers: IBackerViewDatabaseModel[]
+}
+
+export interface CampaignsChangedSource {
+  onCampaignsChanged(listener: CampaignsChangedListener): () => void
+}
+
+export type CampaignViewRecordsWriter = (
+  records: CampaignViewRecords[]
+) => Promise<void>
+
+// A failed write is retried this many times, after WRITE_RETRY_DELAY_MS and then twice as long each time
+const WRITE_RETRIES = 3
+const WRITE_RETRY_DELAY_MS = 500
+
+/**
+ * Converts a campaign to view records at ledgerIndex.
+ * @param writtenFundTransactionStates fund transaction states already in the view, by id
+ */
+export function createCampaignViewRecords(
+  campaign: Campaign,
+  ledgerIndex: number,
+  writtenFundTransactionStates: string[] = []
+): CampaignViewRecords {
+  const fundTransactions: IFundTransactionViewDatabaseModel[] = []
+  const changedAccounts: Set<string> = new Set()
+  let totalFundTransactions = 0
+  campaign.fundTransactions.forEach((fundTransaction, index) => {
+    // fundTransactions is positioned by id, so it may have holes
+    if (!fundTransaction) {
+      return
+    }
+    totalFundTransactions++
+    if (writtenFundTransactionStates[index] === fundTransaction.state) {
+      return
+    }
+    fundTransactions.push({
+      campaignId: campaign.id,
+      fundTransactionId: fundTransaction.id,
+      ledgerIndex,
+      account: fundTransaction.account,
+      state: fundTransaction.state,
+      amountInDrops: fundTransaction.amountInDrops.toString(),
+    })
+    changedAccounts.add(fundTransaction.account)
+  })
+
+  const backers: IBackerViewDatabaseModel[] = campaign.backers
+    .filter((backer) => changedAccounts.has(backer.account))
+    .map((backer) => ({
+      campaignId: campaign.id,
+      account: backer.account,
+      ledgerIndex,
+      fundTransactionIds: backer.fundTransactions.map(({ id }) => id),
+    }))
+
+  return {
+    campaign: {
+      campaignId: campaign.id,
+      ledgerIndex,
+      stateFlag: campaignStateFlagOf(campaign.state),
+      owner: campaign.owner,
+      fundRaiseGoalInDrops: campaign.fundRaiseGoalInDrops.toString(),
+      fundRaiseEndDateInUnixSeconds: Number(
+        campaign.fundRaiseEndDateInUnixSeconds
+      ),
+      totalAmountRaisedInDrops: campaign.totalAmountRaisedInDrops.toString(),
+      totalAmountNonRefundableInDrops:
+        campaign.totalAmountNonRefundableInDrops.toString(),
+      totalReserveAmountInDrops: campaign.totalReserveAmountInDrops.toString(),
+      totalRejectVotesForCurrentMilestone:
+        campaign.totalRejectVotesForCurrentMilestone,
+      totalFundTransactions,
+      milestones: campaign.milestones.map((milestone) => ({
+        stateFlag: milestoneStateFlagOf(milestone.state),
+        endDateInUnixSeconds: milestone.endDateInUnixSeconds.toString(),
+        payoutPercent: milestone.payoutPercent,
+      })),
+    },
+    fundTransactions,
+    backers,
+  }
+}
+
+export async function writeCampaignViewRecords(
+  records: CampaignViewRecords[]
+): Promise<void> {
+  const campaigns = records.map(({ campaign }) => campaign)
+  const fundTransactions = records.flatMap(
+    ({ fundTransactions }) => fundTransactions
+  )
+  const backers = records.flatMap(({ backers }) => backers)
+
+  // Fund transactions and backers first, so a campaign record never counts records that aren't written
+  if (fundTransactions.length > 0) {
+    await FundTransactionViewDatabaseModel.bulkWrite(
+      fundTransactions.map((fundTransaction) => ({
+        replaceOne: {
+          filter: {
+            campaignId: fundTransaction.campaignId,
+            fundTransactionId: fundTransaction.fundTransactionId,
+          },
+          replacement: fundTransaction,
+          upsert: true,
+        },
+      })),
+      { ordered: false }
+    )
+  }
+  if (backers.length > 0) {
+    await BackerViewDatabaseModel.bulkWrite(
+      backers.map((backer) => ({
+        replaceOne: {
+          filter: { campaignId: backer.campaignId, account: backer.account },
+          replacement: backer,
+          upsert: true,
+        },
+      })),
+      { ordered: false }
+    )
+  }
+  if (campaigns.length > 0) {
+    await CampaignViewDatabaseModel.bulkWrite(
+      campaigns.map((campaign) => ({
+        replaceOne: {
+          filter: { campaignId: campaign.campaignId },
+          replacement: campaign,
+          upsert: true,
+        },
+      })),
+      { ordered: false }
+    )
+  }
+}
+
+/*
+Keeps a materialized view of the decoded on-ledger state in MongoDB (CampaignViewDatabaseModel,
+FundTransactionViewDatabaseModel and BackerViewDatabaseModel), following ApplicationStateCache
+campaign changes. Every record carries the validated ledger index it was derived from, which
+CampaignViewReader returns with what it reads.
+
+Writes run one at a time in change order, and only fund transactions (and their backers) that
+changed since the last write are rewritten. A failed write is retried with backoff before the next
+one runs; if it still fails, its campaigns are marked dirty and rewritten in full with the next
+change of any campaign.
+*/
+export class CampaignViewIndexer {
+  private readonly source: CampaignsChangedSource
+  private readonly writeRecords: CampaignViewRecordsWriter
+  private readonly retryDelayMs: number
+  // Fund transaction states written per campaign, by fund transaction id
+  private readonly writtenFundTransactionStates: Map<number, string[]> =
+    new Map()
+  // Campaigns whose last write failed
+  private dirtyCampaignIds: Set<number> = new Set()
+  private writing: Promise<void> = Promise.resolve()
+  private removeListener: (() => void) | undefined
+
+  constructor(
+    source: CampaignsChangedSource,
+    writeRecords: CampaignViewRecordsWriter = writeCampaignViewRecords,
+    retryDelayMs = WRITE_RETRY_DELAY_MS
+  ) {
+    this.source = source
+    this.writeRecords = writeRecords
+    this.retryDelayMs = retryDelayMs
+  }
+
+  start(): void {
+    if (!this.removeListener) {
+      this.removeListener = this.source.onCampaignsChanged(
+        this._onCampaignsChanged
+      )
+    }
+  }
+
+  // Resolves once pending writes are done
+  async stop(): Promise<void> {
+    this.removeListener?.()
+    this.removeListener = undefined
+    await this.writing
+  }
+
+  private _onCampaignsChanged = (
+    campaignIds: number[],
+    applicationState: ApplicationState
+  ): void => {
+    const { ledgerIndex } = applicationState
+    if (ledgerIndex === undefined) {
+      return
+    }
+
+    // Step 1. Read the state now, it may change once the listener returns
+    const records: CampaignViewRecords[] = []
+    const dirtyCampaignIds = this.dirtyCampaignIds
+    this.dirtyCampaignIds = new Set()
+    for (const campaignId of new Set([...campaignIds, ...dirtyCampaignIds])) {
+      const campaign = applicationState.getCampaignById(campaignId)
+      if (!campaign) {
+        continue
+      }
+      records.push(
+        createCampaignViewRecords(
+          campaign,
+          ledgerIndex,
+          this.writtenFundTransactionStates.get(campaignId)
+        )
+      )
+      this.writtenFundTransactionStates.set(
+        campaignId,
+        campaign.fundTransactions.map(
+          (fundTransaction) => fundTransaction.state
+        )
+      )
+    }
+    if (records.length === 0) {
+      return
+    }
+
+    // Step 2. Write after the previous write
+    this.writing = this.writing
+      .then(() => this._write(records))
+      .catch((error) => {
+        console.error(`CampaignViewIndexer failed to write: ${error}`)
+        // Rewrite these campaigns in full with the next change
+        for (const { campaign } of records) {
+          this.writtenFundTransactionStates.delete(campaign.campaignId)
+          this.dirtyCampaignIds.add(campaign.campaignId)
+        }
+      })
+  }
+
+  private async _write(records: CampaignViewRecords[]): Promise<void> {
+    let delayMs = this.retryDelayMs
+    for (let retry = 0; ; retry++) {
+      try {
+        await this.writeRecords(records)
+        return
+      } catch (error) {
+        if (retry === WRITE_RETRIES) {
+          throw error
+        }
+        console.error(
+          `CampaignViewIndexer failed to write, retrying in ${delayMs}ms: ${error}`
+        )
+        await new Promise((resolve) => setTimeout(resolve, delayMs))
+        delayMs *= 2
+      }
+    }
+  }
+}
@@ -0,0 +1,276 @@
+import { Connection } from 'mongoose'
+import {
+  deriveCampaignState,
+  deriveMilestonesStates,
+  FundTransactionState,
+} from '../app/constants'
+import { ApplicationState } from '../app/models/ApplicationState'
+import { Campaign } from '../app/models/Campaign'
+import { FundTransaction } from '../app/models/FundTransaction'
+import { HSVCampaignGeneralInfo } from '../app/models/HSVCampaignGeneralInfo'
+import { HSVMilestone } from '../app/models/HSVMilestone'
+import { Milestone } from '../app/models/Milestone'
+import { BackerViewDatabaseModel } from '../database/models/backerView.model'
+import {
+  CampaignViewDatabaseModel,
+  ICampaignViewDatabaseModel,
+} from '../database/models/campaignView.model'
+import {
+  FundTransactionViewDatabaseModel,
+  IFundTransactionViewDatabaseModel,
+} from '../database/models/fundTransactionView.model'
+import { StateUtility } from './StateUtility'
+import { XrplRequester } from './XrplConnectionPool'
+
+export interface BackerCampaignsView {
+  // Oldest ledger the view records were derived from; campaigns read from the ledger are newer
+  ledgerIndex: number | undefined
+  campaigns: Array<{ campaignId: number; fundTransactions: FundTransaction[] }>
+}
+
+/*
+Reads the MongoDB view kept by CampaignViewIndexer. Campaigns the view doesn't have in full (no
+CampaignView record, or fewer FundTransactionView records than its totalFundTransactions) are read
+from the ledger with StateUtility.getCampaign instead.
+
+Campaign and milestone states are derived on read from the stored state codes and end dates, the
+same way StateUtility derives them when decoding.
+*/
+export class CampaignViewReader {
+  /**
+   * @returns the campaign, or undefined if it doesn't exist
+   */
+  static async getCampaign(
+    client: XrplRequester,
+    database: Connection,
+    campaignId: number
+  ): Promise<Campaign | undefined> {
+    if (database.readyState !== 1) {
+      throw new Error('MongoDB database is not connected')
+    }
+
+    // Step 1. Read the campaign's view records and metadata concurrently
+    const [campaignView, fundTransactionViews, campaignsMetadata] =
+      await Promise.all([
+        CampaignViewDatabaseModel.findOne({ campaignId })
+          .lean<ICampaignViewDatabaseModel>()
+          .exec(),
+        FundTransactionViewDatabaseModel.find({ campaignId })
+          .sort({ fundTransactionId: 1 })
+          .lean<IFundTransactionViewDatabaseModel[]>()
+          .exec(),
+        StateUtility.getCampaignsMetadata([campaignId]),
+      ])
+
+    // Step 2. Fill gaps from the ledger
+    const metadata = campaignsMetadata.get(campaignId)
+    if (
+      !campaignView ||
+      !metadata ||
+      fundTransactionViews.length !== campaignView.totalFundTransactions
+    ) {
+      return StateUtility.getCampaign(client, database, campaignId)
+    }
+
+    // Step 3. Build the campaign; backers are derived from its fund transactions
+    const generalInfo = CampaignViewReader.toGeneralInfo(campaignView)
+    const state = deriveCampaignState(generalInfo)
+    const milestonesStates = deriveMilestonesStates(
+      state,
+      generalInfo.fundRaiseEndDateInUnixSeconds,
+      generalInfo.milestones
+    )
+    const applicationState = new ApplicationState()
+    applicationState.ledgerIndex = campaignView.ledgerIndex
+    applicationState.setCampaign(
+      new Campaign(
+        campaignId,
+        state,
+        generalInfo.owner,
+        metadata.title,
+        metadata.description,
+        metadata.overviewUrl,
+        metadata.imageUrl,
+        generalInfo.fundRaiseGoalInDrops,
+        generalInfo.fundRaiseEndDateInUnixSeconds,
+        generalInfo.totalAmountRaisedInDrops,
+        generalInfo.totalAmountNonRefundableInDrops,
+        generalInfo.totalReserveAmountInDrops,
+        generalInfo.totalRejectVotesForCurrentMilestone,
+        generalInfo.milestones.map(
+          (milestone, index) =>
+            new Milestone(
+              milestonesStates[index],
+              milestone.endDateInUnixSeconds,
+              milestone.payoutPercent,
+              metadata.milestones[index].title
+            )
+        ),
+        [],
+        []
+      )
+    )
+    for (const fundTransactionView of fundTransactionViews) {
+      applicationState.setFundTransaction(
+        campaignId,
+        CampaignViewReader.toFundTransaction(fundTransactionView)
+      )
+    }
+
+    return applicationState.getCampaignById(campaignId)
+  }
+
+  /**
+   * Reads the campaigns account backed and its fund transactions in each. Campaigns the view
+   * doesn't have in full are read from the ledger.
+   */
+  static async getBackerCampaigns(
+    client: XrplRequester,
+    database: Connection,
+    account: string
+  ): Promise<BackerCampaignsView> {
+    if (database.readyState !== 1) {
+      throw new Error('MongoDB database is not connected')
+    }
+
+    // Step 1. Read the account's backer and fund transaction records
+    const [backerViews, fundTransactionViews] = await Promise.all([
+      BackerViewDatabaseModel.find({ account })
+        .sort({ campaignId: 1 })
+        .lean()
+        .exec(),
+      FundTransactionViewDatabaseModel.find({ account })
+        .lean<IFundTransactionViewDatabaseModel[]>()
+        .exec(),
+    ])
+    const campaignIds = backerViews.map(({ campaignId }) => campaignId)
+
+    // Step 2. Read the campaigns' records and how many fund transactions the view has of each
+    const [campaignViews, fundTransactionCounts] = await Promise.all([
+      CampaignViewDatabaseModel.find({ campaignId: { $in: campaignIds } })
+        .lean<ICampaignViewDatabaseModel[]>()
+        .exec(),
+      FundTransactionViewDatabaseModel.aggregate<{
+        _id: number
+        count: number
+      }>([
+        { $match: { campaignId: { $in: campaignIds } } },
+        { $group: { _id: '$campaignId', count: { $sum: 1 } } },
+      ]).exec(),
+    ])
+    const totalFundTransactionsById: Map<number, number> = new Map()
+    for (const campaignView of campaignViews) {
+      totalFundTransactionsById.set(
+        campaignView.campaignId,
+        campaignView.totalFundTransactions
+      )
+    }
+    const fundTransactionCountsById: Map<number, number> = new Map()
+    for (const { _id: campaignId, count } of fundTransactionCounts) {
+      fundTransactionCountsById.set(campaignId, count)
+    }
+    const fundTransactionViewsById: Map<
+      string,
+      IFundTransactionViewDatabaseModel
+    > = new Map()
+    for (const fundTransactionView of fundTransactionViews) {
+      const { campaignId, fundTransactionId } = fundTransactionView
+      fundTransactionViewsById.set(
+        `${campaignId}:${fundTransactionId}`,
+        fundTransactionView
+      )
+    }
+
+    // Step 3. Build each campaign's fund transactions, from the ledger where the view has gaps
+    let ledgerIndex: number | undefined
+    const campaigns = await Promise.all(
+      backerViews.map(async (backerView) => {
+        const { campaignId } = backerView
+        const totalFundTransactions = totalFundTransactionsById.get(campaignId)
+        const fundTransactions: FundTransaction[] = []
+        for (const fundTransactionId of backerView.fundTransactionIds) {
+          const fundTransactionView = fundTransactionViewsById.get(
+            `${campaignId}:${fundTransactionId}`
+          )
+          if (fundTransactionView) {
+            fundTransactions.push(
+              CampaignViewReader.toFundTransaction(fundTransactionView)
+            )
+          }
+        }
+
+        if (
+          totalFundTransactions === undefined ||
+          totalFundTransactions !==
+            fundTransactionCountsById.get(campaignId) ||
+          fundTransactions.length !== backerView.fundTransactionIds.length
+        ) {
+          const campaign = await StateUtility.getCampaign(
+            client,
+            database,
+            campaignId
+          )
+          const backer = campaign?.backers.find(
+            (campaignBacker) => campaignBacker.account === account
+          )
+          if (!backer) {
+            return undefined
+          }
+          return { campaignId, fundTransactions: backer.fundTransactions }
+        }
+
+        if (
+          ledgerIndex === undefined ||
+          backerView.ledgerIndex < ledgerIndex
+        ) {
+          ledgerIndex = backerView.ledgerIndex
+        }
+        return { campaignId, fundTransactions }
+      })
+    )
+
+    return {
+      ledgerIndex,
+      campaigns: campaigns.filter(
+        (campaign): campaign is BackerCampaignsView['campaigns'][number] =>
+          campaign !== undefined
+      ),
+    }
+  }
+
+  // Same General Info the view was written from, with its state codes
+  private static toGeneralInfo(
+    campaignView: ICampaignViewDatabaseModel
+  ): HSVCampaignGeneralInfo {
+    return new HSVCampaignGeneralInfo(
+      campaignView.stateFlag,
+      campaignView.owner,
+      BigInt(campaignView.fundRaiseGoalInDrops),
+      BigInt(campaignView.fundRaiseEndDateInUnixSeconds),
+      BigInt(campaignView.totalAmountRaisedInDrops),
+      BigInt(campaignView.totalAmountNonRefundableInDrops),
+      BigInt(campaignView.totalReserveAmountInDrops),
+      campaignView.totalFundTransactions,
+      campaignView.totalRejectVotesForCurrentMilestone,
+      campaignView.milestones.map(
+        (milestone) =>
+          new HSVMilestone(
+            milestone.stateFlag,
+            BigInt(milestone.endDateInUnixSeconds),
+            milestone.payoutPercent
+          )
+      )
+    )
+  }
+
+  private static toFundTransaction(
+    fundTransactionView: IFundTransactionViewDatabaseModel
+  ): FundTransaction {
+    return new FundTransaction(
+      fundTransactionView.fundTransactionId,
+      fundTransactionView.account,
+      fundTransactionView.state as FundTransactionState,
+      BigInt(fundTransactionView.amountInDrops)
+    )
+  }
+}
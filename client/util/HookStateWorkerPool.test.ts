@@ -0,0 +1,102 @@
+import { ApplicationState } from '../app/models/ApplicationState'
+import { HookStateEntry } from '../app/models/HookStateEntry'
+import { createCampaignNamespaceEntries } from '../app/models/testFixtures'
+import { applyAssembledHookState } from './assembleHookState'
+import { HookStateWorkerPool } from './HookStateWorkerPool'
+import { CampaignMetadata, StateUtility } from './StateUtility'
+
+const CAMPAIGN_IDS = [3, 7, 8, 12]
+
+const namespaceEntries = CAMPAIGN_IDS.flatMap((campaignId) =>
+  createCampaignNamespaceEntries(campaignId)
+)
+
+const campaignsMetadata: Map<number, CampaignMetadata> = new Map(
+  CAMPAIGN_IDS.map((campaignId) => [
+    campaignId,
+    {
+      id: campaignId,
+      title: `Campaign ${campaignId}`,
+      description: 'description',
+      overviewUrl: 'https://example.com',
+      imageUrl: 'https://example.com/image.png',
+      milestones: [{ title: 'Milestone 1' }, { title: 'Milestone 2' }],
+    },
+  ])
+)
+
+function getExpectedApplicationState(): ApplicationState {
+  const applicationState = new ApplicationState()
+  for (const namespaceEntry of namespaceEntries) {
+    StateUtility.applyHookStateEntry(
+      applicationState,
+      new HookStateEntry(namespaceEntry),
+      campaignsMetadata
+    )
+  }
+  return applicationState
+}
+
+async function getPoolApplicationState(
+  pool: HookStateWorkerPool
+): Promise<ApplicationState> {
+  const applicationState = new ApplicationState()
+  for (const assembled of await pool.assemble(namespaceEntries)) {
+    applyAssembledHookState(applicationState, assembled, campaignsMetadata)
+  }
+  return applicationState
+}
+
+function sortedCampaigns(applicationState: ApplicationState) {
+  return applicationState.campaigns.sort((a, b) => a.id - b.id)
+}
+
+describe('HookStateWorkerPool', () => {
+  it('should assemble the same application state inline', async () => {
+    const pool = new HookStateWorkerPool(0)
+    const applicationState = await getPoolApplicationState(pool)
+    expect(sortedCampaigns(applicationState)).toEqual(
+      sortedCampaigns(getExpectedApplicationState())
+    )
+    await pool.close()
+  })
+
+  it('should assemble the same application state on worker threads', async () => {
+    const pool = new HookStateWorkerPool(2)
+    try {
+      // Campaigns are split across both workers by destination tag
+      const assembled = await pool.assemble(namespaceEntries)
+      expect(assembled).toHaveLength(2)
+      const campaignIds = assembled.map(({ campaigns }) =>
+        Array.from(campaigns.id)
+      )
+      expect(campaignIds).toEqual([
+        [8, 12],
+        [3, 7],
+      ])
+
+      const applicationState = await getPoolApplicationState(pool)
+      expect(sortedCampaigns(applicationState)).toEqual(
+        sortedCampaigns(getExpectedApplicationState())
+      )
+    } finally {
+      await pool.close()
+    }
+  }, 30000)
+
+  it('should reject missing campaign metadata', async () => {
+    const pool = new HookStateWorkerPool(0)
+    const [assembled] = await pool.assemble(namespaceEntries)
+    expect(() =>
+      applyAssembledHookState(new ApplicationState(), assembled, new Map())
+    ).toThrow('CampaignDatabaseModel entry not found for campaignId 3')
+  })
+
+  it('should reject work after close', async () => {
+    const pool = new HookStateWorkerPool(1)
+    await pool.close()
+    await expect(pool.assemble(namespaceEntries)).rejects.toThrow(
+      'HookStateWorkerPool is closed'
+    )
+  })
+})
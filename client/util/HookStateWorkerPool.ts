@@ -0,0 +1,208 @@
+import os from 'os'
+import path from 'path'
+import { Worker } from 'worker_threads'
+import { AccountNamespaceHookStateEntry } from '../app/models/HookState'
+import {
+  AssembledHookState,
+  assembleHookStateEntries,
+} from './assembleHookState'
+import { HookStateWorkerTask } from './hookStateWorker'
+
+type HookStateWorkerResult =
+  | { id: number; assembled: AssembledHookState }
+  | { id: number; error: string }
+
+interface PendingTask {
+  resolve: (assembled: AssembledHookState) => void
+  reject: (error: Error) => void
+}
+
+interface PoolWorker {
+  worker: Worker
+  pending: Map<number, PendingTask>
+}
+
+/*
+Pool of worker threads that decode and assemble account_namespace pages (see
+assembleHookStateEntries) off the main thread. A page is split across the workers by destination
+tag, so a campaign's General Info and Fund Transactions pages always go to the same worker, and
+each worker hands its typed arrays back by transferring their buffers.
+
+The size defaults to one less than the number of CPUs (the main thread keeps applying results) and
+can be set with DECODE_WORKER_POOL_SIZE; 0 assembles on the calling thread.
+*/
+export class HookStateWorkerPool {
+  private static sharedPool: HookStateWorkerPool | undefined
+
+  readonly size: number
+  private readonly workers: Array<PoolWorker | undefined>
+  private nextTaskId = 0
+  private closed = false
+
+  constructor(size: number = HookStateWorkerPool.defaultSize()) {
+    if (!Number.isInteger(size) || size < 0) {
+      throw new Error(`Invalid HookStateWorkerPool size: ${size}`)
+    }
+    this.size = size
+    this.workers = new Array(size)
+  }
+
+  static defaultSize(): number {
+    const configured = process.env.DECODE_WORKER_POOL_SIZE
+    if (configured !== undefined && configured !== '') {
+      return Number(configured)
+    }
+    return Math.max(os.cpus().length - 1, 1)
+  }
+
+  // Pool shared by StateUtility.getApplicationState; created on first use
+  static shared(): HookStateWorkerPool {
+    if (!HookStateWorkerPool.sharedPool) {
+      HookStateWorkerPool.sharedPool = new HookStateWorkerPool()
+    }
+    return HookStateWorkerPool.sharedPool
+  }
+
+  static async closeShared(): Promise<void> {
+    const pool = HookStateWorkerPool.sharedPool
+    HookStateWorkerPool.sharedPool = undefined
+    if (pool) {
+      await pool.close()
+    }
+  }
+
+  /**
+   * Decodes and assembles a page of account_namespace entries.
+   * @returns one AssembledHookState per worker that received entries
+   */
+  async assemble(
+    namespaceEntries: AccountNamespaceHookStateEntry[]
+  ): Promise<AssembledHookState[]> {
+    if (this.closed) {
+      throw new Error('HookStateWorkerPool is closed')
+    }
+    if (this.size === 0) {
+      return [assembleHookStateEntries(namespaceEntries)]
+    }
+
+    // Step 1. Partition the entries by destination tag
+    const partitions: AccountNamespaceHookStateEntry[][] = Array.from(
+      { length: this.size },
+      () => []
+    )
+    for (const namespaceEntry of namespaceEntries) {
+      // The destination tag is the last 4 bytes of HookStateKey
+      const destinationTag = parseInt(
+        namespaceEntry.HookStateKey.slice(56, 64),
+        16
+      )
+      partitions[destinationTag % this.size].push(namespaceEntry)
+    }
+
+    // Step 2. Run every non-empty partition on its worker
+    return Promise.all(
+      partitions.flatMap((partition, index) =>
+        partition.length > 0 ? [this.runTask(index, partition)] : []
+      )
+    )
+  }
+
+  async close(): Promise<void> {
+    this.closed = true
+    const workers = this.workers.splice(0, this.workers.length)
+    await Promise.all(
+      workers.map((poolWorker) => {
+        if (!poolWorker) {
+          return Promise.resolve()
+        }
+        HookStateWorkerPool.rejectPending(
+          poolWorker,
+          new Error('HookStateWorkerPool is closed')
+        )
+        return poolWorker.worker.terminate()
+      })
+    )
+  }
+
+  private runTask(
+    index: number,
+    namespaceEntries: AccountNamespaceHookStateEntry[]
+  ): Promise<AssembledHookState> {
+    const { worker, pending } = this.getWorker(index)
+    const id = this.nextTaskId++
+    return new Promise((resolve, reject) => {
+      // Busy workers keep the process alive until their tasks are answered
+      if (pending.size === 0) {
+        worker.ref()
+      }
+      pending.set(id, { resolve, reject })
+      const task: HookStateWorkerTask = { id, namespaceEntries }
+      worker.postMessage(task)
+    })
+  }
+
+  private getWorker(index: number): PoolWorker {
+    const existing = this.workers[index]
+    if (existing) {
+      return existing
+    }
+
+    const poolWorker: PoolWorker = {
+      worker: HookStateWorkerPool.createWorker(),
+      pending: new Map(),
+    }
+    const { worker, pending } = poolWorker
+    worker.on('message', (result: HookStateWorkerResult) => {
+      const task = pending.get(result.id)
+      if (!task) {
+        return
+      }
+      pending.delete(result.id)
+      if (pending.size === 0) {
+        worker.unref()
+      }
+      if ('error' in result) {
+        task.reject(new Error(result.error))
+      } else {
+        task.resolve(result.assembled)
+      }
+    })
+    // A crashed worker fails its tasks and is replaced on the next assemble
+    const discard = (error: Error) => {
+      if (this.workers[index] === poolWorker) {
+        this.workers[index] = undefined
+      }
+      HookStateWorkerPool.rejectPending(poolWorker, error)
+    }
+    worker.on('error', discard)
+    worker.on('exit', (exitCode) => {
+      discard(new Error(`Hook State worker exited with code ${exitCode}`))
+    })
+    // Idle workers don't keep the process alive
+    worker.unref()
+
+    this.workers[index] = poolWorker
+    return poolWorker
+  }
+
+  private static rejectPending(poolWorker: PoolWorker, error: Error): void {
+    for (const task of poolWorker.pending.values()) {
+      task.reject(error)
+    }
+    poolWorker.pending.clear()
+  }
+
+  private static createWorker(): Worker {
+    const extension = path.extname(__filename)
+    const workerPath = path.join(__dirname, `hookStateWorker${extension}`)
+    if (extension === '.ts') {
+      // Running under ts-node/ts-jest; the worker needs its own TS loader
+      return new Worker(
+        `require('ts-node').register({ transpileOnly: true })
+        require(${JSON.stringify(workerPath)})`,
+        { eval: true }
+      )
+    }
+    return new Worker(workerPath)
+  }
+}
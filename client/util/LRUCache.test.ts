@@ -0,0 +1,41 @@
+import { LRUCache } from './LRUCache'
+
+describe('LRUCache', () => {
+  it('should get values that were set', () => {
+    const cache = new LRUCache<number, string>(2)
+    cache.set(1, 'one')
+    cache.set(2, 'two')
+    expect(cache.get(1)).toBe('one')
+    expect(cache.get(2)).toBe('two')
+    expect(cache.get(3)).toBeUndefined()
+    expect(cache.size).toBe(2)
+  })
+
+  it('should evict the least recently used key when full', () => {
+    const cache = new LRUCache<number, string>(2)
+    cache.set(1, 'one')
+    cache.set(2, 'two')
+    cache.get(1) // 2 is now the least recently used key
+    cache.set(3, 'three')
+    expect(cache.has(1)).toBe(true)
+    expect(cache.has(2)).toBe(false)
+    expect(cache.has(3)).toBe(true)
+    expect(cache.size).toBe(2)
+  })
+
+  it('should not evict when overwriting an existing key', () => {
+    const cache = new LRUCache<number, string>(2)
+    cache.set(1, 'one')
+    cache.set(2, 'two')
+    cache.set(1, 'uno')
+    expect(cache.get(1)).toBe('uno')
+    expect(cache.get(2)).toBe('two')
+    expect(cache.size).toBe(2)
+  })
+
+  it('should throw if maxSize is less than 1', () => {
+    expect(() => new LRUCache<number, string>(0)).toThrow(
+      'Invalid maxSize 0. Must be an integer >= 1'
+    )
+  })
+})
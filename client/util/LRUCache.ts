@@ -0,0 +1,53 @@
+/*
+Bounded least-recently-used cache.
+
+Map keeps insertion order, so the first key is always the least recently used one:
+get() and set() re-insert a key to mark it as most recently used.
+*/
+export class LRUCache<K, V> {
+  private readonly maxSize: number
+  private readonly map: Map<K, V> = new Map()
+
+  constructor(maxSize: number) {
+    if (!Number.isInteger(maxSize) || maxSize < 1) {
+      throw new Error(`Invalid maxSize ${maxSize}. Must be an integer >= 1`)
+    }
+    this.maxSize = maxSize
+  }
+
+  get size(): number {
+    return this.map.size
+  }
+
+  has(key: K): boolean {
+    return this.map.has(key)
+  }
+
+  get(key: K): V | undefined {
+    if (!this.map.has(key)) {
+      return undefined
+    }
+    const value = this.map.get(key) as V
+    this.map.delete(key)
+    this.map.set(key, value)
+    return value
+  }
+
+  set(key: K, value: V): void {
+    if (this.map.has(key)) {
+      this.map.delete(key)
+    } else if (this.map.size >= this.maxSize) {
+      const leastRecentlyUsedKey = this.map.keys().next().value as K
+      this.map.delete(leastRecentlyUsedKey)
+    }
+    this.map.set(key, value)
+  }
+
+  delete(key: K): boolean {
+    return this.map.delete(key)
+  }
+
+  clear(): void {
+    this.map.clear()
+  }
+}
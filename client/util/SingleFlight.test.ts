@@ -0,0 +1,80 @@
+import { SingleFlight } from './SingleFlight'
+
+// A load that settles when the test says so
+function deferred<T>() {
+  let resolve!: (value: T) => void
+  let reject!: (error: Error) => void
+  const promise = new Promise<T>((res, rej) => {
+    resolve = res
+    reject = rej
+  })
+  return { promise, resolve, reject }
+}
+
+describe('SingleFlight', () => {
+  it('should share a load between concurrent callers of the same key', async () => {
+    const singleFlight = new SingleFlight<string, number>()
+    const load = deferred<number>()
+    const loader = jest.fn(() => load.promise)
+
+    const first = singleFlight.do('a', loader)
+    const second = singleFlight.do('a', loader)
+    expect(singleFlight.inFlightCount).toBe(1)
+    load.resolve(1)
+
+    await expect(Promise.all([first, second])).resolves.toEqual([1, 1])
+    expect(loader).toHaveBeenCalledTimes(1)
+    expect(singleFlight.inFlightCount).toBe(0)
+  })
+
+  it('should load different keys separately', async () => {
+    const singleFlight = new SingleFlight<string, string>()
+    const loader = jest.fn((key: string) => Promise.resolve(key))
+
+    await expect(
+      Promise.all([
+        singleFlight.do('a', () => loader('a')),
+        singleFlight.do('b', () => loader('b')),
+      ])
+    ).resolves.toEqual(['a', 'b'])
+    expect(loader).toHaveBeenCalledTimes(2)
+  })
+
+  it('should load again once the load settled without maxResults', async () => {
+    const singleFlight = new SingleFlight<string, number>()
+    const loader = jest.fn(() => Promise.resolve(1))
+
+    await singleFlight.do('a', loader)
+    await singleFlight.do('a', loader)
+    expect(loader).toHaveBeenCalledTimes(2)
+  })
+
+  it('should reuse the last maxResults results', async () => {
+    const singleFlight = new SingleFlight<string, string>(1)
+    const loader = jest.fn((key: string) => Promise.resolve(key))
+
+    await singleFlight.do('a', () => loader('a'))
+    await expect(singleFlight.do('a', () => loader('a'))).resolves.toBe('a')
+    expect(loader).toHaveBeenCalledTimes(1)
+
+    // Evicts a
+    await singleFlight.do('b', () => loader('b'))
+    await singleFlight.do('a', () => loader('a'))
+    expect(loader).toHaveBeenCalledTimes(3)
+  })
+
+  it('should share a failure but not keep it', async () => {
+    const singleFlight = new SingleFlight<string, number>(1)
+    const load = deferred<number>()
+
+    const first = singleFlight.do('a', () => load.promise)
+    const second = singleFlight.do('a', () => Promise.resolve(2))
+    load.reject(new Error('load failed'))
+    await expect(first).rejects.toThrow('load failed')
+    await expect(second).rejects.toThrow('load failed')
+
+    await expect(
+      singleFlight.do('a', () => Promise.resolve(3))
+    ).resolves.toBe(3)
+  })
+})
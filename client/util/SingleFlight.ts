@@ -0,0 +1,50 @@
+import { LRUCache } from './LRUCache'
+
+/*
+Coalesces concurrent loads of the same key: callers that ask for a key while its load is in flight
+share that load instead of starting their own. A failed load is never kept, so the next caller
+retries it.
+
+With maxResults, the last maxResults results are also kept and reused by later callers; only use
+that for keys whose value never changes, such as state at a given ledger.
+*/
+export class SingleFlight<K, V> {
+  private readonly inFlight: Map<K, Promise<V>> = new Map()
+  private readonly results: LRUCache<K, V> | undefined
+
+  constructor(maxResults = 0) {
+    this.results = maxResults > 0 ? new LRUCache(maxResults) : undefined
+  }
+
+  get inFlightCount(): number {
+    return this.inFlight.size
+  }
+
+  do(key: K, load: () => Promise<V>): Promise<V> {
+    if (this.results?.has(key)) {
+      return Promise.resolve(this.results.get(key) as V)
+    }
+    const inFlight = this.inFlight.get(key)
+    if (inFlight) {
+      return inFlight
+    }
+
+    const loading = load().then(
+      (result) => {
+        this.inFlight.delete(key)
+        this.results?.set(key, result)
+        return result
+      },
+      (error) => {
+        this.inFlight.delete(key)
+        throw error
+      }
+    )
+    this.inFlight.set(key, loading)
+    return loading
+  }
+
+  clear(): void {
+    this.results?.clear()
+  }
+}
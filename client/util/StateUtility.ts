@@ -1,9 +1,10 @@
-import { AccountInfoRequest, Client, Request } from 'xrpl'
+import { AccountInfoRequest, LedgerStream, Request } from 'xrpl'
 import {
   deriveCampaignState,
   DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG,
   DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
   DATA_LOOKUP_GENERAL_INFO_FLAG,
+  FUND_TRANSACTIONS_PAGE_MAX_SIZE,
   HOOK_ACCOUNT_WALLET,
   deriveMilestonesStates,
   deriveFundTransactionState,
@@ -12,30 +13,191 @@ import config from '../../config.json'
 import { ApplicationState } from '../app/models/ApplicationState'
 import { BaseModel } from '../app/models/BaseModel'
 import { Campaign } from '../app/models/Campaign'
-import { HookState } from '../app/models/HookState'
+import {
+  AccountNamespaceHookStateEntry,
+  HookState,
+} from '../app/models/HookState'
 import { HSVCampaignGeneralInfo } from '../app/models/HSVCampaignGeneralInfo'
-import { deriveHookNamespace } from './transaction'
+import {
+  deriveHookNamespace,
+  generateRandomDestinationTag,
+} from './transaction'
 import { Milestone } from '../app/models/Milestone'
 import { FundTransaction } from '../app/models/FundTransaction'
 import { HSVFundTransactionsPage } from '../app/models/HSVFundTransactionsPage'
-import { Backer } from '../app/models/Backer'
+import { HookStateEntry } from '../app/models/HookStateEntry'
+import { HookStateKey } from '../app/models/HookStateKey'
 import { Connection } from 'mongoose'
-import { CampaignDatabaseModel } from '../database/models/campaign.model'
+import {
+  CampaignDatabaseModel,
+  ICampaignDatabaseModel,
+} from '../database/models/campaign.model'
+import { DestinationTagReservationDatabaseModel } from '../database/models/destinationTagReservation.model'
+import { LRUCache } from './LRUCache'
+import { decodeHookStateEntries } from './nativeDecoder'
+import { applyAssembledHookState } from './assembleHookState'
+import { HookStateWorkerPool } from './HookStateWorkerPool'
+import { client as sharedClient } from './xrplClient'
+import { XrplRequester } from './XrplConnectionPool'
+import { SingleFlight } from './SingleFlight'
+
+// Off-ledger campaign metadata; it never changes after createCampaign so it's safe to cache
+export type CampaignMetadata = Pick<
+  ICampaignDatabaseModel,
+  'id' | 'title' | 'description' | 'overviewUrl' | 'imageUrl'
+> & {
+  milestones: Array<{ title: string }>
+}
+
+const CAMPAIGN_METADATA_CACHE_MAX_SIZE = 10000
+
+const ACCOUNT_NAMESPACE_PAGE_SIZE = 256
+
+const DESTINATION_TAG_ALLOCATION_MAX_ATTEMPTS = 10
+
+// Loaded states kept per (namespace, ledger) for callers that read at a given ledger
+const LOADED_STATE_CACHE_MAX_SIZE = 2
+
+// How long a latest validated state is kept when no ledgerClosed event has dropped it
+const LATEST_STATE_CACHE_TTL_MS = 4000
+
+export interface HookStateFetchOptions {
+  // Validated ledger to read the Hook State at; defaults to the latest validated ledger
+  ledgerIndex?: number
+  // Max entries per account_namespace page
+  pageSize?: number
+}
+
+export interface KeyedHookStateEntry<T extends BaseModel> {
+  ledgerIndex: number
+  entry: HookStateEntry<T>
+}
+
+export interface AccountNamespacePage {
+  ledgerIndex: number
+  namespaceEntries: AccountNamespaceHookStateEntry[]
+}
+
+interface LatestLoadedState<V> {
+  // Validated ledger the state was read at
+  ledgerIndex: number
+  loadedAt: number
+  state: V
+}
+
+/*
+Latest validated states are kept until a newer ledger closes: the shared client's ledgerClosed
+events (when it's subscribed to the ledger stream, e.g. by ApplicationStateCache) advance
+closedLedgerIndex, and states read at an older ledger are reloaded. Without ledger events they're
+reloaded after LATEST_STATE_CACHE_TTL_MS.
+*/
+let closedLedgerIndex = 0
+
+sharedClient.on('ledgerClosed', (ledgerStream: LedgerStream) => {
+  closedLedgerIndex = Math.max(closedLedgerIndex, ledgerStream.ledger_index)
+})
+
+const CAMPAIGN_METADATA_PROJECTION = {
+  _id: 0,
+  id: 1,
+  title: 1,
+  description: 1,
+  overviewUrl: 1,
+  imageUrl: 1,
+  'milestones.title': 1,
+}
 
 export class StateUtility {
-  static async getHookState<T extends BaseModel>(
-    client: Client
-  ): Promise<HookState<T>> {
+  private static campaignMetadataCache = new LRUCache<
+    number,
+    CampaignMetadata
+  >(CAMPAIGN_METADATA_CACHE_MAX_SIZE)
+
+  // State at a ledger never changes, so loads at a given ledger are shared by (namespace, ledger)
+  // and kept. Loads of the latest validated ledger are shared while in flight, then kept with the
+  // ledger their account_info response was read at until a newer ledger closes.
+  private static hookStateLoads = new SingleFlight<
+    string,
+    HookState<BaseModel>
+  >(LOADED_STATE_CACHE_MAX_SIZE)
+  private static applicationStateLoads = new SingleFlight<
+    string,
+    ApplicationState
+  >(LOADED_STATE_CACHE_MAX_SIZE)
+  private static latestHookStateLoads = new SingleFlight<
+    string,
+    HookState<BaseModel>
+  >()
+  private static latestApplicationStateLoads = new SingleFlight<
+    string,
+    ApplicationState
+  >()
+  private static latestHookStates: Map<
+    string,
+    LatestLoadedState<HookState<BaseModel>>
+  > = new Map()
+  private static latestApplicationStates: Map<
+    string,
+    LatestLoadedState<ApplicationState>
+  > = new Map()
+
+  static async getCampaignsMetadata(
+    campaignIds: number[]
+  ): Promise<Map<number, CampaignMetadata>> {
+    const result: Map<number, CampaignMetadata> = new Map()
+
+    // Step 1. Use cached metadata where possible
+    const uncachedCampaignIds: number[] = []
+    for (const campaignId of campaignIds) {
+      const cached = StateUtility.campaignMetadataCache.get(campaignId)
+      if (cached) {
+        result.set(campaignId, cached)
+      } else {
+        uncachedCampaignIds.push(campaignId)
+      }
+    }
+
+    // Step 2. Fetch the rest with a single query
+    if (uncachedCampaignIds.length > 0) {
+      const campaignDatabaseEntries = (await CampaignDatabaseModel.find(
+        { id: { $in: uncachedCampaignIds } },
+        CAMPAIGN_METADATA_PROJECTION
+      )
+        .lean()
+        .exec()) as CampaignMetadata[]
+      for (const campaignDatabaseEntry of campaignDatabaseEntries) {
+        StateUtility.campaignMetadataCache.set(
+          campaignDatabaseEntry.id,
+          campaignDatabaseEntry
+        )
+        result.set(campaignDatabaseEntry.id, campaignDatabaseEntry)
+      }
+    }
+
+    return result
+  }
+
+  /**
+   * Pages through the Hook State namespace with account_namespace markers. Every page is read at
+   * the same validated ledger (options.ledgerIndex, or the latest validated ledger), so entries
+   * are never mixed across ledgers.
+   */
+  static async *iterateAccountNamespacePages(
+    client: XrplRequester,
+    options: HookStateFetchOptions = {}
+  ): AsyncGenerator<AccountNamespacePage> {
     if (!client.isConnected()) {
       throw new Error('xrpl Client is not connected')
     }
 
-    // Step 1. Get HookNamespaces from Hook Account
+    // Step 1. Get HookNamespaces from Hook Account and pin the validated ledger index
     const accountInfoRequest: AccountInfoRequest = {
       command: 'account_info',
       account: HOOK_ACCOUNT_WALLET.address,
+      ledger_index: options.ledgerIndex ?? 'validated',
     }
     const accountInfoResponse = await client.request(accountInfoRequest)
+    const ledgerIndex = accountInfoResponse.result.ledger_index as number
     // @ts-expect-error - this is defined
     const { HookNamespaces } = accountInfoResponse.result.account_data
     if (!HookNamespaces) {
@@ -50,29 +212,92 @@ export class StateUtility {
       throw new Error(`HookNamespace not found for ${hookNamespaceDerived}`)
     }
 
-    // Step 3. Get HookState from Hook Account using HookNamespace
-    const accountNamespaceRequest: Request = {
-      // @ts-expect-error - this command exists on Hooks Testnet v3
-      command: 'account_namespace',
-      account: HOOK_ACCOUNT_WALLET.address,
-      namespace_id: hookNamespaceDerived,
+    // Step 3. Page through HookState from Hook Account using HookNamespace
+    let marker: unknown = undefined
+    do {
+      const accountNamespaceRequest: Request = {
+        // @ts-expect-error - this command exists on Hooks Testnet v3
+        command: 'account_namespace',
+        account: HOOK_ACCOUNT_WALLET.address,
+        namespace_id: hookNamespaceDerived,
+        ledger_index: ledgerIndex,
+        limit: options.pageSize ?? ACCOUNT_NAMESPACE_PAGE_SIZE,
+        marker,
+      }
+      const accountNamespaceResponse = await client.request(
+        accountNamespaceRequest
+      )
+      const { namespace_entries: namespaceEntries, marker: nextMarker } =
+        // @ts-expect-error - this is defined
+        accountNamespaceResponse.result
+
+      yield { ledgerIndex, namespaceEntries: namespaceEntries ?? [] }
+
+      marker = nextMarker
+    } while (marker !== undefined)
+  }
+
+  /**
+   * Decodes Hook State entries page by page as they arrive; see iterateAccountNamespacePages.
+   */
+  static async *iterateHookStateEntries<T extends BaseModel>(
+    client: XrplRequester,
+    options: HookStateFetchOptions = {}
+  ): AsyncGenerator<HookStateEntry<T>> {
+    const pages = StateUtility.iterateAccountNamespacePages(client, options)
+    for await (const { namespaceEntries } of pages) {
+      yield* decodeHookStateEntries<T>(namespaceEntries)
     }
-    const accountNamespaceResponse = await client.request(
-      accountNamespaceRequest
-    )
-    // @ts-expect-error - this is defined
-    const { namespace_entries: namespaceEntries } =
-      accountNamespaceResponse.result
+  }
 
-    // Step 4. Initialize HookState object
-    const hookState = new HookState<T>(namespaceEntries)
+  /**
+   * Loads the whole Hook State namespace. Concurrent callers for the same ledger share one load,
+   * and loads are kept for later callers (the latest validated ledger's until a newer ledger
+   * closes); the result is shared, so it must not be modified.
+   */
+  static async getHookState<T extends BaseModel>(
+    client: XrplRequester,
+    options: HookStateFetchOptions = {}
+  ): Promise<HookState<T>> {
+    const key = StateUtility.getStateLoadKey(options.ledgerIndex)
+    const load = () => StateUtility.loadHookState(client, options)
+    const hookState =
+      options.ledgerIndex === undefined
+        ? await StateUtility.loadLatestState(
+            StateUtility.latestHookStates,
+            StateUtility.latestHookStateLoads,
+            key,
+            load
+          )
+        : await StateUtility.hookStateLoads.do(key, load)
+    return hookState as HookState<T>
+  }
+
+  private static async loadHookState<T extends BaseModel>(
+    client: XrplRequester,
+    options: HookStateFetchOptions
+  ): Promise<HookState<T>> {
+    const namespaceEntries: AccountNamespaceHookStateEntry[] = []
+    let ledgerIndex: number | undefined
+    const pages = StateUtility.iterateAccountNamespacePages(client, options)
+    for await (const page of pages) {
+      ledgerIndex = page.ledgerIndex
+      for (const namespaceEntry of page.namespaceEntries) {
+        namespaceEntries.push(namespaceEntry)
+      }
+    }
 
-    return hookState
+    return new HookState<T>(namespaceEntries, ledgerIndex)
   }
 
+  /**
+   * Loads and decodes the whole Hook State, with campaign metadata from the database. Loads are
+   * shared and kept like getHookState's; the result is shared, so it must not be modified.
+   */
   static async getApplicationState(
-    client: Client,
-    database: Connection
+    client: XrplRequester,
+    database: Connection,
+    options: HookStateFetchOptions = {}
   ): Promise<ApplicationState> {
     if (!client.isConnected()) {
       throw new Error('xrpl Client is not connected')
@@ -81,15 +306,87 @@ export class StateUtility {
       throw new Error('MongoDB database is not connected')
     }
 
-    let hookState
+    const key = StateUtility.getStateLoadKey(options.ledgerIndex)
+    const load = () => StateUtility.loadApplicationState(client, options)
+    if (options.ledgerIndex === undefined) {
+      return StateUtility.loadLatestState(
+        StateUtility.latestApplicationStates,
+        StateUtility.latestApplicationStateLoads,
+        key,
+        load
+      )
+    }
+    return StateUtility.applicationStateLoads.do(key, load)
+  }
+
+  // Returns the kept latest validated state unless a newer ledger has closed since it was read
+  private static async loadLatestState<V extends { ledgerIndex?: number }>(
+    latestStates: Map<string, LatestLoadedState<V>>,
+    loads: SingleFlight<string, V>,
+    key: string,
+    load: () => Promise<V>
+  ): Promise<V> {
+    const latest = latestStates.get(key)
+    if (
+      latest &&
+      latest.ledgerIndex >= closedLedgerIndex &&
+      Date.now() - latest.loadedAt < LATEST_STATE_CACHE_TTL_MS
+    ) {
+      return latest.state
+    }
+
+    const state = await loads.do(key, load)
+    // An empty Hook State has no ledger index; it's kept until the next ledger closes
+    const ledgerIndex = state.ledgerIndex ?? closedLedgerIndex
+    if (ledgerIndex >= closedLedgerIndex) {
+      latestStates.set(key, { ledgerIndex, loadedAt: Date.now(), state })
+    } else {
+      latestStates.delete(key)
+    }
+    return state
+  }
+
+  private static async loadApplicationState(
+    client: XrplRequester,
+    options: HookStateFetchOptions
+  ): Promise<ApplicationState> {
+    const applicationState = new ApplicationState()
+    const pages = StateUtility.iterateAccountNamespacePages(client, options)
+    const pool = HookStateWorkerPool.shared()
+    const maxPagesInFlight = StateUtility.getMaxPagesInFlight()
     try {
-      hookState = await StateUtility.getHookState(client)
+      // Pages are decoded and assembled on the worker pool while the next page is fetched, then
+      // applied in page order; at most maxPagesInFlight pages are held at a time
+      let applied: Promise<void> = Promise.resolve()
+      const pagesInFlight: Promise<void>[] = []
+      for await (const { ledgerIndex, namespaceEntries } of pages) {
+        applicationState.ledgerIndex = ledgerIndex
+
+        const assembling = pool.assemble(namespaceEntries)
+        // Failures surface when applied is awaited
+        assembling.catch(() => undefined)
+        applied = applied.then(async () => {
+          for (const assembled of await assembling) {
+            const campaignsMetadata = await StateUtility.getCampaignsMetadata(
+              Array.from(assembled.campaigns.id)
+            )
+            applyAssembledHookState(
+              applicationState,
+              assembled,
+              campaignsMetadata
+            )
+          }
+        })
+        applied.catch(() => undefined)
+
+        pagesInFlight.push(applied)
+        if (pagesInFlight.length >= maxPagesInFlight) {
+          await pagesInFlight.shift()
+        }
+      }
+      await applied
     } catch (error: Error | any) {
-      if (
-        error?.message ===
-          'No HookNamespaces found. This means no data has been saved to the Hook State yet.' ||
-        error?.message.includes('HookNamespace not found for')
-      ) {
+      if (StateUtility.isHookStateEmptyError(error)) {
         // This means no data has been saved to the Hook State yet so this is fine.
         // We just need to initialize an empty ApplicationState.
         return new ApplicationState([]) // Return empty state
@@ -97,133 +394,280 @@ export class StateUtility {
       throw error
     }
 
-    const destinationTagToCampaignMap: Map<number, Campaign> = new Map()
-    const destinationTagToFundTransactionsMap: Map<number, FundTransaction[]> =
-      new Map()
-    const destinationTagToBackersMap: Map<number, Backer[]> = new Map()
+    return applicationState
+  }
 
-    for (const entry of hookState.entries) {
-      const { key, value } = entry
-      const { dataLookupFlag, destinationTag } = key
+  // Pages a load requests or holds at a time: two per decode worker
+  private static getMaxPagesInFlight(): number {
+    return Math.max(HookStateWorkerPool.shared().size, 1) * 2
+  }
 
-      if (dataLookupFlag === DATA_LOOKUP_GENERAL_INFO_FLAG) {
-        const generalInfo = value.decoded as HSVCampaignGeneralInfo
-        const campaignDatabaseEntry = await CampaignDatabaseModel.findOne({
-          id: destinationTag,
-        })
-          .lean()
-          .exec()
-        if (!campaignDatabaseEntry) {
-          throw new Error(
-            `CampaignDatabaseModel entry not found for campaignId ${destinationTag}`
-          )
-        }
-        const campaignState = deriveCampaignState(generalInfo)
-        const milestonesStates = deriveMilestonesStates(
-          campaignState,
-          generalInfo.fundRaiseEndDateInUnixSeconds,
-          generalInfo.milestones
-        )
-        const milestones: Milestone[] = generalInfo.milestones.map(
-          (milestone, index) => {
-            return new Milestone(
-              milestonesStates[index],
-              milestone.endDateInUnixSeconds,
-              milestone.payoutPercent,
-              campaignDatabaseEntry.milestones[index].title
-            )
-          }
-        )
+  private static getStateLoadKey(
+    ledgerIndex: number | 'validated' = 'validated'
+  ): string {
+    return `${deriveHookNamespace(config.HOOK_NAMESPACE_SEED)}:${ledgerIndex}`
+  }
 
-        const campaign = new Campaign(
-          key.destinationTag,
-          campaignState,
-          generalInfo.owner,
-          campaignDatabaseEntry.title,
-          campaignDatabaseEntry.description,
-          campaignDatabaseEntry.overviewUrl,
-          campaignDatabaseEntry.imageUrl,
-          generalInfo.fundRaiseGoalInDrops,
-          generalInfo.fundRaiseEndDateInUnixSeconds,
-          generalInfo.totalAmountRaisedInDrops,
-          generalInfo.totalAmountNonRefundableInDrops,
-          generalInfo.totalReserveAmountInDrops,
-          generalInfo.totalRejectVotesForCurrentMilestone,
-          milestones,
-          [],
-          []
-        )
-        destinationTagToCampaignMap.set(destinationTag, campaign)
-      } else if (
-        dataLookupFlag >= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG &&
-        dataLookupFlag <= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG
-      ) {
-        const fundTransactionsPage = value.decoded as HSVFundTransactionsPage
-        const fundTransactions = fundTransactionsPage.fundTransactions.map(
-          (fundTransaction) => {
-            /* Step 1. Create new FundTransaction object */
-            const appFundTransaction = new FundTransaction(
-              fundTransaction.id,
-              fundTransaction.account,
-              deriveFundTransactionState(fundTransaction),
-              fundTransaction.amountInDrops
-            )
+  /**
+   * Reads a single Hook State entry by key with ledger_entry. Returns undefined if it doesn't exist.
+   */
+  static async getHookStateEntry<T extends BaseModel>(
+    client: XrplRequester,
+    dataLookupFlag: bigint,
+    destinationTag: number,
+    ledgerIndex: number | 'validated' = 'validated'
+  ): Promise<KeyedHookStateEntry<T> | undefined> {
+    if (!client.isConnected()) {
+      throw new Error('xrpl Client is not connected')
+    }
 
-            /* Step 2. Add/Update Backer object in destinationTagToBackersMap */
-            if (!destinationTagToBackersMap.get(destinationTag)) {
-              destinationTagToBackersMap.set(destinationTag, [])
-            }
-            const backers = destinationTagToBackersMap.get(destinationTag)
+    const ledgerEntryRequest: Request = {
+      command: 'ledger_entry',
+      // @ts-expect-error - hook_state is supported on Hooks Testnet v3
+      hook_state: {
+        account: HOOK_ACCOUNT_WALLET.address,
+        key: new HookStateKey(dataLookupFlag, destinationTag).encode(),
+        namespace_id: deriveHookNamespace(config.HOOK_NAMESPACE_SEED),
+      },
+      ledger_index: ledgerIndex,
+    }
+    try {
+      const ledgerEntryResponse = await client.request(ledgerEntryRequest)
+      // @ts-expect-error - this is defined
+      const { node, ledger_index } = ledgerEntryResponse.result
+      return {
+        ledgerIndex: ledger_index as number,
+        entry: new HookStateEntry<T>(node as AccountNamespaceHookStateEntry),
+      }
+    } catch (error: Error | any) {
+      if (error?.data?.error === 'entryNotFound') {
+        return undefined
+      }
+      throw error
+    }
+  }
 
-            // @ts-expect-error - this is defined from above check
-            // OPTIMIZE: use a map instead of array for constant time O(1) lookup
-            let backer = backers.find(
-              (backer) => backer.account === fundTransaction.account
-            )
-            if (!backer) {
-              backer = new Backer(fundTransaction.account, [])
-              // @ts-expect-error - this is also defined from same check
-              backers.push(backer)
-            }
+  /**
+   * Reads one campaign with keyed ledger_entry lookups instead of loading the whole namespace:
+   * its General Info entry first, then the Fund Transactions pages (derived from
+   * totalFundTransactions) concurrently, all at the General Info entry's validated ledger.
+   * Returns undefined if the campaign doesn't exist.
+   */
+  static async getCampaign(
+    client: XrplRequester,
+    database: Connection,
+    campaignId: number
+  ): Promise<Campaign | undefined> {
+    if (!client.isConnected()) {
+      throw new Error('xrpl Client is not connected')
+    }
+    if (database.readyState !== 1) {
+      throw new Error('MongoDB database is not connected')
+    }
 
-            backer.fundTransactions.push(appFundTransaction)
+    // Step 1. Get General Info and pin its validated ledger index
+    const generalInfo = await StateUtility.getHookStateEntry(
+      client,
+      DATA_LOOKUP_GENERAL_INFO_FLAG,
+      campaignId
+    )
+    if (!generalInfo) {
+      return undefined
+    }
+    const { ledgerIndex } = generalInfo
+    const { totalFundTransactions } = generalInfo.entry.value
+      .decoded as unknown as HSVCampaignGeneralInfo
 
-            /* Step 3. Return new application FundTransaction object */
-            return appFundTransaction
-          }
+    // Step 2. Get Fund Transactions pages and campaign metadata concurrently, with at most
+    // getMaxPagesInFlight page requests at a time
+    const totalPages = Math.ceil(
+      totalFundTransactions / FUND_TRANSACTIONS_PAGE_MAX_SIZE
+    )
+    const pages: (KeyedHookStateEntry<BaseModel> | undefined)[] = new Array(
+      totalPages
+    )
+    let nextPageIndex = 0
+    const readPages = async () => {
+      while (nextPageIndex < totalPages) {
+        const pageIndex = nextPageIndex++
+        pages[pageIndex] = await StateUtility.getHookStateEntry(
+          client,
+          DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG +
+            BigInt(pageIndex),
+          campaignId,
+          ledgerIndex
         )
+      }
+    }
+    const pageReaders = Array.from(
+      { length: Math.min(StateUtility.getMaxPagesInFlight(), totalPages) },
+      readPages
+    )
+    const [campaignsMetadata] = await Promise.all([
+      StateUtility.getCampaignsMetadata([campaignId]),
+      Promise.all(pageReaders),
+    ])
 
-        // Add fundTransactions to destinationTagToFundTransactionsMap
-        const existingTransactions =
-          destinationTagToFundTransactionsMap.get(destinationTag)
-        destinationTagToFundTransactionsMap.set(
-          destinationTag,
-          existingTransactions
-            ? existingTransactions.concat(fundTransactions)
-            : fundTransactions
+    // Step 3. Build the campaign
+    const applicationState = new ApplicationState()
+    applicationState.ledgerIndex = ledgerIndex
+    StateUtility.applyHookStateEntry(
+      applicationState,
+      generalInfo.entry,
+      campaignsMetadata
+    )
+    for (const page of pages) {
+      if (!page) {
+        throw new Error(
+          `Fund Transactions page not found for campaignId ${campaignId}`
         )
-      } else {
-        throw new Error(`Invalid dataLookupFlag: ${dataLookupFlag}`)
       }
+      StateUtility.applyHookStateEntry(
+        applicationState,
+        page.entry,
+        campaignsMetadata
+      )
     }
 
-    // Add fundTransactions and backers to each campaign
-    const campaigns: Campaign[] = []
-    for (const [destinationTag, campaign] of destinationTagToCampaignMap) {
-      // Add fundTransactions to campaign
-      const fundTransactions =
-        destinationTagToFundTransactionsMap.get(destinationTag)
-      if (fundTransactions) {
-        campaign.fundTransactions = fundTransactions
+    return applicationState.getCampaignById(campaignId)
+  }
+
+  /**
+   * Picks a random destination tag for a new campaign without loading the platform state.
+   * A candidate is rejected if its General Info entry already exists on ledger, and is then
+   * reserved through the unique index on DestinationTagReservation; losing a race with a
+   * concurrent creator (E11000) just moves on to the next candidate.
+   */
+  static async allocateDestinationTag(client: XrplRequester): Promise<number> {
+    for (
+      let attempt = 0;
+      attempt < DESTINATION_TAG_ALLOCATION_MAX_ATTEMPTS;
+      attempt++
+    ) {
+      const destinationTag = generateRandomDestinationTag()
+
+      // Step 1. Probe the ledger for an existing campaign
+      const generalInfo = await StateUtility.getHookStateEntry(
+        client,
+        DATA_LOOKUP_GENERAL_INFO_FLAG,
+        destinationTag
+      )
+      if (generalInfo) {
+        continue
       }
-      // Add backers to campaign
-      const backers = destinationTagToBackersMap.get(destinationTag)
-      if (backers) {
-        campaign.backers = backers
+
+      // Step 2. Reserve it atomically
+      try {
+        await DestinationTagReservationDatabaseModel.create({ destinationTag })
+      } catch (error: any) {
+        if (error.code === 11000) {
+          continue
+        }
+        throw new Error(`Error reserving destination tag: ${error}`)
       }
-      campaigns.push(campaign)
+
+      return destinationTag
     }
 
-    return new ApplicationState(campaigns)
+    throw new Error(
+      `Unable to allocate a destination tag after ${DESTINATION_TAG_ALLOCATION_MAX_ATTEMPTS} attempts`
+    )
+  }
+
+  /**
+   * Deletes the reservation allocateDestinationTag made, for a campaign that was never created.
+   * Safe even if the campaign did make it to the ledger: allocateDestinationTag skips tags that
+   * already have a General Info entry.
+   */
+  static async releaseDestinationTag(destinationTag: number): Promise<void> {
+    await DestinationTagReservationDatabaseModel.deleteOne({ destinationTag })
+  }
+
+  // True for the errors iterateAccountNamespacePages throws when nothing has been saved to the Hook State yet
+  static isHookStateEmptyError(error: Error | any): boolean {
+    return (
+      error?.message ===
+        'No HookNamespaces found. This means no data has been saved to the Hook State yet.' ||
+      error?.message?.includes('HookNamespace not found for') === true
+    )
+  }
+
+  /**
+   * Converts a decoded Hook State entry to application models and adds it to applicationState.
+   * General Info entries add/replace a campaign, Fund Transactions page entries add/update
+   * its fund transactions (and backers).
+   */
+  static applyHookStateEntry<T extends BaseModel>(
+    applicationState: ApplicationState,
+    entry: HookStateEntry<T>,
+    campaignsMetadata: Map<number, CampaignMetadata>
+  ): void {
+    const { key, value } = entry
+    const { dataLookupFlag, destinationTag } = key
+
+    if (dataLookupFlag === DATA_LOOKUP_GENERAL_INFO_FLAG) {
+      const generalInfo = value.decoded as unknown as HSVCampaignGeneralInfo
+      const campaignDatabaseEntry = campaignsMetadata.get(destinationTag)
+      if (!campaignDatabaseEntry) {
+        throw new Error(
+          `CampaignDatabaseModel entry not found for campaignId ${destinationTag}`
+        )
+      }
+      const campaignState = deriveCampaignState(generalInfo)
+      const milestonesStates = deriveMilestonesStates(
+        campaignState,
+        generalInfo.fundRaiseEndDateInUnixSeconds,
+        generalInfo.milestones
+      )
+      const milestones: Milestone[] = generalInfo.milestones.map(
+        (milestone, index) => {
+          return new Milestone(
+            milestonesStates[index],
+            milestone.endDateInUnixSeconds,
+            milestone.payoutPercent,
+            campaignDatabaseEntry.milestones[index].title
+          )
+        }
+      )
+
+      const campaign = new Campaign(
+        destinationTag,
+        campaignState,
+        generalInfo.owner,
+        campaignDatabaseEntry.title,
+        campaignDatabaseEntry.description,
+        campaignDatabaseEntry.overviewUrl,
+        campaignDatabaseEntry.imageUrl,
+        generalInfo.fundRaiseGoalInDrops,
+        generalInfo.fundRaiseEndDateInUnixSeconds,
+        generalInfo.totalAmountRaisedInDrops,
+        generalInfo.totalAmountNonRefundableInDrops,
+        generalInfo.totalReserveAmountInDrops,
+        generalInfo.totalRejectVotesForCurrentMilestone,
+        milestones,
+        [],
+        []
+      )
+      applicationState.setCampaign(campaign)
+    } else if (
+      dataLookupFlag >= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG &&
+      dataLookupFlag <= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG
+    ) {
+      const fundTransactionsPage =
+        value.decoded as unknown as HSVFundTransactionsPage
+      for (const fundTransaction of fundTransactionsPage.fundTransactions) {
+        applicationState.setFundTransaction(
+          destinationTag,
+          new FundTransaction(
+            fundTransaction.id,
+            fundTransaction.account,
+            deriveFundTransactionState(fundTransaction),
+            fundTransaction.amountInDrops
+          )
+        )
+      }
+    } else {
+      throw new Error(`Invalid dataLookupFlag: ${dataLookupFlag}`)
+    }
   }
 }
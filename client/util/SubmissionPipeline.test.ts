@@ -0,0 +1,176 @@
+import { EventEmitter } from 'events'
+import { Client, decode, hashes, Payment, Wallet } from 'xrpl'
+import { SubmissionPipeline } from './SubmissionPipeline'
+
+const DESTINATION = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+
+// Answers the requests SubmissionPipeline makes; every applied transaction is streamed as validated
+class FakeClient extends EventEmitter {
+  accountSequence = 10
+  accountInfoRequests = 0
+  submittedSequences: number[] = []
+  submittedTicketSequences: number[] = []
+  engineResults: string[] = [] // returned by the next submits, then tesSUCCESS
+  failedSubmits = 0 // the next submits throw, like a dropped connection
+
+  isConnected(): boolean {
+    return true
+  }
+
+  async request(request: any): Promise<any> {
+    if (request.command === 'account_info') {
+      this.accountInfoRequests++
+      return { result: { account_data: { Sequence: this.accountSequence } } }
+    }
+    if (request.command === 'subscribe' || request.command === 'unsubscribe') {
+      return { result: {} }
+    }
+    if (request.command === 'fee') {
+      return { result: { drops: { base_fee: '12' } } }
+    }
+    if (request.command === 'server_state') {
+      const validated_ledger = { reserve_base: 10, reserve_inc: 2, seq: 1 }
+      return { result: { state: { validated_ledger } } }
+    }
+    if (request.command === 'submit') {
+      if (this.failedSubmits > 0) {
+        this.failedSubmits--
+        throw new Error('websocket was closed')
+      }
+      const engineResult = this.engineResults.shift() ?? 'tesSUCCESS'
+      if (engineResult === 'tesSUCCESS') {
+        const transaction = decode(request.tx_blob)
+        const meta = this._apply(transaction)
+        setImmediate(() => {
+          this.emit('transaction', {
+            type: 'transaction',
+            validated: true,
+            ledger_index: 1,
+            transaction: {
+              ...transaction,
+              hash: hashes.hashSignedTx(request.tx_blob),
+            },
+            meta,
+          })
+        })
+      }
+      return {
+        result: { engine_result: engineResult, engine_result_message: '' },
+      }
+    }
+    throw new Error(`Unexpected request ${request.command}`)
+  }
+
+  // TicketCreate creates Tickets for the Sequences right after its own
+  private _apply(transaction: Record<string, any>) {
+    if (transaction.TicketSequence !== undefined) {
+      this.submittedTicketSequences.push(transaction.TicketSequence)
+    } else {
+      this.submittedSequences.push(transaction.Sequence)
+    }
+    if (transaction.TransactionType !== 'TicketCreate') {
+      return { TransactionResult: 'tesSUCCESS' }
+    }
+    this.accountSequence = transaction.Sequence + transaction.TicketCount + 1
+    return {
+      TransactionResult: 'tesSUCCESS',
+      AffectedNodes: Array.from(
+        { length: transaction.TicketCount },
+        (_, index) => ({
+          CreatedNode: {
+            LedgerEntryType: 'Ticket',
+            NewFields: { TicketSequence: transaction.Sequence + index + 1 },
+          },
+        })
+      ),
+    }
+  }
+}
+
+function createPayment(wallet: Wallet): Payment {
+  return {
+    TransactionType: 'Payment',
+    Account: wallet.classicAddress,
+    Destination: DESTINATION,
+    Amount: '1000000',
+    Fee: '12',
+    LastLedgerSequence: 100,
+  }
+}
+
+describe('SubmissionPipeline', () => {
+  it('should allocate consecutive Sequences locally for concurrent submits', async () => {
+    const fakeClient = new FakeClient()
+    const pipeline = new SubmissionPipeline(fakeClient as unknown as Client)
+    const wallet = Wallet.generate()
+
+    await Promise.all([
+      pipeline.submitAndWait(createPayment(wallet), wallet),
+      pipeline.submitAndWait(createPayment(wallet), wallet),
+      pipeline.submitAndWait(createPayment(wallet), wallet),
+    ])
+
+    expect(fakeClient.accountInfoRequests).toBe(1)
+    expect(fakeClient.submittedSequences.sort()).toEqual([10, 11, 12])
+  })
+
+  it('should re-read the Sequence and renumber on tefPAST_SEQ', async () => {
+    const fakeClient = new FakeClient()
+    const pipeline = new SubmissionPipeline(fakeClient as unknown as Client)
+    const wallet = Wallet.generate()
+
+    await pipeline.submitAndWait(createPayment(wallet), wallet)
+
+    // another process used Sequences 11 and 12
+    fakeClient.accountSequence = 13
+    fakeClient.engineResults = ['tefPAST_SEQ']
+    await pipeline.submitAndWait(createPayment(wallet), wallet)
+
+    expect(fakeClient.accountInfoRequests).toBe(2)
+    expect(fakeClient.submittedSequences).toEqual([10, 13])
+  })
+
+  it('should use the Tickets it created before Sequences', async () => {
+    const fakeClient = new FakeClient()
+    const pipeline = new SubmissionPipeline(fakeClient as unknown as Client)
+    const wallet = Wallet.generate()
+
+    expect(await pipeline.createTickets(wallet, 2)).toEqual([11, 12])
+    await Promise.all([
+      pipeline.submitAndWait(createPayment(wallet), wallet),
+      pipeline.submitAndWait(createPayment(wallet), wallet),
+      pipeline.submitAndWait(createPayment(wallet), wallet),
+    ])
+
+    expect(fakeClient.submittedTicketSequences.sort()).toEqual([11, 12])
+    // The Tickets took Sequences 11 and 12
+    expect(fakeClient.submittedSequences).toEqual([10, 13])
+  })
+
+  it('should reuse the Sequence of a submit that threw', async () => {
+    const fakeClient = new FakeClient()
+    fakeClient.failedSubmits = 1
+    const pipeline = new SubmissionPipeline(fakeClient as unknown as Client)
+    const wallet = Wallet.generate()
+
+    await expect(
+      pipeline.submitAndWait(createPayment(wallet), wallet)
+    ).rejects.toThrow('websocket was closed')
+    await pipeline.submitAndWait(createPayment(wallet), wallet)
+
+    expect(fakeClient.accountInfoRequests).toBe(2)
+    expect(fakeClient.submittedSequences).toEqual([10])
+  })
+
+  it('should not retry transactions that failed with tem results', async () => {
+    const fakeClient = new FakeClient()
+    fakeClient.engineResults = ['temMALFORMED']
+    const pipeline = new SubmissionPipeline(fakeClient as unknown as Client)
+    const wallet = Wallet.generate()
+
+    await expect(
+      pipeline.submitAndWait(createPayment(wallet), wallet)
+    ).rejects.toThrow('Payment transaction failed with temMALFORMED')
+    expect(fakeClient.submittedSequences).toEqual([])
+  })
+})
@@ -0,0 +1,283 @@
+import {
+  AccountInfoRequest,
+  Client,
+  SubmitRequest,
+  Transaction,
+  TxResponse,
+  Wallet,
+} from 'xrpl'
+import { HOOK_ACCOUNT_WALLET } from '../app/constants'
+import { prepareTransactionV3, reportEngineResult } from './transaction'
+import { TransactionWaiter } from './TransactionWaiter'
+
+// Attempts per transaction across renumbering, fee retries and expiries
+const SUBMIT_MAX_ATTEMPTS = 5
+
+type SequenceAllocation = {
+  Sequence: number
+  TicketSequence?: number
+}
+
+// Sequence numbers and Tickets handed out locally for one account
+interface WalletLane {
+  nextSequence?: Promise<number>
+  tickets: number[]
+}
+
+class RenumberError extends Error {}
+
+/*
+Submits transactions for any number of wallets without waiting for one to validate before
+signing the next.
+
+Each wallet gets a lane: Sequence numbers are read once with account_info and then allocated
+locally, so many transactions from the same wallet can be signed and submitted back-to-back.
+Tickets created with createTickets() are used before Sequence numbers; they don't depend on each
+other, so a failed transaction never blocks the ones after it.
+
+Each submitted transaction is tracked by the client's TransactionWaiter until it's validated or its
+LastLedgerSequence has passed:
+- tefPAST_SEQ: the lane is behind the ledger; it's re-read and the transaction renumbered
+- terPRE_SEQ: an earlier sequence hasn't landed yet; the transaction is held by the server and
+  tracked as usual, and renumbered if it expires
+- telINSUF_FEE_P / terQUEUED: the cached fee is dropped (see reportEngineResult); on
+  telINSUF_FEE_P the transaction is re-prepared and resubmitted with the same sequence
+- expired: the lane is re-read and the transaction renumbered with a new LastLedgerSequence
+- the submit request throws (e.g. the connection dropped): the Sequence or Ticket is given back
+  and the error is rethrown
+*/
+export class SubmissionPipeline {
+  private static pipelines: WeakMap<Client, SubmissionPipeline> = new WeakMap()
+
+  private readonly client: Client
+  private readonly transactionWaiter: TransactionWaiter
+  private readonly lanes: Map<string, WalletLane> = new Map()
+
+  constructor(client: Client) {
+    this.client = client
+    this.transactionWaiter = TransactionWaiter.for(client)
+  }
+
+  // Shared pipeline per client, so every caller allocates from the same lanes
+  static for(client: Client): SubmissionPipeline {
+    let pipeline = SubmissionPipeline.pipelines.get(client)
+    if (!pipeline) {
+      pipeline = new SubmissionPipeline(client)
+      SubmissionPipeline.pipelines.set(client, pipeline)
+    }
+    return pipeline
+  }
+
+  async submitAndWait(
+    transaction: Transaction,
+    wallet: Wallet
+  ): Promise<TxResponse> {
+    if (!this.client.isConnected()) {
+      throw new Error('xrpl Client is not connected')
+    }
+
+    let allocation: SequenceAllocation | undefined
+    for (let attempt = 1; attempt <= SUBMIT_MAX_ATTEMPTS; attempt++) {
+      // Step 1. Fee, NetworkID and LastLedgerSequence
+      if (
+        transaction.Fee === undefined ||
+        transaction.LastLedgerSequence === undefined
+      ) {
+        await prepareTransactionV3(transaction, this.client)
+      }
+
+      // Step 2. Sequence or Ticket
+      if (!allocation) {
+        allocation = await this._allocate(wallet)
+      }
+      transaction.Sequence = allocation.Sequence
+      if (allocation.TicketSequence !== undefined) {
+        transaction.TicketSequence = allocation.TicketSequence
+      } else {
+        delete transaction.TicketSequence
+      }
+
+      // Step 3. Sign, start waiting and submit
+      const { tx_blob, hash } = wallet.sign(transaction)
+      const subscriptionAccount = this._getSubscriptionAccount(transaction)
+      await this.transactionWaiter.subscribe(subscriptionAccount)
+      try {
+        const validation = this.transactionWaiter.wait(
+          hash,
+          transaction.LastLedgerSequence as number
+        )
+        let engineResult: string
+        let engineResultMessage: string
+        try {
+          const submitRequest: SubmitRequest = { command: 'submit', tx_blob }
+          const submitResponse = await this.client.request(submitRequest)
+          engineResult = submitResponse.result.engine_result
+          engineResultMessage = submitResponse.result.engine_result_message
+        } catch (error) {
+          // e.g. the connection dropped: the transaction may not have been applied, so give the
+          // allocation back (a ticket that was used anyway fails later with tefNO_TICKET)
+          this.transactionWaiter.cancel(hash)
+          this._release(wallet, allocation)
+          throw error
+        }
+        reportEngineResult(engineResult)
+
+        try {
+          // Step 4. Handle the preliminary result
+          if (
+            engineResult === 'tefPAST_SEQ' ||
+            engineResult === 'tefNO_TICKET'
+          ) {
+            this.transactionWaiter.cancel(hash)
+            throw new RenumberError(engineResult)
+          }
+          if (engineResult === 'telINSUF_FEE_P') {
+            // not applied, so the sequence is still ours; retry with a fresh fee
+            this.transactionWaiter.cancel(hash)
+            delete transaction.Fee
+            continue
+          }
+          if (
+            engineResult !== 'tesSUCCESS' &&
+            engineResult !== 'terQUEUED' &&
+            engineResult !== 'terPRE_SEQ' &&
+            !engineResult.startsWith('tec')
+          ) {
+            // tem/tef/tel results don't consume the sequence or ticket
+            this.transactionWaiter.cancel(hash)
+            this._release(wallet, allocation)
+            throw new Error(
+              `${transaction.TransactionType} transaction failed with ${engineResult}: ${engineResultMessage}`
+            )
+          }
+
+          // Step 5. Track it to validation or expiry
+          const txResponse = await validation
+          if (txResponse) {
+            return txResponse
+          }
+          throw new RenumberError('expired')
+        } catch (error) {
+          if (!(error instanceof RenumberError)) {
+            throw error
+          }
+          if (allocation.TicketSequence === undefined) {
+            this._resync(wallet)
+          } else if (error.message !== 'tefNO_TICKET') {
+            // an expired transaction didn't consume its ticket
+            this._release(wallet, allocation)
+          }
+          allocation = undefined
+          delete transaction.LastLedgerSequence
+        }
+      } finally {
+        this.transactionWaiter.unsubscribe(subscriptionAccount)
+      }
+    }
+
+    throw new Error(
+      `${transaction.TransactionType} transaction not validated after ${SUBMIT_MAX_ATTEMPTS} attempts`
+    )
+  }
+
+  /**
+   * Creates count Tickets for wallet with a TicketCreate transaction. The pipeline uses them
+   * for the wallet's next transactions before falling back to Sequence numbers.
+   */
+  async createTickets(wallet: Wallet, count: number): Promise<number[]> {
+    const ticketCreateTx: Transaction = {
+      TransactionType: 'TicketCreate',
+      Account: wallet.classicAddress,
+      TicketCount: count,
+    }
+    const txResponse = await this.submitAndWait(ticketCreateTx, wallet)
+
+    const ticketSequences: number[] = []
+    // @ts-expect-error - this is defined for validated transactions
+    for (const node of txResponse.result.meta.AffectedNodes) {
+      const { CreatedNode } = node
+      if (CreatedNode?.LedgerEntryType === 'Ticket') {
+        ticketSequences.push(CreatedNode.NewFields.TicketSequence)
+      }
+    }
+    const lane = this._getLane(wallet.classicAddress)
+    lane.tickets.push(...ticketSequences)
+    // The Tickets used up the Sequences after the TicketCreate's
+    this._resync(wallet)
+    return ticketSequences
+  }
+
+  private _getLane(account: string): WalletLane {
+    let lane = this.lanes.get(account)
+    if (!lane) {
+      lane = { tickets: [] }
+      this.lanes.set(account, lane)
+    }
+    return lane
+  }
+
+  private async _allocate(wallet: Wallet): Promise<SequenceAllocation> {
+    const lane = this._getLane(wallet.classicAddress)
+    const ticketSequence = lane.tickets.shift()
+    if (ticketSequence !== undefined) {
+      return { Sequence: 0, TicketSequence: ticketSequence }
+    }
+
+    // Synchronously take the current promise and chain the next one, so concurrent callers
+    // each get a distinct Sequence
+    if (!lane.nextSequence) {
+      lane.nextSequence = this._fetchAccountSequence(wallet.classicAddress)
+    }
+    const sequence = lane.nextSequence
+    const nextSequence = sequence.then((value) => value + 1)
+    lane.nextSequence = nextSequence
+    nextSequence.catch(() => {
+      if (lane.nextSequence === nextSequence) {
+        lane.nextSequence = undefined
+      }
+    })
+    return { Sequence: await sequence }
+  }
+
+  private _release(wallet: Wallet, allocation: SequenceAllocation): void {
+    if (allocation.TicketSequence !== undefined) {
+      this._getLane(wallet.classicAddress).tickets.unshift(
+        allocation.TicketSequence
+      )
+    } else {
+      // later sequences may already be allocated, so re-read instead of handing it out again
+      this._resync(wallet)
+    }
+  }
+
+  private _resync(wallet: Wallet): void {
+    this._getLane(wallet.classicAddress).nextSequence = undefined
+  }
+
+  // Transactions to the Hook Account share its subscription instead of adding every sender
+  private _getSubscriptionAccount(transaction: Transaction): string {
+    const { Destination } = transaction as { Destination?: string }
+    return Destination === HOOK_ACCOUNT_WALLET.address
+      ? HOOK_ACCOUNT_WALLET.address
+      : transaction.Account
+  }
+
+  private async _fetchAccountSequence(account: string): Promise<number> {
+    const accountInfoRequest: AccountInfoRequest = {
+      command: 'account_info',
+      account,
+      ledger_index: 'current',
+    }
+    const accountInfoResponse = await this.client.request(accountInfoRequest)
+    return accountInfoResponse.result.account_data.Sequence
+  }
+}
+
+// Submits through the client's shared SubmissionPipeline
+export function submitAndWaitV3(
+  client: Client,
+  transaction: Transaction,
+  wallet: Wallet
+): Promise<TxResponse> {
+  return SubmissionPipeline.for(client).submitAndWait(transaction, wallet)
+}
@@ -0,0 +1,105 @@
+import { EventEmitter } from 'events'
+import { Client } from 'xrpl'
+import { HOOK_ACCOUNT_WALLET } from '../app/constants'
+import { TransactionWaiter } from './TransactionWaiter'
+
+const ACCOUNT = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+
+class FakeClient extends EventEmitter {
+  subscribeRequests = 0
+  unsubscribedAccounts: string[] = []
+  txRequests = 0
+
+  isConnected(): boolean {
+    return true
+  }
+
+  async request(request: any): Promise<any> {
+    if (request.command === 'subscribe') {
+      this.subscribeRequests++
+      return { result: {} }
+    }
+    if (request.command === 'unsubscribe') {
+      this.unsubscribedAccounts.push(...request.accounts)
+      return { result: {} }
+    }
+    if (request.command === 'tx') {
+      this.txRequests++
+      throw { data: { error: 'txnNotFound' } }
+    }
+    throw new Error(`Unexpected request ${request.command}`)
+  }
+}
+
+function hashOf(index: number): string {
+  return index.toString(16).toUpperCase().padStart(64, '0')
+}
+
+describe('TransactionWaiter', () => {
+  it('should resolve many pending transactions from one subscription', async () => {
+    const fakeClient = new FakeClient()
+    const waiter = new TransactionWaiter(fakeClient as unknown as Client)
+
+    const validations = []
+    for (let i = 0; i < 1000; i++) {
+      await waiter.subscribe(ACCOUNT)
+      validations.push(waiter.wait(hashOf(i), 100))
+    }
+    for (let i = 0; i < 1000; i++) {
+      fakeClient.emit('transaction', {
+        validated: true,
+        ledger_index: 90,
+        transaction: { TransactionType: 'Payment', hash: hashOf(i) },
+        meta: { TransactionResult: 'tesSUCCESS' },
+      })
+    }
+
+    const txResponses = await Promise.all(validations)
+    expect(fakeClient.subscribeRequests).toBe(1)
+    expect(fakeClient.txRequests).toBe(0)
+    expect(waiter.pendingCount).toBe(0)
+    expect(txResponses[999]?.result.hash).toBe(hashOf(999))
+  })
+
+  it('should resolve undefined once LastLedgerSequence has passed', async () => {
+    const fakeClient = new FakeClient()
+    const waiter = new TransactionWaiter(fakeClient as unknown as Client)
+
+    await waiter.subscribe(ACCOUNT)
+    const validation = waiter.wait(hashOf(1), 100)
+
+    fakeClient.emit('ledgerClosed', { ledger_index: 100 })
+    expect(waiter.pendingCount).toBe(1)
+
+    fakeClient.emit('ledgerClosed', { ledger_index: 101 })
+    expect(await validation).toBeUndefined()
+    expect(fakeClient.txRequests).toBe(1)
+  })
+
+  it('should unsubscribe an account when nothing waits on it anymore', async () => {
+    const fakeClient = new FakeClient()
+    const waiter = new TransactionWaiter(fakeClient as unknown as Client)
+
+    await waiter.subscribe(ACCOUNT)
+    await waiter.subscribe(ACCOUNT)
+    waiter.unsubscribe(ACCOUNT)
+    expect(fakeClient.unsubscribedAccounts).toEqual([])
+
+    waiter.unsubscribe(ACCOUNT)
+    expect(fakeClient.unsubscribedAccounts).toEqual([ACCOUNT])
+
+    // Subscribed again for the next wait
+    await waiter.subscribe(ACCOUNT)
+    expect(fakeClient.subscribeRequests).toBe(2)
+  })
+
+  it('should keep the Hook Account subscribed', async () => {
+    const fakeClient = new FakeClient()
+    const waiter = new TransactionWaiter(fakeClient as unknown as Client)
+
+    await waiter.subscribe(HOOK_ACCOUNT_WALLET.address)
+    waiter.unsubscribe(HOOK_ACCOUNT_WALLET.address)
+
+    expect(fakeClient.unsubscribedAccounts).toEqual([])
+  })
+})
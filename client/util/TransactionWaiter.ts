@@ -0,0 +1,254 @@
+import {
+  Client,
+  LedgerStream,
+  SubscribeRequest,
+  TransactionStream,
+  TxRequest,
+  TxResponse,
+  UnsubscribeRequest,
+} from 'xrpl'
+import { HOOK_ACCOUNT_WALLET } from '../app/constants'
+
+interface PendingTransaction {
+  lastLedgerSequence: number
+  resolve: (txResponse: TxResponse | undefined) => void
+  reject: (error: Error) => void
+}
+
+interface AccountSubscription {
+  subscribed: Promise<void>
+  // subscribe() calls not yet matched by unsubscribe()
+  count: number
+}
+
+/*
+Waits for submitted transactions to be validated using the client's subscription streams instead of
+polling per transaction.
+
+Accounts are added to one subscription (together with the ledger stream) the first time they're
+waited on, and removed again once nothing waits on them. The Hook Account stays subscribed: its
+subscription on the connection is shared with ApplicationStateCache, which checks isSubscribed and
+hasSubscriptions before unsubscribing when it stops. Pending transactions are kept
+by hash and resolved from the transaction stream. Every
+validated ledger expires the pending transactions whose LastLedgerSequence it passed: the ledger
+stream message for ledger N is published after all of ledger N - 1's transactions, so those are
+checked once with tx (in case the stream missed it, e.g. across a reconnect) and otherwise resolve
+to undefined.
+*/
+export class TransactionWaiter {
+  private static waiters: WeakMap<Client, TransactionWaiter> = new WeakMap()
+
+  private readonly client: Client
+  private readonly pending: Map<string, PendingTransaction> = new Map()
+  private readonly subscribedAccounts: Map<string, AccountSubscription> =
+    new Map()
+  // unsubscribe requests in flight, so a new subscribe for the account is sent after them
+  private readonly unsubscribingAccounts: Map<string, Promise<void>> =
+    new Map()
+  private listening = false
+
+  constructor(client: Client) {
+    this.client = client
+  }
+
+  // Shared waiter per client, so all pending transactions use the same subscription
+  static for(client: Client): TransactionWaiter {
+    let waiter = TransactionWaiter.waiters.get(client)
+    if (!waiter) {
+      waiter = new TransactionWaiter(client)
+      TransactionWaiter.waiters.set(client, waiter)
+    }
+    return waiter
+  }
+
+  get pendingCount(): number {
+    return this.pending.size
+  }
+
+  // True while a subscribe(account) isn't matched by unsubscribe(account) yet
+  isSubscribed(account: string): boolean {
+    return this.subscribedAccounts.has(account)
+  }
+
+  // True while any account is subscribed or any transaction is waited on; both need the ledger stream
+  get hasSubscriptions(): boolean {
+    return this.subscribedAccounts.size > 0 || this.pending.size > 0
+  }
+
+  /**
+   * Adds account to the subscription until the matching unsubscribe(account). Await this before
+   * submitting a transaction that only affects account, so its validation can't be missed.
+   */
+  subscribe(account: string): Promise<void> {
+    this._listen()
+
+    const subscription = this.subscribedAccounts.get(account)
+    if (subscription) {
+      subscription.count++
+      return subscription.subscribed
+    }
+    const newSubscription = {
+      subscribed: this._requestSubscribe(account),
+      count: 1,
+    }
+    this.subscribedAccounts.set(account, newSubscription)
+    return newSubscription.subscribed
+  }
+
+  // Releases one subscribe(account); the last one removes account from the subscription
+  unsubscribe(account: string): void {
+    const subscription = this.subscribedAccounts.get(account)
+    if (!subscription || --subscription.count > 0) {
+      return
+    }
+    this.subscribedAccounts.delete(account)
+    if (account === HOOK_ACCOUNT_WALLET.address || !this.client.isConnected()) {
+      return
+    }
+
+    const unsubscribeRequest: UnsubscribeRequest = {
+      command: 'unsubscribe',
+      accounts: [account],
+    }
+    const unsubscribing = this.client
+      .request(unsubscribeRequest)
+      .then(() => undefined)
+      .catch((error) => {
+        console.error(`TransactionWaiter failed to unsubscribe: ${error}`)
+      })
+      .finally(() => {
+        if (this.unsubscribingAccounts.get(account) === unsubscribing) {
+          this.unsubscribingAccounts.delete(account)
+        }
+      })
+    this.unsubscribingAccounts.set(account, unsubscribing)
+  }
+
+  /**
+   * Resolves with the validated transaction, or undefined once a validated ledger passes
+   * lastLedgerSequence without it. Call it before submitting, using the signed transaction's hash.
+   */
+  wait(
+    hash: string,
+    lastLedgerSequence: number
+  ): Promise<TxResponse | undefined> {
+    this._listen()
+
+    return new Promise((resolve, reject) => {
+      this.pending.set(hash, { lastLedgerSequence, resolve, reject })
+    })
+  }
+
+  // Stops waiting for a transaction that wasn't applied; its promise never settles
+  cancel(hash: string): void {
+    this.pending.delete(hash)
+  }
+
+  private _listen(): void {
+    if (this.listening) {
+      return
+    }
+    this.listening = true
+    this.client.on('transaction', this._onTransaction)
+    this.client.on('ledgerClosed', this._onLedgerClosed)
+    this.client.on('connected', this._onConnected)
+  }
+
+  private _onTransaction = (transactionStream: TransactionStream): void => {
+    const { transaction, meta, ledger_index, validated } = transactionStream
+    // @ts-expect-error - hash is included in transaction streams
+    const hash: string | undefined = transaction.hash
+    if (!validated || !hash) {
+      return
+    }
+
+    const pendingTransaction = this.pending.get(hash)
+    if (!pendingTransaction) {
+      return
+    }
+    this.pending.delete(hash)
+    pendingTransaction.resolve({
+      id: 0,
+      type: 'response',
+      result: {
+        ...transaction,
+        hash,
+        meta,
+        ledger_index,
+        validated,
+      },
+    } as TxResponse)
+  }
+
+  private _onLedgerClosed = (ledgerStream: LedgerStream): void => {
+    for (const [hash, pendingTransaction] of this.pending) {
+      if (pendingTransaction.lastLedgerSequence < ledgerStream.ledger_index) {
+        this.pending.delete(hash)
+        this._getValidatedTx(hash)
+          .then(pendingTransaction.resolve)
+          .catch(pendingTransaction.reject)
+      }
+    }
+  }
+
+  // Subscriptions don't survive a reconnect: subscribe again and look up what the stream missed
+  private _onConnected = (): void => {
+    this.unsubscribingAccounts.clear()
+    const resubscribed = [...this.subscribedAccounts].map(
+      ([account, subscription]) => {
+        subscription.subscribed = this._requestSubscribe(account)
+        return subscription.subscribed
+      }
+    )
+    Promise.all(resubscribed)
+      .then(() => {
+        for (const [hash, pendingTransaction] of this.pending) {
+          this._getValidatedTx(hash)
+            .then((txResponse) => {
+              if (txResponse && this.pending.delete(hash)) {
+                pendingTransaction.resolve(txResponse)
+              }
+            })
+            .catch(() => undefined) // retried at expiry
+        }
+      })
+      .catch((error) => {
+        console.error(`TransactionWaiter failed to resubscribe: ${error}`)
+      })
+  }
+
+  // Drops the subscription again if the request fails, so the next subscribe() retries it
+  private _requestSubscribe(account: string): Promise<void> {
+    const subscribeRequest: SubscribeRequest = {
+      command: 'subscribe',
+      accounts: [account],
+      streams: ['ledger'],
+    }
+    const subscribed = (
+      this.unsubscribingAccounts.get(account) ?? Promise.resolve()
+    )
+      .then(() => this.client.request(subscribeRequest))
+      .then(() => undefined)
+    subscribed.catch(() => {
+      if (this.subscribedAccounts.get(account)?.subscribed === subscribed) {
+        this.subscribedAccounts.delete(account)
+      }
+    })
+    return subscribed
+  }
+
+  private async _getValidatedTx(
+    hash: string
+  ): Promise<TxResponse | undefined> {
+    const txRequest: TxRequest = { command: 'tx', transaction: hash }
+    try {
+      const txResponse = await this.client.request(txRequest)
+      return txResponse.result.validated ? txResponse : undefined
+    } catch (error: Error | any) {
+      if (error?.data?.error === 'txnNotFound') {
+        return undefined
+      }
+      throw error
+    }
+  }
+}
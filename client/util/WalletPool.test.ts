@@ -0,0 +1,121 @@
+import { Wallet } from 'xrpl'
+import { FundingSource, WalletPool } from './WalletPool'
+
+// Funds a wallet each time fund() is called, so tests control when funding completes
+class FakeFundingSource implements FundingSource {
+  requests: Array<{
+    resolve: (wallet: Wallet) => void
+    reject: (error: Error) => void
+  }> = []
+
+  fundWallet(): Promise<Wallet> {
+    return new Promise((resolve, reject) => {
+      this.requests.push({ resolve, reject })
+    })
+  }
+
+  async fund(count = 1): Promise<void> {
+    for (let i = 0; i < count; i++) {
+      await flushPromises()
+      const request = this.requests.shift()
+      if (!request) {
+        throw new Error('No pending funding request')
+      }
+      request.resolve(Wallet.generate())
+    }
+    await flushPromises()
+  }
+
+  async fail(error: Error): Promise<void> {
+    await flushPromises()
+    this.requests.shift()?.reject(error)
+    await flushPromises()
+  }
+}
+
+function flushPromises(): Promise<void> {
+  return new Promise((resolve) => setImmediate(resolve))
+}
+
+describe('WalletPool', () => {
+  it('should fill up and hand out wallets without waiting', async () => {
+    const source = new FakeFundingSource()
+    const pool = new WalletPool(source, { size: 3, lowWatermark: 1 })
+    pool.start()
+    await source.fund(3)
+    expect(pool.readyCount).toBe(3)
+    expect(source.requests).toHaveLength(0)
+
+    const first = await pool.take()
+    const second = await pool.take()
+    expect(first.classicAddress).not.toBe(second.classicAddress)
+    // Still at the watermark, so no refill yet
+    await flushPromises()
+    expect(source.requests).toHaveLength(0)
+
+    // Below the watermark: refill up to size
+    await pool.take()
+    await source.fund(3)
+    expect(pool.readyCount).toBe(3)
+
+    pool.stop()
+  })
+
+  it('should serve waiting callers first when the pool is empty', async () => {
+    const source = new FakeFundingSource()
+    const pool = new WalletPool(source, { size: 1, lowWatermark: 1 })
+    pool.start()
+
+    const taken = [pool.take(), pool.take()]
+    await source.fund(2)
+    const wallets = await Promise.all(taken)
+    expect(wallets[0].classicAddress).not.toBe(wallets[1].classicAddress)
+    expect(pool.readyCount).toBe(0)
+
+    await source.fund()
+    expect(pool.readyCount).toBe(1)
+    pool.stop()
+  })
+
+  it('should fail waiting callers when funding fails, then retry', async () => {
+    const source = new FakeFundingSource()
+    const pool = new WalletPool(source, {
+      size: 0,
+      lowWatermark: 0,
+      retryDelayMs: 0,
+    })
+    pool.start()
+
+    const taken = expect(pool.take()).rejects.toThrow('faucet unavailable')
+    await source.fail(new Error('faucet unavailable'))
+    await taken
+
+    const retaken = pool.take()
+    await source.fund()
+    await expect(retaken).resolves.toBeInstanceOf(Wallet)
+    expect(pool.readyCount).toBe(0)
+    pool.stop()
+  })
+
+  it('should serve callers that take before the pool starts once it starts', async () => {
+    const source = new FakeFundingSource()
+    const pool = new WalletPool(source, { size: 1, lowWatermark: 1 })
+
+    const taken = pool.take()
+    await flushPromises()
+    expect(source.requests).toHaveLength(0)
+
+    pool.start()
+    await source.fund()
+    await expect(taken).resolves.toBeInstanceOf(Wallet)
+    pool.stop()
+    await expect(pool.take()).rejects.toThrow('WalletPool is stopped')
+  })
+
+  it('should reject a watermark above the size', () => {
+    expect(
+      () =>
+        new WalletPool(new FakeFundingSource(), { size: 1, lowWatermark: 2 })
+    ).toThrow('Invalid WalletPool lowWatermark')
+  })
+})
@@ -0,0 +1,196 @@
+import { AccountInfoRequest, Client, Wallet } from 'xrpl'
+import { fundWallet } from './fundWallet'
+
+// The Hooks Testnet v3 faucet rejects requests less than 10 seconds apart
+const FAUCET_REQUEST_INTERVAL_MS = 10000
+const ACCOUNT_VALIDATION_POLL_INTERVAL_MS = 1000
+const ACCOUNT_VALIDATION_TIMEOUT_MS = 30000
+// Wait before funding again after the funding source failed
+const REFILL_RETRY_DELAY_MS = 5000
+
+// Creates funded wallets; the pool's only dependency on a ledger, so tests can replace it
+export interface FundingSource {
+  fundWallet(): Promise<Wallet>
+}
+
+export interface WalletPoolOptions {
+  // Wallets kept ready
+  size: number
+  // Refilling starts when fewer wallets than this are ready
+  lowWatermark: number
+  retryDelayMs?: number
+}
+
+interface WalletWaiter {
+  resolve: (wallet: Wallet) => void
+  reject: (error: Error) => void
+}
+
+function delay(ms: number): Promise<void> {
+  return new Promise((resolve) => setTimeout(resolve, ms))
+}
+
+/*
+Funds wallets with the Hooks Testnet v3 faucet (fundWallet), one request at a time and no more
+often than the faucet allows, and resolves once the account is in a validated ledger.
+*/
+export class FaucetFundingSource implements FundingSource {
+  private readonly client: Client
+  private queue: Promise<unknown> = Promise.resolve()
+  private lastRequestAt = 0
+
+  constructor(client: Client) {
+    this.client = client
+  }
+
+  fundWallet(): Promise<Wallet> {
+    const funded = this.queue.then(async () => {
+      const waitMs =
+        this.lastRequestAt + FAUCET_REQUEST_INTERVAL_MS - Date.now()
+      if (waitMs > 0) {
+        await delay(waitMs)
+      }
+      this.lastRequestAt = Date.now()
+      return fundWallet()
+    })
+    this.queue = funded.catch(() => undefined)
+    return funded.then((wallet) => this.waitForValidatedAccount(wallet))
+  }
+
+  private async waitForValidatedAccount(wallet: Wallet): Promise<Wallet> {
+    const accountInfoRequest: AccountInfoRequest = {
+      command: 'account_info',
+      account: wallet.classicAddress,
+      ledger_index: 'validated',
+    }
+    const deadline = Date.now() + ACCOUNT_VALIDATION_TIMEOUT_MS
+    for (;;) {
+      try {
+        await this.client.request(accountInfoRequest)
+        return wallet
+      } catch (error: Error | any) {
+        if (error?.data?.error !== 'actNotFound') {
+          throw error
+        }
+      }
+      if (Date.now() >= deadline) {
+        throw new Error(
+          `Funded account ${wallet.classicAddress} not validated after ${ACCOUNT_VALIDATION_TIMEOUT_MS}ms`
+        )
+      }
+      await delay(ACCOUNT_VALIDATION_POLL_INTERVAL_MS)
+    }
+  }
+}
+
+/*
+Keeps up to options.size funded wallets ready so take() can hand one out without waiting on the
+funding source. Once fewer than options.lowWatermark are ready, wallets are funded one at a time
+in the background until the pool is full again.
+
+When the pool is empty, take() waits for the next funded wallet; callers waiting are served before
+the pool is refilled. Callers that take() before start() wait the same way until the pool starts.
+A funding failure fails the waiting callers and is retried after a delay. A pool of size 0 funds a
+wallet for each take().
+
+Ready wallets are only kept in memory, so the ones not handed out are dropped on stop() or a
+restart and the pool refills from the faucet. That's deliberate: a persisted seed could be handed
+out again after a crash between taking it and removing it, and testnet resets unfund them anyway.
+*/
+export class WalletPool {
+  private readonly source: FundingSource
+  private readonly size: number
+  private readonly lowWatermark: number
+  private readonly retryDelayMs: number
+  private readonly ready: Wallet[] = []
+  private readonly waiters: WalletWaiter[] = []
+  private refilling: Promise<void> | undefined
+  private started = false
+  private stopped = false
+
+  constructor(source: FundingSource, options: WalletPoolOptions) {
+    if (options.lowWatermark > options.size) {
+      throw new Error(
+        `Invalid WalletPool lowWatermark: ${options.lowWatermark} (must not exceed size ${options.size})`
+      )
+    }
+    this.source = source
+    this.size = options.size
+    this.lowWatermark = options.lowWatermark
+    this.retryDelayMs = options.retryDelayMs ?? REFILL_RETRY_DELAY_MS
+  }
+
+  get readyCount(): number {
+    return this.ready.length
+  }
+
+  start(): void {
+    this.started = true
+    this.stopped = false
+    this._refill()
+  }
+
+  // Stops refilling without waiting on a funding in flight; waiting callers are failed
+  stop(): void {
+    this.started = false
+    this.stopped = true
+    for (const waiter of this.waiters.splice(0)) {
+      waiter.reject(new Error('WalletPool is stopped'))
+    }
+    this.ready.splice(0)
+  }
+
+  take(): Promise<Wallet> {
+    if (this.stopped) {
+      return Promise.reject(new Error('WalletPool is stopped'))
+    }
+
+    const wallet = this.ready.shift()
+    if (wallet) {
+      if (this.ready.length < this.lowWatermark) {
+        this._refill()
+      }
+      return Promise.resolve(wallet)
+    }
+
+    return new Promise((resolve, reject) => {
+      this.waiters.push({ resolve, reject })
+      this._refill()
+    })
+  }
+
+  // Waiters queued before start() are served once it's called
+  private _refill(): void {
+    if (this.started && !this.refilling) {
+      this.refilling = this._fundUntilFull().finally(() => {
+        this.refilling = undefined
+      })
+    }
+  }
+
+  private async _fundUntilFull(): Promise<void> {
+    while (
+      this.started &&
+      (this.waiters.length > 0 || this.ready.length < this.size)
+    ) {
+      let wallet: Wallet
+      try {
+        wallet = await this.source.fundWallet()
+      } catch (error: Error | any) {
+        console.error(`WalletPool failed to fund a wallet: ${error}`)
+        for (const waiter of this.waiters.splice(0)) {
+          waiter.reject(error)
+        }
+        await delay(this.retryDelayMs)
+        continue
+      }
+
+      const waiter = this.waiters.shift()
+      if (waiter) {
+        waiter.resolve(wallet)
+      } else if (this.started) {
+        this.ready.push(wallet)
+      }
+    }
+  }
+}
@@ -0,0 +1,198 @@
+import { AddressInfo } from 'net'
+import { AccountInfoRequest, RippledError } from 'xrpl'
+import { RawData, WebSocket, WebSocketServer } from 'ws'
+import { XrplConnectionPool } from './XrplConnectionPool'
+
+const ACCOUNT = 'rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh'
+
+type StandInResponse =
+  | { result: Record<string, unknown> }
+  | { error: string }
+  // Never answered
+  | 'stall'
+
+// Answers XRPL requests over WebSocket like a rippled node, after delayMs
+class StandInXrplServer {
+  readonly server: WebSocketServer
+  readonly requests: string[] = []
+  delayMs = 0
+  // Answers by command; server_info and ping are answered as a synced node
+  responses: Record<string, StandInResponse> = {}
+
+  constructor() {
+    this.server = new WebSocketServer({ port: 0, host: '127.0.0.1' })
+    this.server.on('connection', (socket) => {
+      socket.on('message', (data) => this._onMessage(socket, data))
+    })
+  }
+
+  get url(): string {
+    const { port } = this.server.address() as AddressInfo
+    return `ws://127.0.0.1:${port}`
+  }
+
+  listening(): Promise<void> {
+    return new Promise((resolve) => this.server.on('listening', resolve))
+  }
+
+  close(): Promise<void> {
+    for (const socket of this.server.clients) {
+      socket.terminate()
+    }
+    return new Promise((resolve) => this.server.close(() => resolve()))
+  }
+
+  private _onMessage(socket: WebSocket, data: RawData): void {
+    const { id, command } = JSON.parse(data.toString())
+    let response: StandInResponse
+    if (command === 'ping') {
+      response = { result: {} }
+    } else if (command === 'server_info') {
+      response = {
+        result: {
+          info: { server_state: 'full', validated_ledger: { seq: 100 } },
+        },
+      }
+    } else {
+      this.requests.push(command)
+      response = this.responses[command] ?? { error: 'unknownCmd' }
+    }
+    if (response === 'stall') {
+      return
+    }
+
+    const message =
+      'error' in response
+        ? { id, type: 'response', status: 'error', error: response.error }
+        : { id, type: 'response', status: 'success', ...response }
+    setTimeout(() => {
+      if (socket.readyState === WebSocket.OPEN) {
+        socket.send(JSON.stringify(message))
+      }
+    }, this.delayMs)
+  }
+}
+
+const accountInfoRequest: AccountInfoRequest = {
+  command: 'account_info',
+  account: ACCOUNT,
+  ledger_index: 'validated',
+}
+
+function accountInfoResult(served: string): Record<string, unknown> {
+  return { account_data: { Account: ACCOUNT }, ledger_index: 100, served }
+}
+
+describe('XrplConnectionPool', () => {
+  let fast: StandInXrplServer
+  let slow: StandInXrplServer
+  let pool: XrplConnectionPool | undefined
+
+  beforeEach(async () => {
+    fast = new StandInXrplServer()
+    slow = new StandInXrplServer()
+    slow.delayMs = 30
+    await Promise.all([fast.listening(), slow.listening()])
+    fast.responses.account_info = { result: accountInfoResult('fast') }
+    slow.responses.account_info = { result: accountInfoResult('slow') }
+  })
+
+  afterEach(async () => {
+    await pool?.disconnect()
+    pool = undefined
+    await Promise.all([fast.close(), slow.close()])
+  })
+
+  it('should route requests to the lowest latency endpoint', async () => {
+    pool = new XrplConnectionPool([slow.url, fast.url])
+    await pool.connect()
+
+    for (let i = 0; i < 3; i++) {
+      const response = await pool.request(accountInfoRequest)
+      expect(response.result).toMatchObject({ served: 'fast' })
+    }
+    expect(fast.requests).toEqual(Array(3).fill('account_info'))
+    expect(slow.requests).toEqual([])
+  })
+
+  it('should fail over on notSynced and route around the endpoint', async () => {
+    fast.responses.account_info = { error: 'notSynced' }
+    pool = new XrplConnectionPool([fast.url, slow.url])
+    await pool.connect()
+
+    const first = await pool.request(accountInfoRequest)
+    expect(first.result).toMatchObject({ served: 'slow' })
+    // Unhealthy until the next health check
+    const second = await pool.request(accountInfoRequest)
+    expect(second.result).toMatchObject({ served: 'slow' })
+    expect(fast.requests).toEqual(['account_info'])
+  })
+
+  it('should not fail over on an answer such as entryNotFound', async () => {
+    fast.responses.ledger_entry = { error: 'entryNotFound' }
+    slow.responses.ledger_entry = { result: { node: {} } }
+    pool = new XrplConnectionPool([fast.url, slow.url])
+    await pool.connect()
+
+    const request = pool.request({ command: 'ledger_entry', index: '00' })
+    await expect(request).rejects.toBeInstanceOf(RippledError)
+    expect(slow.requests).toEqual([])
+  })
+
+  it('should hedge a read to a second endpoint when the first is slow', async () => {
+    fast.responses.account_info = 'stall'
+    pool = new XrplConnectionPool([fast.url, slow.url], {
+      requestTimeoutMs: 5000,
+      hedgeReads: true,
+      hedgeMinDelayMs: 20,
+    })
+    await pool.connect()
+
+    const startedAt = Date.now()
+    const response = await pool.request(accountInfoRequest)
+    expect(response.result).toMatchObject({ served: 'slow' })
+    expect(Date.now() - startedAt).toBeLessThan(5000)
+    expect(fast.requests).toEqual(['account_info'])
+  })
+
+  it('should not hedge requests that write', async () => {
+    fast.responses.submit = 'stall'
+    pool = new XrplConnectionPool([fast.url, slow.url], {
+      requestTimeoutMs: 200,
+      hedgeReads: true,
+      hedgeMinDelayMs: 20,
+    })
+    await pool.connect()
+
+    // Times out on the first endpoint, then fails over
+    slow.responses.submit = { result: { engine_result: 'tesSUCCESS' } }
+    const startedAt = Date.now()
+    const response = await pool.request({ command: 'submit', tx_blob: '00' })
+    expect(response.result).toMatchObject({ engine_result: 'tesSUCCESS' })
+    expect(Date.now() - startedAt).toBeGreaterThanOrEqual(190)
+    expect(fast.requests).toEqual(['submit'])
+    expect(slow.requests).toEqual(['submit'])
+  })
+
+  it('should keep serving when an endpoint goes down', async () => {
+    pool = new XrplConnectionPool([fast.url, slow.url], {
+      reconnectMinDelayMs: 10000,
+    })
+    await pool.connect()
+    await fast.close()
+
+    const response = await pool.request(accountInfoRequest)
+    expect(response.result).toMatchObject({ served: 'slow' })
+    expect(pool.isConnected()).toBe(true)
+  })
+
+  it('should fail to connect when no endpoint is reachable', async () => {
+    const { url } = fast
+    await Promise.all([fast.close(), slow.close()])
+    pool = new XrplConnectionPool([url], {
+      requestTimeoutMs: 1000,
+      reconnectMinDelayMs: 10000,
+    })
+    await expect(pool.connect()).rejects.toThrow('No XRPL endpoint')
+  })
+})
@@ -0,0 +1,383 @@
+import {
+  Client,
+  ConnectionError,
+  NotConnectedError,
+  Request,
+  RippledError,
+  ServerInfoRequest,
+  TimeoutError,
+} from 'xrpl'
+
+// What StateUtility needs to read from a ledger; both Client and XrplConnectionPool provide it
+export type XrplRequester = Pick<Client, 'request' | 'isConnected'>
+
+// Read-only commands that are safe to send to a second endpoint
+const HEDGED_COMMANDS = new Set([
+  'account_info',
+  'account_namespace',
+  'ledger_entry',
+  'tx',
+])
+
+// rippled errors that mean "ask another node" rather than an answer
+const FAILOVER_RIPPLED_ERRORS = new Set([
+  'notSynced',
+  'noNetwork',
+  'noCurrent',
+  'noClosed',
+  'tooBusy',
+  'slowDown',
+  'lgrNotFound',
+])
+
+const SYNCED_SERVER_STATES = new Set(['full', 'proposing', 'validating'])
+
+// Weight of the newest sample in an endpoint's latency average
+const LATENCY_EWMA_WEIGHT = 0.2
+const LATENCY_SAMPLES_MAX = 200
+
+export interface XrplConnectionPoolOptions {
+  requestTimeoutMs?: number
+  healthCheckIntervalMs?: number
+  // Ledgers an endpoint may trail the newest validated ledger of any endpoint and stay healthy
+  maxLedgerLag?: number
+  // Send read-only requests to a second endpoint when the first hasn't answered in the p95 latency
+  hedgeReads?: boolean
+  hedgeMinDelayMs?: number
+  reconnectMinDelayMs?: number
+  reconnectMaxDelayMs?: number
+}
+
+interface XrplEndpoint {
+  url: string
+  client: Client
+  healthy: boolean
+  latencyMs: number | undefined
+  validatedLedgerIndex: number | undefined
+  reconnectDelayMs: number
+  reconnectTimer: NodeJS.Timeout | undefined
+}
+
+function isFailoverError(error: unknown): boolean {
+  if (error instanceof RippledError) {
+    const data = error.data as { error?: string } | undefined
+    return (
+      data?.error !== undefined && FAILOVER_RIPPLED_ERRORS.has(data.error)
+    )
+  }
+  // NotConnectedError and DisconnectedError extend ConnectionError
+  return error instanceof ConnectionError || error instanceof TimeoutError
+}
+
+/*
+A Client per configured endpoint, used as one XrplRequester.
+
+Requests go to the healthy endpoint with the lowest latency (an average of its recent requests and
+health checks). An endpoint that fails with a timeout, a lost connection or a rippled error such
+as notSynced is marked unhealthy and the request fails over to the next one. Health checks
+(server_info) mark endpoints healthy again once they're synced and within maxLedgerLag of the
+newest validated ledger, and endpoints that disconnect are reconnected with exponential backoff.
+
+With hedgeReads, read-only requests are also sent to the second best endpoint if the first hasn't
+answered after the p95 latency of recent requests (hedgeMinDelayMs at least), and the first answer
+is used.
+
+Subscriptions aren't pooled: streams stay on a single Client.
+*/
+export class XrplConnectionPool implements XrplRequester {
+  private readonly endpoints: XrplEndpoint[]
+  private readonly options: Required<XrplConnectionPoolOptions>
+  private readonly latencySamples: number[] = []
+  private healthCheckTimer: NodeJS.Timeout | undefined
+  private started = false
+
+  constructor(urls: string[], options: XrplConnectionPoolOptions = {}) {
+    if (urls.length === 0) {
+      throw new Error('XrplConnectionPool needs at least one endpoint')
+    }
+    this.options = {
+      requestTimeoutMs: options.requestTimeoutMs ?? 10000,
+      healthCheckIntervalMs: options.healthCheckIntervalMs ?? 5000,
+      maxLedgerLag: options.maxLedgerLag ?? 3,
+      hedgeReads: options.hedgeReads ?? false,
+      hedgeMinDelayMs: options.hedgeMinDelayMs ?? 20,
+      reconnectMinDelayMs: options.reconnectMinDelayMs ?? 1000,
+      reconnectMaxDelayMs: options.reconnectMaxDelayMs ?? 30000,
+    }
+    this.endpoints = urls.map((url) => ({
+      url,
+      client: new Client(url, {
+        timeout: this.options.requestTimeoutMs,
+        connectionTimeout: this.options.requestTimeoutMs,
+      }),
+      healthy: false,
+      latencyMs: undefined,
+      validatedLedgerIndex: undefined,
+      reconnectDelayMs: this.options.reconnectMinDelayMs,
+      reconnectTimer: undefined,
+    }))
+    for (const { url, client } of this.endpoints) {
+      // Client emits connection errors as 'error' events, which throw without a listener
+      client.on('error', (errorCode: string, errorMessage: string) =>
+        console.error(`XRPL endpoint ${url} error: ${errorCode} ${errorMessage}`)
+      )
+    }
+  }
+
+  // Same signature as Client.request, so the pool can be used wherever an XrplRequester is
+  request = ((request: Request) => this._request(request)) as Client['request']
+
+  isConnected(): boolean {
+    return this.endpoints.some(({ client }) => client.isConnected())
+  }
+
+  /**
+   * Connects every endpoint and runs a first health check. Endpoints that fail to connect are
+   * retried in the background; throws only if none connected (and keeps retrying).
+   */
+  async connect(): Promise<void> {
+    if (this.started) {
+      return
+    }
+    this.started = true
+
+    for (const endpoint of this.endpoints) {
+      // Client also reconnects on its own after an unexpected close
+      endpoint.client.on('connected', () => {
+        endpoint.reconnectDelayMs = this.options.reconnectMinDelayMs
+      })
+      endpoint.client.on('disconnected', () =>
+        this._scheduleReconnect(endpoint)
+      )
+    }
+    await Promise.all(
+      this.endpoints.map((endpoint) => this._connect(endpoint))
+    )
+    await this._checkHealth()
+    this.healthCheckTimer = setInterval(
+      () => this._checkHealth(),
+      this.options.healthCheckIntervalMs
+    )
+    this.healthCheckTimer.unref()
+
+    if (!this.isConnected()) {
+      throw new NotConnectedError(
+        `No XRPL endpoint could be connected: ${this.endpoints
+          .map(({ url }) => url)
+          .join(', ')}`
+      )
+    }
+  }
+
+  async disconnect(): Promise<void> {
+    this.started = false
+    clearInterval(this.healthCheckTimer)
+    await Promise.all(
+      this.endpoints.map(async (endpoint) => {
+        clearTimeout(endpoint.reconnectTimer)
+        endpoint.client.removeAllListeners('connected')
+        endpoint.client.removeAllListeners('disconnected')
+        if (endpoint.client.isConnected()) {
+          await endpoint.client.disconnect()
+        }
+      })
+    )
+  }
+
+  private async _connect(endpoint: XrplEndpoint): Promise<void> {
+    try {
+      await endpoint.client.connect()
+    } catch (error) {
+      console.error(
+        `XrplConnectionPool failed to connect ${endpoint.url}: ${error}`
+      )
+      this._scheduleReconnect(endpoint)
+    }
+  }
+
+  private _scheduleReconnect(endpoint: XrplEndpoint): void {
+    endpoint.healthy = false
+    if (!this.started || endpoint.reconnectTimer) {
+      return
+    }
+    endpoint.reconnectTimer = setTimeout(async () => {
+      endpoint.reconnectTimer = undefined
+      if (!this.started || endpoint.client.isConnected()) {
+        return
+      }
+      endpoint.reconnectDelayMs = Math.min(
+        endpoint.reconnectDelayMs * 2,
+        this.options.reconnectMaxDelayMs
+      )
+      await this._connect(endpoint)
+      if (endpoint.client.isConnected()) {
+        await this._checkHealth()
+      }
+    }, endpoint.reconnectDelayMs)
+    endpoint.reconnectTimer.unref()
+  }
+
+  private async _checkHealth(): Promise<void> {
+    const serverInfoRequest: ServerInfoRequest = { command: 'server_info' }
+    const synced = await Promise.all(
+      this.endpoints.map(async (endpoint) => {
+        if (!endpoint.client.isConnected()) {
+          return false
+        }
+        try {
+          const { info } = (
+            await this._send(endpoint, serverInfoRequest)
+          ).result
+          endpoint.validatedLedgerIndex = info.validated_ledger?.seq
+          return SYNCED_SERVER_STATES.has(info.server_state)
+        } catch {
+          return false
+        }
+      })
+    )
+
+    const newestLedgerIndex = Math.max(
+      0,
+      ...this.endpoints.map(
+        ({ validatedLedgerIndex }) => validatedLedgerIndex ?? 0
+      )
+    )
+    this.endpoints.forEach((endpoint, index) => {
+      endpoint.healthy =
+        synced[index] &&
+        endpoint.validatedLedgerIndex !== undefined &&
+        endpoint.validatedLedgerIndex >=
+          newestLedgerIndex - this.options.maxLedgerLag
+    })
+  }
+
+  // Healthy endpoints by latency, then connected but unhealthy ones as a last resort
+  private _getCandidates(): XrplEndpoint[] {
+    const connected = this.endpoints.filter(({ client }) =>
+      client.isConnected()
+    )
+    const byLatency = (a: XrplEndpoint, b: XrplEndpoint) =>
+      (a.latencyMs ?? Infinity) - (b.latencyMs ?? Infinity)
+    return [
+      ...connected.filter(({ healthy }) => healthy).sort(byLatency),
+      ...connected.filter(({ healthy }) => !healthy).sort(byLatency),
+    ]
+  }
+
+  private async _request(request: Request): Promise<unknown> {
+    const candidates = this._getCandidates()
+    if (candidates.length === 0) {
+      throw new NotConnectedError('No XRPL endpoint is connected')
+    }
+    const hedged =
+      this.options.hedgeReads && HEDGED_COMMANDS.has(request.command)
+
+    let lastError: unknown
+    for (let next = 0; next < candidates.length; ) {
+      const endpoints = candidates.slice(next, next + (hedged ? 2 : 1))
+      next += endpoints.length
+      try {
+        return await this._race(request, endpoints)
+      } catch (error) {
+        if (!isFailoverError(error)) {
+          throw error
+        }
+        lastError = error
+      }
+    }
+    throw lastError
+  }
+
+  /**
+   * Sends request to endpoints[0], and to endpoints[1] (if any) once the hedge delay passed or
+   * endpoints[0] failed over. Settles with the first answer; rejects with a failover error only
+   * once every endpoint failed.
+   */
+  private _race(
+    request: Request,
+    endpoints: XrplEndpoint[]
+  ): Promise<unknown> {
+    return new Promise((resolve, reject) => {
+      let sent = 0
+      let failed = 0
+      let settled = false
+      let hedgeTimer: NodeJS.Timeout | undefined
+
+      const settle = (settleWith: () => void) => {
+        settled = true
+        clearTimeout(hedgeTimer)
+        settleWith()
+      }
+      const send = () => {
+        const endpoint = endpoints[sent++]
+        this._send(endpoint, request).then(
+          (response) => {
+            if (!settled) {
+              settle(() => resolve(response))
+            }
+          },
+          (error) => {
+            if (settled) {
+              return
+            }
+            failed++
+            if (!isFailoverError(error) || failed === endpoints.length) {
+              settle(() => reject(error))
+            } else if (sent < endpoints.length) {
+              // Don't wait out the hedge delay for an endpoint that already failed
+              clearTimeout(hedgeTimer)
+              send()
+            }
+          }
+        )
+      }
+
+      send()
+      if (endpoints.length > 1) {
+        hedgeTimer = setTimeout(send, this._getHedgeDelayMs())
+      }
+    })
+  }
+
+  private async _send<R extends Request>(
+    endpoint: XrplEndpoint,
+    request: R
+  ): Promise<any> {
+    const startedAt = Date.now()
+    try {
+      const response = await endpoint.client.request(request)
+      this._recordLatency(endpoint, Date.now() - startedAt)
+      return response
+    } catch (error) {
+      if (isFailoverError(error)) {
+        endpoint.healthy = false
+      } else {
+        this._recordLatency(endpoint, Date.now() - startedAt)
+      }
+      throw error
+    }
+  }
+
+  private _recordLatency(endpoint: XrplEndpoint, latencyMs: number): void {
+    endpoint.latencyMs =
+      endpoint.latencyMs === undefined
+        ? latencyMs
+        : endpoint.latencyMs * (1 - LATENCY_EWMA_WEIGHT) +
+          latencyMs * LATENCY_EWMA_WEIGHT
+    this.latencySamples.push(latencyMs)
+    if (this.latencySamples.length > LATENCY_SAMPLES_MAX) {
+      this.latencySamples.shift()
+    }
+  }
+
+  // p95 of recent request and health check latencies
+  private _getHedgeDelayMs(): number {
+    if (this.latencySamples.length === 0) {
+      return this.options.requestTimeoutMs / 2
+    }
+    const sorted = [...this.latencySamples].sort((a, b) => a - b)
+    const p95 =
+      sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * 0.95))]
+    return Math.max(p95, this.options.hedgeMinDelayMs)
+  }
+}
@@ -0,0 +1,275 @@
+import type { CampaignMetadata } from './StateUtility'
+import {
+  DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG,
+  DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+  DATA_LOOKUP_GENERAL_INFO_FLAG,
+  deriveCampaignState,
+  deriveFundTransactionState,
+  deriveMilestonesStates,
+} from '../app/constants'
+import { AccountNamespaceHookStateEntry } from '../app/models/HookState'
+import { ApplicationState } from '../app/models/ApplicationState'
+import { Campaign } from '../app/models/Campaign'
+import { FundTransaction } from '../app/models/FundTransaction'
+import { HSVCampaignGeneralInfo } from '../app/models/HSVCampaignGeneralInfo'
+import { HSVFundTransactionsPage } from '../app/models/HSVFundTransactionsPage'
+import { Milestone } from '../app/models/Milestone'
+import { decodeHookStateEntries } from './nativeDecoder'
+
+/*
+Hook State entries decoded and converted to application values (derived states included), laid out
+as typed arrays so a worker can hand them back by transferring the buffers instead of copying
+objects. Strings (r-addresses and state names) are stored once in strings and referenced by index.
+
+Everything that needs MongoDB (titles, descriptions, ...) is added on the main thread by
+applyAssembledHookState, the same way StateUtility.applyHookStateEntry does for a single entry.
+*/
+export interface AssembledHookState {
+  strings: string[]
+  campaigns: {
+    id: Uint32Array
+    state: Uint32Array
+    owner: Uint32Array
+    fundRaiseGoalInDrops: BigUint64Array
+    fundRaiseEndDateInUnixSeconds: BigUint64Array
+    totalAmountRaisedInDrops: BigUint64Array
+    totalAmountNonRefundableInDrops: BigUint64Array
+    totalReserveAmountInDrops: BigUint64Array
+    totalRejectVotesForCurrentMilestone: Uint32Array
+    // Exclusive end of each campaign's milestones
+    milestonesEnd: Uint32Array
+  }
+  milestones: {
+    state: Uint32Array
+    endDateInUnixSeconds: BigUint64Array
+    payoutPercent: Uint8Array
+  }
+  fundTransactions: {
+    campaignId: Uint32Array
+    id: Uint32Array
+    account: Uint32Array
+    state: Uint32Array
+    amountInDrops: BigUint64Array
+  }
+}
+
+class StringTable {
+  readonly strings: string[] = []
+  private readonly indexes: Map<string, number> = new Map()
+
+  indexOf(value: string): number {
+    let index = this.indexes.get(value)
+    if (index === undefined) {
+      index = this.strings.push(value) - 1
+      this.indexes.set(value, index)
+    }
+    return index
+  }
+}
+
+export function assembleHookStateEntries(
+  namespaceEntries: AccountNamespaceHookStateEntry[]
+): AssembledHookState {
+  const strings = new StringTable()
+  const campaigns = {
+    id: [] as number[],
+    state: [] as number[],
+    owner: [] as number[],
+    fundRaiseGoalInDrops: [] as bigint[],
+    fundRaiseEndDateInUnixSeconds: [] as bigint[],
+    totalAmountRaisedInDrops: [] as bigint[],
+    totalAmountNonRefundableInDrops: [] as bigint[],
+    totalReserveAmountInDrops: [] as bigint[],
+    totalRejectVotesForCurrentMilestone: [] as number[],
+    milestonesEnd: [] as number[],
+  }
+  const milestones = {
+    state: [] as number[],
+    endDateInUnixSeconds: [] as bigint[],
+    payoutPercent: [] as number[],
+  }
+  const fundTransactions = {
+    campaignId: [] as number[],
+    id: [] as number[],
+    account: [] as number[],
+    state: [] as number[],
+    amountInDrops: [] as bigint[],
+  }
+
+  for (const { key, value } of decodeHookStateEntries(namespaceEntries)) {
+    const { dataLookupFlag } = key
+    if (dataLookupFlag === DATA_LOOKUP_GENERAL_INFO_FLAG) {
+      const generalInfo = value.decoded as unknown as HSVCampaignGeneralInfo
+      const campaignState = deriveCampaignState(generalInfo)
+      const milestonesStates = deriveMilestonesStates(
+        campaignState,
+        generalInfo.fundRaiseEndDateInUnixSeconds,
+        generalInfo.milestones
+      )
+      campaigns.id.push(key.destinationTag)
+      campaigns.state.push(strings.indexOf(campaignState))
+      campaigns.owner.push(strings.indexOf(generalInfo.owner))
+      campaigns.fundRaiseGoalInDrops.push(generalInfo.fundRaiseGoalInDrops)
+      campaigns.fundRaiseEndDateInUnixSeconds.push(
+        generalInfo.fundRaiseEndDateInUnixSeconds
+      )
+      campaigns.totalAmountRaisedInDrops.push(
+        generalInfo.totalAmountRaisedInDrops
+      )
+      campaigns.totalAmountNonRefundableInDrops.push(
+        generalInfo.totalAmountNonRefundableInDrops
+      )
+      campaigns.totalReserveAmountInDrops.push(
+        generalInfo.totalReserveAmountInDrops
+      )
+      campaigns.totalRejectVotesForCurrentMilestone.push(
+        generalInfo.totalRejectVotesForCurrentMilestone
+      )
+      generalInfo.milestones.forEach((milestone, index) => {
+        milestones.state.push(strings.indexOf(milestonesStates[index]))
+        milestones.endDateInUnixSeconds.push(milestone.endDateInUnixSeconds)
+        milestones.payoutPercent.push(milestone.payoutPercent)
+      })
+      campaigns.milestonesEnd.push(milestones.state.length)
+    } else if (
+      dataLookupFlag >= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG &&
+      dataLookupFlag <= DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_END_INDEX_FLAG
+    ) {
+      const fundTransactionsPage =
+        value.decoded as unknown as HSVFundTransactionsPage
+      for (const fundTransaction of fundTransactionsPage.fundTransactions) {
+        fundTransactions.campaignId.push(key.destinationTag)
+        fundTransactions.id.push(fundTransaction.id)
+        fundTransactions.account.push(strings.indexOf(fundTransaction.account))
+        fundTransactions.state.push(
+          strings.indexOf(deriveFundTransactionState(fundTransaction))
+        )
+        fundTransactions.amountInDrops.push(fundTransaction.amountInDrops)
+      }
+    } else {
+      throw new Error(`Invalid dataLookupFlag: ${dataLookupFlag}`)
+    }
+  }
+
+  return {
+    strings: strings.strings,
+    campaigns: {
+      id: Uint32Array.from(campaigns.id),
+      state: Uint32Array.from(campaigns.state),
+      owner: Uint32Array.from(campaigns.owner),
+      fundRaiseGoalInDrops: BigUint64Array.from(campaigns.fundRaiseGoalInDrops),
+      fundRaiseEndDateInUnixSeconds: BigUint64Array.from(
+        campaigns.fundRaiseEndDateInUnixSeconds
+      ),
+      totalAmountRaisedInDrops: BigUint64Array.from(
+        campaigns.totalAmountRaisedInDrops
+      ),
+      totalAmountNonRefundableInDrops: BigUint64Array.from(
+        campaigns.totalAmountNonRefundableInDrops
+      ),
+      totalReserveAmountInDrops: BigUint64Array.from(
+        campaigns.totalReserveAmountInDrops
+      ),
+      totalRejectVotesForCurrentMilestone: Uint32Array.from(
+        campaigns.totalRejectVotesForCurrentMilestone
+      ),
+      milestonesEnd: Uint32Array.from(campaigns.milestonesEnd),
+    },
+    milestones: {
+      state: Uint32Array.from(milestones.state),
+      endDateInUnixSeconds: BigUint64Array.from(
+        milestones.endDateInUnixSeconds
+      ),
+      payoutPercent: Uint8Array.from(milestones.payoutPercent),
+    },
+    fundTransactions: {
+      campaignId: Uint32Array.from(fundTransactions.campaignId),
+      id: Uint32Array.from(fundTransactions.id),
+      account: Uint32Array.from(fundTransactions.account),
+      state: Uint32Array.from(fundTransactions.state),
+      amountInDrops: BigUint64Array.from(fundTransactions.amountInDrops),
+    },
+  }
+}
+
+// Buffers to transfer when posting assembled to another thread
+export function getAssembledTransferList(
+  assembled: AssembledHookState
+): ArrayBuffer[] {
+  const { campaigns, milestones, fundTransactions } = assembled
+  return [
+    ...Object.values(campaigns),
+    ...Object.values(milestones),
+    ...Object.values(fundTransactions),
+  ].map((typedArray) => typedArray.buffer)
+}
+
+/**
+ * Adds assembled campaigns and fund transactions to applicationState, with their metadata.
+ * Produces the same models as StateUtility.applyHookStateEntry.
+ */
+export function applyAssembledHookState(
+  applicationState: ApplicationState,
+  assembled: AssembledHookState,
+  campaignsMetadata: Map<number, CampaignMetadata>
+): void {
+  const { strings, campaigns, milestones, fundTransactions } = assembled
+
+  let milestoneIndex = 0
+  for (let i = 0; i < campaigns.id.length; i++) {
+    const campaignId = campaigns.id[i]
+    const campaignDatabaseEntry = campaignsMetadata.get(campaignId)
+    if (!campaignDatabaseEntry) {
+      throw new Error(
+        `CampaignDatabaseModel entry not found for campaignId ${campaignId}`
+      )
+    }
+
+    const campaignMilestones: Milestone[] = []
+    const milestonesStart = milestoneIndex
+    for (; milestoneIndex < campaigns.milestonesEnd[i]; milestoneIndex++) {
+      campaignMilestones.push(
+        new Milestone(
+          strings[milestones.state[milestoneIndex]] as Milestone['state'],
+          milestones.endDateInUnixSeconds[milestoneIndex],
+          milestones.payoutPercent[milestoneIndex],
+          campaignDatabaseEntry.milestones[milestoneIndex - milestonesStart]
+            .title
+        )
+      )
+    }
+
+    applicationState.setCampaign(
+      new Campaign(
+        campaignId,
+        strings[campaigns.state[i]] as Campaign['state'],
+        strings[campaigns.owner[i]],
+        campaignDatabaseEntry.title,
+        campaignDatabaseEntry.description,
+        campaignDatabaseEntry.overviewUrl,
+        campaignDatabaseEntry.imageUrl,
+        campaigns.fundRaiseGoalInDrops[i],
+        campaigns.fundRaiseEndDateInUnixSeconds[i],
+        campaigns.totalAmountRaisedInDrops[i],
+        campaigns.totalAmountNonRefundableInDrops[i],
+        campaigns.totalReserveAmountInDrops[i],
+        campaigns.totalRejectVotesForCurrentMilestone[i],
+        campaignMilestones,
+        [],
+        []
+      )
+    )
+  }
+
+  for (let i = 0; i < fundTransactions.id.length; i++) {
+    applicationState.setFundTransaction(
+      fundTransactions.campaignId[i],
+      new FundTransaction(
+        fundTransactions.id[i],
+        strings[fundTransactions.account[i]],
+        strings[fundTransactions.state[i]] as FundTransaction['state'],
+        fundTransactions.amountInDrops[i]
+      )
+    )
+  }
+}
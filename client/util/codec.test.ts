@@ -0,0 +1,170 @@
+import { BaseModel, Metadata } from '../app/models/BaseModel'
+import { HSVCampaignGeneralInfo } from '../app/models/HSVCampaignGeneralInfo'
+import { HSVFundTransaction } from '../app/models/HSVFundTransaction'
+import { HSVFundTransactionsPage } from '../app/models/HSVFundTransactionsPage'
+import { HSVMilestone } from '../app/models/HSVMilestone'
+import { HookStateKey } from '../app/models/HookStateKey'
+import {
+  decodeModelFromBytes,
+  decodeModelFromHex,
+  encodeModelToBytes,
+  encodeModelToHex,
+} from './codec'
+import { decodeModel } from './decode'
+import { encodeModel } from './encode'
+import { UInt224, UInt8, VarString } from './types'
+
+const OWNER = 'rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh'
+const BACKER = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+
+function createGeneralInfo(): HSVCampaignGeneralInfo {
+  return new HSVCampaignGeneralInfo(
+    1,
+    OWNER,
+    BigInt(1000000000),
+    BigInt(1700000000),
+    BigInt(250000000),
+    BigInt(50000000),
+    BigInt(100000100),
+    7,
+    2,
+    [
+      new HSVMilestone(0, BigInt(1710000000), 25),
+      new HSVMilestone(0, BigInt(1720000000), 75),
+    ]
+  )
+}
+
+function createFundTransactionsPage(): HSVFundTransactionsPage {
+  return new HSVFundTransactionsPage([
+    new HSVFundTransaction(0, BACKER, 0, BigInt(1000000)),
+    new HSVFundTransaction(1, OWNER, 1, BigInt('18446744073709551615')),
+  ])
+}
+
+describe('codec', () => {
+  it('encodes HSVCampaignGeneralInfo like encodeModel', () => {
+    const generalInfo = createGeneralInfo()
+    expect(encodeModelToHex(generalInfo)).toBe(
+      encodeModel(generalInfo).toUpperCase()
+    )
+  })
+
+  it('decodes HSVCampaignGeneralInfo like decodeModel', () => {
+    const hex = encodeModel(createGeneralInfo())
+    expect(decodeModelFromHex(hex, HSVCampaignGeneralInfo)).toEqual(
+      decodeModel(hex, HSVCampaignGeneralInfo)
+    )
+  })
+
+  it('encodes and decodes HSVFundTransactionsPage', () => {
+    const page = createFundTransactionsPage()
+    const hex = encodeModelToHex(page)
+    expect(hex).toBe(encodeModel(page).toUpperCase())
+
+    const pageDecoded = decodeModelFromHex(hex, HSVFundTransactionsPage)
+    expect(pageDecoded).toEqual(page)
+    expect(pageDecoded.fundTransactions[0]).toBeInstanceOf(HSVFundTransaction)
+  })
+
+  it('encodes and decodes an empty varModelArray', () => {
+    const page = new HSVFundTransactionsPage([])
+    const hex = encodeModelToHex(page)
+    expect(hex).toBe('00')
+    expect(decodeModelFromHex(hex, HSVFundTransactionsPage)).toEqual(page)
+  })
+
+  it('encodes HookStateKey like encodeModel', () => {
+    const key = new HookStateKey(
+      BigInt('0x0000000000000000000000000000000000000000000000000000000A'),
+      0xdeadbeef
+    )
+    const hex = encodeModelToHex(key)
+    expect(hex).toBe(encodeModel(key))
+    expect(decodeModelFromHex(hex, HookStateKey)).toEqual(key)
+  })
+
+  it('decodes at an offset into a byte array', () => {
+    const generalInfo = createGeneralInfo()
+    const bytes = encodeModelToBytes(generalInfo)
+    const padded = new Uint8Array(bytes.length + 3)
+    padded.set(bytes, 3)
+    expect(decodeModelFromBytes(padded, HSVCampaignGeneralInfo, 3)).toEqual(
+      generalInfo
+    )
+  })
+
+  it('decodes nested models and varStrings', () => {
+    const InnerModel = class extends BaseModel {
+      value: UInt224
+
+      constructor(value: UInt224) {
+        super()
+        this.value = value
+      }
+
+      getMetadata(): Metadata {
+        return [{ field: 'value', type: 'uint224' }]
+      }
+    }
+    const SampleModel = class extends BaseModel {
+      modeFlag: UInt8
+      title: VarString
+      description: VarString
+      inner: InstanceType<typeof InnerModel>
+
+      constructor(
+        modeFlag: UInt8,
+        title: VarString,
+        description: VarString,
+        inner: InstanceType<typeof InnerModel>
+      ) {
+        super()
+        this.modeFlag = modeFlag
+        this.title = title
+        this.description = description
+        this.inner = inner
+      }
+
+      getMetadata(): Metadata {
+        return [
+          { field: 'modeFlag', type: 'uint8' },
+          { field: 'title', type: 'varString', maxStringLength: 20 },
+          { field: 'description', type: 'varString', maxStringLength: 300 },
+          { field: 'inner', type: 'model', modelClass: InnerModel },
+        ]
+      }
+    }
+
+    const sample = new SampleModel(
+      3,
+      'Crowdfund',
+      'Fonds für Wasser',
+      new InnerModel(BigInt(2) ** BigInt(223) + BigInt(1))
+    )
+    const hex = encodeModelToHex(sample)
+    const sampleDecoded = decodeModelFromHex(hex, SampleModel)
+    expect(sampleDecoded).toEqual(sample)
+    expect(encodeModelToHex(sampleDecoded)).toBe(hex)
+  })
+
+  it('throws on truncated input', () => {
+    const hex = encodeModelToHex(createFundTransactionsPage())
+    expect(() =>
+      decodeModelFromHex(hex.slice(0, 50), HSVFundTransactionsPage)
+    ).toThrow()
+  })
+
+  it('throws on out of range and undefined fields', () => {
+    expect(() =>
+      encodeModelToHex(new HSVMilestone(256, BigInt(0), 0))
+    ).toThrow('Integer 256 is out of range for uint8 (0-255)')
+
+    const milestone = new HSVMilestone(0, BigInt(0), 0)
+    // @ts-expect-error - testing a missing field
+    milestone.endDateInUnixSeconds = undefined
+    expect(() => encodeModelToHex(milestone)).toThrow(
+      'Field endDateInUnixSeconds is undefined in model'
+    )
+  })
+})
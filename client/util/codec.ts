@@ -0,0 +1,445 @@
+import type {
+  BaseModel,
+  MetadataElement,
+  ModelClass,
+} from '../app/models/BaseModel'
+import {
+  assertUInt8,
+  assertUInt32,
+  assertUInt64,
+  assertUInt224,
+  assertXRPAddressLength,
+} from './encode'
+import { UInt224, VarString, XRPAddress } from './types'
+
+/*
+Binary codec compiled from BaseModel metadata.
+
+decodeModel/encodeModel (decode.ts/encode.ts) walk getMetadata() for every value and slice hex
+field by field. Here each model class is compiled once, on first use, into straight-line decode
+and encode functions that read and write a Uint8Array/DataView at precomputed offsets. Hex is only
+converted at the boundary (decodeModelFromHex/encodeModelToHex). Offsets become relative to a
+running position only after a varModelArray, whose length is known at runtime.
+
+The encoded layout is identical to encodeModel's (hex is uppercase throughout), so both codecs
+can read each other's output.
+*/
+
+type Decoder<T extends BaseModel> = (
+  bytes: Uint8Array,
+  view: DataView,
+  offset: number
+) => T
+
+type Encoder<T extends BaseModel> = (
+  model: T,
+  bytes: Uint8Array,
+  view: DataView,
+  offset: number
+) => void
+
+export interface ModelCodec<T extends BaseModel> {
+  // Encoded byte length if the model has no varModelArray field
+  fixedByteLength: number | undefined
+  // Minimum encoded byte length (varModelArray fields empty)
+  minByteLength: number
+  byteLength: (model: T) => number
+  decode: Decoder<T>
+  encode: Encoder<T>
+}
+
+const MASK_64 = (1n << 64n) - 1n
+
+const helpers = {
+  assertUInt8,
+  assertUInt32,
+  assertUInt64,
+  assertUInt224,
+  assertXRPAddressLength,
+  readUInt224,
+  writeUInt224,
+  readString,
+  readVarString,
+  writeVarString,
+  writeXRPAddress,
+  assertFieldDefined,
+  assertArrayLength,
+  assertByteLength,
+}
+
+// eslint-disable-next-line @typescript-eslint/no-explicit-any
+const codecs: WeakMap<ModelClass<any>, ModelCodec<any>> = new WeakMap()
+
+export function getModelCodec<T extends BaseModel>(
+  modelClass: ModelClass<T>
+): ModelCodec<T> {
+  let codec = codecs.get(modelClass)
+  if (!codec) {
+    codec = compileModelCodec(modelClass)
+    codecs.set(modelClass, codec)
+  }
+  return codec
+}
+
+export function decodeModelFromBytes<T extends BaseModel>(
+  bytes: Uint8Array,
+  modelClass: ModelClass<T>,
+  offset = 0
+): T {
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength)
+  return getModelCodec(modelClass).decode(bytes, view, offset)
+}
+
+export function encodeModelToBytes<T extends BaseModel>(model: T): Uint8Array {
+  const codec = getModelCodec(model.constructor as ModelClass<T>)
+  const bytes = new Uint8Array(codec.byteLength(model))
+  const view = new DataView(bytes.buffer)
+  codec.encode(model, bytes, view, 0)
+  return bytes
+}
+
+export function decodeModelFromHex<T extends BaseModel>(
+  hex: string,
+  modelClass: ModelClass<T>
+): T {
+  return decodeModelFromBytes(Buffer.from(hex, 'hex'), modelClass)
+}
+
+export function encodeModelToHex<T extends BaseModel>(model: T): string {
+  const bytes = encodeModelToBytes(model)
+  return Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength)
+    .toString('hex')
+    .toUpperCase()
+}
+
+function compileModelCodec<T extends BaseModel>(
+  modelClass: ModelClass<T>
+): ModelCodec<T> {
+  const metadata: MetadataElement<T>[] = modelClass.prototype.getMetadata()
+  const name = modelClass.name || 'model'
+
+  // Nested codecs referenced by the generated code as deps[i]
+  // eslint-disable-next-line @typescript-eslint/no-explicit-any
+  const deps: ModelCodec<any>[] = []
+
+  const decodeLines: string[] = []
+  const encodeLines: string[] = []
+  const byteLengthLines: string[] = []
+
+  // Byte offset relative to p, the position after the last varModelArray
+  let k = 0
+  let minByteLength = 0
+  let isFixed = true
+  // Checked before each run of fixed-offset reads
+  let checkIndex = 0
+
+  const checkDecodeLength = (end: number) => {
+    decodeLines.splice(
+      checkIndex,
+      0,
+      `helpers.assertByteLength(bytes, p + ${end}, ${JSON.stringify(name)})`
+    )
+  }
+
+  metadata.forEach((element, index) => {
+    const {
+      field,
+      type,
+      maxStringLength,
+      modelClass: fieldModelClass,
+      maxArrayLength,
+    } = element
+    const prop = `model[${JSON.stringify(field)}]`
+    const fieldName = JSON.stringify(field)
+    const value = `v${index}`
+    encodeLines.push(`const ${value} = ${prop}`)
+    encodeLines.push(`helpers.assertFieldDefined(${value}, ${fieldName})`)
+
+    switch (type) {
+      case 'uint8':
+        decodeLines.push(`${prop} = bytes[p + ${k}]`)
+        encodeLines.push(`helpers.assertUInt8(${value})`)
+        encodeLines.push(`bytes[p + ${k}] = ${value}`)
+        k += 1
+        minByteLength += 1
+        break
+      case 'uint32':
+        decodeLines.push(`${prop} = view.getUint32(p + ${k})`)
+        encodeLines.push(`helpers.assertUInt32(${value})`)
+        encodeLines.push(`view.setUint32(p + ${k}, ${value})`)
+        k += 4
+        minByteLength += 4
+        break
+      case 'uint64':
+        decodeLines.push(`${prop} = view.getBigUint64(p + ${k})`)
+        encodeLines.push(`helpers.assertUInt64(${value})`)
+        encodeLines.push(`view.setBigUint64(p + ${k}, ${value})`)
+        k += 8
+        minByteLength += 8
+        break
+      case 'uint224':
+        decodeLines.push(`${prop} = helpers.readUInt224(view, p + ${k})`)
+        encodeLines.push(`helpers.assertUInt224(${value})`)
+        encodeLines.push(`helpers.writeUInt224(view, p + ${k}, ${value})`)
+        k += 28
+        minByteLength += 28
+        break
+      case 'varString': {
+        if (maxStringLength === undefined) {
+          throw new Error('maxStringLength is required for type varString')
+        }
+        const prefixLength = maxStringLength <= 2 ** 8 ? 1 : 2
+        decodeLines.push(
+          `${prop} = helpers.readVarString(bytes, p + ${k}, ${maxStringLength})`
+        )
+        encodeLines.push(
+          `helpers.writeVarString(bytes, p + ${k}, ${value}, ${maxStringLength})`
+        )
+        k += prefixLength + maxStringLength
+        minByteLength += prefixLength + maxStringLength
+        break
+      }
+      case 'xrpAddress':
+        decodeLines.push(
+          `${prop} = helpers.readString(bytes, p + ${k + 1}, 35, bytes[p + ${k}])`
+        )
+        encodeLines.push(`helpers.assertXRPAddressLength(${value})`)
+        encodeLines.push(`helpers.writeXRPAddress(bytes, p + ${k}, ${value})`)
+        k += 36
+        minByteLength += 36
+        break
+      case 'model': {
+        if (fieldModelClass === undefined) {
+          throw new Error('modelClass is required for type model')
+        }
+        const codec = getModelCodec(fieldModelClass)
+        if (codec.fixedByteLength === undefined) {
+          throw new Error(
+            `model field ${field} must have a fixed length (no varModelArray)`
+          )
+        }
+        const dep = deps.push(codec) - 1
+        decodeLines.push(`${prop} = deps[${dep}].decode(bytes, view, p + ${k})`)
+        encodeLines.push(`deps[${dep}].encode(${value}, bytes, view, p + ${k})`)
+        k += codec.fixedByteLength
+        minByteLength += codec.fixedByteLength
+        break
+      }
+      case 'varModelArray': {
+        if (fieldModelClass === undefined) {
+          throw new Error('modelClass is required for type varModelArray')
+        }
+        if (maxArrayLength === undefined) {
+          throw new Error('maxArrayLength is required for type varModelArray')
+        }
+        const codec = getModelCodec(fieldModelClass)
+        const elementLength = codec.fixedByteLength
+        if (elementLength === undefined) {
+          throw new Error(
+            `varModelArray field ${field} elements must have a fixed length`
+          )
+        }
+        const dep = deps.push(codec) - 1
+
+        checkDecodeLength(k + 1)
+        decodeLines.push(
+          `{`,
+          `  const n = bytes[p + ${k}]`,
+          `  p += ${k + 1}`,
+          `  helpers.assertByteLength(bytes, p + n * ${elementLength}, ${JSON.stringify(name)})`,
+          `  const array = new Array(n)`,
+          `  for (let i = 0; i < n; i++) {`,
+          `    array[i] = deps[${dep}].decode(bytes, view, p)`,
+          `    p += ${elementLength}`,
+          `  }`,
+          `  ${prop} = array`,
+          `}`
+        )
+        checkIndex = decodeLines.length
+
+        encodeLines.push(
+          `helpers.assertArrayLength(${value}, ${maxArrayLength}, ${fieldName})`,
+          `bytes[p + ${k}] = ${value}.length`,
+          `p += ${k + 1}`,
+          `for (let i = 0; i < ${value}.length; i++) {`,
+          `  deps[${dep}].encode(${value}[i], bytes, view, p)`,
+          `  p += ${elementLength}`,
+          `}`
+        )
+
+        byteLengthLines.push(
+          `const v${index} = ${prop}`,
+          `helpers.assertFieldDefined(v${index}, ${fieldName})`,
+          `helpers.assertArrayLength(v${index}, ${maxArrayLength}, ${fieldName})`,
+          `length += v${index}.length * ${elementLength}`
+        )
+
+        k = 0
+        minByteLength += 1
+        isFixed = false
+        break
+      }
+      default:
+        throw new Error(`Unknown type: ${type}`)
+    }
+  })
+  checkDecodeLength(k)
+
+  const decodeSource = [
+    `return function decode${name}(bytes, view, offset) {`,
+    `  const model = new ModelClass()`,
+    `  let p = offset`,
+    ...decodeLines.map((line) => `  ${line}`),
+    `  return model`,
+    `}`,
+  ].join('\n')
+  const encodeSource = [
+    `return function encode${name}(model, bytes, view, offset) {`,
+    `  let p = offset`,
+    ...encodeLines.map((line) => `  ${line}`),
+    `}`,
+  ].join('\n')
+  const byteLengthSource = [
+    `return function byteLength${name}(model) {`,
+    `  let length = ${minByteLength}`,
+    ...byteLengthLines.map((line) => `  ${line}`),
+    `  return length`,
+    `}`,
+  ].join('\n')
+
+  const compile = (source: string) =>
+    new Function('ModelClass', 'deps', 'helpers', source)(
+      modelClass,
+      deps,
+      helpers
+    )
+
+  return {
+    fixedByteLength: isFixed ? minByteLength : undefined,
+    minByteLength,
+    byteLength: compile(byteLengthSource),
+    decode: compile(decodeSource),
+    encode: compile(encodeSource),
+  }
+}
+
+function assertFieldDefined(value: unknown, field: string): void {
+  if (value === undefined) {
+    throw new Error(`Field ${field} is undefined in model`)
+  }
+}
+
+function assertArrayLength(
+  array: BaseModel[],
+  maxArrayLength: number,
+  field: string
+): void {
+  if (array.length > 0 && array.length > maxArrayLength) {
+    throw new Error(
+      `${field} varModelArray length ${array.length} exceeds maxArrayLength ${maxArrayLength} for model ${array[0].constructor.name}`
+    )
+  }
+}
+
+function assertByteLength(
+  bytes: Uint8Array,
+  end: number,
+  modelName: string
+): void {
+  if (end > bytes.length) {
+    throw new Error(
+      `${modelName} needs ${end} bytes but only ${bytes.length} were given`
+    )
+  }
+}
+
+function readUInt224(view: DataView, offset: number): UInt224 {
+  return (
+    (view.getBigUint64(offset) << 160n) |
+    (view.getBigUint64(offset + 8) << 96n) |
+    (view.getBigUint64(offset + 16) << 32n) |
+    BigInt(view.getUint32(offset + 24))
+  )
+}
+
+function writeUInt224(view: DataView, offset: number, value: UInt224): void {
+  view.setBigUint64(offset, value >> 160n)
+  view.setBigUint64(offset + 8, (value >> 96n) & MASK_64)
+  view.setBigUint64(offset + 16, (value >> 32n) & MASK_64)
+  view.setUint32(offset + 24, Number(value & 0xffffffffn))
+}
+
+/**
+ * Same result as decoding byteLength bytes as utf8 and keeping the first length characters
+ * (see hexToXRPAddress and hexToVarString), without the utf8 decode for ASCII content.
+ */
+function readString(
+  bytes: Uint8Array,
+  offset: number,
+  byteLength: number,
+  length: number
+): string {
+  let value = ''
+  const end = Math.min(length, byteLength)
+  for (let i = 0; i < end; i++) {
+    const byte = bytes[offset + i]
+    if (byte >= 0x80) {
+      return Buffer.from(bytes.buffer, bytes.byteOffset + offset, byteLength)
+        .toString('utf8')
+        .slice(0, length)
+    }
+    value += String.fromCharCode(byte)
+  }
+  return value
+}
+
+function readVarString(
+  bytes: Uint8Array,
+  offset: number,
+  maxStringLength: number
+): VarString {
+  if (maxStringLength <= 2 ** 8) {
+    return readString(bytes, offset + 1, maxStringLength, bytes[offset])
+  }
+  const length = (bytes[offset] << 8) | bytes[offset + 1]
+  return readString(bytes, offset + 2, maxStringLength, length)
+}
+
+function writeVarString(
+  bytes: Uint8Array,
+  offset: number,
+  value: VarString,
+  maxStringLength: number
+): void {
+  if (value.length > maxStringLength) {
+    throw new Error(
+      `String length ${value.length} exceeds max length of ${maxStringLength}`
+    )
+  }
+  const content = Buffer.from(value, 'utf8')
+  if (content.length > maxStringLength) {
+    throw new Error(
+      `String byte length ${content.length} exceeds max length of ${maxStringLength}`
+    )
+  }
+  if (maxStringLength <= 2 ** 8) {
+    bytes[offset] = value.length
+    bytes.set(content, offset + 1)
+  } else {
+    bytes[offset] = value.length >> 8
+    bytes[offset + 1] = value.length & 0xff
+    bytes.set(content, offset + 2)
+  }
+}
+
+function writeXRPAddress(
+  bytes: Uint8Array,
+  offset: number,
+  value: XRPAddress
+): void {
+  // r-addresses are base58, so every character is one byte
+  bytes[offset] = value.length
+  for (let i = 0; i < value.length; i++) {
+    bytes[offset + 1 + i] = value.charCodeAt(i)
+  }
+}
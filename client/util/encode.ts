@@ -70,32 +70,29 @@ function encodeField(
   }
 }
 
-export function uint8ToHex(value: UInt8): string {
+export function assertUInt8(value: UInt8): void {
   if (value < 0 || value > 255) {
     throw new Error(`Integer ${value} is out of range for uint8 (0-255)`)
   }
-  return value.toString(16).padStart(2, '0').toUpperCase()
 }
 
-export function uint32ToHex(value: UInt32): string {
+export function assertUInt32(value: UInt32): void {
   if (value < 0 || value > 2 ** 32 - 1) {
     throw new Error(
       `Integer ${value} is out of range for uint32 (0-4294967295)`
     )
   }
-  return value.toString(16).padStart(8, '0').toUpperCase()
 }
 
-export function uint64ToHex(value: UInt64): string {
+export function assertUInt64(value: UInt64): void {
   if (value < 0 || value > BigInt(18446744073709551615n)) {
     throw new Error(
       `Integer ${value} is out of range for uint64 (0-18446744073709551615)`
     )
   }
-  return value.toString(16).padStart(16, '0').toUpperCase()
 }
 
-export function uint224ToHex(value: UInt224): string {
+export function assertUInt224(value: UInt224): void {
   if (
     value < 0 ||
     value >
@@ -107,6 +104,36 @@ export function uint224ToHex(value: UInt224): string {
       `Integer ${value} is out of range for uint224 (0-26959946667150639794667015087019630673637144422540572481103610249215)`
     )
   }
+}
+
+export function assertXRPAddressLength(value: XRPAddress): void {
+  if (value.length > 35) {
+    throw new Error(`XRP address length ${value.length} exceeds 35 characters`)
+  }
+  if (value.length < 25) {
+    throw new Error(
+      `XRP address length ${value.length} is less than 25 characters`
+    )
+  }
+}
+
+export function uint8ToHex(value: UInt8): string {
+  assertUInt8(value)
+  return value.toString(16).padStart(2, '0').toUpperCase()
+}
+
+export function uint32ToHex(value: UInt32): string {
+  assertUInt32(value)
+  return value.toString(16).padStart(8, '0').toUpperCase()
+}
+
+export function uint64ToHex(value: UInt64): string {
+  assertUInt64(value)
+  return value.toString(16).padStart(16, '0').toUpperCase()
+}
+
+export function uint224ToHex(value: UInt224): string {
+  assertUInt224(value)
   return value.toString(16).padStart(56, '0').toUpperCase()
 }
 
@@ -137,14 +164,7 @@ export function varStringToHex(
 }
 
 export function xrpAddressToHex(value: XRPAddress): string {
-  if (value.length > 35) {
-    throw new Error(`XRP address length ${value.length} exceeds 35 characters`)
-  }
-  if (value.length < 25) {
-    throw new Error(
-      `XRP address length ${value.length} is less than 25 characters`
-    )
-  }
+  assertXRPAddressLength(value)
   const length = uint8ToHex(value.length)
   const content = Buffer.from(value, 'utf8').toString('hex')
   return (length + content.padEnd(70, '0')).toUpperCase() // 35 * 2 = 70
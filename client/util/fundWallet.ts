@@ -1,7 +1,10 @@
 import axios from 'axios'
 import { Wallet } from 'xrpl'
 
-const URL = `https://hooks-testnet-v3.xrpl-labs.com/accounts`
+// XRPL_FAUCET_URL points funding at another faucet, e.g. the local ledger's (see client/local-ledger)
+const URL =
+  process.env.XRPL_FAUCET_URL ||
+  `https://hooks-testnet-v3.xrpl-labs.com/accounts`
 
 /**
  * This function will fund a new wallet on the Hooks Testnet v3.
@@ -0,0 +1,24 @@
+import { parentPort } from 'worker_threads'
+import { AccountNamespaceHookStateEntry } from '../app/models/HookState'
+import {
+  assembleHookStateEntries,
+  getAssembledTransferList,
+} from './assembleHookState'
+
+// Entry point of the HookStateWorkerPool threads
+export interface HookStateWorkerTask {
+  id: number
+  namespaceEntries: AccountNamespaceHookStateEntry[]
+}
+
+if (parentPort) {
+  const port = parentPort
+  port.on('message', ({ id, namespaceEntries }: HookStateWorkerTask) => {
+    try {
+      const assembled = assembleHookStateEntries(namespaceEntries)
+      port.postMessage({ id, assembled }, getAssembledTransferList(assembled))
+    } catch (error: Error | any) {
+      port.postMessage({ id, error: error?.message ?? String(error) })
+    }
+  })
+}
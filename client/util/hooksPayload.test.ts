@@ -0,0 +1,72 @@
+import { Client } from 'xrpl'
+import calculateHookOn from './calculateHookOn'
+import { createHooksPayload, getInstalledHookCount } from './hooksPayload'
+import { deriveHookNamespace } from './transaction'
+
+const config = {
+  HOOKS: [
+    {
+      HOOK_C_FILENAME: 'crowdfund',
+      HookOn: ['Payment' as const, 'Invoke' as const],
+    },
+  ],
+  HOOK_NAMESPACE_SEED: 'crowdfund',
+}
+
+const readHookWasm = () => Buffer.from([0x00, 0x61, 0x73, 0x6d])
+
+describe('hooksPayload', () => {
+  describe('createHooksPayload', () => {
+    it('should install the configured hooks from position 0', () => {
+      expect(createHooksPayload(config, 0, readHookWasm)).toEqual([
+        {
+          Hook: {
+            CreateCode: '0061736D',
+            HookOn: calculateHookOn(['Payment', 'Invoke']),
+            Flags: 1,
+            HookNamespace: deriveHookNamespace('crowdfund'),
+            HookApiVersion: 0,
+          },
+        },
+      ])
+    })
+
+    it('should delete the legacy invoke hook at position 1', () => {
+      const Hooks = createHooksPayload(config, 2, readHookWasm)
+
+      expect(Hooks).toHaveLength(2)
+      expect(Hooks[0].Hook.CreateCode).toBe('0061736D')
+      expect(Hooks[1]).toEqual({ Hook: { CreateCode: '', Flags: 1 } })
+    })
+  })
+
+  describe('getInstalledHookCount', () => {
+    const createClient = (accountObjects: unknown[]) =>
+      ({
+        request: async () => ({
+          result: { account_objects: accountObjects },
+        }),
+      } as unknown as Client)
+
+    it('should count positions up to the last installed hook', async () => {
+      const client = createClient([
+        {
+          LedgerEntryType: 'Hook',
+          Hooks: [
+            { Hook: { HookHash: 'A'.repeat(64) } },
+            { Hook: {} },
+            { Hook: { HookHash: 'B'.repeat(64) } },
+          ],
+        },
+      ])
+
+      await expect(getInstalledHookCount(client, 'r')).resolves.toBe(3)
+    })
+
+    it('should return 0 for an account without hooks', async () => {
+      await expect(getInstalledHookCount(createClient([]), 'r')).resolves.toBe(
+        0
+      )
+    })
+  })
+})
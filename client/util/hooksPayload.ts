@@ -0,0 +1,106 @@
+import fs from 'fs'
+import path from 'path'
+import { Client } from 'xrpl'
+
+import calculateHookOn, { HookOnTransactionType } from './calculateHookOn'
+import { deriveHookNamespace } from './transaction'
+
+export type HooksConfig = {
+  HOOKS: {
+    HOOK_C_FILENAME: string
+    HookOn: HookOnTransactionType[]
+  }[]
+  HOOK_NAMESPACE_SEED: string
+}
+
+type HooksPayloadElement = {
+  Hook: {
+    CreateCode: string
+    HookOn?: string
+    Flags: number
+    HookNamespace?: string
+    HookApiVersion?: number
+  }
+}
+
+export type HooksPayload = HooksPayloadElement[]
+
+const hsfOVERRIDE = 1
+
+// An empty CreateCode with hsfOVERRIDE deletes the hook at that position and keeps its Hook State
+const DELETE_HOOK: HooksPayloadElement = {
+  Hook: { CreateCode: '', Flags: hsfOVERRIDE },
+}
+
+export function readBuiltHookWasm(HOOK_C_FILENAME: string): Buffer {
+  return fs.readFileSync(
+    path.resolve(__dirname, `../../build/${HOOK_C_FILENAME}.wasm`)
+  )
+}
+
+/**
+ * Hooks for a SetHook transaction installing config.HOOKS from position 0. Positions after them that
+ * still hold a hook (installedHookCount, see getInstalledHookCount) are deleted, e.g. the legacy
+ * invoke hook at position 1 of accounts that had the separate payment and invoke hooks.
+ */
+export function createHooksPayload(
+  config: HooksConfig,
+  installedHookCount = 0,
+  readHookWasm: (HOOK_C_FILENAME: string) => Buffer = readBuiltHookWasm
+): HooksPayload {
+  const result: HooksPayload = []
+
+  const { HOOKS, HOOK_NAMESPACE_SEED } = config
+  const HookNamespace = deriveHookNamespace(HOOK_NAMESPACE_SEED)
+  for (const hook of HOOKS) {
+    const { HOOK_C_FILENAME, HookOn } = hook
+    const wasm = readHookWasm(HOOK_C_FILENAME)
+
+    result.push({
+      Hook: {
+        CreateCode: wasm.toString(`hex`).toUpperCase(),
+        HookOn: calculateHookOn(HookOn),
+        Flags: hsfOVERRIDE,
+        HookNamespace,
+        HookApiVersion: 0,
+      },
+    })
+  }
+
+  for (
+    let position = HOOKS.length;
+    position < installedHookCount;
+    position++
+  ) {
+    result.push(DELETE_HOOK)
+  }
+
+  return result
+}
+
+/**
+ * Number of hook positions up to and including the last one that holds a hook on the account.
+ */
+export async function getInstalledHookCount(
+  client: Client,
+  account: string
+): Promise<number> {
+  const response = await client.request({
+    command: 'account_objects',
+    account,
+    // @ts-expect-error -- Hook ledger objects are specific to Hooks Testnet v3
+    type: 'hook',
+    ledger_index: 'validated',
+  })
+  const hookObject = response.result.account_objects[0] as unknown as
+    | { Hooks?: { Hook: { HookHash?: string } }[] }
+    | undefined
+  const hooks = hookObject?.Hooks ?? []
+  let installedHookCount = 0
+  hooks.forEach(({ Hook }, position) => {
+    if (Hook.HookHash !== undefined) {
+      installedHookCount = position + 1
+    }
+  })
+  return installedHookCount
+}
@@ -0,0 +1,105 @@
+import { BaseModel } from '../app/models/BaseModel'
+import { HookStateEntry } from '../app/models/HookStateEntry'
+import { AccountNamespaceHookStateEntry } from '../app/models/HookState'
+import { HSVFundTransactionsPage } from '../app/models/HSVFundTransactionsPage'
+import {
+  BACKER,
+  createCampaignNamespaceEntries,
+  OWNER,
+} from '../app/models/testFixtures'
+import {
+  DATA_LOOKUP_GENERAL_INFO_FLAG,
+  DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+} from '../app/constants'
+import {
+  decodeHookStateEntries,
+  fromNativeColumns,
+  isNativeDecoderAvailable,
+  NativeDecodedColumns,
+} from './nativeDecoder'
+
+const namespaceEntries = createCampaignNamespaceEntries(7)
+
+// HookStateEntry decodes lazily, so compare the decoded key and value
+function toDecoded(entries: HookStateEntry<BaseModel>[]) {
+  return entries.map(({ key, value }) => ({ key, value }))
+}
+
+const expectedEntries = toDecoded(
+  namespaceEntries.map((entry) => new HookStateEntry(entry))
+)
+
+// Only run when the addon is built (npm run build:native)
+const itWithNativeAddon = isNativeDecoderAvailable() ? it : it.skip
+
+describe('nativeDecoder', () => {
+  it('decodes the same entries as HookStateEntry', () => {
+    expect(toDecoded(decodeHookStateEntries(namespaceEntries))).toEqual(
+      expectedEntries
+    )
+  })
+
+  it('builds HookStateEntry models from native columns', () => {
+    const columns: NativeDecodedColumns = {
+      kinds: Uint8Array.from([0, 1]),
+      dataLookupFlags: BigUint64Array.from([
+        DATA_LOOKUP_GENERAL_INFO_FLAG,
+        DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG,
+      ]),
+      destinationTags: Uint32Array.from([7, 7]),
+      accounts: [OWNER, BACKER],
+      generalInfo: {
+        state: Uint8Array.from([0]),
+        owner: Uint32Array.from([0]),
+        fundRaiseGoalInDrops: BigUint64Array.from([BigInt(1000000000)]),
+        fundRaiseEndDateInUnixSeconds: BigUint64Array.from([
+          BigInt(1700000000),
+        ]),
+        totalAmountRaisedInDrops: BigUint64Array.from([BigInt(20000000)]),
+        totalAmountNonRefundableInDrops: BigUint64Array.from([BigInt(0)]),
+        totalReserveAmountInDrops: BigUint64Array.from([BigInt(100000100)]),
+        totalFundTransactions: Uint32Array.from([2]),
+        totalRejectVotesForCurrentMilestone: Uint32Array.from([0]),
+        layoutVersion: Uint8Array.from([0]),
+        migrationCursor: Uint32Array.from([0]),
+        milestonesEnd: Uint32Array.from([2]),
+      },
+      milestones: {
+        state: Uint8Array.from([0, 0]),
+        endDateInUnixSeconds: BigUint64Array.from([
+          BigInt(1710000000),
+          BigInt(1720000000),
+        ]),
+        payoutPercent: Uint8Array.from([40, 60]),
+      },
+      fundTransactions: {
+        pageEnd: Uint32Array.from([2]),
+        id: Uint32Array.from([0, 1]),
+        account: Uint32Array.from([1, 0]),
+        state: Uint8Array.from([0, 1]),
+        amountInDrops: BigUint64Array.from([
+          BigInt(10000000),
+          BigInt(10000000),
+        ]),
+      },
+    }
+
+    const entries = fromNativeColumns(columns)
+    expect(toDecoded(entries)).toEqual(expectedEntries)
+    expect(entries[0]).toBeInstanceOf(HookStateEntry)
+    expect(entries[1].value.decoded).toBeInstanceOf(HSVFundTransactionsPage)
+  })
+
+  itWithNativeAddon('names the missing or mistyped field of an entry', () => {
+    const [{ HookStateKey }] = namespaceEntries
+    const decode = (entry: object) => () =>
+      decodeHookStateEntries([entry as AccountNamespaceHookStateEntry])
+
+    expect(decode({ HookStateKey })).toThrow(
+      'account_namespace entry 0 HookStateData is missing'
+    )
+    expect(decode({ HookStateKey, HookStateData: 7 })).toThrow(
+      'account_namespace entry 0 HookStateData is not a string'
+    )
+  })
+})
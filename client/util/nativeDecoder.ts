@@ -0,0 +1,163 @@
+import { BaseModel } from '../app/models/BaseModel'
+import { AccountNamespaceHookStateEntry } from '../app/models/HookState'
+import { HookStateEntry } from '../app/models/HookStateEntry'
+import { HookStateKey } from '../app/models/HookStateKey'
+import { HookStateValue } from '../app/models/HookStateValue'
+import { HSVCampaignGeneralInfo } from '../app/models/HSVCampaignGeneralInfo'
+import { HSVFundTransaction } from '../app/models/HSVFundTransaction'
+import { HSVFundTransactionsPage } from '../app/models/HSVFundTransactionsPage'
+import { HSVMilestone } from '../app/models/HSVMilestone'
+
+// Built with `npm run build:native` (see native/crowdfund_state.cc)
+const NATIVE_BINDING_PATH = '../../native/build/Release/crowdfund_state.node'
+
+const ENTRY_KIND_GENERAL_INFO = 0
+
+// Columns returned by the addon; models are split into one typed array per field
+export interface NativeDecodedColumns {
+  kinds: Uint8Array
+  dataLookupFlags: BigUint64Array
+  destinationTags: Uint32Array
+  // Unique r-addresses, referenced by index from owner and account
+  accounts: string[]
+  generalInfo: {
+    state: Uint8Array
+    owner: Uint32Array
+    fundRaiseGoalInDrops: BigUint64Array
+    fundRaiseEndDateInUnixSeconds: BigUint64Array
+    totalAmountRaisedInDrops: BigUint64Array
+    totalAmountNonRefundableInDrops: BigUint64Array
+    totalReserveAmountInDrops: BigUint64Array
+    totalFundTransactions: Uint32Array
+    totalRejectVotesForCurrentMilestone: Uint32Array
+    layoutVersion: Uint8Array
+    migrationCursor: Uint32Array
+    // Exclusive end of each General Info's milestones
+    milestonesEnd: Uint32Array
+  }
+  milestones: {
+    state: Uint8Array
+    endDateInUnixSeconds: BigUint64Array
+    payoutPercent: Uint8Array
+  }
+  fundTransactions: {
+    // Exclusive end of each page's fund transactions
+    pageEnd: Uint32Array
+    id: Uint32Array
+    account: Uint32Array
+    state: Uint8Array
+    amountInDrops: BigUint64Array
+  }
+}
+
+interface NativeBinding {
+  decodeHookStateEntries: (
+    namespaceEntries: AccountNamespaceHookStateEntry[]
+  ) => NativeDecodedColumns
+}
+
+let nativeBinding: NativeBinding | null | undefined
+
+function loadNativeBinding(): NativeBinding | null {
+  if (nativeBinding === undefined) {
+    try {
+      // eslint-disable-next-line @typescript-eslint/no-var-requires
+      nativeBinding = require(NATIVE_BINDING_PATH) as NativeBinding
+    } catch {
+      // Not built; the TS codec is used instead
+      nativeBinding = null
+    }
+  }
+  return nativeBinding
+}
+
+export function isNativeDecoderAvailable(): boolean {
+  return loadNativeBinding() !== null
+}
+
+/**
+ * Decodes a batch of account_namespace entries with the native addon when it's built, or with the
+ * TS codec otherwise. Both return the same HookStateEntry models.
+ */
+export function decodeHookStateEntries<T extends BaseModel>(
+  namespaceEntries: AccountNamespaceHookStateEntry[]
+): HookStateEntry<T>[] {
+  const binding = loadNativeBinding()
+  if (!binding) {
+    return namespaceEntries.map((entry) => new HookStateEntry<T>(entry))
+  }
+  return fromNativeColumns(binding.decodeHookStateEntries(namespaceEntries))
+}
+
+export function fromNativeColumns<T extends BaseModel>(
+  columns: NativeDecodedColumns
+): HookStateEntry<T>[] {
+  const { kinds, dataLookupFlags, destinationTags, accounts } = columns
+  const { generalInfo, milestones, fundTransactions } = columns
+
+  const entries: HookStateEntry<T>[] = new Array(kinds.length)
+  let generalInfoIndex = 0
+  let milestoneIndex = 0
+  let pageIndex = 0
+  let fundTransactionIndex = 0
+  for (let i = 0; i < kinds.length; i++) {
+    const dataLookupFlag = dataLookupFlags[i]
+    const key = new HookStateKey(dataLookupFlag, destinationTags[i])
+
+    let value: HookStateValue<BaseModel>
+    if (kinds[i] === ENTRY_KIND_GENERAL_INFO) {
+      const g = generalInfoIndex++
+      const milestonesEnd = generalInfo.milestonesEnd[g]
+      const hsvMilestones: HSVMilestone[] = []
+      for (; milestoneIndex < milestonesEnd; milestoneIndex++) {
+        hsvMilestones.push(
+          new HSVMilestone(
+            milestones.state[milestoneIndex],
+            milestones.endDateInUnixSeconds[milestoneIndex],
+            milestones.payoutPercent[milestoneIndex]
+          )
+        )
+      }
+      value = new HookStateValue<BaseModel>(
+        dataLookupFlag,
+        new HSVCampaignGeneralInfo(
+          generalInfo.state[g],
+          accounts[generalInfo.owner[g]],
+          generalInfo.fundRaiseGoalInDrops[g],
+          generalInfo.fundRaiseEndDateInUnixSeconds[g],
+          generalInfo.totalAmountRaisedInDrops[g],
+          generalInfo.totalAmountNonRefundableInDrops[g],
+          generalInfo.totalReserveAmountInDrops[g],
+          generalInfo.totalFundTransactions[g],
+          generalInfo.totalRejectVotesForCurrentMilestone[g],
+          hsvMilestones
+        ),
+        generalInfo.layoutVersion[g],
+        generalInfo.migrationCursor[g]
+      )
+    } else {
+      const pageEnd = fundTransactions.pageEnd[pageIndex++]
+      const hsvFundTransactions: HSVFundTransaction[] = []
+      for (; fundTransactionIndex < pageEnd; fundTransactionIndex++) {
+        hsvFundTransactions.push(
+          new HSVFundTransaction(
+            fundTransactions.id[fundTransactionIndex],
+            accounts[fundTransactions.account[fundTransactionIndex]],
+            fundTransactions.state[fundTransactionIndex],
+            fundTransactions.amountInDrops[fundTransactionIndex]
+          )
+        )
+      }
+      value = new HookStateValue<BaseModel>(
+        dataLookupFlag,
+        new HSVFundTransactionsPage(hsvFundTransactions)
+      )
+    }
+
+    entries[i] = HookStateEntry.fromDecoded(
+      key,
+      value as unknown as HookStateValue<T>
+    )
+  }
+  return entries
+}
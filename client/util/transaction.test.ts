@@ -1,6 +1,7 @@
 import { Transaction } from 'xrpl'
 import {
   accountReserveFee,
+  getReserves,
   ownerReserveFee,
   prepareTransactionV3,
 } from './transaction'
@@ -25,6 +26,14 @@ describe('transaction', () => {
     expect(fee).toBe(50000000)
   })
 
+  it('getReserves should return both reserves from one server_state', async () => {
+    const reserves = await getReserves()
+    expect(reserves).toEqual({
+      accountReserveFee: 200000000,
+      ownerReserveFee: 50000000,
+    })
+  })
+
   it('prepareTransactionV3', async () => {
     const tx: Transaction = {
       TransactionType: 'Payment',
@@ -36,5 +45,6 @@ describe('transaction', () => {
     // @ts-expect-error -- NetworkID is expected for Hooks Testnet V3
     expect(tx.NetworkID).toBe(21338)
     expect(tx.Fee).toBe('52')
+    expect(tx.LastLedgerSequence).toBeDefined()
   })
 })
@@ -1,6 +1,6 @@
 import { SHA256 } from 'crypto-js'
 import { encode } from 'ripple-binary-codec'
-import { Transaction } from 'xrpl'
+import { Client, Transaction } from 'xrpl'
 import { BaseResponse } from 'xrpl/dist/npm/models/methods/baseMethod'
 import { UInt32 } from './types'
 
@@ -11,6 +11,7 @@ interface ServerStateRPCResult {
     validated_ledger: {
       reserve_base: number // Account Reserve fee
       reserve_inc: number // Owner Reserve fee
+      seq: number
     }
   }
 }
@@ -21,53 +22,179 @@ interface FeeRPCResult {
   }
 }
 
+export interface Reserves {
+  accountReserveFee: number
+  ownerReserveFee: number
+}
+
+interface ServerStateCacheEntry {
+  reserves: Reserves
+  validatedLedgerIndex: number
+}
+
+// Hooks Testnet v3 network id; required on every submitted transaction
+const NETWORK_ID = 21338
+
+// Roughly one ledger close: fees and reserves can only change on a new ledger
+const LEDGER_CACHE_TTL_MS = 4000
+
+// Same offset xrpl.js autofill uses for LastLedgerSequence
+const LAST_LEDGER_SEQUENCE_OFFSET = 20
+
+// Fee and server_state requests go to the shared client unless another one is given
+type LedgerRequester = Pick<Client, 'request'>
+
+// Submission results that mean the cached fee is too low
+const FEE_FEEDBACK_ENGINE_RESULTS = ['telINSUF_FEE_P', 'terQUEUED']
+
+/*
+Fees and reserves are cached per validated ledger. Entries are dropped on every ledgerClosed
+event (when the client is subscribed to the ledger stream, e.g. by ApplicationStateCache),
+after LEDGER_CACHE_TTL_MS otherwise, and whenever a submission reports the fee was too low
+(see reportEngineResult).
+
+Fees are keyed by transaction type, destination (a Payment to the Hook Account runs the hook)
+and encoded size, since the fee RPC charges Hooks by what gets executed and by blob size.
+Pending lookups are cached too, so concurrent callers share one RPC.
+*/
+let cachedAt = 0
+let serverStateCache: Promise<ServerStateCacheEntry> | undefined
+const feeCache: Map<string, Promise<string>> = new Map()
+
+function invalidateLedgerCache(): void {
+  serverStateCache = undefined
+  feeCache.clear()
+}
+
+function expireLedgerCache(): void {
+  if (Date.now() - cachedAt >= LEDGER_CACHE_TTL_MS) {
+    invalidateLedgerCache()
+    cachedAt = Date.now()
+  }
+}
+
+client.on('ledgerClosed', invalidateLedgerCache)
+
 function generateRandomDestinationTag(): UInt32 {
   return Math.floor(Math.random() * 4294967295)
 }
 
-async function serverStateRPC(): Promise<BaseResponse> {
+async function serverStateRPC(
+  requester: LedgerRequester = client
+): Promise<BaseResponse> {
   const request = {
     command: 'server_state',
   }
-  return await client.request(request)
+  return await requester.request(request)
+}
+
+async function getServerState(
+  requester: LedgerRequester = client
+): Promise<ServerStateCacheEntry> {
+  expireLedgerCache()
+  if (!serverStateCache) {
+    const pending = serverStateRPC(requester).then(({ result }) => {
+      const { reserve_base, reserve_inc, seq } = (
+        result as ServerStateRPCResult
+      ).state.validated_ledger
+      return {
+        reserves: {
+          accountReserveFee: reserve_base,
+          ownerReserveFee: reserve_inc,
+        },
+        validatedLedgerIndex: seq,
+      }
+    })
+    pending.catch(() => {
+      if (serverStateCache === pending) {
+        serverStateCache = undefined
+      }
+    })
+    serverStateCache = pending
+  }
+  return serverStateCache
+}
+
+async function getReserves(): Promise<Reserves> {
+  return (await getServerState()).reserves
 }
 
 async function accountReserveFee(): Promise<number> {
-  const { result } = await serverStateRPC()
-  return (result as ServerStateRPCResult).state.validated_ledger?.reserve_base
+  return (await getReserves()).accountReserveFee
 }
 
 async function ownerReserveFee(): Promise<number> {
-  const { result } = await serverStateRPC()
-  return (result as ServerStateRPCResult).state.validated_ledger?.reserve_inc
+  return (await getReserves()).ownerReserveFee
 }
 
-async function feeRPC(tx_blob: string): Promise<BaseResponse> {
+async function feeRPC(
+  tx_blob: string,
+  requester: LedgerRequester = client
+): Promise<BaseResponse> {
   const request = {
     command: 'fee',
     tx_blob,
   }
-  return await client.request(request)
+  return await requester.request(request)
 }
 
-async function getTransactionFee(transaction: Transaction): Promise<string> {
-  const copyTx = JSON.parse(JSON.stringify(transaction))
-  copyTx.Fee = `0`
-  copyTx.SigningPubKey = ``
-
-  const preparedTx = await client.autofill(copyTx)
-
-  const tx_blob = encode(preparedTx)
-
-  const { result } = await feeRPC(tx_blob)
-
-  return (result as FeeRPCResult).drops.base_fee
+async function getTransactionFee(
+  transaction: Transaction,
+  requester: LedgerRequester = client
+): Promise<string> {
+  // Fee and Sequence don't change the blob size or the fee, so placeholders avoid an autofill
+  const tx_blob = encode({
+    ...transaction,
+    Fee: '0',
+    Sequence: transaction.Sequence ?? 0,
+    SigningPubKey: '',
+  })
+
+  const { Destination } = transaction as { Destination?: string }
+  const key = `${transaction.TransactionType}:${Destination ?? ''}:${
+    tx_blob.length
+  }`
+
+  expireLedgerCache()
+  let fee = feeCache.get(key)
+  if (!fee) {
+    fee = feeRPC(tx_blob, requester).then(
+      ({ result }) => (result as FeeRPCResult).drops.base_fee
+    )
+    const pending = fee
+    feeCache.set(key, pending)
+    pending.catch(() => {
+      if (feeCache.get(key) === pending) {
+        feeCache.delete(key)
+      }
+    })
+  }
+  return fee
 }
 
-async function prepareTransactionV3(transaction: Transaction) {
+async function prepareTransactionV3(
+  transaction: Transaction,
+  requester: LedgerRequester = client
+) {
   // @ts-expect-error -- necessary to submit transactions on Hooks Testnet v3
-  transaction.NetworkID = 21338
-  transaction.Fee = await getTransactionFee(transaction)
+  transaction.NetworkID = NETWORK_ID
+  const [fee, { validatedLedgerIndex }] = await Promise.all([
+    getTransactionFee(transaction, requester),
+    getServerState(requester),
+  ])
+  transaction.Fee = fee
+  // Set here so autofill doesn't need a ledger request for it
+  if (transaction.LastLedgerSequence === undefined) {
+    transaction.LastLedgerSequence =
+      validatedLedgerIndex + LAST_LEDGER_SEQUENCE_OFFSET
+  }
+}
+
+// Drops cached fees when a submission says the fee was too low
+function reportEngineResult(engineResult: string | undefined): void {
+  if (engineResult && FEE_FEEDBACK_ENGINE_RESULTS.includes(engineResult)) {
+    invalidateLedgerCache()
+  }
 }
 
 function deriveHookNamespace(hookNamespaceSeed: string): string {
@@ -78,7 +205,11 @@ export {
   accountReserveFee,
   deriveHookNamespace,
   generateRandomDestinationTag,
+  getReserves,
+  getTransactionFee,
+  invalidateLedgerCache,
   ownerReserveFee,
   prepareTransactionV3,
+  reportEngineResult,
   serverStateRPC,
 }
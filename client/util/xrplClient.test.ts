@@ -1,4 +1,9 @@
-import { client, connectClient, disconnectClient } from './xrplClient'
+import {
+  client,
+  connectClient,
+  connectWithRetry,
+  disconnectClient,
+} from './xrplClient'
 
 describe('xrplClient', () => {
   it('connect/disconnect client', async () => {
@@ -8,4 +13,38 @@ describe('xrplClient', () => {
     await disconnectClient()
     expect(client.isConnected()).toBe(false)
   })
+
+  describe('connectWithRetry', () => {
+    // Fails the first `failures` connects
+    const createClient = (failures: number) => {
+      const fakeClient = {
+        url: 'wss://unreachable.test',
+        connects: 0,
+        connect: async () => {
+          fakeClient.connects++
+          if (fakeClient.connects <= failures) {
+            throw new Error('connect ECONNREFUSED')
+          }
+        },
+      }
+      return fakeClient
+    }
+
+    it('should retry until the client connects', async () => {
+      const fakeClient = createClient(2)
+
+      await connectWithRetry(fakeClient, 3, 1, 2)
+
+      expect(fakeClient.connects).toBe(3)
+    })
+
+    it('should throw the last error once every attempt has failed', async () => {
+      const fakeClient = createClient(3)
+
+      await expect(connectWithRetry(fakeClient, 3, 1, 2)).rejects.toThrow(
+        'connect ECONNREFUSED'
+      )
+      expect(fakeClient.connects).toBe(3)
+    })
+  })
 })
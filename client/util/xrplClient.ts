@@ -1,10 +1,52 @@
 import { Client } from 'xrpl'
 
-const client = new Client(`wss://hooks-testnet-v3.xrpl-labs.com`)
+// Comma separated XRPL endpoints; the client (subscriptions and submits) uses the first one
+const XRPL_ENDPOINTS = (
+  process.env.XRPL_ENDPOINTS || 'wss://hooks-testnet-v3.xrpl-labs.com'
+)
+  .split(',')
+  .map((url) => url.trim())
+  .filter((url) => url.length > 0)
+
+// Same backoff as XrplConnectionPool's reconnects
+const CONNECT_ATTEMPTS = 6
+const CONNECT_RETRY_MIN_DELAY_MS = 1000
+const CONNECT_RETRY_MAX_DELAY_MS = 30000
+
+const client = new Client(XRPL_ENDPOINTS[0])
+
+/**
+ * Connects xrplClient, retrying failed attempts after a delay that doubles from minDelayMs up to
+ * maxDelayMs. Throws the last error once all attempts have failed. Once connected, Client
+ * reconnects on its own after an unexpected close.
+ */
+async function connectWithRetry(
+  xrplClient: Pick<Client, 'connect' | 'url'>,
+  attempts = CONNECT_ATTEMPTS,
+  minDelayMs = CONNECT_RETRY_MIN_DELAY_MS,
+  maxDelayMs = CONNECT_RETRY_MAX_DELAY_MS
+): Promise<void> {
+  let delayMs = minDelayMs
+  for (let attempt = 1; ; attempt++) {
+    try {
+      await xrplClient.connect()
+      return
+    } catch (error) {
+      if (attempt >= attempts) {
+        throw error
+      }
+      console.error(
+        `Failed to connect ${xrplClient.url} (attempt ${attempt} of ${attempts}), retrying in ${delayMs}ms: ${error}`
+      )
+      await new Promise((resolve) => setTimeout(resolve, delayMs))
+      delayMs = Math.min(delayMs * 2, maxDelayMs)
+    }
+  }
+}
 
 async function connectClient(): Promise<void> {
   // console.log('\nclient connecting...')
-  await client.connect()
+  await connectWithRetry(client)
   // console.log('client connected!\n')
 }
 
@@ -14,4 +56,10 @@ async function disconnectClient() {
   // console.log('client connected!')
 }
 
-export { client, connectClient, disconnectClient }
+export {
+  XRPL_ENDPOINTS,
+  client,
+  connectClient,
+  connectWithRetry,
+  disconnectClient,
+}
@@ -0,0 +1,949 @@
+/**
+ * This hook accepts Payment and Invoke transactions coming through it:
+ * Payment => Create Campaign, Fund Campaign, Multi Fund Campaign
+ * Invoke => Vote Reject/Approve Milestone, Request Refund Payment, Request Milestone Payout Payment, Migrate Hook State
+ *
+ * Both transaction types share the parsing & validation steps in crowdfund_core.h.
+ * Define CROWDFUND_DEV_MODE before including this file (see crowdfund_dev.c) to also accept the MODE_DEV_* flags,
+ * which carry a mock current time in their payload.
+ */
+#include <stdbool.h>
+#include "hookapi.h"
+#include "crowdfund.h"
+#include "crowdfund_core.h"
+
+#ifdef CROWDFUND_DEV_MODE
+#define CROWDFUND_HOOK_NAME "Crowdfund Hook (Develop Mode)"
+#define IS_DEV_PAYMENT_MODE_FLAG(mode_flag) ((mode_flag) == MODE_DEV_CREATE_CAMPAIGN_FLAG || (mode_flag) == MODE_DEV_FUND_CAMPAIGN_FLAG)
+#define IS_DEV_INVOKE_MODE_FLAG(mode_flag) ((mode_flag) == MODE_DEV_VOTE_REJECT_MILESTONE_FLAG || (mode_flag) == MODE_DEV_VOTE_APPROVE_MILESTONE_FLAG)
+#define BLOB_MAX_BYTES 15 // 1 byte prefix + 8 bytes mockCurrentTimeInUnixSeconds + 6 bytes max blob length
+#else
+#define CROWDFUND_HOOK_NAME "Crowdfund Hook"
+#define IS_DEV_PAYMENT_MODE_FLAG(mode_flag) 0
+#define IS_DEV_INVOKE_MODE_FLAG(mode_flag) 0
+#define BLOB_MAX_BYTES 7 // 1 byte prefix + 6 bytes max blob length
+#endif
+
+static inline int64_t create_campaign(uint8_t* payload_ptr, uint64_t current_time_unix_seconds) {
+    /***** Validate/Parse Fields Steps *****/
+    /* Step 1. Amount - Check if Amount is at least the minimum deposit for creating a campaign */
+    // NOTE: Amounts can be 384 bits or 64 bits. If Amount is an XRP value it will be 64 bits.
+    //       Amount should always be XRP for this hook.
+    uint8_t amount_buffer[8];
+    otxn_field(SBUF(amount_buffer), sfAmount);
+    int64_t otxn_drops = AMOUNT_TO_DROPS(amount_buffer);
+    TRACEVAR(otxn_drops);
+    if (otxn_drops < CREATE_CAMPAIGN_DEPOSIT_IN_DROPS) {
+        rollback(SBUF("Amount must be at least the create campaign deposit 100 XRP"), 400);
+    }
+
+    /* Step 2. DestinationTag - Check if destinationTag isn't already used by another campaign */
+    uint8_t destination_tag_buffer[4];
+    read_otxn_destination_tag(destination_tag_buffer);
+
+    uint8_t hook_state_key[HOOK_STATE_KEY_BYTES];
+    uint8_t hook_state_lookup_buffer[HOOK_STATE_VALUE_MAX_BYTES];
+    if (lookup_general_info(destination_tag_buffer, hook_state_key, hook_state_lookup_buffer) > 0) {
+        rollback(SBUF("destination_tag already in use for another campaign. Use a different one."), 400);
+    }
+
+    /* Step 3. Sender Account - Get Sender Account as Campaign Owner */
+    uint8_t sender_account_buffer[ACCOUNT_ID_BYTES];
+    uint8_t owner_raddress[XRP_ADDRESS_MAX_BYTES];
+    uint8_t owner_raddress_len = read_otxn_account_raddress(sender_account_buffer, owner_raddress);
+
+    /* Step 4. fundRaiseGoalInDrops */
+    uint64_t fund_raise_goal_in_drops = UINT64_FROM_BUF(payload_ptr);
+    TRACEVAR(fund_raise_goal_in_drops);
+    payload_ptr += 8;
+
+    /* Step 5. fundRaiseEndDateInUnixSeconds */
+    uint64_t fund_raise_end_date_in_unix_seconds = UINT64_FROM_BUF(payload_ptr);
+    TRACEVAR(fund_raise_end_date_in_unix_seconds);
+    payload_ptr += 8;
+    TRACEVAR(current_time_unix_seconds);
+    if (fund_raise_end_date_in_unix_seconds <= current_time_unix_seconds) {
+        rollback(SBUF("Fund raise end date must be in the future."), 400);
+    }
+
+    /* Step 6. milestones */
+    uint8_t milestones_len = *payload_ptr++;
+    uint8_t* milestones = payload_ptr;
+    TRACEVAR(milestones_len);
+    if (milestones_len < 1 || milestones_len > MILESTONES_MAX_LENGTH) {
+        rollback(SBUF("Milestones length must be between 1 and 10"), 49);
+    }
+
+    uint8_t* milestone_iterator = milestones;
+    uint64_t prev_milestone_end_date_in_unix_seconds = 0;
+    uint8_t total_payout_percent = 0;
+    for (int i = 0; GUARD(MILESTONES_MAX_LENGTH), i < milestones_len; i++) {
+        /* Step 6.1. milestone.endDateInUnixSeconds */
+        uint64_t milestone_end_date_in_unix_seconds = UINT64_FROM_BUF(milestone_iterator);
+        milestone_iterator += 8;
+        TRACEVAR(milestone_end_date_in_unix_seconds);
+        if (milestone_end_date_in_unix_seconds <= current_time_unix_seconds) {
+            rollback(SBUF("Milestone end date must be in the future."), 400);
+        }
+
+        if (milestone_end_date_in_unix_seconds < prev_milestone_end_date_in_unix_seconds) {
+            rollback(SBUF("Milestone end date must be in ascending order."), 400);
+        }
+        prev_milestone_end_date_in_unix_seconds = milestone_end_date_in_unix_seconds;
+
+        /* Step 6.2. milestone.payoutPercent */
+        uint8_t milestone_payout_percent = *milestone_iterator++;
+        TRACEVAR(milestone_payout_percent);
+        if (milestone_payout_percent < 1 || milestone_payout_percent > 100) {
+            rollback(SBUF("Milestone payout percent must be between 1 and 100"), 49);
+        }
+        total_payout_percent += milestone_payout_percent;
+    }
+
+    if (total_payout_percent != 100) {
+        rollback(SBUF("Total payout percents must sum to 100"), 49);
+    }
+
+    /***** Write Campaign General Info to Hook State Steps *****/
+    /* Step 1. Initialize General Info Buffer */
+    int general_info_index = 0;
+    uint8_t general_info_buffer[GENERAL_INFO_V1_BYTES];
+
+    /* Step 2. Write Campaign State to General Info Buffer */
+    general_info_buffer[general_info_index++] = CAMPAIGN_STATE_DERIVE_FLAG;
+
+    /* Step 3. Write Campaign Owner to General Info Buffer */
+    general_info_buffer[general_info_index++] = owner_raddress_len;
+    COPY_XRP_ADDRESS(general_info_buffer + general_info_index, owner_raddress);
+    general_info_index += XRP_ADDRESS_MAX_BYTES;
+
+    /* Step 4. Write fundRaiseGoalInDrops to General Info Buffer */
+    UINT64_TO_BUF(general_info_buffer + general_info_index, fund_raise_goal_in_drops);
+    general_info_index += 8;
+
+    /* Step 5. Write fundRaiseEndDateInUnixSeconds to General Info Buffer */
+    UINT64_TO_BUF(general_info_buffer + general_info_index, fund_raise_end_date_in_unix_seconds);
+    general_info_index += 8;
+
+    /* Step 6. Write zero totalAmountRaisedInDrops and totalAmountNonRefundableInDrops to General Info Buffer */
+    UINT64_TO_BUF(general_info_buffer + general_info_index, 0);
+    general_info_index += 8;
+    UINT64_TO_BUF(general_info_buffer + general_info_index, 0);
+    general_info_index += 8;
+
+    /* Step 7. Write totalReserveAmountInDrops to General Info Buffer */
+    UINT64_TO_BUF(general_info_buffer + general_info_index, otxn_drops);
+    general_info_index += 8;
+
+    /* Step 8. Write zero totalFundTransactions to General Info Buffer */
+    UINT32_TO_BUF(general_info_buffer + general_info_index, 0);
+    general_info_index += 4;
+
+    /* Step 9. Write zero totalRejectVotesForCurrentMilestone to General Info Buffer */
+    UINT32_TO_BUF(general_info_buffer + general_info_index, 0);
+    general_info_index += 4;
+
+    /* Step 10. Write milestones to General Info Buffer */
+    general_info_buffer[general_info_index++] = milestones_len;
+    uint8_t* milestones_iterator = milestones;
+    for (int i = 0; GUARD(MILESTONES_MAX_LENGTH), i < milestones_len; i++) {
+        /* Step 10.1. milestone.state */
+        general_info_buffer[general_info_index++] = MILESTONE_STATE_DERIVE_FLAG;
+
+        /* Step 10.2. milestone.endDateInUnixSeconds */
+        uint64_t milestone_end_date_in_unix_seconds = UINT64_FROM_BUF(milestones_iterator);
+        UINT64_TO_BUF(general_info_buffer + general_info_index, milestone_end_date_in_unix_seconds);
+        general_info_index += 8;
+        milestones_iterator += 8;
+
+        /* Step 10.3. milestone.payoutPercent */
+        uint8_t milestone_payout_percent = *milestones_iterator++;
+        general_info_buffer[general_info_index++] = milestone_payout_percent;
+    }
+
+    /* Step 11. Verify General Info Buffer was filled correctly */
+    uint8_t expected_general_info_bytes = GENERAL_INFO_MAX_BYTES - ((MILESTONES_MAX_LENGTH - milestones_len) * MILESTONE_BYTES);
+    if (general_info_index != expected_general_info_bytes) {
+        rollback(SBUF("general_info_buffer was not filled correctly."), 400);
+    }
+
+    /* Step 12. Write Layout Trailer to General Info Buffer; new campaigns start at the current layout version */
+    SET_GENERAL_INFO_LAYOUT_TRAILER(general_info_buffer, HOOK_STATE_LAYOUT_VERSION_CURRENT, 0);
+
+    /* Step 13. Write General Info Buffer to Hook State */
+    state_set_or_rollback(general_info_buffer, GENERAL_INFO_V1_BYTES, hook_state_key, SBUF("Failed to write general info to hook state."));
+
+    TRACESTR("Accept.c: Called.");
+    accept (0,0,0);
+    return 0;
+}
+
+static inline int64_t fund_campaign(uint64_t current_time_unix_seconds) {
+    /***** Validate/Parse Fields Steps *****/
+    /* Step 1. Amount - Check if Amount is more than the fund campaign deposit */
+    // NOTE: Amounts can be 384 bits or 64 bits. If Amount is an XRP value it will be 64 bits.
+    //       Amount should always be XRP for this hook.
+    uint8_t amount_buffer[8];
+    otxn_field(SBUF(amount_buffer), sfAmount);
+    int64_t otxn_drops = AMOUNT_TO_DROPS(amount_buffer);
+    TRACEVAR(otxn_drops);
+    if (otxn_drops <= FUND_CAMPAIGN_DEPOSIT_IN_DROPS) {
+        rollback(SBUF("Amount must be more than the fund campaign deposit 10 XRP"), 400);
+    }
+
+    /* Step 2. DestinationTag - Check if destinationTag exists for a campaign */
+    uint8_t destination_tag_buffer[4];
+    read_otxn_destination_tag(destination_tag_buffer);
+
+    uint8_t hook_state_general_info_key[HOOK_STATE_KEY_BYTES];
+    uint8_t general_info_buffer[HOOK_STATE_VALUE_MAX_BYTES];
+    int64_t general_info_len = require_general_info(destination_tag_buffer, hook_state_general_info_key, general_info_buffer);
+
+    /* Step 3. verify campaign is in fund raise state */
+    require_fund_raise_state(general_info_buffer, current_time_unix_seconds);
+
+    /* Step 4. Sender Account - Get Sender Account as Campaign Backer */
+    uint8_t sender_account_buffer[ACCOUNT_ID_BYTES];
+    uint8_t backer_raddress[XRP_ADDRESS_MAX_BYTES];
+    uint8_t backer_raddress_len = read_otxn_account_raddress(sender_account_buffer, backer_raddress);
+
+    /***** Write Fund Transaction to Hook State Steps *****/
+    int64_t fund_amount_without_deposit_fee_in_drops = otxn_drops - FUND_CAMPAIGN_DEPOSIT_IN_DROPS;
+    uint32_t fund_transaction_id = append_fund_transaction(
+        destination_tag_buffer,
+        general_info_buffer,
+        backer_raddress,
+        backer_raddress_len,
+        fund_amount_without_deposit_fee_in_drops
+    );
+
+    /***** Update Campaign General Info Hook State Steps *****/
+    // length is preserved so the layout trailer (if any) is kept
+    state_set_or_rollback(general_info_buffer, general_info_len, hook_state_general_info_key, SBUF("Failed to write general info to hook state."));
+
+    /***** Return Fund Transaction Id in transaction response *****/
+    uint8_t fund_transaction_id_buffer[4];
+    UINT32_TO_BUF(fund_transaction_id_buffer, fund_transaction_id);
+    trace(SBUF("fund_transaction_id_buffer"), fund_transaction_id_buffer, 4, 1);
+    TRACESTR("Accept.c: Called returning fund_transaction_id");
+    accept (SBUF(fund_transaction_id_buffer), 0);
+    return 0;
+}
+
+static inline int64_t multi_fund_campaign(uint8_t* payload_ptr, uint32_t payload_len, uint64_t current_time_unix_seconds) {
+    /***** Validate/Parse Fields Steps *****/
+    /* Step 1. Amount - Read the total Amount shared by every fund campaign entry */
+    // NOTE: Amounts can be 384 bits or 64 bits. If Amount is an XRP value it will be 64 bits.
+    //       Amount should always be XRP for this hook.
+    uint8_t amount_buffer[8];
+    otxn_field(SBUF(amount_buffer), sfAmount);
+    int64_t otxn_drops = AMOUNT_TO_DROPS(amount_buffer);
+    TRACEVAR(otxn_drops);
+
+    /* Step 2. fundCampaigns - Check entries length and payload size */
+    uint8_t fund_campaigns_len = *payload_ptr++;
+    uint8_t* fund_campaigns = payload_ptr;
+    TRACEVAR(fund_campaigns_len);
+    if (fund_campaigns_len < 1 || fund_campaigns_len > MULTI_FUND_CAMPAIGNS_MAX_LENGTH) {
+        rollback(SBUF("Fund campaigns length must be between 1 and 5"), 49);
+    }
+    if (payload_len < 2 + (fund_campaigns_len * MULTI_FUND_CAMPAIGN_ENTRY_BYTES)) { // +2 for the mode flag and length bytes
+        rollback(SBUF("Memo payload is too small for fund campaigns length."), 49);
+    }
+
+    /* Step 3. Check fund amounts sum to Amount minus one fund campaign deposit per entry */
+    int64_t expected_otxn_drops = 0;
+    uint8_t* fund_campaign_iterator = fund_campaigns;
+    for (int i = 0; GUARD(MULTI_FUND_CAMPAIGNS_MAX_LENGTH), i < fund_campaigns_len; i++) {
+        uint64_t fund_amount_in_drops = UINT64_FROM_BUF(fund_campaign_iterator + 4);
+        fund_campaign_iterator += MULTI_FUND_CAMPAIGN_ENTRY_BYTES;
+        TRACEVAR(fund_amount_in_drops);
+        if (fund_amount_in_drops == 0 || fund_amount_in_drops > otxn_drops) {
+            rollback(SBUF("Fund amount must be more than 0 and at most Amount."), 400);
+        }
+        expected_otxn_drops += fund_amount_in_drops + FUND_CAMPAIGN_DEPOSIT_IN_DROPS;
+    }
+
+    TRACEVAR(expected_otxn_drops);
+    if (otxn_drops != expected_otxn_drops) {
+        rollback(SBUF("Amount must equal the sum of fund amounts plus a fund campaign deposit 10 XRP per campaign."), 400);
+    }
+
+    /* Step 4. Sender Account - Get Sender Account as Campaign Backer */
+    uint8_t sender_account_buffer[ACCOUNT_ID_BYTES];
+    uint8_t backer_raddress[XRP_ADDRESS_MAX_BYTES];
+    uint8_t backer_raddress_len = read_otxn_account_raddress(sender_account_buffer, backer_raddress);
+
+    /***** Write Fund Transactions to Hook State Steps *****/
+    uint8_t fund_transaction_ids_buffer[MULTI_FUND_CAMPAIGNS_MAX_LENGTH * 4];
+    fund_campaign_iterator = fund_campaigns;
+    for (int i = 0; GUARD(MULTI_FUND_CAMPAIGNS_MAX_LENGTH), i < fund_campaigns_len; i++) {
+        /* Step 1. DestinationTag - Check if destinationTag exists for a campaign */
+        uint8_t* destination_tag_buffer = fund_campaign_iterator;
+        uint64_t fund_amount_in_drops = UINT64_FROM_BUF(fund_campaign_iterator + 4);
+        fund_campaign_iterator += MULTI_FUND_CAMPAIGN_ENTRY_BYTES;
+
+        uint8_t hook_state_general_info_key[HOOK_STATE_KEY_BYTES];
+        uint8_t general_info_buffer[HOOK_STATE_VALUE_MAX_BYTES];
+        int64_t general_info_len = require_general_info(destination_tag_buffer, hook_state_general_info_key, general_info_buffer);
+
+        /* Step 2. verify campaign is in fund raise state */
+        require_fund_raise_state(general_info_buffer, current_time_unix_seconds);
+
+        /* Step 3. Append Fund Transaction to the campaign's Fund Transactions page */
+        uint32_t fund_transaction_id = append_fund_transaction(
+            destination_tag_buffer,
+            general_info_buffer,
+            backer_raddress,
+            backer_raddress_len,
+            fund_amount_in_drops
+        );
+        UINT32_TO_BUF(fund_transaction_ids_buffer + (i * 4), fund_transaction_id);
+
+        /* Step 4. Update General Info Buffer to Hook State; length is preserved so the layout trailer (if any) is kept */
+        state_set_or_rollback(general_info_buffer, general_info_len, hook_state_general_info_key, SBUF("Failed to write general info to hook state."));
+    }
+
+    /***** Return Fund Transaction Ids (in payload order) in transaction response *****/
+    trace(SBUF("fund_transaction_ids_buffer"), fund_transaction_ids_buffer, fund_campaigns_len * 4, 1);
+    TRACESTR("Accept.c: Called returning fund_transaction_ids");
+    accept (fund_transaction_ids_buffer, fund_campaigns_len * 4, 0);
+    return 0;
+}
+
+static inline int64_t vote_milestone(uint8_t* blob_ptr, uint64_t current_time_unix_seconds, bool IS_VOTE_REJECT) {
+    /***** Validate/Parse Fields Steps *****/
+    /* Step 1. DestinationTag - Check if destinationTag exists for a campaign */
+    uint8_t destination_tag_buffer[4];
+    read_otxn_destination_tag(destination_tag_buffer);
+
+    uint8_t hook_state_general_info_key[HOOK_STATE_KEY_BYTES];
+    uint8_t general_info_buffer[HOOK_STATE_VALUE_MAX_BYTES];
+    int64_t general_info_len = require_general_info(destination_tag_buffer, hook_state_general_info_key, general_info_buffer);
+
+    /* Step 2. verify campaign is in a milestone state */
+    uint8_t campaign_state = general_info_buffer[GENERAL_INFO_STATE_INDEX];
+    if (campaign_state == CAMPAIGN_STATE_DERIVE_FLAG) {
+        uint64_t fund_raise_end_date_in_unix_seconds = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_FUND_RAISE_END_DATE_IN_UNIX_SECONDS_INDEX);
+        // get last milestone end date
+        uint8_t milestones_len = general_info_buffer[GENERAL_INFO_MILESTONES_INDEX];
+        uint64_t last_milestone_end_date_in_unix_seconds = UINT64_FROM_BUF(
+            general_info_buffer + GENERAL_INFO_MILESTONES_INDEX + 1 + ((milestones_len - 1) * MILESTONE_BYTES) + GENERAL_INFO_MILESTONE_END_DATE_IN_UNIX_SECONDS_INDEX_OFFSET
+        );
+        TRACEVAR(milestones_len);
+        TRACEVAR(last_milestone_end_date_in_unix_seconds);
+
+        if (current_time_unix_seconds < fund_raise_end_date_in_unix_seconds) {
+            rollback(SBUF("Campaign is currently in fund raise state. Votes can only be applied during a milestone state."), 400);
+        } else if (current_time_unix_seconds >= last_milestone_end_date_in_unix_seconds) {
+            rollback(SBUF("Campaign is currently in a closed state. Votes can only be applied during a milestone state."), 400);
+        }
+    } else if (campaign_state >= CAMPAIGN_STATE_FAILED_MILESTONE_1_FLAG && campaign_state <= CAMPAIGN_STATE_FAILED_MILESTONE_10_FLAG) {
+        rollback(SBUF("Campaign has already failed due to a rejected milestone."), 400);
+    } else {
+        rollback(SBUF("Campaign is in an unknown state; this shouldn't happen. Something went wrong when campaign state was last updated."), 400);
+    }
+
+    /* Step 3. Sender Account - Get Sender Account as Backer */
+    uint8_t backer_account_buffer[ACCOUNT_ID_BYTES];
+    uint8_t backer_raddress[XRP_ADDRESS_MAX_BYTES];
+    uint8_t backer_raddress_len = read_otxn_account_raddress(backer_account_buffer, backer_raddress);
+
+    /* Step 4. Fund Transaction ID */
+    uint32_t fund_transaction_id = UINT32_FROM_BUF(blob_ptr);
+    blob_ptr += 4;
+    TRACEVAR(fund_transaction_id);
+
+    /* Step 5. Check if Fund Transaction exists and belongs to Backer */
+    uint8_t hook_state_fund_transaction_page_key[HOOK_STATE_KEY_BYTES];
+    uint8_t fund_transaction_page_buffer[FUND_TRANSACTION_MAX_BYTES];
+    uint8_t fund_transaction_page_index;
+    int64_t fund_transaction_page_len = require_backer_fund_transaction(
+        fund_transaction_id,
+        destination_tag_buffer,
+        backer_raddress,
+        backer_raddress_len,
+        hook_state_fund_transaction_page_key,
+        fund_transaction_page_buffer,
+        &fund_transaction_page_index
+    );
+
+    /* Step 6. Check if Fund Transaction has already placed same vote */
+    const uint8_t VOTE_FLAG_UPDATE = IS_VOTE_REJECT ? FUND_TRANSACTION_STATE_REJECT_FLAG : FUND_TRANSACTION_STATE_APPROVE_FLAG;
+    uint8_t fund_transaction_state_flag = fund_transaction_page_buffer[fund_transaction_page_index + FUND_TRANSACTION_STATE_INDEX_OFFSET];
+    TRACEVAR(fund_transaction_state_flag);
+
+    if (fund_transaction_state_flag == VOTE_FLAG_UPDATE) {
+        rollback(SBUF("Fund Transaction has already placed same vote"), 400);
+    }
+
+    /***** Update Fund Transaction Hook State Steps *****/
+    /* Step 1. Change Fund Transaction state to updated vote */
+    fund_transaction_page_buffer[fund_transaction_page_index + FUND_TRANSACTION_STATE_INDEX_OFFSET] = VOTE_FLAG_UPDATE;
+
+    /* Step 2. Update Fund Transaction Hook State */
+    state_set_or_rollback(fund_transaction_page_buffer, fund_transaction_page_len, hook_state_fund_transaction_page_key, SBUF("Failed to update fund transaction hook state"));
+
+    /***** Update Campaign General Info Hook State Steps *****/
+    /* Step 1. Increment reject votes for General Info */
+    uint32_t total_reject_votes_for_current_milestone = UINT32_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_REJECT_VOTES_FOR_CURRENT_MILESTONE_INDEX);
+    total_reject_votes_for_current_milestone += IS_VOTE_REJECT ? 1 : -1;
+    TRACEVAR(total_reject_votes_for_current_milestone);
+
+    /* Step 2. Check if reject votes for General Info is greater than 50% (half) of total votes */
+    uint32_t total_votes_for_current_milestone = UINT32_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_FUND_TRANSACTIONS_INDEX);
+    uint32_t half_of_total_votes = total_votes_for_current_milestone / 2;
+    TRACEVAR(total_votes_for_current_milestone);
+    TRACEVAR(half_of_total_votes);
+
+    if (total_reject_votes_for_current_milestone > half_of_total_votes) {
+        TRACESTR("Campaign failed current milestone")
+
+        /* Step 2.1. Get current milestone and compute totalAmountNonRefundableInDrops */
+        uint64_t total_amount_non_refundable_in_drops = 0;
+        uint8_t* current_milestone_ptr;
+        uint8_t milestones_len = general_info_buffer[GENERAL_INFO_MILESTONES_INDEX];
+        uint8_t* milestones_ptr = general_info_buffer + 1 + GENERAL_INFO_MILESTONES_INDEX; // +1 to skip the prefix length byte
+        TRACEVAR(milestones_len);
+
+        for (int i = 0; GUARD(MILESTONES_MAX_LENGTH), i < milestones_len; i++) {
+            uint8_t* milestone_ptr = milestones_ptr + (i * MILESTONE_BYTES);
+            uint64_t milestone_end_date_in_unix_seconds = UINT64_FROM_BUF(milestone_ptr + GENERAL_INFO_MILESTONE_END_DATE_IN_UNIX_SECONDS_INDEX_OFFSET);
+            TRACEVAR(milestone_end_date_in_unix_seconds);
+
+            if (milestone_end_date_in_unix_seconds > current_time_unix_seconds) {
+                current_milestone_ptr = milestone_ptr;
+                /* Step 2.2. Change General Info state to failed milestone i + 1 */
+                general_info_buffer[GENERAL_INFO_STATE_INDEX] = i + 1; // TODO: create a macro to convert index to failed milestone (i+1) flag
+                break;
+            }
+
+            /* Step 2.2.1. Add milestone payout to totalAmountNonRefundableInDrops */
+            uint64_t total_amount_raised_in_drops = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_AMOUNT_RAISED_IN_DROPS_INDEX);
+            uint8_t milestone_payout_percent = milestone_ptr[GENERAL_INFO_MILESTONE_PAYOUT_PERCENT_INDEX_OFFSET];
+            TRACEVAR(total_amount_raised_in_drops);
+            TRACEVAR(milestone_payout_percent);
+
+            int64_t total_amount_raised_in_drops_float = UINT64_TO_FLOAT(total_amount_raised_in_drops);
+            int64_t milestone_payout_percent_float = float_set(-2, milestone_payout_percent); // Converts percent to its decimal form. For e.g. 25% = 0.25
+            int64_t milestone_payout_in_drops_float = float_multiply(total_amount_raised_in_drops_float, milestone_payout_percent_float);
+            TRACEXFL(total_amount_raised_in_drops_float);
+            TRACEXFL(milestone_payout_percent_float);
+            TRACEXFL(milestone_payout_in_drops_float);
+
+            uint64_t milestone_payout_in_drops = (uint64_t)float_int(milestone_payout_in_drops_float, 0, 0);
+            TRACEVAR(milestone_payout_in_drops);
+
+            total_amount_non_refundable_in_drops += milestone_payout_in_drops;
+        }
+
+        /* Step 2.3 Update General Info totalAmountNonRefundableInDrops */
+        UINT64_TO_BUF(general_info_buffer + GENERAL_INFO_TOTAL_AMOUNT_NON_REFUNDABLE_IN_DROPS_INDEX, total_amount_non_refundable_in_drops);
+
+        /* Step 2.4 Update General Info current milestone state to failed */
+        current_milestone_ptr[GENERAL_INFO_MILESTONE_STATE_INDEX_OFFSET] = MILESTONE_STATE_FAILED_FLAG;
+    }
+
+    /* Step 3. Update General Info reject votes */
+    UINT32_TO_BUF(general_info_buffer + GENERAL_INFO_TOTAL_REJECT_VOTES_FOR_CURRENT_MILESTONE_INDEX, total_reject_votes_for_current_milestone);
+
+    /* Step 4. Update General Info Hook State */
+    state_set_or_rollback(general_info_buffer, general_info_len, hook_state_general_info_key, SBUF("Failed to update general info hook state"));
+
+    TRACESTR("Accept.c: Called.");
+    accept (0,0,0);
+    return 0;
+}
+
+static inline int64_t request_refund_payment(uint8_t* blob_ptr) {
+    /***** Validate/Parse Fields Steps *****/
+    /* Step 1. DestinationTag - Check if destinationTag exists for a campaign */
+    uint8_t destination_tag_buffer[4];
+    uint32_t destination_tag = read_otxn_destination_tag(destination_tag_buffer);
+
+    uint8_t hook_state_general_info_key[HOOK_STATE_KEY_BYTES];
+    uint8_t general_info_buffer[HOOK_STATE_VALUE_MAX_BYTES];
+    require_general_info(destination_tag_buffer, hook_state_general_info_key, general_info_buffer);
+
+    /* Step 2. Check if campaign is in failed milestone state */
+    uint8_t campaign_state = general_info_buffer[GENERAL_INFO_STATE_INDEX];
+    if (campaign_state < CAMPAIGN_STATE_FAILED_MILESTONE_1_FLAG || campaign_state > CAMPAIGN_STATE_FAILED_MILESTONE_10_FLAG) {
+        rollback(SBUF("Campaign is not in failed milestone state."), 400);
+    }
+
+    /* Step 3. Sender Account - Get Sender Account as Backer */
+    uint8_t backer_account_buffer[ACCOUNT_ID_BYTES];
+    uint8_t backer_raddress[XRP_ADDRESS_MAX_BYTES];
+    uint8_t backer_raddress_len = read_otxn_account_raddress(backer_account_buffer, backer_raddress);
+
+    /* Step 4. Fund Transaction ID */
+    uint32_t fund_transaction_id = UINT32_FROM_BUF(blob_ptr);
+    blob_ptr += 4;
+    TRACEVAR(fund_transaction_id);
+
+    /* Step 5. Check if Fund Transaction exists and belongs to Backer */
+    uint8_t hook_state_fund_transaction_page_key[HOOK_STATE_KEY_BYTES];
+    uint8_t fund_transaction_page_buffer[FUND_TRANSACTION_MAX_BYTES];
+    uint8_t fund_transaction_page_index;
+    int64_t fund_transaction_page_len = require_backer_fund_transaction(
+        fund_transaction_id,
+        destination_tag_buffer,
+        backer_raddress,
+        backer_raddress_len,
+        hook_state_fund_transaction_page_key,
+        fund_transaction_page_buffer,
+        &fund_transaction_page_index
+    );
+
+    /* Step 6. Check if Fund Transaction has already been refunded */
+    uint8_t fund_transaction_state_flag = fund_transaction_page_buffer[fund_transaction_page_index + FUND_TRANSACTION_STATE_INDEX_OFFSET];
+    TRACEVAR(fund_transaction_state_flag);
+
+    if (fund_transaction_state_flag == FUND_TRANSACTION_STATE_REFUNDED_FLAG) {
+        rollback(SBUF("Fund Transaction has already been refunded"), 400);
+    }
+
+    /***** Emit Refund Payment Transaction to Backer *****/
+    /* Step 1. Before we start calling hook-api functions we should tell the hook how many tx we intend to create */
+    etxn_reserve(1); // we are going to emit 1 transaction
+
+    /* Step 2. Compute Refund Payment Amount */
+    uint64_t total_amount_raised_in_drops = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_AMOUNT_RAISED_IN_DROPS_INDEX);
+    uint64_t total_amount_non_refundable_in_drops = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_AMOUNT_NON_REFUNDABLE_IN_DROPS_INDEX);
+    uint64_t fund_transaction_amount_in_drops = UINT64_FROM_BUF(fund_transaction_page_buffer + fund_transaction_page_index + FUND_TRANSACTION_AMOUNT_IN_DROPS_INDEX_OFFSET);
+    uint64_t remaining_funds_in_drops = total_amount_raised_in_drops - total_amount_non_refundable_in_drops;
+    TRACEVAR(total_amount_raised_in_drops);
+    TRACEVAR(total_amount_non_refundable_in_drops);
+    TRACEVAR(fund_transaction_amount_in_drops);
+    TRACEVAR(remaining_funds_in_drops);
+
+    int64_t fund_transaction_amount_in_drops_float = UINT64_TO_FLOAT(fund_transaction_amount_in_drops);
+    int64_t total_amount_raised_in_drops_float = UINT64_TO_FLOAT(total_amount_raised_in_drops);
+    int64_t original_fund_percent_float = float_divide(fund_transaction_amount_in_drops_float, total_amount_raised_in_drops_float);
+    int64_t remaining_funds_in_drops_float = UINT64_TO_FLOAT(remaining_funds_in_drops);
+    int64_t refund_amount_in_drops_float = float_multiply(remaining_funds_in_drops_float, original_fund_percent_float);
+    uint64_t refund_amount_in_drops = (uint64_t)float_int(refund_amount_in_drops_float, 0, 0);
+    TRACEXFL(fund_transaction_amount_in_drops_float);
+    TRACEXFL(total_amount_raised_in_drops_float);
+    TRACEXFL(original_fund_percent_float);
+    TRACEXFL(remaining_funds_in_drops_float);
+    TRACEXFL(refund_amount_in_drops_float);
+    TRACEVAR(refund_amount_in_drops);
+
+    /* Step 3. Emit Refund Payment Transaction to Backer */
+    // Create a buffer to write the emitted transaction into
+    unsigned char tx[PREPARE_PAYMENT_SIMPLE_SIZE];
+
+    // We will use an XRP payment macro, this will populate the buffer with a serialized binary transaction
+    // Parameter list: ( buf_out, drops_amount, to_address, dest_tag, src_tag )
+    PREPARE_PAYMENT_SIMPLE(tx, refund_amount_in_drops, backer_account_buffer, 0, destination_tag);
+
+    // Emit the transaction
+    uint8_t emithash[32];
+    int64_t emit_result = emit(SBUF(emithash), SBUF(tx));
+    TRACEVAR(emit_result);
+
+    if (emit_result < 0) {
+        rollback(SBUF("Failed to emit refund payment transaction to backer"), 400);
+    }
+
+    /***** Update Fund Transaction State *****/
+    /* Step 1. Update Fund Transaction State */
+    fund_transaction_page_buffer[fund_transaction_page_index + FUND_TRANSACTION_STATE_INDEX_OFFSET] = FUND_TRANSACTION_STATE_REFUNDED_FLAG;
+
+    /* Step 2. Update Fund Transaction Hook State */
+    state_set_or_rollback(fund_transaction_page_buffer, fund_transaction_page_len, hook_state_fund_transaction_page_key, SBUF("Failed to update fund transaction hook state"));
+
+    /***** Return Refund Amount In Drops in transaction response *****/
+    uint8_t refund_amount_in_drops_buffer[8];
+    UINT64_TO_BUF(refund_amount_in_drops_buffer, refund_amount_in_drops);
+    trace(SBUF("refund_amount_in_drops_buffer"), refund_amount_in_drops_buffer, 8, 1);
+    TRACESTR("Accept.c: Called returning refund_amount_in_drops");
+    accept (SBUF(refund_amount_in_drops_buffer), 0);
+    return 0;
+}
+
+static inline int64_t request_milestone_payout_payment(uint8_t* blob_ptr, uint64_t current_time_unix_seconds) {
+    /***** Validate/Parse Fields Steps *****/
+    /* Step 1. DestinationTag - Check if destinationTag exists for a campaign */
+    uint8_t destination_tag_buffer[4];
+    uint32_t destination_tag = read_otxn_destination_tag(destination_tag_buffer);
+
+    uint8_t hook_state_general_info_key[HOOK_STATE_KEY_BYTES];
+    uint8_t general_info_buffer[HOOK_STATE_VALUE_MAX_BYTES];
+    int64_t general_info_len = require_general_info(destination_tag_buffer, hook_state_general_info_key, general_info_buffer);
+
+    /* Step 2. Sender Account - Get Sender Account as Owner */
+    uint8_t owner_account_buffer[ACCOUNT_ID_BYTES];
+    uint8_t owner_raddress[XRP_ADDRESS_MAX_BYTES];
+    read_otxn_account_raddress(owner_account_buffer, owner_raddress);
+
+    /* Step 3. Check if Owner matches General Info Owner */
+    uint8_t* general_info_owner_raddress = general_info_buffer + GENERAL_INFO_CAMPAIGN_OWNER_INDEX + 1; // +1 to skip length byte
+    trace(SBUF("general_info_owner_raddress:"), general_info_owner_raddress, 34, 0);
+    bool owner_matches = XRP_ADDRESS_EQUAL(owner_raddress, general_info_owner_raddress);
+    TRACEVAR(owner_matches);
+    if (!owner_matches) {
+        rollback(SBUF("Owner does not match campaign owner."), 400);
+    }
+
+    /* Step 4. Milestone Index */
+    uint8_t milestone_index = *blob_ptr;
+    blob_ptr += 1;
+    TRACEVAR(milestone_index);
+
+    if (milestone_index < 0 || milestone_index > MILESTONES_MAX_LENGTH - 1) {
+        rollback(SBUF("Invalid milestone index. Must be between 0 and 9"), 400);
+    }
+
+    /***** Validate Campaign Milestone State *****/
+    /* Step 1. Check if Milestone exists */
+    uint8_t milestones_len = general_info_buffer[GENERAL_INFO_MILESTONES_INDEX];
+    TRACEVAR(milestones_len);
+    if (milestone_index >= milestones_len) {
+        rollback(SBUF("Invalid milestone index. Milestone does not exist."), 400);
+    }
+
+    /* Step 2. Check if campaign fund goal is/was reached */
+    uint8_t campaign_state = general_info_buffer[GENERAL_INFO_STATE_INDEX];
+    if (campaign_state == CAMPAIGN_STATE_DERIVE_FLAG) {
+        uint64_t total_amount_raised_in_drops = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_AMOUNT_RAISED_IN_DROPS_INDEX);
+        uint64_t fund_goal_in_drops = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_FUND_RAISE_GOAL_IN_DROPS_INDEX);
+        TRACEVAR(total_amount_raised_in_drops);
+        TRACEVAR(fund_goal_in_drops);
+        if (total_amount_raised_in_drops < fund_goal_in_drops) {
+            rollback(SBUF("Campaign fund goal is/was not reached."), 400);
+        }
+    }
+
+    /* Step 3. Check if milestone hasn't failed by looking at campaign state */
+    if (campaign_state >= CAMPAIGN_STATE_FAILED_MILESTONE_1_FLAG && campaign_state <= CAMPAIGN_STATE_FAILED_MILESTONE_10_FLAG && milestone_index + 1 >= campaign_state) {
+        rollback(SBUF("Milestone has failed. Payout ineligible."), 400);
+    }
+
+    /* Step 4. Check if Milestone is completed */
+    uint8_t* milestone_ptr = general_info_buffer + GENERAL_INFO_MILESTONES_INDEX + 1 + (milestone_index * MILESTONE_BYTES);
+    uint64_t milestone_end_date_in_unix_seconds = UINT64_FROM_BUF(milestone_ptr + GENERAL_INFO_MILESTONE_END_DATE_IN_UNIX_SECONDS_INDEX_OFFSET);
+    if (current_time_unix_seconds < milestone_end_date_in_unix_seconds) {
+        rollback(SBUF("Milestone is not completed yet. Payout ineligible."), 400);
+    }
+
+    /* Step 5. Check if Milestone has already been paid out */
+    uint8_t milestone_state = milestone_ptr[GENERAL_INFO_MILESTONE_STATE_INDEX_OFFSET];
+    TRACEVAR(milestone_state);
+    if (milestone_state == MILESTONE_STATE_PAID_FLAG) {
+        rollback(SBUF("Milestone has already been paid out."), 400);
+    }
+
+    /***** Emit Milestone Payout Payment Transaction to Owner *****/
+    /* Step 1. Before we start calling hook-api functions we should tell the hook how many tx we intend to create */
+    etxn_reserve(1); // we are going to emit 1 transaction
+
+    /* Step 2. Compute Milestone Payout Payment Amount */
+    uint64_t total_amount_raised_in_drops = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_AMOUNT_RAISED_IN_DROPS_INDEX);
+    uint8_t payout_percent = milestone_ptr[GENERAL_INFO_MILESTONE_PAYOUT_PERCENT_INDEX_OFFSET];
+    TRACEVAR(total_amount_raised_in_drops);
+    TRACEVAR(payout_percent);
+
+    int64_t total_amount_raised_in_drops_float = UINT64_TO_FLOAT(total_amount_raised_in_drops);
+    int64_t payout_percent_float = float_set(-2, payout_percent);
+    int64_t payout_amount_in_drops_float = float_multiply(total_amount_raised_in_drops_float, payout_percent_float);
+    uint64_t payout_amount_in_drops = (uint64_t)float_int(payout_amount_in_drops_float, 0, 0);
+    TRACEXFL(total_amount_raised_in_drops_float);
+    TRACEXFL(payout_percent_float);
+    TRACEXFL(payout_amount_in_drops_float);
+    TRACEVAR(payout_amount_in_drops);
+
+    /* Step 3. Emit Milestone Payout Payment Transaction to Owner */
+    // Create a buffer to write the emitted transaction into
+    unsigned char tx[PREPARE_PAYMENT_SIMPLE_SIZE];
+
+    // We will use an XRP payment macro, this will populate the buffer with a serialized binary transaction
+    // Parameter list: ( buf_out, drops_amount, to_address, dest_tag, src_tag )
+    PREPARE_PAYMENT_SIMPLE(tx, payout_amount_in_drops, owner_account_buffer, 0, destination_tag);
+
+    // Emit the transaction
+    uint8_t emithash[32];
+    int64_t emit_result = emit(SBUF(emithash), SBUF(tx));
+    TRACEVAR(emit_result);
+
+    if (emit_result < 0) {
+        rollback(SBUF("Failed to emit milestone payout payment transaction to owner"), 400);
+    }
+
+    /***** Update Milestone State *****/
+    /* Step 1. Update Milestone State */
+    milestone_ptr[GENERAL_INFO_MILESTONE_STATE_INDEX_OFFSET] = MILESTONE_STATE_PAID_FLAG;
+
+    /* Step 2. Update Milestone Hook State */
+    state_set_or_rollback(general_info_buffer, general_info_len, hook_state_general_info_key, SBUF("Failed to update milestone hook state"));
+
+    /***** Return Milestone Payout Amount In Drops in transaction response *****/
+    uint8_t payout_amount_in_drops_buffer[8];
+    UINT64_TO_BUF(payout_amount_in_drops_buffer, payout_amount_in_drops);
+    trace(SBUF("payout_amount_in_drops_buffer"), payout_amount_in_drops_buffer, 8, 1);
+    TRACESTR("Accept.c: Called returning payout_amount_in_drops");
+    accept (SBUF(payout_amount_in_drops_buffer), 0);
+    return 0;
+}
+
+/*
+ * Layout version 1 differs from version 0 in two ways: General Info carries the layout trailer, and Fund Transactions pages
+ * are stored with only their used bytes. Legacy writers stored pages as the full FUND_TRANSACTION_MAX_BYTES buffer, which
+ * only leaves unused bytes in a partially filled page, so pages already stored at their used length are read but not rewritten.
+ */
+static inline int64_t migrate_hook_state() {
+    /***** Validate/Parse Fields Steps *****/
+    /* Step 1. Sender Account - Only the Hook Account may migrate its own Hook State */
+    require_otxn_from_hook_account();
+
+    /* Step 2. DestinationTag - Check if destinationTag exists for a campaign */
+    uint8_t destination_tag_buffer[4];
+    read_otxn_destination_tag(destination_tag_buffer);
+
+    uint8_t hook_state_general_info_key[HOOK_STATE_KEY_BYTES];
+    uint8_t general_info_buffer[HOOK_STATE_VALUE_MAX_BYTES];
+    int64_t general_info_len = require_general_info(destination_tag_buffer, hook_state_general_info_key, general_info_buffer);
+
+    /* Step 3. Get campaign layout version and migration cursor */
+    uint8_t layout_version = GET_GENERAL_INFO_LAYOUT_VERSION(general_info_buffer, general_info_len);
+    uint32_t migration_cursor = GET_GENERAL_INFO_MIGRATION_CURSOR(general_info_buffer, general_info_len);
+    TRACEVAR(layout_version);
+    TRACEVAR(migration_cursor);
+
+    /***** Migrate Fund Transaction Pages Steps *****/
+    if (layout_version < HOOK_STATE_LAYOUT_VERSION_CURRENT) {
+        /* Step 1. Compute the batch of pages to migrate in this transaction */
+        uint32_t total_fund_transactions = UINT32_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_FUND_TRANSACTIONS_INDEX);
+        uint32_t total_fund_transaction_pages = (total_fund_transactions + HOOK_STATE_FUND_TRANSACTIONS_PAGE_SIZE - 1) / HOOK_STATE_FUND_TRANSACTIONS_PAGE_SIZE;
+        uint32_t migration_batch_end = migration_cursor + HOOK_STATE_MIGRATION_BATCH_PAGES;
+        if (migration_batch_end > total_fund_transaction_pages) {
+            migration_batch_end = total_fund_transaction_pages;
+        }
+        TRACEVAR(total_fund_transaction_pages);
+        TRACEVAR(migration_batch_end);
+
+        /* Step 2. Rewrite the pages of the batch that still carry unused bytes */
+        for (uint32_t page_index = migration_cursor; GUARD(HOOK_STATE_MIGRATION_BATCH_PAGES), page_index < migration_batch_end; page_index++) {
+            uint8_t fund_transaction_data_lookup_flag[DATA_LOOKUP_FLAG_BYTES];
+            GET_DATA_LOOKUP_PAGE_FLAG_USING_PAGE_INDEX(page_index, fund_transaction_data_lookup_flag);
+
+            uint8_t hook_state_fund_transaction_page_key[HOOK_STATE_KEY_BYTES];
+            GET_HOOK_STATE_KEY(fund_transaction_data_lookup_flag, destination_tag_buffer, hook_state_fund_transaction_page_key);
+
+            uint8_t fund_transaction_page_buffer[FUND_TRANSACTION_MAX_BYTES];
+            int64_t fund_transaction_page_len = state(SBUF(fund_transaction_page_buffer), SBUF(hook_state_fund_transaction_page_key));
+            if (fund_transaction_page_len < 0) {
+                rollback(SBUF("Failed to read fund transaction page from hook state."), 400);
+            }
+
+            uint8_t fund_transactions_in_page = fund_transaction_page_buffer[0];
+            if (fund_transactions_in_page < 1 || fund_transactions_in_page > HOOK_STATE_FUND_TRANSACTIONS_PAGE_SIZE) {
+                rollback(SBUF("Fund transaction page has an invalid prefix length."), 400);
+            }
+
+            // Version 0 -> 1: pages are stored with only their used bytes
+            uint32_t fund_transaction_page_used_bytes = GET_FUND_TRANSACTIONS_PAGE_BYTES(fund_transaction_page_buffer);
+            if (fund_transaction_page_len > fund_transaction_page_used_bytes) {
+                state_set_or_rollback(
+                    fund_transaction_page_buffer,
+                    fund_transaction_page_used_bytes,
+                    hook_state_fund_transaction_page_key,
+                    SBUF("Failed to migrate fund transaction page hook state.")
+                );
+            }
+        }
+
+        /* Step 3. Advance the migration cursor, or bump the layout version once every page is migrated */
+        if (migration_batch_end < total_fund_transaction_pages) {
+            migration_cursor = migration_batch_end;
+        } else {
+            layout_version = HOOK_STATE_LAYOUT_VERSION_CURRENT;
+            migration_cursor = 0;
+        }
+        SET_GENERAL_INFO_LAYOUT_TRAILER(general_info_buffer, layout_version, migration_cursor);
+
+        /* Step 4. Update General Info Hook State */
+        state_set_or_rollback(general_info_buffer, GENERAL_INFO_V1_BYTES, hook_state_general_info_key, SBUF("Failed to update general info hook state"));
+    }
+
+    /***** Return Layout Version and Migration Cursor in transaction response *****/
+    uint8_t migration_status_buffer[5];
+    migration_status_buffer[0] = layout_version;
+    UINT32_TO_BUF(migration_status_buffer + 1, migration_cursor);
+    trace(SBUF("migration_status_buffer"), migration_status_buffer, 5, 1);
+    TRACESTR("Accept.c: Called returning migration_status");
+    accept (SBUF(migration_status_buffer), 0);
+    return 0;
+}
+
+static inline int64_t payment_hook() {
+    // check for the presence of a memo
+    uint8_t memos[2048];
+    int64_t memos_len = otxn_field(SBUF(memos), sfMemos);
+
+    // the memos are presented in an array object, which we must index into
+    int64_t memo_lookup = sto_subarray(memos, memos_len, 0);
+
+    TRACEVAR(memo_lookup);
+    if (memo_lookup < 0)
+        rollback(SBUF("Memo transaction did not contain correct format."), 49);
+
+    // if the subfield/array lookup is successful we must extract the two pieces of returned data
+    // which are, respectively, the offset at which the field occurs and the field's length
+    uint8_t*  memo_ptr = SUB_OFFSET(memo_lookup) + memos;
+    uint32_t  memo_len = SUB_LENGTH(memo_lookup);
+
+    trace(SBUF("Memo: "), memo_ptr, memo_len, 1);
+
+    // memos are nested inside an actual memo object, so we need to subfield
+    // equivalently in JSON this would look like memo_array[i]["Memo"]
+    memo_lookup = sto_subfield(memo_ptr, memo_len, sfMemo);
+    memo_ptr = SUB_OFFSET(memo_lookup) + memo_ptr;
+    memo_len = SUB_LENGTH(memo_lookup);
+
+    // now we lookup the subfields of the memo itself
+    // again, equivalently this would look like memo_array[i]["Memo"]["MemoData"], ... etc.
+    int64_t data_lookup = sto_subfield(memo_ptr, memo_len, sfMemoData);
+    int64_t format_lookup = sto_subfield(memo_ptr, memo_len, sfMemoFormat);
+
+    TRACEVAR(data_lookup);
+    TRACEVAR(format_lookup);
+
+    // if any of these lookups fail the request is malformed
+    if (data_lookup < 0 || format_lookup < 0)
+        rollback(SBUF("Memo transaction did not contain correct memo format."), 54);
+
+    // care must be taken to add the correct pointer to an offset returned by sub_array or sub_field
+    // since we are working relative to the specific memo we must add memo_ptr, NOT memos or something else
+    uint8_t* payload_ptr = SUB_OFFSET(data_lookup) + memo_ptr;
+    uint32_t payload_len = SUB_LENGTH(data_lookup);
+
+    /*
+     * First byte indicates transaction mode flag:
+     * 0x00 => Create Campaign Mode
+     * 0x01 => Fund Campaign Mode
+     * 0x0B => Multi Fund Campaign Mode
+     */
+    uint8_t mode_flag = *payload_ptr++;
+    TRACEVAR(mode_flag);
+
+    const int IS_DEV_MODE = IS_DEV_PAYMENT_MODE_FLAG(mode_flag);
+    TRACEVAR(IS_DEV_MODE);
+    uint64_t current_time_unix_seconds;
+    if (IS_DEV_MODE) {
+        current_time_unix_seconds = UINT64_FROM_BUF(payload_ptr);
+        payload_ptr += 8;
+    } else {
+        current_time_unix_seconds = GET_LAST_LEDGER_TIME_IN_UNIX_SECONDS();
+    }
+
+    if (mode_flag == MODE_CREATE_CAMPAIGN_FLAG || (IS_DEV_MODE && mode_flag == MODE_DEV_CREATE_CAMPAIGN_FLAG)) {
+        if (IS_DEV_MODE) {
+            TRACESTR("Develop Mode: Create Campaign");
+        } else {
+            TRACESTR("Mode: Create Campaign");
+        }
+        return create_campaign(payload_ptr, current_time_unix_seconds);
+    } else if (mode_flag == MODE_FUND_CAMPAIGN_FLAG || (IS_DEV_MODE && mode_flag == MODE_DEV_FUND_CAMPAIGN_FLAG)) {
+        if (IS_DEV_MODE) {
+            TRACESTR("Develop Mode: Fund Campaign");
+        } else {
+            TRACESTR("Mode: Fund Campaign");
+        }
+        return fund_campaign(current_time_unix_seconds);
+    } else if (mode_flag == MODE_MULTI_FUND_CAMPAIGN_FLAG) {
+        TRACESTR("Mode: Multi Fund Campaign");
+        return multi_fund_campaign(payload_ptr, payload_len, current_time_unix_seconds);
+    }
+
+    rollback(SBUF("Invalid mode_flag"), 54);
+    return 0;
+}
+
+static inline int64_t invoke_hook() {
+    uint8_t blob_buffer[BLOB_MAX_BYTES];
+    int64_t blob_len = otxn_field(SBUF(blob_buffer), sfBlob);
+    uint8_t* blob_ptr = blob_buffer;
+    TRACEVAR(blob_len);
+
+    if (blob_len < 0) {
+        if (blob_len == TOO_SMALL) {
+            rollback(SBUF("Can't read blob buffer is too small"), 49);
+        } else {
+            rollback(SBUF("Can't read Blob from Invoke transaction"), 49);
+        }
+    }
+    trace(SBUF("blob (hex):"), blob_ptr, blob_len, 1);
+    blob_ptr += 1; // Skip over prefix length bytes: this will always be 1 byte for all transaction modes
+
+    uint8_t mode_flag = *blob_ptr++;
+    TRACEVAR(mode_flag);
+
+    const int IS_DEV_MODE = IS_DEV_INVOKE_MODE_FLAG(mode_flag);
+    TRACEVAR(IS_DEV_MODE);
+    uint64_t current_time_unix_seconds;
+    if (IS_DEV_MODE) {
+        current_time_unix_seconds = UINT64_FROM_BUF(blob_ptr);
+        blob_ptr += 8;
+    } else {
+        current_time_unix_seconds = GET_LAST_LEDGER_TIME_IN_UNIX_SECONDS();
+    }
+
+    if (
+        mode_flag == MODE_VOTE_REJECT_MILESTONE_FLAG ||
+        mode_flag == MODE_VOTE_APPROVE_MILESTONE_FLAG ||
+        (IS_DEV_MODE && mode_flag == MODE_DEV_VOTE_REJECT_MILESTONE_FLAG) ||
+        (IS_DEV_MODE && mode_flag == MODE_DEV_VOTE_APPROVE_MILESTONE_FLAG)
+    ) {
+        const bool IS_VOTE_REJECT =
+            mode_flag == MODE_VOTE_REJECT_MILESTONE_FLAG || mode_flag == MODE_DEV_VOTE_REJECT_MILESTONE_FLAG;
+        if (IS_VOTE_REJECT) {
+            if (IS_DEV_MODE) {
+                TRACESTR("Develop Mode: Vote Reject Milestone");
+            } else {
+                TRACESTR("Mode: Vote Reject Milestone");
+            }
+        } else {
+            if (IS_DEV_MODE) {
+                TRACESTR("Develop Mode: Vote Approve Milestone");
+            } else {
+                TRACESTR("Mode: Vote Approve Milestone");
+            }
+        }
+        return vote_milestone(blob_ptr, current_time_unix_seconds, IS_VOTE_REJECT);
+    } else if (mode_flag == MODE_REQUEST_REFUND_PAYMENT_FLAG) {
+        TRACESTR("Mode: Request Refund Payment");
+        return request_refund_payment(blob_ptr);
+    } else if (mode_flag == MODE_REQUEST_MILESTONE_PAYOUT_PAYMENT_FLAG) {
+        TRACESTR("Mode: Request Milestone Payout Payment");
+        return request_milestone_payout_payment(blob_ptr, current_time_unix_seconds);
+    } else if (mode_flag == MODE_MIGRATE_HOOK_STATE_FLAG) {
+        TRACESTR("Mode: Migrate Hook State");
+        return migrate_hook_state();
+    }
+
+    rollback(SBUF("Invalid mode flag"), 49);
+    return 0;
+}
+
+int64_t hook(uint32_t reserved) {
+    trace(SBUF(CROWDFUND_HOOK_NAME), 0, 0, 0);
+
+    int64_t tt = otxn_type();
+    TRACEVAR(tt);
+
+    if (tt == ttPAYMENT) {
+        payment_hook();
+    } else if (tt == ttINVOKE) {
+        invoke_hook();
+    } else {
+        rollback(SBUF("Transaction type must be Payment or Invoke. HookOn field is incorrectly set."), 50);
+    }
+
+    TRACESTR("Accept.c: Called.");
+    accept (0,0,0);
+    _g(1,1);   // every hook needs to import guard function and use it at least once
+    // unreachable
+    return 0;
+}
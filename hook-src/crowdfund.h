@@ -13,6 +13,12 @@
 #define MODE_DEV_VOTE_REJECT_MILESTONE_FLAG 0x08
 #define MODE_DEV_VOTE_APPROVE_MILESTONE_FLAG 0x09
 
+// Mode used to upgrade a campaign's Hook State entries to the current layout version
+#define MODE_MIGRATE_HOOK_STATE_FLAG 0x0A
+
+// Mode used to fund several campaigns with a single Payment
+#define MODE_MULTI_FUND_CAMPAIGN_FLAG 0x0B
+
 // Campaign state flags
 #define CAMPAIGN_STATE_DERIVE_FLAG 0x00
 #define CAMPAIGN_STATE_FAILED_MILESTONE_1_FLAG 0x01
@@ -41,6 +47,15 @@
 #define FUND_TRANSACTION_MAX_BYTES 246
 #define FUND_TRANSACTION_BYTES 49
 
+// Hook State layout versions
+#define HOOK_STATE_LAYOUT_VERSION_LEGACY 0x00
+#define HOOK_STATE_LAYOUT_VERSION_CURRENT 0x01
+
+// General Info layout trailer (layout version 1+): 4 bytes magic + 1 byte version + 4 bytes migration cursor
+#define GENERAL_INFO_LAYOUT_TRAILER_BYTES 9
+#define GENERAL_INFO_V1_BYTES 195
+#define GENERAL_INFO_LAYOUT_MAGIC 0x43464C56 // "CFLV"
+
 // General Info state index positions
 #define GENERAL_INFO_STATE_INDEX 0
 #define GENERAL_INFO_CAMPAIGN_OWNER_INDEX 1
@@ -55,6 +70,9 @@
 #define GENERAL_INFO_MILESTONE_STATE_INDEX_OFFSET 0
 #define GENERAL_INFO_MILESTONE_END_DATE_IN_UNIX_SECONDS_INDEX_OFFSET 1
 #define GENERAL_INFO_MILESTONE_PAYOUT_PERCENT_INDEX_OFFSET 9
+#define GENERAL_INFO_LAYOUT_MAGIC_INDEX 186
+#define GENERAL_INFO_LAYOUT_VERSION_INDEX 190
+#define GENERAL_INFO_MIGRATION_CURSOR_INDEX 191
 
 // Fund Transaction state index positions
 #define FUND_TRANSACTION_ID_INDEX_OFFSET 0
@@ -67,12 +85,18 @@
 
 // Payload validation
 #define XRP_ADDRESS_MAX_BYTES 35
+#define ACCOUNT_ID_BYTES 20
 #define MILESTONES_MAX_LENGTH 10
+#define MULTI_FUND_CAMPAIGNS_MAX_LENGTH 5
+#define MULTI_FUND_CAMPAIGN_ENTRY_BYTES 12 // 4 bytes destinationTag + 8 bytes fundAmountInDrops
 
+#define HOOK_STATE_KEY_BYTES 32
+#define HOOK_STATE_VALUE_MAX_BYTES 256
 #define HOOK_STATE_DESCRIPTION_MAX_FRAGMENTS 10
 #define HOOK_STATE_MILESTONES_PAGE_SIZE 2
 #define HOOK_STATE_MILESTONE_PAGE_SLOT_BYTES 85
 #define HOOK_STATE_FUND_TRANSACTIONS_PAGE_SIZE 5
+#define HOOK_STATE_MIGRATION_BATCH_PAGES 8
 
 #define DATA_LOOKUP_FLAG_BYTES 28
 #define DATA_LOOKUP_GENERAL_INFO_FLAG ((uint8_t[DATA_LOOKUP_FLAG_BYTES]){ \
@@ -133,6 +157,41 @@
     ADD_UINT32_TO_ARRS_28(DATA_LOOKUP_FUND_TRANSACTIONS_PAGE_START_INDEX_FLAG, page_index, result_data_lookup_page_flag); \
 }
 
+// Loop-free variant used inside guarded loops where ADD_UINT32_TO_ARRS_28 would exceed its guard
+#define GET_DATA_LOOKUP_PAGE_FLAG_USING_PAGE_INDEX(page_index, result_data_lookup_page_flag) { \
+    UINT64_TO_BUF((result_data_lookup_page_flag), 0); \
+    UINT64_TO_BUF((result_data_lookup_page_flag) + 8, 0); \
+    UINT32_TO_BUF((result_data_lookup_page_flag) + 16, 0); \
+    UINT64_TO_BUF((result_data_lookup_page_flag) + 20, ((uint64_t)(page_index)) + 1); \
+}
+
+// Number of bytes used by a Fund Transactions page: 1 byte prefix length + fund transactions
+#define GET_FUND_TRANSACTIONS_PAGE_BYTES(fund_transaction_page_buffer) \
+    (1 + ((fund_transaction_page_buffer)[0] * FUND_TRANSACTION_BYTES))
+
+// Legacy (version 0) General Info entries have no trailer; a trailer with version 0 means a migration is in progress
+#define HAS_GENERAL_INFO_LAYOUT_TRAILER(general_info_buffer, general_info_len) \
+    ( \
+        ((general_info_len) >= GENERAL_INFO_V1_BYTES) && \
+        (UINT32_FROM_BUF((general_info_buffer) + GENERAL_INFO_LAYOUT_MAGIC_INDEX) == GENERAL_INFO_LAYOUT_MAGIC) \
+    )
+
+#define GET_GENERAL_INFO_LAYOUT_VERSION(general_info_buffer, general_info_len) \
+    (HAS_GENERAL_INFO_LAYOUT_TRAILER(general_info_buffer, general_info_len) \
+        ? (general_info_buffer)[GENERAL_INFO_LAYOUT_VERSION_INDEX] \
+        : HOOK_STATE_LAYOUT_VERSION_LEGACY)
+
+#define GET_GENERAL_INFO_MIGRATION_CURSOR(general_info_buffer, general_info_len) \
+    (HAS_GENERAL_INFO_LAYOUT_TRAILER(general_info_buffer, general_info_len) \
+        ? UINT32_FROM_BUF((general_info_buffer) + GENERAL_INFO_MIGRATION_CURSOR_INDEX) \
+        : 0)
+
+#define SET_GENERAL_INFO_LAYOUT_TRAILER(general_info_buffer, layout_version, migration_cursor) { \
+    UINT32_TO_BUF((general_info_buffer) + GENERAL_INFO_LAYOUT_MAGIC_INDEX, GENERAL_INFO_LAYOUT_MAGIC); \
+    (general_info_buffer)[GENERAL_INFO_LAYOUT_VERSION_INDEX] = (layout_version); \
+    UINT32_TO_BUF((general_info_buffer) + GENERAL_INFO_MIGRATION_CURSOR_INDEX, (migration_cursor)); \
+}
+
 #define GET_LAST_LEDGER_TIME_IN_UNIX_SECONDS(result) (ledger_last_time() + XRPL_TIMESTAMP_OFFSET)
 
 #define INCREMENT_DATA_LOOKUP_FLAG(data_lookup_flag) { \
@@ -197,6 +256,34 @@
         ((addr1)[34] == (addr2)[34]) \
     )
 
+// Loop-free so it can be used inside guarded loops
+#define ACCOUNT_ID_EQUAL(account1, account2) \
+    ( \
+        (UINT64_FROM_BUF(account1) == UINT64_FROM_BUF(account2)) && \
+        (UINT64_FROM_BUF((account1) + 8) == UINT64_FROM_BUF((account2) + 8)) && \
+        (UINT32_FROM_BUF((account1) + 16) == UINT32_FROM_BUF((account2) + 16)) \
+    )
+
+// Loop-free so it can be used inside guarded loops
+#define ZERO_XRP_ADDRESS(addr) { \
+    UINT64_TO_BUF((addr), 0); \
+    UINT64_TO_BUF((addr) + 8, 0); \
+    UINT64_TO_BUF((addr) + 16, 0); \
+    UINT64_TO_BUF((addr) + 24, 0); \
+    UINT16_TO_BUF((addr) + 32, 0); \
+    (addr)[34] = 0; \
+}
+
+// Loop-free so it can be used inside guarded loops
+#define COPY_XRP_ADDRESS(dest, src) { \
+    UINT64_TO_BUF((dest), UINT64_FROM_BUF(src)); \
+    UINT64_TO_BUF((dest) + 8, UINT64_FROM_BUF((src) + 8)); \
+    UINT64_TO_BUF((dest) + 16, UINT64_FROM_BUF((src) + 16)); \
+    UINT64_TO_BUF((dest) + 24, UINT64_FROM_BUF((src) + 24)); \
+    UINT16_TO_BUF((dest) + 32, UINT16_FROM_BUF((src) + 32)); \
+    (dest)[34] = (src)[34]; \
+}
+
 #define UINT64_TO_FLOAT(x) float_set(IEEE754_EXPONENT(x), IEEE754_MANTISSA(x))
 
 /* Macros to extract the mantissa and exponent of a floating-point number in the IEEE 754 binary64 format */
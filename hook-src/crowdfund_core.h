@@ -0,0 +1,204 @@
+/**
+ * Parsing & validation steps shared by the Payment and Invoke paths of crowdfund.c
+ *
+ * NOTE: Every helper here is loop-free. GUARD ids are derived from __LINE__, so a guarded loop in this header
+ *       could share its id with a guarded loop in crowdfund.c; loop-free helpers can also be called inside guarded loops.
+ */
+#ifndef CROWDFUND_CORE_H
+#define CROWDFUND_CORE_H
+
+/* Reads sfDestinationTag of the originating transaction into destination_tag_buffer (4 bytes) */
+static inline uint32_t read_otxn_destination_tag(uint8_t* destination_tag_buffer) {
+    if (otxn_field(destination_tag_buffer, 4, sfDestinationTag) != 4) {
+        rollback(SBUF("Transaction is missing sfDestinationTag."), 400);
+    }
+    uint32_t destination_tag = UINT32_FROM_BUF(destination_tag_buffer);
+    TRACEVAR(destination_tag);
+    return destination_tag;
+}
+
+/* Reads sfAccount of the originating transaction into account_buffer (20 bytes) and raddress (35 bytes) */
+static inline uint8_t read_otxn_account_raddress(uint8_t* account_buffer, uint8_t* raddress) {
+    otxn_field(account_buffer, ACCOUNT_ID_BYTES, sfAccount);
+    // Zero the unused tail so XRP_ADDRESS_EQUAL and COPY_XRP_ADDRESS always see the same bytes for the same account
+    ZERO_XRP_ADDRESS(raddress);
+    uint8_t raddress_len = util_raddr(raddress, XRP_ADDRESS_MAX_BYTES, account_buffer, ACCOUNT_ID_BYTES);
+    TRACEVAR(raddress_len);
+    trace(SBUF("otxn account raddress:"), raddress, raddress_len, 0);
+    return raddress_len;
+}
+
+/* Rolls back unless the originating transaction was sent by the Hook Account itself */
+static inline void require_otxn_from_hook_account() {
+    uint8_t otxn_account_buffer[ACCOUNT_ID_BYTES];
+    uint8_t hook_account_buffer[ACCOUNT_ID_BYTES];
+    otxn_field(SBUF(otxn_account_buffer), sfAccount);
+    hook_account(SBUF(hook_account_buffer));
+    if (!ACCOUNT_ID_EQUAL(otxn_account_buffer, hook_account_buffer)) {
+        rollback(SBUF("Only the Hook Account can use this mode."), 400);
+    }
+}
+
+/* Reads a campaign's General Info into general_info_buffer (256 bytes); returns a negative value if the campaign doesn't exist */
+static inline int64_t lookup_general_info(uint8_t* destination_tag_buffer, uint8_t* hook_state_general_info_key, uint8_t* general_info_buffer) {
+    GET_HOOK_STATE_KEY(DATA_LOOKUP_GENERAL_INFO_FLAG, destination_tag_buffer, hook_state_general_info_key);
+    trace(SBUF("hook_state_general_info_key:"), hook_state_general_info_key, HOOK_STATE_KEY_BYTES, 1);
+    return state(general_info_buffer, HOOK_STATE_VALUE_MAX_BYTES, hook_state_general_info_key, HOOK_STATE_KEY_BYTES);
+}
+
+/* Same as lookup_general_info but rolls back if the campaign doesn't exist */
+static inline int64_t require_general_info(uint8_t* destination_tag_buffer, uint8_t* hook_state_general_info_key, uint8_t* general_info_buffer) {
+    int64_t general_info_len = lookup_general_info(destination_tag_buffer, hook_state_general_info_key, general_info_buffer);
+    if (general_info_len < 0) {
+        rollback(SBUF("No campaign found with destination_tag."), 400);
+    }
+    return general_info_len;
+}
+
+/* Rolls back unless the campaign is still raising funds */
+static inline void require_fund_raise_state(uint8_t* general_info_buffer, uint64_t current_time_unix_seconds) {
+    uint64_t fund_raise_end_date_in_unix_seconds = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_FUND_RAISE_END_DATE_IN_UNIX_SECONDS_INDEX);
+    if (current_time_unix_seconds >= fund_raise_end_date_in_unix_seconds) {
+        rollback(SBUF("Campaign is no longer in fund raise state."), 400);
+    }
+}
+
+/* Computes the Hook State key of the Fund Transactions page holding fund_transaction_id; returns the page slot index */
+static inline uint8_t get_fund_transaction_page_key(uint32_t fund_transaction_id, uint8_t* destination_tag_buffer, uint8_t* hook_state_fund_transaction_page_key) {
+    uint8_t fund_transaction_data_lookup_flag[DATA_LOOKUP_FLAG_BYTES];
+    GET_DATA_LOOKUP_PAGE_FLAG_USING_PAGE_INDEX(fund_transaction_id / HOOK_STATE_FUND_TRANSACTIONS_PAGE_SIZE, fund_transaction_data_lookup_flag);
+    GET_HOOK_STATE_KEY(fund_transaction_data_lookup_flag, destination_tag_buffer, hook_state_fund_transaction_page_key);
+    uint8_t fund_transaction_page_slot_index = fund_transaction_id % HOOK_STATE_FUND_TRANSACTIONS_PAGE_SIZE;
+    TRACEVAR(fund_transaction_page_slot_index);
+    return fund_transaction_page_slot_index;
+}
+
+/*
+ * Reads the Fund Transactions page holding fund_transaction_id into fund_transaction_page_buffer and checks the fund transaction belongs to backer_raddress.
+ * Returns the page length; fund_transaction_page_index is set to the offset of the fund transaction within the page.
+ */
+static inline int64_t require_backer_fund_transaction(
+    uint32_t fund_transaction_id,
+    uint8_t* destination_tag_buffer,
+    uint8_t* backer_raddress,
+    uint8_t backer_raddress_len,
+    uint8_t* hook_state_fund_transaction_page_key,
+    uint8_t* fund_transaction_page_buffer,
+    uint8_t* fund_transaction_page_index
+) {
+    /* Step 1. Compute Hook State Fund Transaction Page Key */
+    uint8_t fund_transaction_page_slot_index = get_fund_transaction_page_key(fund_transaction_id, destination_tag_buffer, hook_state_fund_transaction_page_key);
+
+    /* Step 2. Fund Transaction ID - Check if fund transaction exists for a campaign */
+    int64_t fund_transaction_page_len = state(fund_transaction_page_buffer, FUND_TRANSACTION_MAX_BYTES, hook_state_fund_transaction_page_key, HOOK_STATE_KEY_BYTES);
+    if (fund_transaction_page_len < 0) {
+        rollback(SBUF("Fund Transaction ID doesn't exist for campaign; hook_state_fund_transaction_page_key doesn't exist in Hook State."), 400);
+    }
+    *fund_transaction_page_index = (fund_transaction_page_slot_index * FUND_TRANSACTION_BYTES) + 1; // +1 to skip the prefix length byte
+    uint8_t* fund_transaction_ptr = fund_transaction_page_buffer + *fund_transaction_page_index;
+    uint32_t fund_transaction_id_from_hook_state = UINT32_FROM_BUF(fund_transaction_ptr + FUND_TRANSACTION_ID_INDEX_OFFSET);
+    TRACEVAR(fund_transaction_id_from_hook_state);
+
+    if (fund_transaction_id != fund_transaction_id_from_hook_state) {
+        rollback(SBUF("Fund Transaction ID doesn't exist for campaign; fund_transaction_id != fund_transaction_id_from_hook_state"), 400);
+    }
+
+    /* Step 3. Check if Backer matches Fund Transaction */
+    uint8_t fund_transaction_backer_raddress_len = fund_transaction_ptr[FUND_TRANSACTION_BACKER_INDEX_OFFSET];
+    uint8_t* fund_transaction_backer_raddress_ptr = fund_transaction_ptr + 1 + FUND_TRANSACTION_BACKER_INDEX_OFFSET; // +1 to skip the prefix length byte
+    TRACEVAR(fund_transaction_backer_raddress_len);
+
+    if (backer_raddress_len != fund_transaction_backer_raddress_len) {
+        rollback(SBUF("Backer doesn't match fund transaction; address length doesn't match"), 400);
+    }
+
+    if (!XRP_ADDRESS_EQUAL(backer_raddress, fund_transaction_backer_raddress_ptr)) {
+        rollback(SBUF("Backer doesn't match fund transaction; backer_raddress != fund_transaction_backer_raddress"), 400);
+    }
+
+    return fund_transaction_page_len;
+}
+
+/* Writes a Hook State entry; rolls back with the given error message if it fails */
+static inline void state_set_or_rollback(uint8_t* data, uint32_t data_len, uint8_t* hook_state_key, uint32_t error_ptr, uint32_t error_len) {
+    int64_t state_set_res = state_set(data, data_len, hook_state_key, HOOK_STATE_KEY_BYTES);
+    TRACEVAR(state_set_res);
+    if (state_set_res == RESERVE_INSUFFICIENT) {
+        rollback(SBUF("Insufficient reserve to write hook state."), 400);
+    } else if (state_set_res < 0) {
+        rollback(error_ptr, error_len, 400);
+    }
+}
+
+/*
+ * Appends a Fund Transaction for backer_raddress to the campaign's last Fund Transactions page, and updates the totals in general_info_buffer.
+ * The caller is responsible for writing general_info_buffer back to Hook State. Returns the new fund transaction id.
+ */
+static inline uint32_t append_fund_transaction(
+    uint8_t* destination_tag_buffer,
+    uint8_t* general_info_buffer,
+    uint8_t* backer_raddress,
+    uint8_t backer_raddress_len,
+    uint64_t fund_amount_in_drops
+) {
+    /* Step 1. Compute fundTransactionId, Hook State key and pageSlotIndex for new Fund Transaction */
+    uint32_t total_fund_transactions = UINT32_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_FUND_TRANSACTIONS_INDEX);
+    uint32_t fund_transaction_id = total_fund_transactions;
+    uint8_t hook_state_fund_transaction_page_key[HOOK_STATE_KEY_BYTES];
+    uint8_t fund_transaction_page_slot_index = get_fund_transaction_page_key(fund_transaction_id, destination_tag_buffer, hook_state_fund_transaction_page_key);
+
+    /* Step 2. Use existing Fund Transaction Hook State page or create new buffer */
+    uint8_t fund_transaction_page_buffer[FUND_TRANSACTION_MAX_BYTES];
+    uint8_t fund_transaction_page_index = 0;
+    if (fund_transaction_page_slot_index == 0) {
+        // Use new Fund Transaction page buffer
+        fund_transaction_page_buffer[0] = 1; // set prefix length byte
+        fund_transaction_page_index++;
+    } else {
+        // Read from Hook State to use existing Fund Transaction page buffer
+        if (state(SBUF(fund_transaction_page_buffer), hook_state_fund_transaction_page_key, HOOK_STATE_KEY_BYTES) < 0) {
+            rollback(SBUF("Failed to read hook state."), 400);
+        }
+        fund_transaction_page_buffer[0]++; // increment the prefix length byte
+        fund_transaction_page_index = (fund_transaction_page_slot_index * FUND_TRANSACTION_BYTES) + 1; // +1 to skip the prefix length byte
+    }
+
+    /* Step 3. Write Fund Transaction ID to Fund Transaction Page Buffer */
+    UINT32_TO_BUF(fund_transaction_page_buffer + fund_transaction_page_index, fund_transaction_id);
+    fund_transaction_page_index += 4;
+
+    /* Step 4. Write Backer Address to Fund Transaction Buffer */
+    fund_transaction_page_buffer[fund_transaction_page_index++] = backer_raddress_len;
+    COPY_XRP_ADDRESS(fund_transaction_page_buffer + fund_transaction_page_index, backer_raddress);
+    fund_transaction_page_index += XRP_ADDRESS_MAX_BYTES;
+
+    /* Step 5. Write Fund Transaction State to Fund Transaction Buffer */
+    fund_transaction_page_buffer[fund_transaction_page_index++] = FUND_TRANSACTION_STATE_APPROVE_FLAG;
+
+    /* Step 6. Write Fund Transaction Amount to Fund Transaction Buffer */
+    UINT64_TO_BUF(fund_transaction_page_buffer + fund_transaction_page_index, fund_amount_in_drops);
+    fund_transaction_page_index += 8;
+
+    /* Step 7. Verify Fund Transaction Buffer was filled correctly */
+    uint8_t expected_fund_transaction_page_index = (fund_transaction_page_slot_index * FUND_TRANSACTION_BYTES) + 1 + FUND_TRANSACTION_BYTES;
+    if (fund_transaction_page_index != expected_fund_transaction_page_index) {
+        rollback(SBUF("fund_transaction_page_buffer was not filled correctly."), 400);
+    }
+
+    /* Step 8. Write Fund Transaction Buffer to Hook State; only the used bytes of the page are written */
+    state_set_or_rollback(fund_transaction_page_buffer, fund_transaction_page_index, hook_state_fund_transaction_page_key, SBUF("Failed to write fund transaction to hook state."));
+
+    /* Step 9. Update totalAmountRaisedInDrops, totalReserveAmountInDrops and totalFundTransactions in General Info Buffer */
+    uint64_t total_amount_raised_in_drops = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_AMOUNT_RAISED_IN_DROPS_INDEX);
+    UINT64_TO_BUF(general_info_buffer + GENERAL_INFO_TOTAL_AMOUNT_RAISED_IN_DROPS_INDEX, total_amount_raised_in_drops + fund_amount_in_drops);
+
+    uint64_t total_reserve_amount_in_drops = UINT64_FROM_BUF(general_info_buffer + GENERAL_INFO_TOTAL_RESERVE_AMOUNT_IN_DROPS_INDEX);
+    UINT64_TO_BUF(general_info_buffer + GENERAL_INFO_TOTAL_RESERVE_AMOUNT_IN_DROPS_INDEX, total_reserve_amount_in_drops + FUND_CAMPAIGN_DEPOSIT_IN_DROPS);
+
+    UINT32_TO_BUF(general_info_buffer + GENERAL_INFO_TOTAL_FUND_TRANSACTIONS_INDEX, total_fund_transactions + 1);
+
+    TRACEVAR(fund_transaction_id);
+    return fund_transaction_id;
+}
+
+#endif
@@ -0,0 +1,5 @@
+/**
+ * Develop Mode build of crowdfund.c: also accepts the MODE_DEV_* flags used by the integration tests
+ */
+#define CROWDFUND_DEV_MODE 1
+#include "crowdfund.c"
@@ -0,0 +1,14 @@
+{
+  "targets": [
+    {
+      "target_name": "crowdfund_state",
+      "sources": ["crowdfund_state.cc"],
+      "include_dirs": ["../hook-src"],
+      "defines": ["NAPI_VERSION=6"],
+      "cflags_cc": ["-O3"],
+      "xcode_settings": {
+        "OTHER_CPLUSPLUSFLAGS": ["-O3"]
+      }
+    }
+  ]
+}
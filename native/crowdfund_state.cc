@@ -0,0 +1,419 @@
+/**
+ * Node addon that decodes the crowdfund Hook's Hook State entries.
+ *
+ * The byte layout comes straight from hook-src/crowdfund.h, so the offsets used here are the ones
+ * the Hook writes with. A whole account_namespace page (or namespace) is decoded in one call:
+ *
+ *   decodeHookStateEntries(namespaceEntries: { HookStateKey: string, HookStateData: string }[])
+ *
+ * The result is columnar: one typed array per model field (see DecodedColumns and
+ * NativeDecodedColumns in client/util/nativeDecoder.ts), so a batch costs a handful of N-API calls
+ * instead of several per decoded value. nativeDecoder.ts turns the columns into model instances, and
+ * falls back to the TS codec when this addon isn't built.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <node_api.h>
+
+// Byte helpers from hook-src/macro.h, which can't be included outside a Hook (it pulls in hookapi.h)
+#ifndef UINT32_FROM_BUF
+#define UINT32_FROM_BUF(buf)\
+    (((uint64_t)((buf)[0]) << 24) +\
+     ((uint64_t)((buf)[1]) << 16) +\
+     ((uint64_t)((buf)[2]) <<  8) +\
+     ((uint64_t)((buf)[3]) <<  0))
+#endif
+
+#ifndef UINT64_FROM_BUF
+#define UINT64_FROM_BUF(buf)\
+    (((uint64_t)((buf)[0]) << 56) +\
+     ((uint64_t)((buf)[1]) << 48) +\
+     ((uint64_t)((buf)[2]) << 40) +\
+     ((uint64_t)((buf)[3]) << 32) +\
+     ((uint64_t)((buf)[4]) << 24) +\
+     ((uint64_t)((buf)[5]) << 16) +\
+     ((uint64_t)((buf)[6]) <<  8) +\
+     ((uint64_t)((buf)[7]) <<  0))
+#endif
+
+#include "crowdfund.h"
+
+// General Info fixed part: everything up to and including the milestones prefix length byte
+#define GENERAL_INFO_FIXED_BYTES (GENERAL_INFO_MILESTONES_INDEX + 1)
+
+// Fits any Hook State value (HOOK_STATE_VALUE_MAX_BYTES) in hex, so strings are copied once
+#define HEX_BUFFER_BYTES (HOOK_STATE_VALUE_MAX_BYTES * 2 + 2)
+
+#define NAPI_CALL(env, call) \
+    do { \
+        if ((call) != napi_ok) { \
+            throw_last_error(env); \
+            return nullptr; \
+        } \
+    } while (0)
+
+#define NAPI_THROW(env, message) \
+    do { \
+        napi_throw_error((env), nullptr, (message)); \
+        return nullptr; \
+    } while (0)
+
+static void throw_last_error(napi_env env) {
+    bool is_exception_pending = false;
+    napi_is_exception_pending(env, &is_exception_pending);
+    if (is_exception_pending) {
+        return;
+    }
+    const napi_extended_error_info* error_info = nullptr;
+    napi_get_last_error_info(env, &error_info);
+    const char* message = error_info != nullptr && error_info->error_message != nullptr
+        ? error_info->error_message
+        : "N-API call failed";
+    napi_throw_error(env, nullptr, message);
+}
+
+static inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* Throws an error naming the entry and its field, e.g. "account_namespace entry 3 HookStateData is missing" */
+static void throw_field_error(napi_env env, uint32_t index, const char* name, const char* problem) {
+    std::string message = "account_namespace entry " + std::to_string(index) + " " + name + " " + problem;
+    napi_throw_error(env, nullptr, message.c_str());
+}
+
+/* Reads the hex string property key (named name) of the index-th entry into bytes; returns false with a pending exception on failure */
+static bool read_hex_property(napi_env env, napi_value object, uint32_t index, napi_value key, const char* name, std::string& hex, std::vector<uint8_t>& bytes) {
+    napi_value value;
+    napi_valuetype value_type = napi_undefined;
+    size_t hex_len = 0;
+    if (hex.size() < HEX_BUFFER_BYTES) {
+        hex.resize(HEX_BUFFER_BYTES);
+    }
+    if (napi_get_property(env, object, key, &value) != napi_ok ||
+        napi_typeof(env, value, &value_type) != napi_ok) {
+        throw_last_error(env);
+        return false;
+    }
+    if (value_type == napi_undefined || value_type == napi_null) {
+        throw_field_error(env, index, name, "is missing");
+        return false;
+    }
+    if (value_type != napi_string) {
+        throw_field_error(env, index, name, "is not a string");
+        return false;
+    }
+    if (napi_get_value_string_latin1(env, value, &hex[0], hex.size(), &hex_len) != napi_ok) {
+        throw_last_error(env);
+        return false;
+    }
+    if (hex_len == hex.size() - 1) {
+        // Possibly truncated: read the length and copy again
+        if (napi_get_value_string_latin1(env, value, nullptr, 0, &hex_len) != napi_ok) {
+            throw_last_error(env);
+            return false;
+        }
+        hex.resize(hex_len + 1);
+        if (napi_get_value_string_latin1(env, value, &hex[0], hex.size(), &hex_len) != napi_ok) {
+            throw_last_error(env);
+            return false;
+        }
+    }
+    if (hex_len % 2 != 0) {
+        throw_field_error(env, index, name, "has an odd number of hex digits");
+        return false;
+    }
+
+    bytes.resize(hex_len / 2);
+    for (size_t i = 0; i < bytes.size(); i++) {
+        int high = hex_digit(hex[i * 2]);
+        int low = hex_digit(hex[i * 2 + 1]);
+        if (high < 0 || low < 0) {
+            throw_field_error(env, index, name, "is not a hex string");
+            return false;
+        }
+        bytes[i] = (uint8_t)((high << 4) | low);
+    }
+    return true;
+}
+
+// Decoded columns of one batch; entries keep their namespace order within each kind
+struct DecodedColumns {
+    std::vector<uint8_t> kinds;
+    std::vector<uint64_t> data_lookup_flags;
+    std::vector<uint32_t> destination_tags;
+
+    std::vector<uint8_t> general_info_state;
+    std::vector<uint32_t> general_info_owner;
+    std::vector<uint64_t> general_info_fund_raise_goal_in_drops;
+    std::vector<uint64_t> general_info_fund_raise_end_date_in_unix_seconds;
+    std::vector<uint64_t> general_info_total_amount_raised_in_drops;
+    std::vector<uint64_t> general_info_total_amount_non_refundable_in_drops;
+    std::vector<uint64_t> general_info_total_reserve_amount_in_drops;
+    std::vector<uint32_t> general_info_total_fund_transactions;
+    std::vector<uint32_t> general_info_total_reject_votes_for_current_milestone;
+    std::vector<uint8_t> general_info_layout_version;
+    std::vector<uint32_t> general_info_migration_cursor;
+    std::vector<uint32_t> general_info_milestones_end;
+
+    std::vector<uint8_t> milestone_state;
+    std::vector<uint64_t> milestone_end_date_in_unix_seconds;
+    std::vector<uint8_t> milestone_payout_percent;
+
+    std::vector<uint32_t> fund_transactions_page_end;
+    std::vector<uint32_t> fund_transaction_id;
+    std::vector<uint32_t> fund_transaction_account;
+    std::vector<uint8_t> fund_transaction_state;
+    std::vector<uint64_t> fund_transaction_amount_in_drops;
+
+    // r-addresses are repeated across entries, so each one is returned once and referenced by index
+    std::vector<std::string> accounts;
+    std::unordered_map<std::string, uint32_t> account_indexes;
+};
+
+#define ENTRY_KIND_GENERAL_INFO 0
+#define ENTRY_KIND_FUND_TRANSACTIONS_PAGE 1
+
+/* 1 byte prefix length + 35 bytes, same as hexToXRPAddress for r-addresses */
+static uint32_t add_account(DecodedColumns& columns, const uint8_t* buf) {
+    size_t len = buf[0] < XRP_ADDRESS_MAX_BYTES ? buf[0] : XRP_ADDRESS_MAX_BYTES;
+    std::string account((const char*)(buf + 1), len);
+    auto inserted = columns.account_indexes.emplace(account, (uint32_t)columns.accounts.size());
+    if (inserted.second) {
+        columns.accounts.push_back(std::move(account));
+    }
+    return inserted.first->second;
+}
+
+/* Returns an error message, or nullptr on success */
+static const char* decode_general_info(DecodedColumns& columns, const uint8_t* buf, size_t len) {
+    if (len < GENERAL_INFO_FIXED_BYTES) {
+        return "General Info entry is too short";
+    }
+    uint8_t milestones_len = buf[GENERAL_INFO_MILESTONES_INDEX];
+    if (milestones_len > MILESTONES_MAX_LENGTH ||
+        len < GENERAL_INFO_FIXED_BYTES + (size_t)milestones_len * MILESTONE_BYTES) {
+        return "General Info entry has an invalid milestones length";
+    }
+
+    columns.general_info_state.push_back(buf[GENERAL_INFO_STATE_INDEX]);
+    columns.general_info_owner.push_back(add_account(columns, buf + GENERAL_INFO_CAMPAIGN_OWNER_INDEX));
+    columns.general_info_fund_raise_goal_in_drops.push_back(
+        UINT64_FROM_BUF(buf + GENERAL_INFO_FUND_RAISE_GOAL_IN_DROPS_INDEX));
+    columns.general_info_fund_raise_end_date_in_unix_seconds.push_back(
+        UINT64_FROM_BUF(buf + GENERAL_INFO_FUND_RAISE_END_DATE_IN_UNIX_SECONDS_INDEX));
+    columns.general_info_total_amount_raised_in_drops.push_back(
+        UINT64_FROM_BUF(buf + GENERAL_INFO_TOTAL_AMOUNT_RAISED_IN_DROPS_INDEX));
+    columns.general_info_total_amount_non_refundable_in_drops.push_back(
+        UINT64_FROM_BUF(buf + GENERAL_INFO_TOTAL_AMOUNT_NON_REFUNDABLE_IN_DROPS_INDEX));
+    columns.general_info_total_reserve_amount_in_drops.push_back(
+        UINT64_FROM_BUF(buf + GENERAL_INFO_TOTAL_RESERVE_AMOUNT_IN_DROPS_INDEX));
+    columns.general_info_total_fund_transactions.push_back(
+        (uint32_t)UINT32_FROM_BUF(buf + GENERAL_INFO_TOTAL_FUND_TRANSACTIONS_INDEX));
+    columns.general_info_total_reject_votes_for_current_milestone.push_back(
+        (uint32_t)UINT32_FROM_BUF(buf + GENERAL_INFO_TOTAL_REJECT_VOTES_FOR_CURRENT_MILESTONE_INDEX));
+    columns.general_info_layout_version.push_back(GET_GENERAL_INFO_LAYOUT_VERSION(buf, len));
+    columns.general_info_migration_cursor.push_back((uint32_t)GET_GENERAL_INFO_MIGRATION_CURSOR(buf, len));
+
+    const uint8_t* milestone_ptr = buf + GENERAL_INFO_MILESTONES_INDEX + 1; // +1 to skip the prefix length byte
+    for (uint8_t i = 0; i < milestones_len; i++, milestone_ptr += MILESTONE_BYTES) {
+        columns.milestone_state.push_back(milestone_ptr[GENERAL_INFO_MILESTONE_STATE_INDEX_OFFSET]);
+        columns.milestone_end_date_in_unix_seconds.push_back(
+            UINT64_FROM_BUF(milestone_ptr + GENERAL_INFO_MILESTONE_END_DATE_IN_UNIX_SECONDS_INDEX_OFFSET));
+        columns.milestone_payout_percent.push_back(milestone_ptr[GENERAL_INFO_MILESTONE_PAYOUT_PERCENT_INDEX_OFFSET]);
+    }
+    columns.general_info_milestones_end.push_back((uint32_t)columns.milestone_state.size());
+    return nullptr;
+}
+
+/* Returns an error message, or nullptr on success */
+static const char* decode_fund_transactions_page(DecodedColumns& columns, const uint8_t* buf, size_t len) {
+    if (len < 1 || buf[0] > HOOK_STATE_FUND_TRANSACTIONS_PAGE_SIZE || len < (size_t)GET_FUND_TRANSACTIONS_PAGE_BYTES(buf)) {
+        return "Fund Transactions page entry has an invalid length";
+    }
+
+    uint8_t fund_transactions_len = buf[0];
+    const uint8_t* fund_transaction_ptr = buf + 1; // +1 to skip the prefix length byte
+    for (uint8_t i = 0; i < fund_transactions_len; i++, fund_transaction_ptr += FUND_TRANSACTION_BYTES) {
+        columns.fund_transaction_id.push_back(
+            (uint32_t)UINT32_FROM_BUF(fund_transaction_ptr + FUND_TRANSACTION_ID_INDEX_OFFSET));
+        columns.fund_transaction_account.push_back(
+            add_account(columns, fund_transaction_ptr + FUND_TRANSACTION_BACKER_INDEX_OFFSET));
+        columns.fund_transaction_state.push_back(fund_transaction_ptr[FUND_TRANSACTION_STATE_INDEX_OFFSET]);
+        columns.fund_transaction_amount_in_drops.push_back(
+            UINT64_FROM_BUF(fund_transaction_ptr + FUND_TRANSACTION_AMOUNT_IN_DROPS_INDEX_OFFSET));
+    }
+    columns.fund_transactions_page_end.push_back((uint32_t)columns.fund_transaction_id.size());
+    return nullptr;
+}
+
+/* Returns an error message, or nullptr on success */
+static const char* decode_entry(DecodedColumns& columns, const std::vector<uint8_t>& key, const std::vector<uint8_t>& data) {
+    if (key.size() != HOOK_STATE_KEY_BYTES) {
+        return "HookStateKey must be 32 bytes";
+    }
+    // Fund Transactions page flags are the page index + 1, so they always fit in 64 bits
+    for (size_t i = 0; i < DATA_LOOKUP_FLAG_BYTES - 8; i++) {
+        if (key[i] != 0) {
+            return "HookStateKey data lookup flag exceeds 64 bits";
+        }
+    }
+    uint64_t data_lookup_flag = UINT64_FROM_BUF(key.data() + DATA_LOOKUP_FLAG_BYTES - 8);
+    columns.data_lookup_flags.push_back(data_lookup_flag);
+    columns.destination_tags.push_back((uint32_t)UINT32_FROM_BUF(key.data() + DATA_LOOKUP_FLAG_BYTES));
+
+    // DATA_LOOKUP_GENERAL_INFO_FLAG is all zeros; every other flag is a Fund Transactions page
+    if (data_lookup_flag == 0) {
+        columns.kinds.push_back(ENTRY_KIND_GENERAL_INFO);
+        return decode_general_info(columns, data.data(), data.size());
+    }
+    columns.kinds.push_back(ENTRY_KIND_FUND_TRANSACTIONS_PAGE);
+    return decode_fund_transactions_page(columns, data.data(), data.size());
+}
+
+/* Copies column into a new typed array of type and sets it as object[name] */
+template <typename T>
+static bool set_typed_array(napi_env env, napi_value object, const char* name, napi_typedarray_type type, const std::vector<T>& column) {
+    void* array_buffer_data = nullptr;
+    napi_value array_buffer;
+    napi_value typed_array;
+    size_t byte_length = column.size() * sizeof(T);
+    if (napi_create_arraybuffer(env, byte_length, &array_buffer_data, &array_buffer) != napi_ok) {
+        return false;
+    }
+    if (byte_length > 0) {
+        memcpy(array_buffer_data, column.data(), byte_length);
+    }
+    return napi_create_typedarray(env, type, column.size(), array_buffer, 0, &typed_array) == napi_ok &&
+        napi_set_named_property(env, object, name, typed_array) == napi_ok;
+}
+
+static napi_value create_columns_object(napi_env env, const DecodedColumns& columns) {
+    napi_value result;
+    napi_value general_info;
+    napi_value milestones;
+    napi_value fund_transactions;
+    napi_value accounts;
+    NAPI_CALL(env, napi_create_object(env, &result));
+    NAPI_CALL(env, napi_create_object(env, &general_info));
+    NAPI_CALL(env, napi_create_object(env, &milestones));
+    NAPI_CALL(env, napi_create_object(env, &fund_transactions));
+    NAPI_CALL(env, napi_create_array_with_length(env, columns.accounts.size(), &accounts));
+
+    for (size_t i = 0; i < columns.accounts.size(); i++) {
+        napi_value account;
+        NAPI_CALL(env, napi_create_string_latin1(env, columns.accounts[i].data(), columns.accounts[i].size(), &account));
+        NAPI_CALL(env, napi_set_element(env, accounts, (uint32_t)i, account));
+    }
+
+    bool is_ok =
+        set_typed_array(env, result, "kinds", napi_uint8_array, columns.kinds) &&
+        set_typed_array(env, result, "dataLookupFlags", napi_biguint64_array, columns.data_lookup_flags) &&
+        set_typed_array(env, result, "destinationTags", napi_uint32_array, columns.destination_tags) &&
+
+        set_typed_array(env, general_info, "state", napi_uint8_array, columns.general_info_state) &&
+        set_typed_array(env, general_info, "owner", napi_uint32_array, columns.general_info_owner) &&
+        set_typed_array(env, general_info, "fundRaiseGoalInDrops", napi_biguint64_array,
+            columns.general_info_fund_raise_goal_in_drops) &&
+        set_typed_array(env, general_info, "fundRaiseEndDateInUnixSeconds", napi_biguint64_array,
+            columns.general_info_fund_raise_end_date_in_unix_seconds) &&
+        set_typed_array(env, general_info, "totalAmountRaisedInDrops", napi_biguint64_array,
+            columns.general_info_total_amount_raised_in_drops) &&
+        set_typed_array(env, general_info, "totalAmountNonRefundableInDrops", napi_biguint64_array,
+            columns.general_info_total_amount_non_refundable_in_drops) &&
+        set_typed_array(env, general_info, "totalReserveAmountInDrops", napi_biguint64_array,
+            columns.general_info_total_reserve_amount_in_drops) &&
+        set_typed_array(env, general_info, "totalFundTransactions", napi_uint32_array,
+            columns.general_info_total_fund_transactions) &&
+        set_typed_array(env, general_info, "totalRejectVotesForCurrentMilestone", napi_uint32_array,
+            columns.general_info_total_reject_votes_for_current_milestone) &&
+        set_typed_array(env, general_info, "layoutVersion", napi_uint8_array, columns.general_info_layout_version) &&
+        set_typed_array(env, general_info, "migrationCursor", napi_uint32_array, columns.general_info_migration_cursor) &&
+        set_typed_array(env, general_info, "milestonesEnd", napi_uint32_array, columns.general_info_milestones_end) &&
+
+        set_typed_array(env, milestones, "state", napi_uint8_array, columns.milestone_state) &&
+        set_typed_array(env, milestones, "endDateInUnixSeconds", napi_biguint64_array,
+            columns.milestone_end_date_in_unix_seconds) &&
+        set_typed_array(env, milestones, "payoutPercent", napi_uint8_array, columns.milestone_payout_percent) &&
+
+        set_typed_array(env, fund_transactions, "pageEnd", napi_uint32_array, columns.fund_transactions_page_end) &&
+        set_typed_array(env, fund_transactions, "id", napi_uint32_array, columns.fund_transaction_id) &&
+        set_typed_array(env, fund_transactions, "account", napi_uint32_array, columns.fund_transaction_account) &&
+        set_typed_array(env, fund_transactions, "state", napi_uint8_array, columns.fund_transaction_state) &&
+        set_typed_array(env, fund_transactions, "amountInDrops", napi_biguint64_array,
+            columns.fund_transaction_amount_in_drops) &&
+
+        napi_set_named_property(env, result, "generalInfo", general_info) == napi_ok &&
+        napi_set_named_property(env, result, "milestones", milestones) == napi_ok &&
+        napi_set_named_property(env, result, "fundTransactions", fund_transactions) == napi_ok &&
+        napi_set_named_property(env, result, "accounts", accounts) == napi_ok;
+    if (!is_ok) {
+        throw_last_error(env);
+        return nullptr;
+    }
+    return result;
+}
+
+static napi_value decode_hook_state_entries(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+    bool is_array = false;
+    if (argc < 1 || napi_is_array(env, argv[0], &is_array) != napi_ok || !is_array) {
+        NAPI_THROW(env, "decodeHookStateEntries expects an array of account_namespace entries");
+    }
+
+    uint32_t entries_len = 0;
+    NAPI_CALL(env, napi_get_array_length(env, argv[0], &entries_len));
+
+    napi_value hook_state_key_name;
+    napi_value hook_state_data_name;
+    NAPI_CALL(env, napi_create_string_latin1(env, "HookStateKey", NAPI_AUTO_LENGTH, &hook_state_key_name));
+    NAPI_CALL(env, napi_create_string_latin1(env, "HookStateData", NAPI_AUTO_LENGTH, &hook_state_data_name));
+
+    DecodedColumns columns;
+    columns.kinds.reserve(entries_len);
+    columns.data_lookup_flags.reserve(entries_len);
+    columns.destination_tags.reserve(entries_len);
+
+    // Reused across entries
+    std::string hex;
+    std::vector<uint8_t> key;
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i < entries_len; i++) {
+        napi_value namespace_entry;
+        napi_valuetype entry_type = napi_undefined;
+        NAPI_CALL(env, napi_get_element(env, argv[0], i, &namespace_entry));
+        NAPI_CALL(env, napi_typeof(env, namespace_entry, &entry_type));
+        if (entry_type != napi_object) {
+            std::string message = "account_namespace entry " + std::to_string(i) + " is not an object";
+            NAPI_THROW(env, message.c_str());
+        }
+        if (!read_hex_property(env, namespace_entry, i, hook_state_key_name, "HookStateKey", hex, key) ||
+            !read_hex_property(env, namespace_entry, i, hook_state_data_name, "HookStateData", hex, data)) {
+            return nullptr;
+        }
+        const char* error_message = decode_entry(columns, key, data);
+        if (error_message != nullptr) {
+            NAPI_THROW(env, error_message);
+        }
+    }
+
+    return create_columns_object(env, columns);
+}
+
+static napi_value init(napi_env env, napi_value exports) {
+    napi_value decode_function;
+    NAPI_CALL(env, napi_create_function(env, "decodeHookStateEntries", NAPI_AUTO_LENGTH,
+        decode_hook_state_entries, nullptr, &decode_function));
+    NAPI_CALL(env, napi_set_named_property(env, exports, "decodeHookStateEntries", decode_function));
+    return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, init)
@@ -0,0 +1,194 @@
+import { Backer } from '../../client/app/models/Backer'
+import { Campaign } from '../../client/app/models/Campaign'
+import { createCampaign as createCampaignFixture } from '../../client/app/models/testFixtures'
+import { CampaignState } from '../../client/app/constants'
+import {
+  CampaignListIndex,
+  CampaignListQuery,
+  createCampaignListEntry,
+  parseCampaignListQuery,
+} from './CampaignListIndex'
+
+function createCampaign(
+  id: number,
+  state: CampaignState,
+  raisedInDrops: number,
+  endDateInUnixSeconds: number,
+  backersCount: number
+): Campaign {
+  return createCampaignFixture(id, {
+    state,
+    fundRaiseEndDateInUnixSeconds: BigInt(endDateInUnixSeconds),
+    totalAmountRaisedInDrops: BigInt(raisedInDrops),
+    backers: Array.from(
+      { length: backersCount },
+      (_, index) => new Backer(`r${index}`, [])
+    ),
+  })
+}
+
+const campaigns = [
+  createCampaign(1, 'fundRaise', 300, 1700000300, 1),
+  createCampaign(2, 'milestone1', 100, 1700000100, 3),
+  createCampaign(3, 'fundRaise', 200, 1700000200, 2),
+  createCampaign(4, 'fundRaise', 200, 1700000400, 0),
+  createCampaign(5, 'completed', 500, 1700000000, 4),
+]
+
+const index = new CampaignListIndex(
+  campaigns.map((campaign) =>
+    createCampaignListEntry(JSON.stringify(campaign.serialize()))
+  )
+)
+
+function query(params: Record<string, string>): {
+  campaigns: Array<Record<string, unknown>>
+  nextCursor: string | null
+} {
+  return JSON.parse(
+    index.query(parseCampaignListQuery(params) as CampaignListQuery)
+  )
+}
+
+// Follows nextCursor until the last page
+function queryAllIds(params: Record<string, string>): number[][] {
+  const pages: number[][] = []
+  let cursor: string | null = null
+  do {
+    const page = query(cursor ? { ...params, cursor } : params)
+    pages.push(page.campaigns.map((campaign) => campaign.id as number))
+    cursor = page.nextCursor
+  } while (cursor)
+  return pages
+}
+
+describe('parseCampaignListQuery', () => {
+  it('should keep the unpaged list when no list parameter is given', () => {
+    expect(parseCampaignListQuery({})).toBeUndefined()
+  })
+
+  it('should apply defaults', () => {
+    expect(parseCampaignListQuery({ sort: 'raised' })).toEqual({
+      limit: 50,
+      cursor: undefined,
+      state: undefined,
+      sort: 'raised',
+      order: 'desc',
+      fields: undefined,
+    })
+    expect(parseCampaignListQuery({ limit: '2' })?.order).toBe('asc')
+  })
+
+  it('should reject invalid parameters', () => {
+    expect(() => parseCampaignListQuery({ limit: '0' })).toThrow(
+      'Invalid limit'
+    )
+    expect(() => parseCampaignListQuery({ limit: '501' })).toThrow(
+      'Invalid limit'
+    )
+    expect(() => parseCampaignListQuery({ sort: 'title' })).toThrow(
+      'Invalid sort'
+    )
+    expect(() => parseCampaignListQuery({ order: 'up' })).toThrow(
+      'Invalid order'
+    )
+    expect(() => parseCampaignListQuery({ state: ['a', 'b'] })).toThrow(
+      'Invalid state'
+    )
+  })
+})
+
+describe('CampaignListIndex', () => {
+  it('should page through campaigns by id', () => {
+    expect(queryAllIds({ limit: '2' })).toEqual([[1, 2], [3, 4], [5]])
+  })
+
+  it('should sort with ties broken by id', () => {
+    expect(queryAllIds({ sort: 'raised', limit: '2' })).toEqual([
+      [5, 1],
+      [4, 3],
+      [2],
+    ])
+    expect(
+      queryAllIds({ sort: 'raised', order: 'asc', limit: '2' })
+    ).toEqual([
+      [2, 3],
+      [4, 1],
+      [5],
+    ])
+    expect(queryAllIds({ sort: 'endDate', order: 'asc' })).toEqual([
+      [5, 2, 3, 1, 4],
+    ])
+    expect(queryAllIds({ sort: 'backers' })).toEqual([[5, 2, 3, 1, 4]])
+  })
+
+  it('should filter by campaign state', () => {
+    expect(
+      queryAllIds({ state: 'fundRaise', sort: 'raised', limit: '1' })
+    ).toEqual([[1], [4], [3]])
+    expect(queryAllIds({ state: 'failedFundRaise' })).toEqual([[]])
+  })
+
+  it('should project fields without fund transactions and backers', () => {
+    const page = query({ fields: 'id,title,totalAmountRaisedInDrops' })
+    expect(page.campaigns[0]).toEqual({
+      id: 1,
+      title: 'title 1',
+      totalAmountRaisedInDrops: '300',
+    })
+    expect(query({ fields: 'id,backers', limit: '1' }).campaigns).toEqual([
+      { id: 1, backers: [campaigns[0].backers[0].serialize()] },
+    ])
+    expect(query({ limit: '1' }).campaigns).toEqual([
+      JSON.parse(JSON.stringify(campaigns[0].serialize())),
+    ])
+  })
+
+  it('should reject a cursor from another query', () => {
+    const { nextCursor } = query({ sort: 'raised', limit: '1' })
+    expect(() =>
+      query({ sort: 'endDate', limit: '1', cursor: nextCursor as string })
+    ).toThrow('Invalid cursor')
+    expect(() => query({ cursor: 'not-a-cursor' })).toThrow('Invalid cursor')
+  })
+
+  it('should match a fresh build after updating changed and removed campaigns', () => {
+    const states: CampaignState[] = ['fundRaise', 'milestone1', 'completed']
+    const createEntry = (id: number, raised: number) =>
+      createCampaignListEntry(
+        JSON.stringify(
+          createCampaign(
+            id,
+            states[(id + raised) % states.length],
+            raised,
+            1700000000 + ((id * 7) % 40),
+            (id * 3) % 5
+          ).serialize()
+        )
+      )
+    const entries = Array.from({ length: 80 }, (_, index) =>
+      createEntry(index + 1, 100)
+    )
+    const changed = [createEntry(7, 250), createEntry(81, 100)]
+    const updated = new CampaignListIndex(entries)
+    updated.update(changed, [12])
+
+    const fresh = new CampaignListIndex([
+      ...entries.filter((entry) => entry.id !== 7 && entry.id !== 12),
+      ...changed,
+    ])
+    for (const state of [undefined, ...states]) {
+      for (const sort of ['id', 'raised', 'endDate', 'backers']) {
+        for (const order of ['asc', 'desc']) {
+          const listQuery = parseCampaignListQuery({
+            sort,
+            order,
+            limit: '500',
+            ...(state ? { state } : {}),
+          }) as CampaignListQuery
+          expect(updated.query(listQuery)).toBe(fresh.query(listQuery))
+        }
+      }
+    }
+  })
+})
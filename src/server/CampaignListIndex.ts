@@ -0,0 +1,405 @@
+export type CampaignSortKey = 'id' | 'raised' | 'endDate' | 'backers'
+export type SortOrder = 'asc' | 'desc'
+
+const CAMPAIGN_SORT_KEYS: CampaignSortKey[] = [
+  'id',
+  'raised',
+  'endDate',
+  'backers',
+]
+
+// Serialized fields that aren't part of a campaign summary
+const DETAIL_FIELDS = ['fundTransactions', 'backers']
+
+export const CAMPAIGN_LIST_DEFAULT_LIMIT = 50
+export const CAMPAIGN_LIST_MAX_LIMIT = 500
+
+// Updates touching more than this fraction of the campaigns re-sort instead of splicing each one
+const CAMPAIGN_LIST_RESORT_FRACTION = 1 / 16
+
+export interface CampaignListQuery {
+  limit: number
+  cursor?: string
+  state?: string
+  sort: CampaignSortKey
+  order: SortOrder
+  // Serialized Campaign fields to return; all of them when undefined
+  fields?: string[]
+}
+
+export interface CampaignListEntry {
+  id: number
+  state: string
+  sortValues: Record<CampaignSortKey, bigint>
+  // Campaign.serialize() without fundTransactions and backers
+  summary: Record<string, unknown>
+  // Full Campaign.serialize() JSON
+  body: string
+}
+
+interface Cursor {
+  sort: CampaignSortKey
+  order: SortOrder
+  state?: string
+  value: string
+  id: number
+}
+
+// Built from the serialized campaign alone, so snapshots read from a file need no Campaign models
+export function createCampaignListEntry(body: string): CampaignListEntry {
+  const summary = JSON.parse(body) as Record<string, unknown>
+  const backers = summary.backers as unknown[]
+  for (const field of DETAIL_FIELDS) {
+    delete summary[field]
+  }
+  return {
+    id: summary.id as number,
+    state: summary.state as string,
+    sortValues: {
+      id: BigInt(summary.id as number),
+      raised: BigInt(summary.totalAmountRaisedInDrops as string),
+      endDate: BigInt(summary.fundRaiseEndDateInUnixSeconds as string),
+      backers: BigInt(backers.length),
+    },
+    summary,
+    body,
+  }
+}
+
+/**
+ * Parses the GET /campaigns query parameters. Throws on invalid values.
+ * @returns undefined when no list parameter is given (the full, unpaged list is served)
+ */
+export function parseCampaignListQuery(
+  query: Record<string, unknown>
+): CampaignListQuery | undefined {
+  const { limit, cursor, state, sort, order, fields } = query
+  if (
+    [limit, cursor, state, sort, order, fields].every(
+      (param) => param === undefined
+    )
+  ) {
+    return undefined
+  }
+  for (const [name, param] of Object.entries({
+    limit,
+    cursor,
+    state,
+    sort,
+    order,
+    fields,
+  })) {
+    if (param !== undefined && typeof param !== 'string') {
+      throw new Error(`Invalid ${name}: expected a single value`)
+    }
+  }
+
+  const parsedLimit =
+    limit === undefined ? CAMPAIGN_LIST_DEFAULT_LIMIT : Number(limit)
+  if (
+    !Number.isInteger(parsedLimit) ||
+    parsedLimit < 1 ||
+    parsedLimit > CAMPAIGN_LIST_MAX_LIMIT
+  ) {
+    throw new Error(
+      `Invalid limit: ${limit} (must be an integer from 1 to ${CAMPAIGN_LIST_MAX_LIMIT})`
+    )
+  }
+
+  const parsedSort = (sort ?? 'id') as CampaignSortKey
+  if (!CAMPAIGN_SORT_KEYS.includes(parsedSort)) {
+    throw new Error(
+      `Invalid sort: ${sort} (must be one of ${CAMPAIGN_SORT_KEYS.join(', ')})`
+    )
+  }
+
+  const parsedOrder = (order ?? (parsedSort === 'id' ? 'asc' : 'desc')) as
+    | SortOrder
+  if (parsedOrder !== 'asc' && parsedOrder !== 'desc') {
+    throw new Error(`Invalid order: ${order} (must be asc or desc)`)
+  }
+
+  return {
+    limit: parsedLimit,
+    cursor: cursor as string | undefined,
+    state: state as string | undefined,
+    sort: parsedSort,
+    order: parsedOrder,
+    fields:
+      fields === undefined
+        ? undefined
+        : (fields as string)
+            .split(',')
+            .map((field) => field.trim())
+            .filter((field) => field.length > 0),
+  }
+}
+
+function compareEntries(
+  a: CampaignListEntry,
+  b: CampaignListEntry,
+  sort: CampaignSortKey
+): number {
+  const aValue = a.sortValues[sort]
+  const bValue = b.sortValues[sort]
+  if (aValue !== bValue) {
+    return aValue < bValue ? -1 : 1
+  }
+  return a.id - b.id
+}
+
+function encodeCursor(cursor: Cursor): string {
+  return Buffer.from(JSON.stringify(cursor)).toString('base64url')
+}
+
+function decodeCursor(cursorEncoded: string): Cursor {
+  try {
+    const cursor = JSON.parse(
+      Buffer.from(cursorEncoded, 'base64url').toString()
+    ) as Cursor
+    BigInt(cursor.value)
+    if (!Number.isInteger(cursor.id)) {
+      throw new Error()
+    }
+    return cursor
+  } catch {
+    throw new Error(`Invalid cursor: ${cursorEncoded}`)
+  }
+}
+
+/*
+Campaign list entries sorted by every CampaignSortKey, for all campaigns and for each campaign
+state, so a page is a binary search for the cursor plus a slice. Sorted once, then kept up to date
+with update(): each changed campaign is removed and re-inserted at its binary-searched position.
+
+Ties are broken by campaign id, and the cursor holds the last returned (sort value, id), so pages
+stay consistent when campaigns are added or change between requests.
+*/
+export class CampaignListIndex {
+  private indexes: Map<
+    string | undefined,
+    Record<CampaignSortKey, CampaignListEntry[]>
+  > = new Map()
+  private readonly entriesById: Map<number, CampaignListEntry> = new Map()
+
+  constructor(entries: CampaignListEntry[]) {
+    for (const entry of entries) {
+      this.entriesById.set(entry.id, entry)
+    }
+    this._sort()
+  }
+
+  /**
+   * Replaces the entries of changed campaigns (adding new ones) and removes removedIds.
+   */
+  update(changed: CampaignListEntry[], removedIds: number[]): void {
+    const changeCount = changed.length + removedIds.length
+    if (changeCount > this.entriesById.size * CAMPAIGN_LIST_RESORT_FRACTION) {
+      for (const id of removedIds) {
+        this.entriesById.delete(id)
+      }
+      for (const entry of changed) {
+        this.entriesById.set(entry.id, entry)
+      }
+      this._sort()
+      return
+    }
+
+    for (const id of removedIds) {
+      const entry = this.entriesById.get(id)
+      if (entry) {
+        this._remove(entry)
+        this.entriesById.delete(id)
+      }
+    }
+    for (const entry of changed) {
+      const previous = this.entriesById.get(entry.id)
+      if (previous) {
+        this._remove(previous)
+      }
+      this._insert(entry)
+      this.entriesById.set(entry.id, entry)
+    }
+  }
+
+  /**
+   * @returns the page as JSON: { campaigns, nextCursor }, nextCursor being null on the last page
+   */
+  query(query: CampaignListQuery): string {
+    const { limit, state, sort, order, fields } = query
+    const sorted = this.indexes.get(state)?.[sort] ?? []
+
+    // Step 1. Find where the page starts
+    let start = order === 'asc' ? 0 : sorted.length - 1
+    if (query.cursor !== undefined) {
+      const cursor = decodeCursor(query.cursor)
+      if (
+        cursor.sort !== sort ||
+        cursor.order !== order ||
+        cursor.state !== state
+      ) {
+        throw new Error('Invalid cursor: it belongs to a different query')
+      }
+      // Entries up to the cursor (asc) or from the cursor (desc) were already returned
+      const bound = CampaignListIndex.search(
+        sorted,
+        sort,
+        BigInt(cursor.value),
+        cursor.id,
+        order === 'asc'
+      )
+      start = order === 'asc' ? bound : bound - 1
+    }
+
+    // Step 2. Take the page
+    const step = order === 'asc' ? 1 : -1
+    const page: CampaignListEntry[] = []
+    for (
+      let i = start;
+      i >= 0 && i < sorted.length && page.length < limit;
+      i += step
+    ) {
+      page.push(sorted[i])
+    }
+
+    const last = page[page.length - 1]
+    const next = start + step * page.length
+    const nextCursor =
+      last && next >= 0 && next < sorted.length
+        ? encodeCursor({
+            sort,
+            order,
+            state,
+            value: last.sortValues[sort].toString(),
+            id: last.id,
+          })
+        : null
+    const campaigns = page.map((entry) =>
+      CampaignListIndex.project(entry, fields)
+    )
+    return `{"campaigns":[${campaigns.join(',')}],"nextCursor":${JSON.stringify(
+      nextCursor
+    )}}`
+  }
+
+  private _sort(): void {
+    const entries = [...this.entriesById.values()]
+    const entriesByState: Map<string | undefined, CampaignListEntry[]> =
+      new Map([[undefined, entries]])
+    for (const entry of entries) {
+      let stateEntries = entriesByState.get(entry.state)
+      if (!stateEntries) {
+        stateEntries = []
+        entriesByState.set(entry.state, stateEntries)
+      }
+      stateEntries.push(entry)
+    }
+
+    this.indexes = new Map()
+    for (const [state, stateEntries] of entriesByState) {
+      const sorted = {} as Record<CampaignSortKey, CampaignListEntry[]>
+      for (const sort of CAMPAIGN_SORT_KEYS) {
+        sorted[sort] = [...stateEntries].sort((a, b) =>
+          compareEntries(a, b, sort)
+        )
+      }
+      this.indexes.set(state, sorted)
+    }
+  }
+
+  // Inserts entry into the lists of all campaigns and of its state
+  private _insert(entry: CampaignListEntry): void {
+    for (const state of [undefined, entry.state]) {
+      let sorted = this.indexes.get(state)
+      if (!sorted) {
+        sorted = { id: [], raised: [], endDate: [], backers: [] }
+        this.indexes.set(state, sorted)
+      }
+      for (const sort of CAMPAIGN_SORT_KEYS) {
+        const position = CampaignListIndex.search(
+          sorted[sort],
+          sort,
+          entry.sortValues[sort],
+          entry.id,
+          false
+        )
+        sorted[sort].splice(position, 0, entry)
+      }
+    }
+  }
+
+  // Removes entry, as it was inserted, from the lists of all campaigns and of its state
+  private _remove(entry: CampaignListEntry): void {
+    for (const state of [undefined, entry.state]) {
+      const sorted = this.indexes.get(state)
+      if (!sorted) {
+        continue
+      }
+      for (const sort of CAMPAIGN_SORT_KEYS) {
+        const position = CampaignListIndex.search(
+          sorted[sort],
+          sort,
+          entry.sortValues[sort],
+          entry.id,
+          false
+        )
+        if (sorted[sort][position]?.id === entry.id) {
+          sorted[sort].splice(position, 1)
+        }
+      }
+      if (state !== undefined && sorted.id.length === 0) {
+        this.indexes.delete(state)
+      }
+    }
+  }
+
+  /**
+   * Binary search in entries sorted ascending by (sort value, id).
+   * @returns index of the first entry after (value, id), or at/after it when not exclusive
+   */
+  private static search(
+    sorted: CampaignListEntry[],
+    sort: CampaignSortKey,
+    value: bigint,
+    id: number,
+    exclusive: boolean
+  ): number {
+    let low = 0
+    let high = sorted.length
+    while (low < high) {
+      const middle = (low + high) >>> 1
+      const entry = sorted[middle]
+      const entryValue = entry.sortValues[sort]
+      const before =
+        entryValue < value ||
+        (entryValue === value && (exclusive ? entry.id <= id : entry.id < id))
+      if (before) {
+        low = middle + 1
+      } else {
+        high = middle
+      }
+    }
+    return low
+  }
+
+  // JSON of the entry with only the requested fields
+  private static project(
+    entry: CampaignListEntry,
+    fields: string[] | undefined
+  ): string {
+    if (fields === undefined) {
+      return entry.body
+    }
+    // fundTransactions and backers are only parsed back when asked for
+    const serialized = fields.some((field) => DETAIL_FIELDS.includes(field))
+      ? (JSON.parse(entry.body) as Record<string, unknown>)
+      : entry.summary
+    const projected: Record<string, unknown> = {}
+    for (const field of fields) {
+      if (field in serialized) {
+        projected[field] = serialized[field]
+      }
+    }
+    return JSON.stringify(projected)
+  }
+}
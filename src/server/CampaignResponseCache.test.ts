@@ -0,0 +1,117 @@
+import { gunzipSync } from 'zlib'
+import { ApplicationState } from '../../client/app/models/ApplicationState'
+import { FundTransaction } from '../../client/app/models/FundTransaction'
+import { createCampaign } from '../../client/app/models/testFixtures'
+import {
+  ApplicationStateReader,
+  CachedResponse,
+  CampaignResponseCache,
+} from './CampaignResponseCache'
+
+const BACKER = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+
+// Stand-in for ApplicationStateCache; reads wait for release() when blocked
+class FakeApplicationStateReader implements ApplicationStateReader {
+  applicationState = new ApplicationState([
+    createCampaign(1),
+    createCampaign(2),
+  ])
+  stateVersion = 1
+  reads = 0
+  private blocked: Array<() => void> | undefined
+
+  block(): void {
+    this.blocked = []
+  }
+
+  release(): void {
+    const blocked = this.blocked ?? []
+    this.blocked = undefined
+    blocked.forEach((resolve) => resolve())
+  }
+
+  async readApplicationState<T>(
+    reader: (applicationState: ApplicationState, stateVersion: number) => T
+  ): Promise<T> {
+    this.reads++
+    if (this.blocked) {
+      const blocked = this.blocked
+      await new Promise<void>((resolve) => blocked.push(resolve))
+    }
+    return reader(this.applicationState, this.stateVersion)
+  }
+}
+
+describe('CampaignResponseCache', () => {
+  it('should serialize campaigns like Campaign.serialize', async () => {
+    const source = new FakeApplicationStateReader()
+    source.applicationState.ledgerIndex = 10
+    const snapshot = await new CampaignResponseCache(source).getSnapshot()
+
+    expect(snapshot.ledgerIndex).toBe(10)
+    expect(snapshot.campaigns.body).toBe(
+      JSON.stringify(
+        source.applicationState.campaigns.map((campaign) =>
+          campaign.serialize()
+        )
+      )
+    )
+    expect(snapshot.campaignsById.get(2)?.body).toBe(
+      JSON.stringify(createCampaign(2).serialize())
+    )
+  })
+
+  it('should only rebuild responses that changed', async () => {
+    const source = new FakeApplicationStateReader()
+    const cache = new CampaignResponseCache(source)
+    const first = await cache.refresh()
+
+    // Same state version: the snapshot is reused as is
+    source.applicationState.ledgerIndex = 11
+    const second = await cache.refresh()
+    expect(second).toBe(first)
+    expect(second.ledgerIndex).toBe(11)
+
+    // Campaign 2 changed: only its response and the list get new ETags
+    source.applicationState.setFundTransaction(
+      2,
+      new FundTransaction(0, BACKER, 'approve', BigInt(100))
+    )
+    source.stateVersion++
+    const third = await cache.refresh()
+    expect(third).not.toBe(first)
+    expect(third.campaignsById.get(1)).toBe(first.campaignsById.get(1))
+    expect(third.campaignsById.get(2)?.etag).not.toBe(
+      first.campaignsById.get(2)?.etag
+    )
+    expect(third.campaigns.etag).not.toBe(first.campaigns.etag)
+  })
+
+  it('should serve the last snapshot while a refresh runs', async () => {
+    const source = new FakeApplicationStateReader()
+    const cache = new CampaignResponseCache(source)
+    const first = await cache.getSnapshot()
+
+    source.block()
+    source.applicationState.setCampaign(createCampaign(3))
+    source.stateVersion++
+    expect(await cache.getSnapshot()).toBe(first)
+    expect(await cache.getSnapshot()).toBe(first)
+    // Refreshes don't pile up while one is running
+    expect(source.reads).toBe(2)
+
+    source.release()
+    await cache.refresh()
+    expect((await cache.getSnapshot()).campaignsById.has(3)).toBe(true)
+  })
+
+  it('should gzip a response once', async () => {
+    const response = new CachedResponse(
+      JSON.stringify({ title: 'a'.repeat(2000) })
+    )
+    const gzipped = await response.getGzipped()
+    expect(await response.getGzipped()).toBe(gzipped)
+    expect(gunzipSync(gzipped).toString()).toBe(response.body)
+    expect(response.etag).toBe(new CachedResponse(response.body).etag)
+  })
+})
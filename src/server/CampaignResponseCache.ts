@@ -0,0 +1,287 @@
+import { createHash } from 'crypto'
+import { Express, Request, Response } from 'express'
+import { promisify } from 'util'
+import { gzip } from 'zlib'
+import { ApplicationState } from '../../client/app/models/ApplicationState'
+import { Campaign } from '../../client/app/models/Campaign'
+import {
+  CampaignListEntry,
+  CampaignListIndex,
+  createCampaignListEntry,
+  parseCampaignListQuery,
+} from './CampaignListIndex'
+
+const gzipAsync = promisify(gzip)
+
+// Smaller bodies aren't worth compressing
+const GZIP_MIN_BYTES = 1024
+
+export interface ApplicationStateReader {
+  readApplicationState<T>(
+    reader: (applicationState: ApplicationState, stateVersion: number) => T
+  ): Promise<T>
+}
+
+export class CachedResponse {
+  readonly body: string
+  readonly etag: string
+  private gzipped?: Promise<Buffer>
+
+  constructor(body: string) {
+    this.body = body
+    this.etag = `"${createHash('sha1').update(body).digest('base64url')}"`
+  }
+
+  // Compressed on first use, then kept with the response
+  getGzipped(): Promise<Buffer> {
+    if (!this.gzipped) {
+      this.gzipped = gzipAsync(this.body)
+    }
+    return this.gzipped
+  }
+}
+
+export interface CampaignsSnapshot {
+  stateVersion: number
+  // Validated ledger the state was at when the snapshot was last checked
+  ledgerIndex?: number
+  campaigns: CachedResponse
+  campaignsById: Map<number, CachedResponse>
+  // Sorted indexes for paged, filtered and projected listings
+  campaignList: CampaignListIndex
+  campaignListEntries: Map<number, CampaignListEntry>
+}
+
+// Where the read routes get snapshots: CampaignResponseCache, or SharedCampaignSnapshots in a cluster worker
+export interface CampaignSnapshotSource {
+  getSnapshot(): Promise<CampaignsSnapshot>
+  // False until the first snapshot is built; getSnapshot waits for it until then
+  hasSnapshot(): boolean
+}
+
+// Reads one campaign without a snapshot, e.g. CampaignViewReader.getCampaign
+export type CampaignReader = (
+  campaignId: number
+) => Promise<Campaign | undefined>
+
+/*
+Serialized GET /campaigns and GET /campaigns/:id responses, rebuilt only when the
+ApplicationStateCache state version changes. ETags are hashes of the body, so a response that
+didn't change keeps its ETag across rebuilds (and server restarts) and polls get 304s.
+
+Once a snapshot exists it's served right away, and a refresh runs in the background (one at a
+time), so requests never wait on a Hook State reload.
+*/
+export class CampaignResponseCache implements CampaignSnapshotSource {
+  private readonly source: ApplicationStateReader
+  private snapshot: CampaignsSnapshot | undefined
+  private refreshing: Promise<CampaignsSnapshot> | undefined
+
+  constructor(source: ApplicationStateReader) {
+    this.source = source
+  }
+
+  async getSnapshot(): Promise<CampaignsSnapshot> {
+    if (!this.snapshot) {
+      return this.refresh()
+    }
+    this.refresh().catch((error) => {
+      console.error(`CampaignResponseCache failed to refresh: ${error}`)
+    })
+    return this.snapshot
+  }
+
+  hasSnapshot(): boolean {
+    return this.snapshot !== undefined
+  }
+
+  refresh(): Promise<CampaignsSnapshot> {
+    if (!this.refreshing) {
+      this.refreshing = this.source
+        .readApplicationState((applicationState, stateVersion) =>
+          this.buildSnapshot(applicationState, stateVersion)
+        )
+        .then((snapshot) => {
+          this.snapshot = snapshot
+          return snapshot
+        })
+        .finally(() => {
+          this.refreshing = undefined
+        })
+    }
+    return this.refreshing
+  }
+
+  private buildSnapshot(
+    applicationState: ApplicationState,
+    stateVersion: number
+  ): CampaignsSnapshot {
+    const previous = this.snapshot
+    if (previous && previous.stateVersion === stateVersion) {
+      previous.ledgerIndex = applicationState.ledgerIndex
+      return previous
+    }
+
+    const campaignBodies: Array<[number, string]> =
+      applicationState.campaigns.map((campaign) => [
+        campaign.id,
+        JSON.stringify(campaign.serialize()),
+      ])
+    return buildCampaignsSnapshot(
+      campaignBodies,
+      stateVersion,
+      applicationState.ledgerIndex,
+      previous
+    )
+  }
+}
+
+/**
+ * Builds a snapshot from serialized campaigns, reusing previous's responses (and their gzip) and
+ * list entries for campaigns whose JSON didn't change. previous's campaign list index is taken
+ * over and updated with only the changed and removed campaigns.
+ */
+export function buildCampaignsSnapshot(
+  campaignBodies: Array<[number, string]>,
+  stateVersion: number,
+  ledgerIndex: number | undefined,
+  previous?: CampaignsSnapshot
+): CampaignsSnapshot {
+  // Step 1. Index each campaign
+  const campaignsById: Map<number, CachedResponse> = new Map()
+  const campaignListEntries: Map<number, CampaignListEntry> = new Map()
+  const changedListEntries: CampaignListEntry[] = []
+  const bodies: string[] = []
+  for (const [campaignId, body] of campaignBodies) {
+    const previousResponse = previous?.campaignsById.get(campaignId)
+    const previousListEntry = previous?.campaignListEntries.get(campaignId)
+    if (previousResponse && previousListEntry?.body === body) {
+      campaignsById.set(campaignId, previousResponse)
+      campaignListEntries.set(campaignId, previousListEntry)
+    } else {
+      const listEntry = createCampaignListEntry(body)
+      campaignsById.set(campaignId, new CachedResponse(body))
+      campaignListEntries.set(campaignId, listEntry)
+      changedListEntries.push(listEntry)
+    }
+    bodies.push(body)
+  }
+
+  // Step 2. The list is the same JSON as stringifying the serialized array
+  const campaignsBody = `[${bodies.join(',')}]`
+  const campaigns =
+    previous?.campaigns.body === campaignsBody
+      ? previous.campaigns
+      : new CachedResponse(campaignsBody)
+
+  // Step 3. Update the sorted indexes with what changed since previous
+  let campaignList: CampaignListIndex
+  if (previous) {
+    const removedIds = [...previous.campaignListEntries.keys()].filter(
+      (campaignId) => !campaignListEntries.has(campaignId)
+    )
+    campaignList = previous.campaignList
+    campaignList.update(changedListEntries, removedIds)
+  } else {
+    campaignList = new CampaignListIndex([...campaignListEntries.values()])
+  }
+
+  return {
+    stateVersion,
+    ledgerIndex,
+    campaigns,
+    campaignsById,
+    campaignList,
+    campaignListEntries,
+  }
+}
+
+/**
+ * Sends a cached JSON response, or 304 when If-None-Match matches its ETag.
+ * The body is gzipped when the client accepts it.
+ */
+export async function sendCachedResponse(
+  req: Request,
+  res: Response,
+  response: CachedResponse,
+  ledgerIndex: number | undefined
+): Promise<void> {
+  res.set('X-Ledger-Index', String(ledgerIndex))
+  res.set('ETag', response.etag)
+  // Clients may keep the response but must revalidate it
+  res.set('Cache-Control', 'no-cache')
+  res.set('Vary', 'Accept-Encoding')
+
+  if (req.fresh) {
+    res.status(304).end()
+    return
+  }
+
+  res.type('json')
+  if (
+    response.body.length >= GZIP_MIN_BYTES &&
+    req.acceptsEncodings('gzip') === 'gzip'
+  ) {
+    const gzipped = await response.getGzipped()
+    res.set('Content-Encoding', 'gzip')
+    res.send(gzipped)
+    return
+  }
+  res.send(response.body)
+}
+
+/**
+ * Registers GET /campaigns and GET /campaigns/:id, served from snapshots. Until the first snapshot
+ * is built (it waits on the whole Hook State), GET /campaigns/:id reads the campaign with
+ * readCampaign when one is given.
+ */
+export function registerCampaignReadRoutes(
+  app: Express,
+  snapshots: CampaignSnapshotSource,
+  readCampaign?: CampaignReader
+): void {
+  app.get('/campaigns', async (req: Request, res: Response) => {
+    try {
+      const snapshot = await snapshots.getSnapshot()
+
+      // Without list parameters every campaign is returned in full
+      let response = snapshot.campaigns
+      try {
+        const listQuery = parseCampaignListQuery(req.query)
+        if (listQuery) {
+          response = new CachedResponse(snapshot.campaignList.query(listQuery))
+        }
+      } catch (err: any) {
+        res.status(400).send(err.message)
+        return
+      }
+      await sendCachedResponse(req, res, response, snapshot.ledgerIndex)
+    } catch (err: any) {
+      res.status(500).send(err.message)
+    }
+  })
+
+  app.get('/campaigns/:id', async (req: Request, res: Response) => {
+    try {
+      const id = parseInt(req.params.id)
+      if (readCampaign && !snapshots.hasSnapshot()) {
+        const campaign = await readCampaign(id)
+        if (!campaign) {
+          throw new Error(`Campaign with ID ${id} not found`)
+        }
+        const body = JSON.stringify(campaign.serialize())
+        await sendCachedResponse(req, res, new CachedResponse(body), undefined)
+        return
+      }
+
+      const snapshot = await snapshots.getSnapshot()
+      const campaign = snapshot.campaignsById.get(id)
+      if (!campaign) {
+        throw new Error(`Campaign with ID ${id} not found`)
+      }
+      await sendCachedResponse(req, res, campaign, snapshot.ledgerIndex)
+    } catch (err: any) {
+      res.status(500).send(err.message)
+    }
+  })
+}
@@ -0,0 +1,163 @@
+import fs from 'fs'
+import os from 'os'
+import path from 'path'
+import { createCampaign } from '../../client/app/models/testFixtures'
+import { buildCampaignsSnapshot } from './CampaignResponseCache'
+import {
+  readCampaignSnapshotFile,
+  SharedCampaignSnapshots,
+  writeCampaignSnapshotFile,
+} from './CampaignSnapshotFile'
+
+function createCampaignBody(
+  id: number,
+  totalAmountRaisedInDrops = 0
+): [number, string] {
+  const campaign = createCampaign(id, {
+    description: 'description\twith a tab',
+    totalAmountRaisedInDrops: BigInt(totalAmountRaisedInDrops),
+  })
+  return [id, JSON.stringify(campaign.serialize())]
+}
+
+describe('CampaignSnapshotFile', () => {
+  let dir: string
+
+  beforeEach(async () => {
+    dir = await fs.promises.mkdtemp(path.join(os.tmpdir(), 'snapshot-test-'))
+  })
+
+  afterEach(async () => {
+    await fs.promises.rm(dir, { recursive: true, force: true })
+  })
+
+  it('should read back the snapshot that was written', async () => {
+    const snapshot = buildCampaignsSnapshot(
+      [createCampaignBody(1), createCampaignBody(2)],
+      3,
+      10
+    )
+    const file = await writeCampaignSnapshotFile(dir, snapshot)
+    expect(path.basename(file)).toBe('campaigns-3.snapshot')
+
+    const read = await readCampaignSnapshotFile(file)
+    expect(read.stateVersion).toBe(3)
+    expect(read.ledgerIndex).toBe(10)
+    expect(read.campaigns.body).toBe(snapshot.campaigns.body)
+    expect(read.campaigns.etag).toBe(snapshot.campaigns.etag)
+    expect(read.campaignsById.get(2)?.body).toBe(
+      snapshot.campaignsById.get(2)?.body
+    )
+  })
+
+  it('should reuse responses of campaigns that did not change', async () => {
+    const previous = await readCampaignSnapshotFile(
+      await writeCampaignSnapshotFile(
+        dir,
+        buildCampaignsSnapshot(
+          [createCampaignBody(1), createCampaignBody(2)],
+          1,
+          10
+        )
+      )
+    )
+    const read = await readCampaignSnapshotFile(
+      await writeCampaignSnapshotFile(
+        dir,
+        buildCampaignsSnapshot(
+          [createCampaignBody(1), createCampaignBody(2, 100)],
+          2,
+          11
+        )
+      ),
+      previous
+    )
+    expect(read.campaignsById.get(1)).toBe(previous.campaignsById.get(1))
+    expect(read.campaignsById.get(2)).not.toBe(previous.campaignsById.get(2))
+  })
+
+  it('should reject a truncated file', async () => {
+    const file = await writeCampaignSnapshotFile(
+      dir,
+      buildCampaignsSnapshot(
+        [createCampaignBody(1), createCampaignBody(2)],
+        1,
+        10
+      )
+    )
+    const lines = (await fs.promises.readFile(file, 'utf8')).split('\n')
+    await fs.promises.writeFile(file, lines.slice(0, 2).join('\n'))
+    await expect(readCampaignSnapshotFile(file)).rejects.toThrow(
+      'Invalid campaign snapshot file'
+    )
+  })
+})
+
+describe('SharedCampaignSnapshots', () => {
+  it('should wait for the first snapshot, then follow messages', async () => {
+    const dir = await fs.promises.mkdtemp(
+      path.join(os.tmpdir(), 'snapshot-test-')
+    )
+    const snapshots = new SharedCampaignSnapshots()
+    const first = snapshots.getSnapshot()
+
+    const file = await writeCampaignSnapshotFile(
+      dir,
+      buildCampaignsSnapshot([createCampaignBody(1)], 1, 10)
+    )
+    await snapshots.update({
+      type: 'campaignSnapshot',
+      path: file,
+      stateVersion: 1,
+      ledgerIndex: 10,
+    })
+    expect((await first).stateVersion).toBe(1)
+
+    // Same state at a new ledger: the file isn't read again
+    await fs.promises.rm(dir, { recursive: true, force: true })
+    await snapshots.update({
+      type: 'campaignSnapshot',
+      path: file,
+      stateVersion: 1,
+      ledgerIndex: 11,
+    })
+    const snapshot = await snapshots.getSnapshot()
+    expect(snapshot).toBe(await first)
+    expect(snapshot.ledgerIndex).toBe(11)
+  })
+  it('should read the newest snapshot when an older file was removed', async () => {
+    const dir = await fs.promises.mkdtemp(
+      path.join(os.tmpdir(), 'snapshot-test-')
+    )
+    const snapshots = new SharedCampaignSnapshots()
+    const [removed, newest] = await Promise.all(
+      [1, 2].map((stateVersion) =>
+        writeCampaignSnapshotFile(
+          dir,
+          buildCampaignsSnapshot([createCampaignBody(1)], stateVersion, 10)
+        )
+      )
+    )
+    // The leader removed the older file before this worker got to it
+    await fs.promises.rm(removed)
+
+    const updated = snapshots.update({
+      type: 'campaignSnapshot',
+      path: removed,
+      stateVersion: 1,
+      ledgerIndex: 10,
+    })
+    snapshots.update({
+      type: 'campaignSnapshot',
+      path: newest,
+      stateVersion: 2,
+      ledgerIndex: 11,
+    })
+    await updated
+
+    const snapshot = await snapshots.getSnapshot()
+    expect(snapshot.stateVersion).toBe(2)
+    expect(snapshot.ledgerIndex).toBe(11)
+    await fs.promises.rm(dir, { recursive: true, force: true })
+  })
+})
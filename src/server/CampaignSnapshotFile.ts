@@ -0,0 +1,262 @@
+import fs from 'fs'
+import os from 'os'
+import path from 'path'
+import {
+  buildCampaignsSnapshot,
+  CampaignResponseCache,
+  CampaignSnapshotSource,
+  CampaignsSnapshot,
+} from './CampaignResponseCache'
+import { CampaignChangeSource } from './CampaignUpdateHub'
+
+// Snapshots are also published on this interval, so workers see new ledger indexes
+const PUBLISH_INTERVAL_MS = 1000
+// The previous file is kept for workers that are still reading it
+const SNAPSHOT_FILES_KEPT = 2
+
+interface CampaignSnapshotHeader {
+  stateVersion: number
+  ledgerIndex?: number
+  count: number
+}
+
+// Sent from the cluster leader to its workers over IPC
+export interface CampaignSnapshotMessage {
+  type: 'campaignSnapshot'
+  path: string
+  stateVersion: number
+  ledgerIndex?: number
+}
+
+export function isCampaignSnapshotMessage(
+  message: unknown
+): message is CampaignSnapshotMessage {
+  return (
+    typeof message === 'object' &&
+    message !== null &&
+    (message as CampaignSnapshotMessage).type === 'campaignSnapshot'
+  )
+}
+
+/**
+ * Creates a directory for snapshot files, on tmpfs (/dev/shm) when there is one so reading a
+ * snapshot is a memory copy. CLUSTER_SNAPSHOT_DIR overrides where it's created.
+ */
+export function createCampaignSnapshotDir(): Promise<string> {
+  const parent =
+    process.env.CLUSTER_SNAPSHOT_DIR ||
+    (fs.existsSync('/dev/shm') ? '/dev/shm' : os.tmpdir())
+  return fs.promises.mkdtemp(path.join(parent, 'xrpl-crowdfund-'))
+}
+
+/**
+ * Writes snapshot as a JSON header line followed by one "<id>\t<campaign JSON>" line per
+ * campaign. The file is written under a temporary name and renamed, so readers never see a
+ * partial snapshot.
+ * @returns path of the file
+ */
+export async function writeCampaignSnapshotFile(
+  dir: string,
+  snapshot: CampaignsSnapshot
+): Promise<string> {
+  const header: CampaignSnapshotHeader = {
+    stateVersion: snapshot.stateVersion,
+    ledgerIndex: snapshot.ledgerIndex,
+    count: snapshot.campaignListEntries.size,
+  }
+  const lines = [JSON.stringify(header)]
+  for (const [campaignId, entry] of snapshot.campaignListEntries) {
+    lines.push(`${campaignId}\t${entry.body}`)
+  }
+
+  const file = path.join(dir, `campaigns-${snapshot.stateVersion}.snapshot`)
+  const temporaryFile = `${file}.tmp`
+  await fs.promises.writeFile(temporaryFile, lines.join('\n'))
+  await fs.promises.rename(temporaryFile, file)
+  return file
+}
+
+/**
+ * Reads a snapshot written by writeCampaignSnapshotFile, reusing previous's responses for
+ * campaigns that didn't change.
+ */
+export async function readCampaignSnapshotFile(
+  file: string,
+  previous?: CampaignsSnapshot
+): Promise<CampaignsSnapshot> {
+  const lines = (await fs.promises.readFile(file, 'utf8')).split('\n')
+  const header: CampaignSnapshotHeader = JSON.parse(lines[0])
+  const count = lines.length - 1
+  if (count !== header.count) {
+    throw new Error(
+      `Invalid campaign snapshot file: ${file} (expected ${header.count} campaigns, found ${count})`
+    )
+  }
+
+  const campaignBodies: Array<[number, string]> = lines
+    .slice(1)
+    .map((line): [number, string] => {
+      const separator = line.indexOf('\t')
+      return [Number(line.slice(0, separator)), line.slice(separator + 1)]
+    })
+  return buildCampaignsSnapshot(
+    campaignBodies,
+    header.stateVersion,
+    header.ledgerIndex,
+    previous
+  )
+}
+
+/*
+Runs in the cluster leader. Writes a snapshot file whenever the CampaignResponseCache snapshot
+changes, and sends a CampaignSnapshotMessage for it (or for a new ledger index) to the workers.
+*/
+export class CampaignSnapshotPublisher {
+  private readonly responseCache: CampaignResponseCache
+  private readonly changeSource: CampaignChangeSource
+  private readonly dir: string
+  private readonly send: (message: CampaignSnapshotMessage) => void
+  private readonly files: string[] = []
+  private latest: CampaignSnapshotMessage | undefined
+  private publishing: Promise<void> = Promise.resolve()
+  private removeListener: (() => void) | undefined
+  private interval: NodeJS.Timeout | undefined
+
+  constructor(
+    responseCache: CampaignResponseCache,
+    changeSource: CampaignChangeSource,
+    dir: string,
+    send: (message: CampaignSnapshotMessage) => void
+  ) {
+    this.responseCache = responseCache
+    this.changeSource = changeSource
+    this.dir = dir
+    this.send = send
+  }
+
+  // Last message sent, for workers that start later
+  get latestMessage(): CampaignSnapshotMessage | undefined {
+    return this.latest
+  }
+
+  start(): void {
+    this.removeListener = this.changeSource.onCampaignsChanged(() => {
+      this.publish()
+    })
+    this.interval = setInterval(() => this.publish(), PUBLISH_INTERVAL_MS)
+    this.publish()
+  }
+
+  stop(): void {
+    this.removeListener?.()
+    this.removeListener = undefined
+    clearInterval(this.interval)
+    this.interval = undefined
+  }
+
+  publish(): Promise<void> {
+    this.publishing = this.publishing
+      .then(() => this._publish())
+      .catch((error) => {
+        console.error(`CampaignSnapshotPublisher failed to publish: ${error}`)
+      })
+    return this.publishing
+  }
+
+  private async _publish(): Promise<void> {
+    const snapshot = await this.responseCache.refresh()
+    const { stateVersion, ledgerIndex } = snapshot
+    if (
+      this.latest?.stateVersion === stateVersion &&
+      this.latest.ledgerIndex === ledgerIndex
+    ) {
+      return
+    }
+
+    // Step 1. Only a new state needs a new file
+    let file = this.latest?.path
+    if (!file || this.latest?.stateVersion !== stateVersion) {
+      file = await writeCampaignSnapshotFile(this.dir, snapshot)
+      this.files.push(file)
+      while (this.files.length > SNAPSHOT_FILES_KEPT) {
+        await fs.promises.rm(this.files.shift() as string, { force: true })
+      }
+    }
+
+    // Step 2. Tell the workers
+    this.latest = {
+      type: 'campaignSnapshot',
+      path: file,
+      stateVersion,
+      ledgerIndex,
+    }
+    this.send(this.latest)
+  }
+}
+
+/*
+Runs in a cluster worker. Holds the latest snapshot published by the leader; requests wait for
+the first one.
+
+The leader only keeps SNAPSHOT_FILES_KEPT files, so a worker that falls behind can be sent a file
+that's already removed. Each update reads the newest message received so far, and a file that's gone
+is retried with the newest one.
+*/
+export class SharedCampaignSnapshots implements CampaignSnapshotSource {
+  private snapshot: CampaignsSnapshot | undefined
+  private newestMessage: CampaignSnapshotMessage | undefined
+  private loading: Promise<void> = Promise.resolve()
+  private readonly firstSnapshot: Promise<CampaignsSnapshot>
+  private resolveFirstSnapshot: (snapshot: CampaignsSnapshot) => void = () =>
+    undefined
+
+  constructor() {
+    this.firstSnapshot = new Promise((resolve) => {
+      this.resolveFirstSnapshot = resolve
+    })
+  }
+
+  getSnapshot(): Promise<CampaignsSnapshot> {
+    return this.snapshot ? Promise.resolve(this.snapshot) : this.firstSnapshot
+  }
+
+  hasSnapshot(): boolean {
+    return this.snapshot !== undefined
+  }
+
+  // Messages arrive in publish order, so the last one received is the newest
+  update(message: CampaignSnapshotMessage): Promise<void> {
+    this.newestMessage = message
+    this.loading = this.loading
+      .then(() => this._load())
+      .catch((error) => {
+        console.error(`Failed to read campaign snapshot: ${error}`)
+      })
+    return this.loading
+  }
+
+  private async _load(): Promise<void> {
+    let message = this.newestMessage as CampaignSnapshotMessage
+    if (this.snapshot?.stateVersion === message.stateVersion) {
+      this.snapshot.ledgerIndex = message.ledgerIndex
+      return
+    }
+
+    let snapshot: CampaignsSnapshot
+    for (;;) {
+      try {
+        snapshot = await readCampaignSnapshotFile(message.path, this.snapshot)
+        break
+      } catch (error: Error | any) {
+        // Removed by the leader; a newer file was published before that
+        if (error?.code !== 'ENOENT' || this.newestMessage === message) {
+          throw error
+        }
+        message = this.newestMessage as CampaignSnapshotMessage
+      }
+    }
+    snapshot.ledgerIndex = message.ledgerIndex
+    this.snapshot = snapshot
+    this.resolveFirstSnapshot(snapshot)
+  }
+}
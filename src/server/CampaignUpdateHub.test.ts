@@ -0,0 +1,119 @@
+import { ApplicationState } from '../../client/app/models/ApplicationState'
+import { FundTransaction } from '../../client/app/models/FundTransaction'
+import { Milestone } from '../../client/app/models/Milestone'
+import { createCampaign as createCampaignFixture } from '../../client/app/models/testFixtures'
+import { CampaignsChangedListener } from '../../client/util/ApplicationStateCache'
+import {
+  CampaignChangeSource,
+  CampaignDelta,
+  CampaignUpdateHub,
+} from './CampaignUpdateHub'
+
+const BACKER = 'rN7n7otQDd6FczFgLdSqtcsAUxDkw6fzRH'
+
+const createCampaign = (id: number, totalAmountRaisedInDrops = 0) =>
+  createCampaignFixture(id, {
+    totalAmountRaisedInDrops: BigInt(totalAmountRaisedInDrops),
+    milestones: [
+      new Milestone('unstarted', BigInt(1710000000), 100, 'Milestone 1'),
+    ],
+  })
+
+// Stand-in for ApplicationStateCache that notifies listeners on change()
+class FakeCampaignChangeSource implements CampaignChangeSource {
+  applicationState = new ApplicationState([
+    createCampaign(1),
+    createCampaign(2),
+  ])
+  listeners: Set<CampaignsChangedListener> = new Set()
+
+  async readApplicationState<T>(
+    reader: (applicationState: ApplicationState, stateVersion: number) => T
+  ): Promise<T> {
+    return reader(this.applicationState, 0)
+  }
+
+  onCampaignsChanged(listener: CampaignsChangedListener): () => void {
+    this.listeners.add(listener)
+    return () => this.listeners.delete(listener)
+  }
+
+  change(campaignIds: number[]): void {
+    this.listeners.forEach((listener) =>
+      listener(campaignIds, this.applicationState)
+    )
+  }
+}
+
+function createSubscriber() {
+  const deltas: CampaignDelta[] = []
+  return { deltas, send: (delta: CampaignDelta) => deltas.push(delta) }
+}
+
+describe('CampaignUpdateHub', () => {
+  it('should send the current state, then only what changed', async () => {
+    const source = new FakeCampaignChangeSource()
+    source.applicationState.ledgerIndex = 10
+    const hub = new CampaignUpdateHub(source)
+    hub.start()
+    const subscriber = createSubscriber()
+    await hub.subscribe([1], subscriber)
+
+    expect(subscriber.deltas).toEqual([
+      {
+        id: 1,
+        ledgerIndex: 10,
+        state: 'fundRaise',
+        totalAmountRaisedInDrops: '0',
+        totalAmountNonRefundableInDrops: '0',
+        totalRejectVotesForCurrentMilestone: 0,
+        milestones: [{ index: 0, state: 'unstarted' }],
+      },
+    ])
+
+    // A backer funds campaign 1
+    source.applicationState.ledgerIndex = 11
+    source.applicationState.setCampaign(createCampaign(1, 100))
+    source.applicationState.setFundTransaction(
+      1,
+      new FundTransaction(0, BACKER, 'approve', BigInt(100))
+    )
+    source.change([1])
+    expect(subscriber.deltas[1]).toEqual({
+      id: 1,
+      ledgerIndex: 11,
+      totalAmountRaisedInDrops: '100',
+      fundTransactions: [
+        { id: 0, account: BACKER, state: 'approve', amountInDrops: '100' },
+      ],
+    })
+
+    // Nothing changed
+    source.change([1])
+    expect(subscriber.deltas).toHaveLength(2)
+  })
+
+  it('should only send deltas for subscribed campaigns', async () => {
+    const source = new FakeCampaignChangeSource()
+    const hub = new CampaignUpdateHub(source)
+    hub.start()
+    const first = createSubscriber()
+    const second = createSubscriber()
+    const unsubscribeFirst = await hub.subscribe([1], first)
+    await hub.subscribe([1, 2], second)
+
+    source.applicationState.setCampaign(createCampaign(2, 50))
+    source.change([2])
+    expect(first.deltas.map(({ id }) => id)).toEqual([1])
+    expect(second.deltas.map(({ id }) => id)).toEqual([1, 2, 2])
+
+    unsubscribeFirst()
+    source.applicationState.setCampaign(createCampaign(1, 50))
+    source.change([1])
+    expect(first.deltas).toHaveLength(1)
+    expect(second.deltas).toHaveLength(4)
+
+    hub.stop()
+    expect(source.listeners.size).toBe(0)
+  })
+})
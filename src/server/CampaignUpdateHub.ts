@@ -0,0 +1,222 @@
+import { ApplicationState } from '../../client/app/models/ApplicationState'
+import { Campaign } from '../../client/app/models/Campaign'
+import { CampaignsChangedListener } from '../../client/util/ApplicationStateCache'
+import { ApplicationStateReader } from './CampaignResponseCache'
+
+export const CAMPAIGN_UPDATES_MAX_CAMPAIGN_IDS = 100
+
+export interface CampaignChangeSource extends ApplicationStateReader {
+  onCampaignsChanged(listener: CampaignsChangedListener): () => void
+}
+
+/*
+Changes to a campaign since the previous delta; only fields that changed are set. The first
+delta a subscriber gets for a campaign has every field, and all its fund transactions.
+*/
+export interface CampaignDelta {
+  id: number
+  ledgerIndex?: number
+  state?: string
+  totalAmountRaisedInDrops?: string
+  totalAmountNonRefundableInDrops?: string
+  totalRejectVotesForCurrentMilestone?: number
+  milestones?: Array<{ index: number; state: string }>
+  // Added fund transactions, and ones whose state changed (e.g. refunded)
+  fundTransactions?: object[]
+}
+
+export interface CampaignUpdateSubscriber {
+  send(delta: CampaignDelta): void
+}
+
+// What was last sent for a campaign, to compute the next delta from
+interface CampaignView {
+  state: string
+  totalAmountRaisedInDrops: bigint
+  totalAmountNonRefundableInDrops: bigint
+  totalRejectVotesForCurrentMilestone: number
+  milestoneStates: string[]
+  fundTransactionStates: string[]
+}
+
+function toCampaignView(campaign: Campaign): CampaignView {
+  return {
+    state: campaign.state,
+    totalAmountRaisedInDrops: campaign.totalAmountRaisedInDrops,
+    totalAmountNonRefundableInDrops: campaign.totalAmountNonRefundableInDrops,
+    totalRejectVotesForCurrentMilestone:
+      campaign.totalRejectVotesForCurrentMilestone,
+    milestoneStates: campaign.milestones.map((milestone) => milestone.state),
+    fundTransactionStates: campaign.fundTransactions.map(
+      (fundTransaction) => fundTransaction.state
+    ),
+  }
+}
+
+/**
+ * @returns the campaign's changes since view, or undefined if nothing changed
+ */
+export function diffCampaign(
+  view: CampaignView | undefined,
+  campaign: Campaign,
+  ledgerIndex: number | undefined
+): CampaignDelta | undefined {
+  const delta: CampaignDelta = { id: campaign.id, ledgerIndex }
+  let changed = false
+
+  if (view?.state !== campaign.state) {
+    delta.state = campaign.state
+    changed = true
+  }
+  if (view?.totalAmountRaisedInDrops !== campaign.totalAmountRaisedInDrops) {
+    delta.totalAmountRaisedInDrops =
+      campaign.totalAmountRaisedInDrops.toString()
+    changed = true
+  }
+  if (
+    view?.totalAmountNonRefundableInDrops !==
+    campaign.totalAmountNonRefundableInDrops
+  ) {
+    delta.totalAmountNonRefundableInDrops =
+      campaign.totalAmountNonRefundableInDrops.toString()
+    changed = true
+  }
+  if (
+    view?.totalRejectVotesForCurrentMilestone !==
+    campaign.totalRejectVotesForCurrentMilestone
+  ) {
+    delta.totalRejectVotesForCurrentMilestone =
+      campaign.totalRejectVotesForCurrentMilestone
+    changed = true
+  }
+
+  const milestones: Array<{ index: number; state: string }> = []
+  campaign.milestones.forEach((milestone, index) => {
+    if (view?.milestoneStates[index] !== milestone.state) {
+      milestones.push({ index, state: milestone.state })
+    }
+  })
+  if (milestones.length > 0) {
+    delta.milestones = milestones
+    changed = true
+  }
+
+  const fundTransactions: object[] = []
+  campaign.fundTransactions.forEach((fundTransaction, index) => {
+    // fundTransactions is positioned by id, so it may have holes
+    if (
+      fundTransaction &&
+      view?.fundTransactionStates[index] !== fundTransaction.state
+    ) {
+      fundTransactions.push(fundTransaction.serialize())
+    }
+  })
+  if (fundTransactions.length > 0) {
+    delta.fundTransactions = fundTransactions
+    changed = true
+  }
+
+  return changed ? delta : undefined
+}
+
+/*
+Fans ApplicationStateCache campaign changes out to subscribers of those campaigns, as deltas.
+All subscribers share the cache's single XRPL subscription, and deltas are only computed for
+campaigns someone is subscribed to.
+*/
+export class CampaignUpdateHub {
+  private readonly source: CampaignChangeSource
+  private readonly subscribers: Map<number, Set<CampaignUpdateSubscriber>> =
+    new Map()
+  private readonly views: Map<number, CampaignView> = new Map()
+  private removeListener: (() => void) | undefined
+
+  constructor(source: CampaignChangeSource) {
+    this.source = source
+  }
+
+  start(): void {
+    if (!this.removeListener) {
+      this.removeListener = this.source.onCampaignsChanged(
+        this._onCampaignsChanged
+      )
+    }
+  }
+
+  stop(): void {
+    this.removeListener?.()
+    this.removeListener = undefined
+  }
+
+  /**
+   * Subscribes to campaignIds and sends the current state of each existing campaign right away.
+   * @returns a function that unsubscribes
+   */
+  async subscribe(
+    campaignIds: number[],
+    subscriber: CampaignUpdateSubscriber
+  ): Promise<() => void> {
+    await this.source.readApplicationState((applicationState) => {
+      for (const campaignId of campaignIds) {
+        let campaignSubscribers = this.subscribers.get(campaignId)
+        if (!campaignSubscribers) {
+          campaignSubscribers = new Set()
+          this.subscribers.set(campaignId, campaignSubscribers)
+        }
+        campaignSubscribers.add(subscriber)
+
+        const campaign = applicationState.getCampaignById(campaignId)
+        if (campaign) {
+          if (!this.views.has(campaignId)) {
+            this.views.set(campaignId, toCampaignView(campaign))
+          }
+          const delta = diffCampaign(
+            undefined,
+            campaign,
+            applicationState.ledgerIndex
+          )
+          if (delta) {
+            subscriber.send(delta)
+          }
+        }
+      }
+    })
+
+    return () => {
+      for (const campaignId of campaignIds) {
+        const campaignSubscribers = this.subscribers.get(campaignId)
+        campaignSubscribers?.delete(subscriber)
+        if (campaignSubscribers?.size === 0) {
+          this.subscribers.delete(campaignId)
+          this.views.delete(campaignId)
+        }
+      }
+    }
+  }
+
+  private _onCampaignsChanged = (
+    campaignIds: number[],
+    applicationState: ApplicationState
+  ): void => {
+    for (const campaignId of campaignIds) {
+      const campaignSubscribers = this.subscribers.get(campaignId)
+      const campaign = applicationState.getCampaignById(campaignId)
+      if (!campaignSubscribers || !campaign) {
+        continue
+      }
+
+      const delta = diffCampaign(
+        this.views.get(campaignId),
+        campaign,
+        applicationState.ledgerIndex
+      )
+      this.views.set(campaignId, toCampaignView(campaign))
+      if (!delta) {
+        continue
+      }
+      for (const subscriber of campaignSubscribers) {
+        subscriber.send(delta)
+      }
+    }
+  }
+}
@@ -0,0 +1,183 @@
+import cluster from 'cluster'
+import cors from 'cors'
+import express, { Request, Response } from 'express'
+import fs from 'fs'
+import http from 'http'
+import {
+  CampaignResponseCache,
+  registerCampaignReadRoutes,
+} from './CampaignResponseCache'
+import {
+  CampaignSnapshotPublisher,
+  createCampaignSnapshotDir,
+  isCampaignSnapshotMessage,
+  SharedCampaignSnapshots,
+} from './CampaignSnapshotFile'
+import { CampaignChangeSource } from './CampaignUpdateHub'
+import { CLUSTER_LEADER_PORT, PORT } from './config'
+
+// Workers that keep crashing are re-forked with exponential backoff between these delays
+const WORKER_RESTART_MIN_DELAY_MS = 1000
+const WORKER_RESTART_MAX_DELAY_MS = 30000
+// A worker that ran at least this long resets the backoff
+const WORKER_STABLE_UPTIME_MS = 60000
+
+export interface ClusterLeader {
+  stop(): Promise<void>
+}
+
+/**
+ * Forks `workers` HTTP worker processes that share PORT, and publishes campaign snapshots to them.
+ * Workers that exit are replaced until stop() is called, after a delay that doubles while workers
+ * keep exiting soon after they start.
+ */
+export async function startClusterLeader(
+  workers: number,
+  responseCache: CampaignResponseCache,
+  changeSource: CampaignChangeSource
+): Promise<ClusterLeader> {
+  const snapshotDir = await createCampaignSnapshotDir()
+  const publisher = new CampaignSnapshotPublisher(
+    responseCache,
+    changeSource,
+    snapshotDir,
+    (message) => {
+      for (const worker of Object.values(cluster.workers ?? {})) {
+        worker?.send(message)
+      }
+    }
+  )
+  let stopping = false
+  let restartDelayMs = WORKER_RESTART_MIN_DELAY_MS
+  const restartTimers: Set<NodeJS.Timeout> = new Set()
+  // Fork time by worker id
+  const forkedAt: Map<number, number> = new Map()
+  const fork = () => {
+    const worker = cluster.fork()
+    forkedAt.set(worker.id, Date.now())
+  }
+
+  // Running under ts-node, workers need it too
+  if (__filename.endsWith('.ts')) {
+    cluster.setupPrimary({
+      execArgv: [...process.execArgv, '-r', 'ts-node/register/transpile-only'],
+    })
+  }
+  cluster.on('online', (worker) => {
+    const latest = publisher.latestMessage
+    if (latest) {
+      worker.send(latest)
+    }
+  })
+  cluster.on('exit', (worker, code, signal) => {
+    const uptimeMs = Date.now() - (forkedAt.get(worker.id) ?? 0)
+    forkedAt.delete(worker.id)
+    if (stopping) {
+      return
+    }
+    if (uptimeMs >= WORKER_STABLE_UPTIME_MS) {
+      restartDelayMs = WORKER_RESTART_MIN_DELAY_MS
+    }
+    console.error(
+      `Cluster worker ${worker.process.pid} exited (${signal ?? code}), restarting in ${restartDelayMs}ms`
+    )
+    const restartTimer = setTimeout(() => {
+      restartTimers.delete(restartTimer)
+      if (!stopping) {
+        fork()
+      }
+    }, restartDelayMs)
+    restartTimers.add(restartTimer)
+    restartDelayMs = Math.min(restartDelayMs * 2, WORKER_RESTART_MAX_DELAY_MS)
+  })
+
+  for (let i = 0; i < workers; i++) {
+    fork()
+  }
+  publisher.start()
+
+  return {
+    stop: async () => {
+      stopping = true
+      for (const restartTimer of restartTimers) {
+        clearTimeout(restartTimer)
+      }
+      publisher.stop()
+      await Promise.all(
+        Object.values(cluster.workers ?? {}).map(
+          (worker) =>
+            new Promise((resolve) => {
+              if (!worker || worker.isDead()) {
+                resolve(undefined)
+                return
+              }
+              worker.once('exit', resolve)
+              worker.process.kill('SIGTERM')
+            })
+        )
+      )
+      await fs.promises.rm(snapshotDir, { recursive: true, force: true })
+    },
+  }
+}
+
+// Forwards a request the worker doesn't serve itself to the leader, streaming both ways
+function proxyToLeader(req: Request, res: Response): void {
+  const proxyRequest = http.request(
+    {
+      host: '127.0.0.1',
+      port: CLUSTER_LEADER_PORT,
+      method: req.method,
+      path: req.originalUrl,
+      headers: req.headers,
+    },
+    (proxyResponse) => {
+      res.writeHead(proxyResponse.statusCode ?? 502, proxyResponse.headers)
+      proxyResponse.pipe(res)
+    }
+  )
+  proxyRequest.on('error', (error) => {
+    if (res.headersSent) {
+      res.end()
+      return
+    }
+    res.status(502).send(`Cluster leader unavailable: ${error.message}`)
+  })
+  // e.g. a /campaign-updates client went away
+  res.on('close', () => proxyRequest.destroy())
+  req.pipe(proxyRequest)
+}
+
+/**
+ * Serves GET /campaigns and GET /campaigns/:id from the snapshots the leader publishes, without
+ * an XRPL connection or database of its own, and proxies every other request to the leader.
+ */
+export function startClusterWorker(): void {
+  const snapshots = new SharedCampaignSnapshots()
+  process.on('message', (message) => {
+    if (isCampaignSnapshotMessage(message)) {
+      snapshots.update(message)
+    }
+  })
+
+  const app = express()
+  app.use(cors())
+  registerCampaignReadRoutes(app, snapshots)
+  // Request bodies aren't parsed here, they're streamed to the leader as is
+  app.use(proxyToLeader)
+
+  const server = app.listen(PORT, () => {
+    console.log(
+      `xrpl-crowdfund worker ${process.pid} listening on port ${PORT}`
+    )
+  })
+
+  const shutdown = () => {
+    server.close(() => process.exit(0))
+    setTimeout(() => process.exit(1), 5000).unref()
+  }
+  process.on('SIGINT', shutdown)
+  process.on('SIGTERM', shutdown)
+  // The leader is gone
+  process.on('disconnect', shutdown)
+}
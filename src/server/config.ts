@@ -0,0 +1,20 @@
+export const PORT = 3001
+
+// Number of HTTP worker processes; 0 runs the API in a single process
+export const CLUSTER_WORKERS = Number(process.env.CLUSTER_WORKERS || 0)
+
+// Internal port the cluster leader serves writes and /campaign-updates on, for the workers
+export const CLUSTER_LEADER_PORT = Number(
+  process.env.CLUSTER_LEADER_PORT || PORT + 1
+)
+
+// Pre-funded wallets kept ready for /users/create; 0 funds one per signup
+export const WALLET_POOL_SIZE = Number(process.env.WALLET_POOL_SIZE ?? 3)
+
+// The wallet pool refills once fewer wallets than this are ready
+export const WALLET_POOL_LOW_WATERMARK = Number(
+  process.env.WALLET_POOL_LOW_WATERMARK ?? Math.ceil(WALLET_POOL_SIZE / 2)
+)
+
+// Send Hook State reads to a second XRPL endpoint when the first is slow to answer
+export const XRPL_HEDGE_READS = process.env.XRPL_HEDGE_READS === 'true'
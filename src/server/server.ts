@@ -0,0 +1,545 @@
+import express, { Request, Response } from 'express'
+import cors from 'cors'
+import bodyParser from 'body-parser'
+import { Wallet } from 'xrpl'
+import {
+  CreateCampaignParams,
+  FundCampaignParams,
+  FundCampaignsParams,
+  VoteRejectMilestoneParams,
+  VoteApproveMilestoneParams,
+  RequestRefundPaymentParams,
+  RequestMilestonePayoutPaymentParams,
+  Application,
+} from '../../client/app/Application'
+import {
+  XRPL_ENDPOINTS,
+  client,
+  connectClient,
+  disconnectClient,
+} from '../../client/util/xrplClient'
+import { XrplConnectionPool } from '../../client/util/XrplConnectionPool'
+import connectDatabase from '../../client/database'
+import {
+  IUserDatabaseModel,
+  UserDatabaseModel,
+} from '../../client/database/models/user.model'
+import {
+  FaucetFundingSource,
+  WalletPool,
+} from '../../client/util/WalletPool'
+import { ApplicationStateCache } from '../../client/util/ApplicationStateCache'
+import { HookStateWorkerPool } from '../../client/util/HookStateWorkerPool'
+import { CampaignViewIndexer } from '../../client/util/CampaignViewIndexer'
+import { CampaignViewReader } from '../../client/util/CampaignViewReader'
+import {
+  CampaignResponseCache,
+  registerCampaignReadRoutes,
+} from './CampaignResponseCache'
+import {
+  CAMPAIGN_UPDATES_MAX_CAMPAIGN_IDS,
+  CampaignUpdateHub,
+} from './CampaignUpdateHub'
+import { startClusterLeader } from './cluster'
+import {
+  CLUSTER_LEADER_PORT,
+  CLUSTER_WORKERS,
+  PORT,
+  WALLET_POOL_LOW_WATERMARK,
+  WALLET_POOL_SIZE,
+  XRPL_HEDGE_READS,
+} from './config'
+
+// Keeps idle Server-Sent Events connections open through proxies
+const SSE_HEARTBEAT_INTERVAL_MS = 15000
+const app = express()
+app.use(cors())
+app.use(bodyParser.urlencoded({ extended: true }))
+app.use(bodyParser.json())
+
+const database = connectDatabase()
+// Hook State reads go through the pool; subscriptions and submits stay on client
+const xrplPool = new XrplConnectionPool(XRPL_ENDPOINTS, {
+  hedgeReads: XRPL_HEDGE_READS,
+})
+const applicationStateCache = new ApplicationStateCache(
+  client,
+  database,
+  xrplPool
+)
+const campaignResponseCache = new CampaignResponseCache(applicationStateCache)
+const campaignUpdateHub = new CampaignUpdateHub(applicationStateCache)
+campaignUpdateHub.start()
+const campaignViewIndexer = new CampaignViewIndexer(applicationStateCache)
+campaignViewIndexer.start()
+// Open /campaign-updates streams, ended on shutdown so server.close() can finish
+const eventStreams: Set<Response> = new Set()
+// Funded wallets for /users/create; the faucet also needs the client to check they're validated
+const walletPool = new WalletPool(new FaucetFundingSource(client), {
+  size: WALLET_POOL_SIZE,
+  lowWatermark: WALLET_POOL_LOW_WATERMARK,
+})
+Promise.all([connectClient(), xrplPool.connect(), database.asPromise()])
+  .then(() => {
+    walletPool.start()
+    return applicationStateCache.start()
+  })
+  .catch((error) => {
+    // Without the XRPL client the server can neither stream nor submit
+    console.error('Error starting application state cache:', error)
+    process.exit(1)
+  })
+
+type PostUsersCreateParams = {
+  username: string
+  password: string
+  xrplWalletSeed: string
+}
+
+type PostUsersLoginParams = {
+  username: string
+  password: string
+  xrplWalletSeed: string
+}
+
+type PostCampaignParams = {
+  ownerSeed: string
+  depositInDrops: string
+  title: string
+  description: string
+  overviewUrl: string
+  imageUrl: string
+  fundRaiseGoalInDrops: string
+  fundRaiseEndDateInUnixSeconds: string
+  milestones: Array<{
+    endDateInUnixSeconds: string
+    title: string
+    payoutPercent: number
+  }>
+}
+
+type PostCampaignFundTransactionsParams = {
+  backerWalletSeed: string
+  fundAmountInDrops: string
+}
+
+type PostFundTransactionsParams = {
+  backerWalletSeed: string
+  fundCampaigns: Array<{
+    campaignId: number
+    fundAmountInDrops: string
+  }>
+}
+
+type PostVoteReject = {
+  backerWalletSeed: string
+}
+
+type PostVoteApprove = {
+  backerWalletSeed: string
+}
+
+type PostRequestRefundPayment = {
+  backerWalletSeed: string
+}
+
+type PostRequestMilestonePayoutPayment = {
+  ownerWalletSeed: string
+}
+
+app.post('/users/create', async (req: Request, res: Response) => {
+  try {
+    const params: PostUsersCreateParams = req.body
+    const { username, password } = params
+    if (!username || !password) {
+      throw new Error('username and/or password is missing')
+    }
+
+    const wallet = await walletPool.take()
+    if (!wallet || !wallet.seed) {
+      throw new Error('Error funding wallet')
+    }
+    const xrplWalletSeed = wallet.seed
+
+    const userData: IUserDatabaseModel = {
+      username,
+      password,
+      xrplWalletSeed,
+    }
+    const user = new UserDatabaseModel(userData)
+    try {
+      await user.save()
+    } catch (error: any) {
+      if (error.code === 11000) {
+        throw new Error(`Username already exists: ${username}`)
+      }
+      throw new Error(`Error saving user to database: ${error}`)
+    }
+
+    res.send({ username, password, wallet })
+  } catch (err: any) {
+    res.status(500).send(err.message)
+  }
+})
+
+app.post('/users/login', async (req: Request, res: Response) => {
+  try {
+    const params: PostUsersLoginParams = req.body
+    const { username, password } = params
+    if (!username || !password) {
+      throw new Error('username and/or password is missing')
+    }
+
+    // check if username and password match in database
+    const userDatabaseEntry = await UserDatabaseModel.findOne({
+      username,
+      password,
+    })
+      .lean()
+      .exec()
+    if (!userDatabaseEntry) {
+      throw new Error(
+        `User doesn't exist (username,password): (${username},${password})`
+      )
+    }
+
+    // check if xrplWalletSeed is valid
+    const { xrplWalletSeed } = userDatabaseEntry
+    const wallet = Wallet.fromSeed(xrplWalletSeed)
+    if (!wallet) {
+      throw new Error(`Invalid xrplWalletSeed from database: ${xrplWalletSeed}`)
+    }
+
+    res.send({ username, password, wallet })
+  } catch (err: any) {
+    res.status(500).send(err.message)
+  }
+})
+
+registerCampaignReadRoutes(app, campaignResponseCache, (campaignId) =>
+  CampaignViewReader.getCampaign(xrplPool, database, campaignId)
+)
+
+// Server-Sent Events stream of CampaignDelta for ?ids=1,2,3; the first event per campaign has its current state
+app.get('/campaign-updates', async (req: Request, res: Response) => {
+  const ids = typeof req.query.ids === 'string' ? req.query.ids.split(',') : []
+  const campaignIds = [
+    ...new Set(ids.filter((id) => id !== '').map((id) => Number(id))),
+  ]
+  if (
+    campaignIds.length === 0 ||
+    campaignIds.length > CAMPAIGN_UPDATES_MAX_CAMPAIGN_IDS ||
+    !campaignIds.every((id) => Number.isInteger(id) && id >= 0)
+  ) {
+    res
+      .status(400)
+      .send(
+        `ids must be 1 to ${CAMPAIGN_UPDATES_MAX_CAMPAIGN_IDS} comma-separated campaign ids`
+      )
+    return
+  }
+
+  res.set({
+    'Content-Type': 'text/event-stream',
+    'Cache-Control': 'no-cache',
+    Connection: 'keep-alive',
+    'X-Accel-Buffering': 'no',
+  })
+  res.flushHeaders()
+  eventStreams.add(res)
+
+  let unsubscribe: (() => void) | undefined
+  let closed = false
+  const heartbeat = setInterval(() => {
+    res.write(':\n\n')
+  }, SSE_HEARTBEAT_INTERVAL_MS)
+  req.on('close', () => {
+    closed = true
+    eventStreams.delete(res)
+    clearInterval(heartbeat)
+    unsubscribe?.()
+  })
+
+  try {
+    unsubscribe = await campaignUpdateHub.subscribe(campaignIds, {
+      send: (delta) => {
+        res.write(`event: campaign\ndata: ${JSON.stringify(delta)}\n\n`)
+      },
+    })
+    if (closed) {
+      unsubscribe()
+    }
+  } catch (err: any) {
+    res.write(`event: error\ndata: ${JSON.stringify(err.message)}\n\n`)
+    res.end()
+  }
+})
+
+// Campaigns an account backed and its fund transactions in each, from the MongoDB view
+app.get('/backers/:account/campaigns', async (req: Request, res: Response) => {
+  try {
+    const { ledgerIndex, campaigns } =
+      await CampaignViewReader.getBackerCampaigns(
+        xrplPool,
+        database,
+        req.params.account
+      )
+    res.set('X-Ledger-Index', String(ledgerIndex))
+    res.send(
+      campaigns.map(({ campaignId, fundTransactions }) => ({
+        campaignId,
+        fundTransactions: fundTransactions.map((fundTransaction) =>
+          fundTransaction.serialize()
+        ),
+      }))
+    )
+  } catch (err: any) {
+    res.status(500).send(err.message)
+  }
+})
+
+app.get('/deposit-fee/:operation', async (req: Request, res: Response) => {
+  try {
+    const operation = req.params.operation
+    let depositInDrops
+
+    if (operation === 'create-campaign') {
+      depositInDrops = await Application.getCreateCampaignDepositInDrops()
+    } else if (operation === 'fund-campaign') {
+      depositInDrops = await Application.getFundCampaignDepositInDrops()
+    } else {
+      return res.status(400).send('Invalid operation specified')
+    }
+
+    res.send({ depositInDrops: depositInDrops.toString() })
+  } catch (err: any) {
+    res.status(500).send(err.message)
+  }
+})
+
+app.post('/campaigns', async (req: Request, res: Response) => {
+  try {
+    const params: PostCampaignParams = req.body
+    const createCampaignParams: CreateCampaignParams = {
+      ownerWallet: Wallet.fromSeed(params.ownerSeed),
+      depositInDrops: BigInt(params.depositInDrops),
+      title: params.title,
+      description: params.description,
+      overviewUrl: params.overviewUrl,
+      imageUrl: params.imageUrl,
+      fundRaiseGoalInDrops: BigInt(params.fundRaiseGoalInDrops),
+      fundRaiseEndDateInUnixSeconds: BigInt(
+        params.fundRaiseEndDateInUnixSeconds
+      ),
+      milestones: params.milestones.map((milestone) => {
+        return {
+          endDateInUnixSeconds: BigInt(milestone.endDateInUnixSeconds),
+          title: milestone.title,
+          payoutPercent: milestone.payoutPercent,
+        }
+      }),
+    }
+    const campaignId = await Application.createCampaign(
+      client,
+      database,
+      createCampaignParams
+    )
+    res.send({ campaignId })
+  } catch (err: any) {
+    res.status(500).send(err.message)
+  }
+})
+
+app.post(
+  '/campaigns/fund-transactions',
+  async (req: Request, res: Response) => {
+    try {
+      const params: PostFundTransactionsParams = req.body
+      const fundCampaignsParams: FundCampaignsParams = {
+        backerWallet: Wallet.fromSeed(params.backerWalletSeed),
+        fundCampaigns: params.fundCampaigns.map((fundCampaign) => {
+          return {
+            campaignId: fundCampaign.campaignId,
+            fundAmountInDrops: BigInt(fundCampaign.fundAmountInDrops),
+          }
+        }),
+      }
+      const fundTransactionIds = await Application.fundCampaigns(
+        client,
+        fundCampaignsParams
+      )
+      res.send({ fundTransactionIds })
+    } catch (err: any) {
+      res.status(500).send(err.message)
+    }
+  }
+)
+
+app.post(
+  '/campaigns/:id/fund-transactions',
+  async (req: Request, res: Response) => {
+    try {
+      const id = parseInt(req.params.id)
+      const params: PostCampaignFundTransactionsParams = req.body
+      const fundCampaignParams: FundCampaignParams = {
+        backerWallet: Wallet.fromSeed(params.backerWalletSeed),
+        campaignId: id,
+        fundAmountInDrops: BigInt(params.fundAmountInDrops),
+      }
+      const fundTransactionId = await Application.fundCampaign(
+        client,
+        fundCampaignParams
+      )
+      res.send({ fundTransactionId })
+    } catch (err: any) {
+      res.status(500).send(err.message)
+    }
+  }
+)
+
+app.post(
+  '/campaigns/:campaignId/fund-transactions/:fundTransactionId/vote-reject',
+  async (req: Request, res: Response) => {
+    try {
+      const campaignId = parseInt(req.params.campaignId)
+      const fundTransactionId = parseInt(req.params.fundTransactionId)
+      const params: PostVoteReject = req.body
+      const voteRejectParams: VoteRejectMilestoneParams = {
+        backerWallet: Wallet.fromSeed(params.backerWalletSeed),
+        campaignId,
+        fundTransactionId,
+      }
+      await Application.voteRejectMilestone(client, voteRejectParams)
+      res.send('OK')
+    } catch (err: any) {
+      res.status(500).send(err.message)
+    }
+  }
+)
+
+app.post(
+  '/campaigns/:campaignId/fund-transactions/:fundTransactionId/vote-approve',
+  async (req: Request, res: Response) => {
+    try {
+      const campaignId = parseInt(req.params.campaignId)
+      const fundTransactionId = parseInt(req.params.fundTransactionId)
+      const params: PostVoteApprove = req.body
+      const voteApproveParams: VoteApproveMilestoneParams = {
+        backerWallet: Wallet.fromSeed(params.backerWalletSeed),
+        campaignId,
+        fundTransactionId,
+      }
+      await Application.voteApproveMilestone(client, voteApproveParams)
+      res.send('OK')
+    } catch (err: any) {
+      res.status(500).send(err.message)
+    }
+  }
+)
+
+app.post(
+  '/campaigns/:campaignId/fund-transactions/:fundTransactionId/request-refund-payment',
+  async (req: Request, res: Response) => {
+    try {
+      const campaignId = parseInt(req.params.campaignId)
+      const fundTransactionId = parseInt(req.params.fundTransactionId)
+      const params: PostRequestRefundPayment = req.body
+      const requestRefundPaymentParams: RequestRefundPaymentParams = {
+        backerWallet: Wallet.fromSeed(params.backerWalletSeed),
+        campaignId,
+        fundTransactionId,
+      }
+      await Application.requestRefundPayment(client, requestRefundPaymentParams)
+      res.send('OK')
+    } catch (err: any) {
+      res.status(500).send(err.message)
+    }
+  }
+)
+
+app.post(
+  '/campaigns/:campaignId/milestones/:milestoneIndex/request-milestone-payout-payment',
+  async (req: Request, res: Response) => {
+    try {
+      const campaignId = parseInt(req.params.campaignId)
+      const milestoneIndex = parseInt(req.params.milestoneIndex)
+      const params: PostRequestMilestonePayoutPayment = req.body
+      const requestMilestonePayoutPaymentParams: RequestMilestonePayoutPaymentParams =
+        {
+          ownerWallet: Wallet.fromSeed(params.ownerWalletSeed),
+          campaignId,
+          milestoneIndex,
+        }
+      await Application.requestMilestonePayoutPayment(
+        client,
+        requestMilestonePayoutPaymentParams
+      )
+      res.send('OK')
+    } catch (err: any) {
+      res.status(500).send(err.message)
+    }
+  }
+)
+
+// In cluster mode the workers own PORT and reach this server on the loopback interface
+const server =
+  CLUSTER_WORKERS > 0
+    ? app.listen(CLUSTER_LEADER_PORT, '127.0.0.1', () => {
+        console.log(
+          `xrpl-crowdfund leader listening at http://127.0.0.1:${CLUSTER_LEADER_PORT}`
+        )
+      })
+    : app.listen(PORT, () => {
+        console.log(`xrpl-crowdfund listening at http://localhost:${PORT}`)
+      })
+const clusterLeader =
+  CLUSTER_WORKERS > 0
+    ? startClusterLeader(
+        CLUSTER_WORKERS,
+        campaignResponseCache,
+        applicationStateCache
+      ).catch((error) => {
+        console.error('Error starting cluster workers:', error)
+        process.exit(1)
+      })
+    : undefined
+
+// Graceful shutdown
+const shutdown = (signal: string) => {
+  console.log(`${signal} received, shutting down gracefully`)
+
+  campaignUpdateHub.stop()
+  eventStreams.forEach((eventStream) => eventStream.end())
+  // Workers stop taking requests while the leader finishes the ones they proxied
+  const clusterStopped = Promise.resolve(clusterLeader).then((leader) =>
+    leader?.stop()
+  )
+  server.close(() => {
+    console.log('HTTP server closed')
+    clusterStopped
+      .then(() => walletPool.stop())
+      .then(() => applicationStateCache.stop())
+      .then(() => campaignViewIndexer.stop())
+      .then(() => HookStateWorkerPool.closeShared())
+      .then(() => Promise.all([disconnectClient(), xrplPool.disconnect()]))
+      .then(() => {
+        console.log('XRPL client disconnected')
+        database.close().then(() => {
+          console.log('Database connection closed')
+          process.exit(0)
+        })
+      })
+      .catch((error) => {
+        console.error('Error during cleanup:', error)
+        process.exit(1)
+      })
+  })
+
+  setTimeout(() => {
+    console.error('Shutdown timed out, forcefully terminating process')
+    process.exit(1)
+  }, 5000)
+}
+
+process.on('SIGINT', () => shutdown('SIGINT'))
+process.on('SIGTERM', () => shutdown('SIGTERM'))